@@ -22,7 +22,7 @@ struct PointLight
     vec3 color;
 };
 
-#define MAX_POINT_LIGHTS 8
+#define MAX_POINT_LIGHTS 32   // 和 Light.h 的 kMaxPointLights 一致
 uniform int u_PointLightCount;
 uniform PointLight u_PointLights[MAX_POINT_LIGHTS];
 
@@ -3,7 +3,16 @@ layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec3 aNormal;
 layout (location = 2) in vec2 aUV;
 
+#ifdef USE_INSTANCING
+// 每实例属性（Renderer::InstanceData）
+layout (location = 3) in mat4 aInstanceModel;   // 占 3~6
+layout (location = 7) in vec4 aInstanceColor;
+layout (location = 8) in vec4 aInstanceParams;  // metallic, roughness, ao, layer
+flat out vec4 vInstanceColor;
+flat out vec4 vInstanceParams;
+#else
 uniform mat4 u_Model;
+#endif
 uniform mat4 u_View;
 uniform mat4 u_Proj;
 
@@ -13,10 +22,17 @@ out vec3 vNormal;
 
 void main()
 {
+#ifdef USE_INSTANCING
+    mat4 model = aInstanceModel;
+    vInstanceColor  = aInstanceColor;
+    vInstanceParams = aInstanceParams;
+#else
+    mat4 model = u_Model;
+#endif
     vUV = aUV;
-    vec4 worldPos = u_Model * vec4(aPos,1.0);
+    vec4 worldPos = model * vec4(aPos,1.0);
     vFragPos = worldPos.xyz;
-    mat3 normalMat = mat3(transpose(inverse(u_Model)));
+    mat3 normalMat = mat3(transpose(inverse(model)));
     vNormal = normalize(normalMat * aNormal);
 
     gl_Position = u_Proj * u_View * worldPos;
@@ -0,0 +1,56 @@
+#version 330 core
+out vec4 FragColor;
+in vec2 vUV;
+
+// Dual-Kawase 降采样（Bjørge 2015）：中心 1 个 + 四个对角各 1 个双线性采样，共 5 次 fetch
+// 对角采样落在源纹理 texel 的角上，一次双线性等于 4 个 texel 的平均，相当于 16 texel 的加权核
+// BLOOM_PREFILTER：第一级顺带做亮度阈值（soft knee），只有过亮的部分进金字塔
+
+uniform sampler2D u_Source;
+uniform vec2 u_SourceTexel;        // 1 / 源纹理尺寸
+uniform vec4 u_Threshold;          // (阈值, knee, -, -)
+#ifdef BLOOM_PREFILTER
+uniform vec2 u_SourceUvScale;      // 源里有效区域的比例（动态分辨率时场景只占左下角）
+#endif
+
+vec3 fetch(vec2 uv)
+{
+#ifdef BLOOM_PREFILTER
+    // 不让双线性采样越过有效区域的边
+    uv = clamp(uv, 0.5 * u_SourceTexel, u_SourceUvScale - 0.5 * u_SourceTexel);
+#endif
+    return texture(u_Source, uv).rgb;
+}
+
+vec3 prefilter(vec3 c)
+{
+    // 防 inf / 极亮像素把整个金字塔点亮
+    c = min(c, vec3(65000.0));
+    float br = max(c.r, max(c.g, c.b));
+    float knee = u_Threshold.y;
+    float soft = clamp(br - u_Threshold.x + knee, 0.0, 2.0 * knee);
+    soft = soft * soft / (4.0 * knee + 1e-4);
+    float w = max(soft, br - u_Threshold.x) / max(br, 1e-4);
+    return c * w;
+}
+
+void main()
+{
+    vec2 o = u_SourceTexel;
+#ifdef BLOOM_PREFILTER
+    vec2 uv = vUV * u_SourceUvScale;
+#else
+    vec2 uv = vUV;
+#endif
+    vec3 sum = fetch(uv) * 4.0;
+    sum += fetch(uv + vec2(-o.x, -o.y));
+    sum += fetch(uv + vec2( o.x, -o.y));
+    sum += fetch(uv + vec2(-o.x,  o.y));
+    sum += fetch(uv + vec2( o.x,  o.y));
+    vec3 c = sum * (1.0 / 8.0);
+
+#ifdef BLOOM_PREFILTER
+    c = prefilter(c);
+#endif
+    FragColor = vec4(c, 1.0);
+}
@@ -0,0 +1,24 @@
+#version 330 core
+out vec4 FragColor;
+in vec2 vUV;
+
+// Dual-Kawase 升采样：四条边方向各 1 个（权重 1）+ 四个对角各 1 个（权重 2），共 8 次 fetch
+// 结果用加法混合叠到上一级降采样的结果上，最后 1/2 分辨率那一级就是所有尺度的和
+
+uniform sampler2D u_Source;
+uniform vec2 u_SourceTexel;        // 1 / 源纹理（更小那一级）尺寸
+
+void main()
+{
+    // 半个源 texel：边方向偏 1 个 texel，对角偏半个
+    vec2 o = 0.5 * u_SourceTexel;
+    vec3 sum = texture(u_Source, vUV + vec2(-2.0 * o.x, 0.0)).rgb;
+    sum += texture(u_Source, vUV + vec2( 2.0 * o.x, 0.0)).rgb;
+    sum += texture(u_Source, vUV + vec2(0.0, -2.0 * o.y)).rgb;
+    sum += texture(u_Source, vUV + vec2(0.0,  2.0 * o.y)).rgb;
+    sum += texture(u_Source, vUV + vec2(-o.x, -o.y)).rgb * 2.0;
+    sum += texture(u_Source, vUV + vec2( o.x, -o.y)).rgb * 2.0;
+    sum += texture(u_Source, vUV + vec2(-o.x,  o.y)).rgb * 2.0;
+    sum += texture(u_Source, vUV + vec2( o.x,  o.y)).rgb * 2.0;
+    FragColor = vec4(sum * (1.0 / 12.0), 1.0);
+}
@@ -0,0 +1,73 @@
+#version 330 core
+out vec2 FragColor;
+in vec2 vUV;    // x = N·V，y = roughness
+
+uniform int u_SampleCount;
+
+const float PI = 3.14159265359;
+
+// 和 IBLMath.cpp 的 IntegrateBRDF 逐行对应，改一边要同步另一边（CompareBRDFLUT 会报出差异）
+float RadicalInverse_VdC(uint bits)
+{
+    bits = (bits << 16u) | (bits >> 16u);
+    bits = ((bits & 0x55555555u) << 1u) | ((bits & 0xAAAAAAAAu) >> 1u);
+    bits = ((bits & 0x33333333u) << 2u) | ((bits & 0xCCCCCCCCu) >> 2u);
+    bits = ((bits & 0x0F0F0F0Fu) << 4u) | ((bits & 0xF0F0F0F0u) >> 4u);
+    bits = ((bits & 0x00FF00FFu) << 8u) | ((bits & 0xFF00FF00u) >> 8u);
+    return float(bits) * 2.3283064365386963e-10;
+}
+
+vec2 Hammersley(uint i, uint N)
+{
+    return vec2(float(i) / float(N), RadicalInverse_VdC(i));
+}
+
+// N 固定为 +Z，不需要切线空间变换
+vec3 ImportanceSampleGGX(vec2 Xi, float roughness)
+{
+    float a = roughness * roughness;
+    float phi      = 2.0 * PI * Xi.x;
+    float cosTheta = sqrt((1.0 - Xi.y) / (1.0 + (a * a - 1.0) * Xi.y));
+    float sinTheta = sqrt(1.0 - cosTheta * cosTheta);
+    return vec3(cos(phi) * sinTheta, sin(phi) * sinTheta, cosTheta);
+}
+
+// IBL 用的 k = a / 2（直接光是 (r+1)²/8）
+float GeometrySchlickGGX(float NdotV, float roughness)
+{
+    float k = (roughness * roughness) / 2.0;
+    return NdotV / (NdotV * (1.0 - k) + k);
+}
+
+vec2 IntegrateBRDF(float NdotV, float roughness)
+{
+    vec3 V = vec3(sqrt(1.0 - NdotV * NdotV), 0.0, NdotV);
+
+    float A = 0.0;
+    float B = 0.0;
+    uint sampleCount = uint(u_SampleCount);
+    for (uint i = 0u; i < sampleCount; ++i)
+    {
+        vec2 Xi = Hammersley(i, sampleCount);
+        vec3 H  = ImportanceSampleGGX(Xi, roughness);
+        vec3 L  = normalize(2.0 * dot(V, H) * H - V);
+
+        float NdotL = max(L.z, 0.0);
+        float NdotH = max(H.z, 0.0);
+        float VdotH = max(dot(V, H), 0.0);
+        if (NdotL > 0.0)
+        {
+            float G = GeometrySchlickGGX(NdotV, roughness) * GeometrySchlickGGX(NdotL, roughness);
+            float G_Vis = (G * VdotH) / (NdotH * NdotV);
+            float Fc = pow(1.0 - VdotH, 5.0);
+            A += (1.0 - Fc) * G_Vis;
+            B += Fc * G_Vis;
+        }
+    }
+    return vec2(A, B) / float(sampleCount);
+}
+
+void main()
+{
+    FragColor = IntegrateBRDF(vUV.x, vUV.y);
+}
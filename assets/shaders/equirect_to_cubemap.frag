@@ -3,6 +3,7 @@ out vec4 FragColor;
 in vec3 vLocalPos;
 
 uniform sampler2D u_EquirectMap;  // 你加载的 HDR 全景图
+uniform bool      u_RGBE;         // 全景图是 RGBE8 原始数据（TextureHDR::Decode::RGBE），需要手动解码
 
 // 1/(2π) 和 1/π，用于把弧度归一化到 [0,1]
 const vec2 invAtan = vec2(0.1591, 0.3183);
@@ -20,6 +21,13 @@ vec2 SampleSphericalMap(vec3 v)
 void main()
 {
     vec2 uv = SampleSphericalMap(normalize(vLocalPos));
-    vec3 color = texture(u_EquirectMap, uv).rgb;
+    vec4 texel = texture(u_EquirectMap, uv);
+    vec3 color = texel.rgb;
+    if (u_RGBE)
+    {
+        // RGBE：rgb * 2^(e - 136)，e = 0 表示黑色（和 stb_image / RadianceHDR 一致）
+        float e = floor(texel.a * 255.0 + 0.5);
+        color = (e > 0.0) ? floor(texel.rgb * 255.0 + 0.5) * exp2(e - 136.0) : vec3(0.0);
+    }
     FragColor = vec4(color, 1.0);
 }
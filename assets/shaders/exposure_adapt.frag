@@ -0,0 +1,19 @@
+#version 330 core
+out vec4 FragColor;
+
+// 自动曝光的时间适应：结果（log2 亮度）留在 1x1 纹理里，post.frag 直接读，不回读 CPU
+// 和上一帧的结果按指数衰减混合，变亮和变暗用不同的速度（人眼对变亮适应更快）
+
+uniform sampler2D u_AverageLum;    // 归约到 1x1 的平均 log2 亮度
+uniform sampler2D u_Previous;      // 上一帧适应后的 log2 亮度
+uniform vec4 u_Adapt;              // (变亮速度, 变暗速度, dt, 重置)
+
+void main()
+{
+    float target = texelFetch(u_AverageLum, ivec2(0), 0).r;
+    float prev = texelFetch(u_Previous, ivec2(0), 0).r;
+    float speed = target > prev ? u_Adapt.x : u_Adapt.y;
+    float a = 1.0 - exp(-u_Adapt.z * speed);
+    float adapted = (u_Adapt.w > 0.5) ? target : mix(prev, target, a);
+    FragColor = vec4(adapted, 0.0, 0.0, 1.0);
+}
@@ -0,0 +1,45 @@
+#version 330 core
+out vec4 FragColor;
+in vec2 vUV;
+
+// 自动曝光的亮度归约：每个输出像素覆盖 4x4 个源 texel
+// 四个双线性采样落在 2x2 块的中心，每个等于 4 个 texel 的平均
+// LUMINANCE_FIRST：第一级从场景颜色算 log2 亮度；之后各级只是继续平均 log2 亮度
+
+uniform sampler2D u_Source;
+uniform vec2 u_SourceTexel;        // 1 / 源纹理尺寸
+uniform vec2 u_LogLumRange;        // log2 亮度的夹取范围（太暗/太亮的像素不把平均值拖走）
+#ifdef LUMINANCE_FIRST
+uniform vec2 u_SourceUvScale;      // 源里有效区域的比例（动态分辨率时场景只占左下角）
+#endif
+
+vec4 fetch(vec2 uv)
+{
+#ifdef LUMINANCE_FIRST
+    uv = clamp(uv, 0.5 * u_SourceTexel, u_SourceUvScale - 0.5 * u_SourceTexel);
+#endif
+    return texture(u_Source, uv);
+}
+
+void main()
+{
+    vec2 o = u_SourceTexel;
+#ifdef LUMINANCE_FIRST
+    vec2 uv = vUV * u_SourceUvScale;
+#else
+    vec2 uv = vUV;
+#endif
+    vec4 sum = fetch(uv + vec2(-o.x, -o.y));
+    sum += fetch(uv + vec2( o.x, -o.y));
+    sum += fetch(uv + vec2(-o.x,  o.y));
+    sum += fetch(uv + vec2( o.x,  o.y));
+    sum *= 0.25;
+
+#ifdef LUMINANCE_FIRST
+    float lum = dot(sum.rgb, vec3(0.2126, 0.7152, 0.0722));
+    float logLum = clamp(log2(max(lum, 1e-6)), u_LogLumRange.x, u_LogLumRange.y);
+#else
+    float logLum = sum.r;
+#endif
+    FragColor = vec4(logLum, 0.0, 0.0, 1.0);
+}
@@ -10,11 +10,21 @@ in vec3 vNormal; //world space
 //光照 → BRDF计算 → HDR(允许光照计算产生大于1的亮度，从而保留真实光照强度差异，最后再通过 tone mapping 显示到屏幕) → Tone Mapping(色调映射 压光 避免过曝) → Gamma(srgb伽马矫正) → 屏幕
 
 // ---- 材质参数 ----
+#ifdef USE_TEXTURE_ARRAY
+uniform sampler2DArray u_TextureArray;  // 打包后的 albedo（TextureArrayPacker），layer 来自实例数据
+#else
 uniform sampler2D  u_Texture0;   // albedo map
+#endif
+#ifdef USE_INSTANCING
+// instanced 路径：材质参数逐实例传入（见 basic.vert）
+flat in vec4 vInstanceColor;
+flat in vec4 vInstanceParams;    // metallic, roughness, ao, layer
+#else
 uniform vec4       u_Color;      // albedo tint(乘以贴图颜色)
 uniform float      u_Metallic;   // 0 = 非金属, 1 = 金属
 uniform float      u_Roughness;  // 0 = 镜面光滑, 1 = 完全粗糙
 uniform float      u_AO;         // ambient occlusion(0~1,暂时传 1.0)
+#endif
 
 // ---- 相机位置 ----
 uniform vec3 u_ViewPos;
@@ -24,10 +34,16 @@ struct PointLight {
    vec3 position;
    vec3 color;
 };
-#define MAX_POINT_LIGHTS 8
+#define MAX_POINT_LIGHTS 32   // 和 Light.h 的 kMaxPointLights 一致
 uniform int        u_PointLightCount;
 uniform PointLight u_PointLights[MAX_POINT_LIGHTS];
-uniform samplerCube u_IrradianceMap;   // 漫反射 IBL
+uniform samplerCube u_IrradianceMap;   // 漫反射 IBL（GPU 卷积，u_UseSH 为 false 时用）
+uniform bool       u_UseSH;            // true：用 CPU 烘焙的 SH9 辐照度
+uniform vec3       u_SH[9];            // IBLBaker::GetIrradianceSH()，已除以 π
+uniform samplerCube u_PrefilterMap;    // 镜面 IBL：按 roughness 分级预滤波的环境图
+uniform sampler2D  u_BrdfLUT;          // 镜面 IBL：分裂求和的 (A, B)，u = N·V，v = roughness
+uniform float      u_PrefilterMaxLod;  // IBLBaker::GetPrefilterMaxLod()
+uniform bool       u_UseSpecularIBL;
 
 
 // -------------------------------------------------------------------------
@@ -36,6 +52,21 @@ uniform samplerCube u_IrradianceMap;   // 漫反射 IBL
 
 const float PI = 3.14159265359;
 
+// SH9 辐照度求值，基函数顺序和常数与 IBLMath.cpp 的 EvalSH9 一致
+vec3 EvalSHIrradiance(vec3 n)
+{
+    vec3 result = u_SH[0] * 0.282095
+                + u_SH[1] * (0.488603 * n.y)
+                + u_SH[2] * (0.488603 * n.z)
+                + u_SH[3] * (0.488603 * n.x)
+                + u_SH[4] * (1.092548 * n.x * n.y)
+                + u_SH[5] * (1.092548 * n.y * n.z)
+                + u_SH[6] * (0.315392 * (3.0 * n.z * n.z - 1.0))
+                + u_SH[7] * (1.092548 * n.x * n.z)
+                + u_SH[8] * (0.546274 * (n.x * n.x - n.y * n.y));
+    return max(result, vec3(0.0));
+}
+
 // D: 法线分布函数(GGX / Trowbridge - Reitz)
 // 作用: 统计微表面中有多少个对齐到H方向(光方向 和 视线方向 的中间方向  如果某个微表面的法线 = H 它就会把光反射到眼睛)的面
 // roughness 越大,高光越分散
@@ -88,11 +119,26 @@ void main()
 {
     // ---- albedo：从 sRGB 转换到线性空间 ----
     // 贴图文件通常存储为 sRGB，PBR 计算必须在线性空间里做
-    vec3 albedo = pow(texture(u_Texture0, vUV).rgb, vec3(2.2)) * u_Color.rgb;
-
-    float metallic  = clamp(u_Metallic,  0.0, 1.0);
-    float roughness = clamp(u_Roughness, 0.05, 1.0); // 避免完全 0 导致除零
-    float ao        = u_AO;
+#ifdef USE_INSTANCING
+    vec4  baseColor = vInstanceColor;
+    float metallicIn  = vInstanceParams.x;
+    float roughnessIn = vInstanceParams.y;
+    float ao          = vInstanceParams.z;
+#else
+    vec4  baseColor = u_Color;
+    float metallicIn  = u_Metallic;
+    float roughnessIn = u_Roughness;
+    float ao          = u_AO;
+#endif
+#ifdef USE_TEXTURE_ARRAY
+    vec3 texColor = texture(u_TextureArray, vec3(vUV, vInstanceParams.w)).rgb;
+#else
+    vec3 texColor = texture(u_Texture0, vUV).rgb;
+#endif
+    vec3 albedo = pow(texColor, vec3(2.2)) * baseColor.rgb;
+
+    float metallic  = clamp(metallicIn,  0.0, 1.0);
+    float roughness = clamp(roughnessIn, 0.05, 1.0); // 避免完全 0 导致除零
 
     vec3 N = normalize(vNormal);
     vec3 V = normalize(u_ViewPos - vFragPos);
@@ -136,16 +182,26 @@ void main()
         Lo += (kD * albedo / PI + specular) * radiance * NdotL;
     }
 
-    // ---- 漫反射 IBL（用 IrradianceMap 替代常量环境光）----
+    // ---- 环境光 IBL：漫反射（辐照度）+ 镜面（预滤波环境图 × BRDF LUT）----
     // 间接光没有明确 H，用 N·V + roughness 修正的 Fresnel
     vec3 F_ibl = FresnelSchlickRoughness(max(dot(N, V), 0.0), F0, roughness);
     vec3 kD_ibl = (vec3(1.0) - F_ibl) * (1.0 - metallic);
 
-    // 用法线方向采样 IrradianceMap，得到这个方向的平均环境光
-    vec3 irradiance = texture(u_IrradianceMap, N).rgb;
+    // 用法线方向取这个方向的平均环境光：SH9 直接求值，或采样卷积出来的 IrradianceMap
+    vec3 irradiance = u_UseSH ? EvalSHIrradiance(N) : texture(u_IrradianceMap, N).rgb;
     vec3 diffuse_ibl = irradiance * albedo;
 
-    vec3 ambient = kD_ibl * diffuse_ibl * ao;
+    // 分裂求和：prefiltered(R, roughness) · (F·A + B)
+    vec3 specular_ibl = vec3(0.0);
+    if (u_UseSpecularIBL)
+    {
+        vec3 R = reflect(-V, N);
+        vec3 prefiltered = textureLod(u_PrefilterMap, R, roughness * u_PrefilterMaxLod).rgb;
+        vec2 brdf = texture(u_BrdfLUT, vec2(max(dot(N, V), 0.0), roughness)).rg;
+        specular_ibl = prefiltered * (F_ibl * brdf.x + brdf.y);
+    }
+
+    vec3 ambient = (kD_ibl * diffuse_ibl + specular_ibl) * ao;
     vec3 color   = ambient + Lo;
 
     FragColor = vec4(color, 1.0);
@@ -2,44 +2,190 @@
 out vec4 FragColor;
 in vec2 vUV;
 
+// 融合后处理：PostProcessPass 按效果栈生成 POST_STEP0..POST_STEP7 宏，
+// 每个宏展开成一次 applyXxx 调用，整条栈只读一次场景纹理、写一次结果，没有运行时分支。
+// 参数都放在 u_EffectParams 里，每个效果占 0~2 个 vec4（下标由宏直接写死）
+
+#ifndef POST_PARAM_COUNT
+#define POST_PARAM_COUNT 1
+#endif
+
 uniform sampler2D u_SceneTex;
-uniform int   u_Mode;              // 0=none 1=invert 2=grayscale
-uniform float u_VignetteStrength;  // 0..1
+uniform sampler3D u_ColorLut;      // ColorLut 烘的纯颜色效果段
+uniform sampler2D u_BloomTex;      // BloomPass 的结果（1/2 分辨率，双线性放大）
+uniform sampler2D u_ExposureTex;   // AutoExposure 适应后的平均 log2 亮度（1x1）
+uniform vec4 u_EffectParams[POST_PARAM_COUNT];
+uniform vec2 u_SceneUvScale;       // 场景有效区域占 u_SceneTex 的比例（动态分辨率）
+uniform vec2 u_SceneTexel;         // 1 / u_SceneTex 尺寸
+uniform float u_UpscaleSharpness;  // POST_UPSCALE_SHARPEN：0..1
+
+// ---- 放大：把 [0,1] 的输出 UV 映射到场景的有效区域 ----
+// 默认双线性；POST_UPSCALE_SHARPEN 时再按局部对比度做一次锐化（RCAS 的思路）：
+// 对比度越高锐化越弱，结果夹在邻域 min/max 里，边缘上不会出现振铃
+vec3 sampleScene(vec2 uv)
+{
+    vec2 lo = 0.5 * u_SceneTexel;
+    vec2 hi = u_SceneUvScale - 0.5 * u_SceneTexel;
+    uv = clamp(uv * u_SceneUvScale, lo, hi);
+    vec3 c = texture(u_SceneTex, uv).rgb;
+#ifdef POST_UPSCALE_SHARPEN
+    vec3 n = texture(u_SceneTex, clamp(uv + vec2(0.0, u_SceneTexel.y), lo, hi)).rgb;
+    vec3 s = texture(u_SceneTex, clamp(uv - vec2(0.0, u_SceneTexel.y), lo, hi)).rgb;
+    vec3 e = texture(u_SceneTex, clamp(uv + vec2(u_SceneTexel.x, 0.0), lo, hi)).rgb;
+    vec3 w = texture(u_SceneTex, clamp(uv - vec2(u_SceneTexel.x, 0.0), lo, hi)).rgb;
+    vec3 mn = min(c, min(min(n, s), min(e, w)));
+    vec3 mx = max(c, max(max(n, s), max(e, w)));
+    // HDR 输入：用 min/max 的比值当对比度，不假设在 [0,1]
+    vec3 amp = sqrt(clamp(mn / max(mx, vec3(1e-4)), 0.0, 1.0));
+    vec3 k = -amp * (0.2 * u_UpscaleSharpness);
+    vec3 r = (c + k * (n + s + e + w)) / (1.0 + 4.0 * k);
+    c = clamp(r, mn, mx);
+#endif
+    return c;
+}
+
+// ---- Bloom：p.x = 强度 ----
+vec3 applyBloom(vec3 c, vec4 p)
+{
+    return c + texture(u_BloomTex, vUV).rgb * p.x;
+}
+
+// ---- 曝光：p.x = 2^EV ----
+vec3 applyExposure(vec3 c, vec4 p)
+{
+    return c * p.x;
+}
+
+// ---- 自动曝光：p.x = 2^补偿EV，p.y = key（平均亮度映射到的中灰） ----
+vec3 applyAutoExposure(vec3 c, vec4 p)
+{
+    float logLum = texelFetch(u_ExposureTex, ivec2(0), 0).r;
+    return c * (p.x * p.y * exp2(-logLum));
+}
+
+// ---- Tone mapping：HDR -> LDR，再做 gamma 编码（p.x = 1/gamma） ----
+// 之后的效果都在显示空间里工作
+vec3 tonemapReinhard(vec3 c, vec4 p)
+{
+    c = c / (c + vec3(1.0));
+    return pow(c, vec3(p.x));
+}
+
+// Narkowicz 的 ACES 拟合
+vec3 tonemapACES(vec3 c, vec4 p)
+{
+    c = clamp((c * (2.51 * c + 0.03)) / (c * (2.43 * c + 0.59) + 0.14), 0.0, 1.0);
+    return pow(c, vec3(p.x));
+}
+
+// Hable（Uncharted 2）曲线，白点 11.2
+vec3 hableCurve(vec3 x)
+{
+    const float A = 0.15, B = 0.50, C = 0.10, D = 0.20, E = 0.02, F = 0.30;
+    return ((x * (A * x + C * B) + D * E) / (x * (A * x + B) + D * F)) - E / F;
+}
 
-//暗角(中心亮边缘暗)
-vec3 vignette(vec2 uv, vec3 c, float s)
+vec3 tonemapFilmic(vec3 c, vec4 p)
+{
+    c = hableCurve(2.0 * c) / hableCurve(vec3(11.2));
+    return pow(clamp(c, 0.0, 1.0), vec3(p.x));
+}
+
+// ---- 调色：a = (对比度, 饱和度, -, -)，b = 颜色滤镜 ----
+vec3 applyColorGrade(vec3 c, vec4 a, vec4 b)
+{
+    c = (c - vec3(0.5)) * a.x + vec3(0.5);
+    float g = dot(c, vec3(0.2126, 0.7152, 0.0722));
+    c = mix(vec3(g), c, a.y);
+    return max(c * b.rgb, vec3(0.0));
+}
+
+// ---- 反色 ----
+vec3 applyInvert(vec3 c)
+{
+    return vec3(1.0) - c;
+}
+
+// ---- 灰度：人眼感知加权 ----
+vec3 applyGrayscale(vec3 c)
+{
+    float g = dot(c, vec3(0.2126, 0.7152, 0.0722));
+    return vec3(g);
+}
+
+// ---- 暗角(中心亮边缘暗)：p.x = 强度 0..1 ----
+vec3 applyVignette(vec3 c, vec4 p)
 {
     //计算中心距离（找画面中心）
-    vec2 d = uv - vec2(0.5);
+    vec2 d = vUV - vec2(0.5);
     float r2 = dot(d, d);
     //计算渐变因子
     float v = smoothstep(0.8, 0.2, r2);
     //混合强度
-    return mix(c, c * v, s);
+    return mix(c, c * v, p.x);
 }
 
-void main()
+// ---- 3D LUT：一次三线性采样代替 tonemap/调色/反色/灰度 ----
+// p = (shaper 最小 EV, EV 范围, LUT 边长, -)；texel 中心对齐，u = i / (size - 1)
+vec3 sampleColorLut(vec3 u, vec4 p)
 {
-    //根据当前像素的 UV 从场景纹理里采样颜色
-    vec3 c = texture(u_SceneTex, vUV).rgb;
+    u = clamp(u, 0.0, 1.0) * ((p.z - 1.0) / p.z) + vec3(0.5 / p.z);
+    return texture(u_ColorLut, u).rgb;
+}
+
+// 输入已经在 [0,1]（显示空间）
+vec3 applyColorLut(vec3 c, vec4 p)
+{
+    return sampleColorLut(c, p);
+}
 
-        // ---- Tone mapping：HDR -> LDR ----
-        // 物理正确的光照计算结果可能超过 1.0（HDR）
-        // Reinhard 算子把它压回 [0,1]
-        c = c / (c + vec3(1.0));
+// HDR 输入：log shaper，和 ColorLut::ShaperEncode 一致
+vec3 applyColorLutLog(vec3 c, vec4 p)
+{
+    float bias = exp2(p.x);
+    vec3 u = (log2(max(c, vec3(0.0)) + vec3(bias)) - vec3(p.x)) / p.y;
+    return sampleColorLut(u, p);
+}
 
-        // ---- Gamma 矫正：线性 -> sRGB ----
-        c = pow(c, vec3(1.0 / 2.2));
+// ---- 抖动：8 位输出前加一点噪声打散色带，p.x = 幅度（单位 1/255） ----
+// interleaved gradient noise，两个样本相减得到三角分布
+vec3 applyDither(vec3 c, vec4 p)
+{
+    vec2 f = gl_FragCoord.xy;
+    float n0 = fract(52.9829189 * fract(dot(f, vec2(0.06711056, 0.00583715))));
+    float n1 = fract(52.9829189 * fract(dot(f + vec2(5.588238), vec2(0.06711056, 0.00583715))));
+    return c + vec3((n0 - n1) * p.x / 255.0);
+}
+
+void main()
+{
+    //根据当前像素的 UV 从场景纹理里采样颜色（动态分辨率时顺带放大）
+    vec3 c = sampleScene(vUV);
 
-    //Mode1 反色
-    if (u_Mode == 1) c = vec3(1.0) - c;
-    //Mode2 灰度
-    if (u_Mode == 2) {
-        //灰度公式 人眼感知加权
-        float g = dot(c, vec3(0.2126, 0.7152, 0.0722));
-        c = vec3(g);
-    }
+#ifdef POST_STEP0
+    c = POST_STEP0(c);
+#endif
+#ifdef POST_STEP1
+    c = POST_STEP1(c);
+#endif
+#ifdef POST_STEP2
+    c = POST_STEP2(c);
+#endif
+#ifdef POST_STEP3
+    c = POST_STEP3(c);
+#endif
+#ifdef POST_STEP4
+    c = POST_STEP4(c);
+#endif
+#ifdef POST_STEP5
+    c = POST_STEP5(c);
+#endif
+#ifdef POST_STEP6
+    c = POST_STEP6(c);
+#endif
+#ifdef POST_STEP7
+    c = POST_STEP7(c);
+#endif
 
-    c = vignette(vUV, c, u_VignetteStrength);
     FragColor = vec4(c, 1.0);
 }
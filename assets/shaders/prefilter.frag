@@ -0,0 +1,92 @@
+#version 330 core
+out vec4 FragColor;
+in vec3 vLocalPos;
+
+uniform samplerCube u_EnvMap;       // 带完整 mipmap 的环境立方体
+uniform float u_Roughness;          // 当前 mip 对应的粗糙度
+uniform int   u_SampleCount;        // 每个 mip 的采样数由 CPU 决定（越粗糙越多）
+uniform float u_EnvResolution;      // u_EnvMap 第 0 层的边长
+uniform float u_OutputResolution;   // 当前输出 mip 的边长
+
+const float PI = 3.14159265359;
+
+// Hammersley 低差异序列：第 i 个点 = (i/N, i 的二进制位反转)
+float RadicalInverse_VdC(uint bits)
+{
+    bits = (bits << 16u) | (bits >> 16u);
+    bits = ((bits & 0x55555555u) << 1u) | ((bits & 0xAAAAAAAAu) >> 1u);
+    bits = ((bits & 0x33333333u) << 2u) | ((bits & 0xCCCCCCCCu) >> 2u);
+    bits = ((bits & 0x0F0F0F0Fu) << 4u) | ((bits & 0xF0F0F0F0u) >> 4u);
+    bits = ((bits & 0x00FF00FFu) << 8u) | ((bits & 0xFF00FF00u) >> 8u);
+    return float(bits) * 2.3283064365386963e-10; // / 0x100000000
+}
+
+vec2 Hammersley(uint i, uint N)
+{
+    return vec2(float(i) / float(N), RadicalInverse_VdC(i));
+}
+
+// 按 GGX 分布采样半程向量 H（a = roughness²，和 pbr.frag 的 DistributionGGX 一致）
+vec3 ImportanceSampleGGX(vec2 Xi, vec3 N, float roughness)
+{
+    float a = roughness * roughness;
+
+    float phi      = 2.0 * PI * Xi.x;
+    float cosTheta = sqrt((1.0 - Xi.y) / (1.0 + (a * a - 1.0) * Xi.y));
+    float sinTheta = sqrt(1.0 - cosTheta * cosTheta);
+
+    vec3 H = vec3(cos(phi) * sinTheta, sin(phi) * sinTheta, cosTheta);
+
+    vec3 up        = abs(N.z) < 0.999 ? vec3(0.0, 0.0, 1.0) : vec3(1.0, 0.0, 0.0);
+    vec3 tangent   = normalize(cross(up, N));
+    vec3 bitangent = cross(N, tangent);
+    return normalize(tangent * H.x + bitangent * H.y + N * H.z);
+}
+
+float DistributionGGX(float NdotH, float roughness)
+{
+    float a  = roughness * roughness;
+    float a2 = a * a;
+    float denom = NdotH * NdotH * (a2 - 1.0) + 1.0;
+    return a2 / (PI * denom * denom);
+}
+
+void main()
+{
+    // 分裂求和近似：假设 N = V = R
+    vec3 N = normalize(vLocalPos);
+    vec3 V = N;
+
+    uint  sampleCount = uint(u_SampleCount);
+    float saTexel = 4.0 * PI / (6.0 * u_EnvResolution * u_EnvResolution);
+    // 源 mip 至少和输出一样粗，roughness = 0 那层只有 1 个样本时也不会走样
+    float minMip  = max(log2(u_EnvResolution / u_OutputResolution), 0.0);
+
+    vec3  color = vec3(0.0);
+    float totalWeight = 0.0;
+    for (uint i = 0u; i < sampleCount; ++i)
+    {
+        vec2 Xi = Hammersley(i, sampleCount);
+        vec3 H  = ImportanceSampleGGX(Xi, N, u_Roughness);
+        vec3 L  = normalize(2.0 * dot(V, H) * H - V);
+
+        float NdotL = dot(N, L);
+        if (NdotL > 0.0)
+        {
+            // 按 PDF 选源 mip（filtered importance sampling）：
+            // 每个样本代表的立体角 1/(N·pdf) 比一个 texel 大多少，就去采更模糊的那层，
+            // 少量样本也不会出现亮点噪声
+            float NdotH = max(dot(N, H), 0.0);
+            float HdotV = max(dot(H, V), 0.0);
+            float pdf   = DistributionGGX(NdotH, u_Roughness) * NdotH / (4.0 * HdotV) + 0.0001;
+            float saSample = 1.0 / (float(sampleCount) * pdf + 0.0001);
+            float mip = u_Roughness == 0.0 ? 0.0 : 0.5 * log2(saSample / saTexel) + 1.0;
+            mip = max(mip, minMip);
+
+            color       += textureLod(u_EnvMap, L, mip).rgb * NdotL;
+            totalWeight += NdotL;
+        }
+    }
+
+    FragColor = vec4(color / max(totalWeight, 0.0001), 1.0);
+}
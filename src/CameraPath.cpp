@@ -0,0 +1,105 @@
+#include "CameraPath.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+bool CameraPath::Load(const std::string& path)
+{
+    std::ifstream file(path);
+    if (!file)
+    {
+        std::fprintf(stderr, "[CameraPath] Cannot open %s\n", path.c_str());
+        return false;
+    }
+
+    std::vector<Key> keys;
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(file, line))
+    {
+        ++lineNumber;
+        std::size_t first = line.find_first_not_of(" \t\r");
+        if (first == std::string::npos || line[first] == '#') continue;
+
+        std::istringstream in(line);
+        Key key;
+        if (!(in >> key.time >> key.position.x >> key.position.y >> key.position.z >> key.yaw >> key.pitch))
+        {
+            std::fprintf(stderr, "[CameraPath] %s:%d: expected 't x y z yaw pitch [fov]'\n", path.c_str(), lineNumber);
+            return false;
+        }
+        if (!(in >> key.fov)) key.fov = keys.empty() ? 60.0f : keys.back().fov;
+        if (!keys.empty() && key.time <= keys.back().time)
+        {
+            std::fprintf(stderr, "[CameraPath] %s:%d: time must increase\n", path.c_str(), lineNumber);
+            return false;
+        }
+        keys.push_back(key);
+    }
+    if (keys.empty())
+    {
+        std::fprintf(stderr, "[CameraPath] %s has no keys\n", path.c_str());
+        return false;
+    }
+    m_Keys = std::move(keys);
+    return true;
+}
+
+CameraPath CameraPath::Orbit(const glm::vec3& center, float radius, float height, float duration, int keys)
+{
+    CameraPath path;
+    keys = std::max(keys, 2);
+    for (int i = 0; i <= keys; ++i)
+    {
+        float a = 6.2831853f * (float)i / (float)keys;
+        Key key;
+        key.time = duration * (float)i / (float)keys;
+        key.position = center + glm::vec3(std::sin(a) * radius, height, std::cos(a) * radius);
+        // 和 main 里一样：front = (cos yaw cos pitch, sin pitch, sin yaw cos pitch)
+        glm::vec3 d = glm::normalize(center - key.position);
+        key.yaw = glm::degrees(std::atan2(d.z, d.x));
+        key.pitch = glm::degrees(std::asin(d.y));
+        // yaw 连续变化，不在 ±180 处跳回去
+        if (!path.m_Keys.empty())
+        {
+            float prev = path.m_Keys.back().yaw;
+            while (key.yaw - prev > 180.0f) key.yaw -= 360.0f;
+            while (key.yaw - prev < -180.0f) key.yaw += 360.0f;
+        }
+        path.m_Keys.push_back(key);
+    }
+    return path;
+}
+
+CameraPath::Key CameraPath::Evaluate(float time) const
+{
+    if (m_Keys.empty()) return Key{};
+    if (time <= m_Keys.front().time) return m_Keys.front();
+    if (time >= m_Keys.back().time) return m_Keys.back();
+
+    auto it = std::upper_bound(m_Keys.begin(), m_Keys.end(), time,
+                               [](float t, const Key& k) { return t < k.time; });
+    const int i1 = (int)(it - m_Keys.begin());
+    const int i0 = i1 - 1;
+    const Key& k0 = m_Keys[i0];
+    const Key& k1 = m_Keys[i1];
+    const Key& kPrev = m_Keys[std::max(i0 - 1, 0)];
+    const Key& kNext = m_Keys[std::min(i1 + 1, (int)m_Keys.size() - 1)];
+    const float t = (time - k0.time) / (k1.time - k0.time);
+
+    // 均匀 Catmull-Rom
+    const float t2 = t * t, t3 = t2 * t;
+    Key out;
+    out.time = time;
+    out.position = 0.5f * ((2.0f * k0.position) +
+                           (-kPrev.position + k1.position) * t +
+                           (2.0f * kPrev.position - 5.0f * k0.position + 4.0f * k1.position - kNext.position) * t2 +
+                           (-kPrev.position + 3.0f * k0.position - 3.0f * k1.position + kNext.position) * t3);
+    out.yaw = k0.yaw + (k1.yaw - k0.yaw) * t;
+    out.pitch = k0.pitch + (k1.pitch - k0.pitch) * t;
+    out.fov = k0.fov + (k1.fov - k0.fov) * t;
+    return out;
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+
+// CameraPath：按时间插值的相机关键帧，给 headless 模式回放用（结果只取决于时间，可重复）
+// 文件格式：每行一个关键帧 "t x y z yaw pitch [fov]"，# 开头是注释；时间要递增
+// 位置用 Catmull-Rom（经过每个关键帧），yaw/pitch/fov 线性插值
+class CameraPath
+{
+public:
+    struct Key
+    {
+        float time = 0.0f;
+        glm::vec3 position{0.0f};
+        float yaw = -90.0f;
+        float pitch = 0.0f;
+        float fov = 60.0f;
+    };
+
+    bool Load(const std::string& path);
+    // 绕 center 一圈，始终看着 center
+    static CameraPath Orbit(const glm::vec3& center, float radius, float height, float duration, int keys = 16);
+
+    // 超出范围时停在首/尾关键帧
+    Key Evaluate(float time) const;
+
+    bool Empty() const { return m_Keys.empty(); }
+    float Duration() const { return m_Keys.empty() ? 0.0f : m_Keys.back().time; }
+    const std::vector<Key>& Keys() const { return m_Keys; }
+
+private:
+    std::vector<Key> m_Keys;
+};
@@ -0,0 +1,202 @@
+#include "CpuProfiler.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <unordered_set>
+
+std::atomic<bool> CpuProfiler::s_Capturing{ false };
+
+namespace
+{
+    struct Event
+    {
+        const char* name;
+        std::uint64_t beginTicks;
+        std::uint64_t endTicks;
+    };
+
+    // 单写者环形缓冲：只有所属线程写 events 和 head，导出时别的线程按 head 读
+    struct ThreadBuffer
+    {
+        std::vector<Event> events;
+        std::atomic<std::uint64_t> head{ 0 };
+        std::atomic<const char*> name{ nullptr };
+        int tid = 0;
+        bool allocated = false;     // 只有所属线程读写；只起名字不录制的线程不占这块内存
+    };
+
+    struct Registry
+    {
+        std::mutex mutex;
+        std::vector<std::unique_ptr<ThreadBuffer>> buffers;   // 线程退出后也保留，导出时还要读
+        std::unordered_set<std::string> names;               // Intern 的字符串，节点地址稳定
+        // 录制开始时同时记下墙钟和 Ticks，导出时再取一对，两段之比就是每个 tick 的纳秒数
+        std::atomic<std::uint64_t> captureBeginNs{ 0 };
+        std::atomic<std::uint64_t> captureBeginTicks{ 0 };
+    };
+
+    Registry& GetRegistry()
+    {
+        static Registry s_Registry;
+        return s_Registry;
+    }
+
+    thread_local ThreadBuffer* t_Buffer = nullptr;
+
+    ThreadBuffer* ThisThreadBuffer()
+    {
+        if (t_Buffer) return t_Buffer;
+        Registry& reg = GetRegistry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        auto buffer = std::make_unique<ThreadBuffer>();
+        buffer->tid = (int)reg.buffers.size() + 1;
+        t_Buffer = buffer.get();
+        reg.buffers.push_back(std::move(buffer));
+        return t_Buffer;
+    }
+
+    void WriteJsonString(std::FILE* f, const char* s)
+    {
+        std::fputc('"', f);
+        for (; *s; ++s)
+        {
+            if (*s == '"' || *s == '\\') std::fputc('\\', f);
+            if ((unsigned char)*s >= 0x20) std::fputc(*s, f);
+        }
+        std::fputc('"', f);
+    }
+
+    // 元数据总是写在前面，这里每条都带前导逗号
+    // beginNs 相对录制开始
+    void WriteEvent(std::FILE* f, const char* name, int pid, int tid, double beginNs, double durationNs)
+    {
+        std::fprintf(f, ",\n    { \"ph\": \"X\", \"pid\": %d, \"tid\": %d, \"ts\": %.3f, \"dur\": %.3f, \"name\": ",
+                     pid, tid, beginNs / 1000.0, durationNs / 1000.0);
+        WriteJsonString(f, name);
+        std::fprintf(f, " }");
+    }
+}
+
+void CpuProfiler::StartCapture()
+{
+    // 不清空各线程的缓冲（别的线程可能正在写），导出时按开始时间过滤
+    Registry& reg = GetRegistry();
+    reg.captureBeginTicks.store(Ticks(), std::memory_order_relaxed);
+    reg.captureBeginNs.store(NowNs(), std::memory_order_relaxed);
+    s_Capturing.store(true, std::memory_order_relaxed);
+    std::printf("[CpuProfiler] Capture started\n");
+}
+
+void CpuProfiler::StopCapture()
+{
+    s_Capturing.store(false, std::memory_order_relaxed);
+}
+
+void CpuProfiler::SetThreadName(const char* name)
+{
+    ThisThreadBuffer()->name.store(name, std::memory_order_relaxed);
+}
+
+void CpuProfiler::Record(const char* name, std::uint64_t beginTicks, std::uint64_t endTicks)
+{
+    ThreadBuffer* buffer = ThisThreadBuffer();
+    if (!buffer->allocated)
+    {
+        // 导出时持锁读 events，分配也要在锁里；head 在分配之后才会变成非零
+        std::lock_guard<std::mutex> lock(GetRegistry().mutex);
+        buffer->events.resize(kEventsPerThread);
+        buffer->allocated = true;
+    }
+    const std::uint64_t head = buffer->head.load(std::memory_order_relaxed);
+    buffer->events[head & (kEventsPerThread - 1)] = Event{ name, beginTicks, endTicks };
+    buffer->head.store(head + 1, std::memory_order_release);
+}
+
+const char* CpuProfiler::Intern(const std::string& name)
+{
+    Registry& reg = GetRegistry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    return reg.names.insert(name).first->c_str();
+}
+
+bool CpuProfiler::WriteChromeTrace(const std::string& path, const std::vector<ExternalEvent>& gpuEvents)
+{
+    StopCapture();
+
+    Registry& reg = GetRegistry();
+    const std::uint64_t originNs = reg.captureBeginNs.load(std::memory_order_relaxed);
+    const std::uint64_t originTicks = reg.captureBeginTicks.load(std::memory_order_relaxed);
+    const std::uint64_t spanTicks = Ticks() - originTicks;
+    const std::uint64_t spanNs = NowNs() - originNs;
+    const double nsPerTick = spanTicks > 0 ? (double)spanNs / (double)spanTicks : 1.0;
+
+    std::FILE* f = std::fopen(path.c_str(), "w");
+    if (!f)
+    {
+        std::fprintf(stderr, "[CpuProfiler] Cannot write %s\n", path.c_str());
+        return false;
+    }
+
+    std::fprintf(f, "{\n  \"displayTimeUnit\": \"ms\",\n  \"traceEvents\": [");
+    int cpuCount = 0;
+
+    // 进程/线程轨道名
+    std::fprintf(f, "\n    { \"ph\": \"M\", \"pid\": 1, \"name\": \"process_name\", \"args\": { \"name\": \"CPU\" } },");
+    std::fprintf(f, "\n    { \"ph\": \"M\", \"pid\": 2, \"name\": \"process_name\", \"args\": { \"name\": \"GPU\" } },");
+    std::fprintf(f, "\n    { \"ph\": \"M\", \"pid\": 2, \"tid\": 1, \"name\": \"thread_name\", \"args\": { \"name\": \"GL queue\" } }");
+
+    {
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        std::vector<Event> events;
+        for (const std::unique_ptr<ThreadBuffer>& buffer : reg.buffers)
+        {
+            const char* threadName = buffer->name.load(std::memory_order_relaxed);
+            char fallback[32];
+            if (!threadName)
+            {
+                std::snprintf(fallback, sizeof(fallback), "Thread %d", buffer->tid);
+                threadName = fallback;
+            }
+            std::fprintf(f, ",\n    { \"ph\": \"M\", \"pid\": 1, \"tid\": %d, \"name\": \"thread_name\", \"args\": { \"name\": ",
+                         buffer->tid);
+            WriteJsonString(f, threadName);
+            std::fprintf(f, " } }");
+
+            // 停止录制后，刚好跨过停止点的区间还可能在写；拷贝后再看一次 head，期间可能被覆盖的那一段丢掉
+            // 写入方先写槽位再发布 head，所以 headAfter 指向的那个槽位也可能写了一半
+            const std::uint64_t head = buffer->head.load(std::memory_order_acquire);
+            const std::uint64_t count = std::min<std::uint64_t>(head, kEventsPerThread);
+            events.clear();
+            for (std::uint64_t i = head - count; i < head; ++i)
+                events.push_back(buffer->events[i & (kEventsPerThread - 1)]);
+            const std::uint64_t headAfter = buffer->head.load(std::memory_order_acquire);
+            // 拷贝的第 k 个（环里序号 head - count + k）和 [head, headAfter] 里的槽位重合时就不可信
+            const std::uint64_t firstTouched = headAfter + 1 > kEventsPerThread ? headAfter + 1 - kEventsPerThread : 0;
+            const std::uint64_t stale = firstTouched > head - count ? firstTouched - (head - count) : 0;
+
+            for (std::size_t i = (std::size_t)std::min<std::uint64_t>(stale, events.size()); i < events.size(); ++i)
+            {
+                const Event& e = events[i];
+                if (e.beginTicks < originTicks) continue;
+                WriteEvent(f, e.name, 1, buffer->tid, (double)(e.beginTicks - originTicks) * nsPerTick,
+                           (double)(e.endTicks - e.beginTicks) * nsPerTick);
+                ++cpuCount;
+            }
+        }
+    }
+
+    int gpuCount = 0;
+    for (const ExternalEvent& e : gpuEvents)
+    {
+        if (e.beginNs < originNs) continue;
+        WriteEvent(f, e.name.c_str(), 2, 1, (double)(e.beginNs - originNs), (double)(e.endNs - e.beginNs));
+        ++gpuCount;
+    }
+
+    std::fprintf(f, "\n  ]\n}\n");
+    std::fclose(f);
+    std::printf("[CpuProfiler] Wrote %s (%d CPU zones, %d GPU zones)\n", path.c_str(), cpuCount, gpuCount);
+    return true;
+}
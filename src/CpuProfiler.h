@@ -0,0 +1,101 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#if defined(_MSC_VER) && defined(_M_X64)
+    #include <intrin.h>
+#elif defined(__x86_64__)
+    #include <x86intrin.h>
+#endif
+
+// CpuProfiler：带作用域的 CPU 区间，导出 Chrome / Perfetto 的 trace JSON（chrome://tracing、ui.perfetto.dev 直接打开）
+// - 每个线程第一次记录时登记一块自己的环形缓冲，之后只有这个线程写：不加锁，一个区间两次读 TSC + 一次写入
+//   （x86-64 上区间用 TSC 计时，比 steady_clock 便宜一半左右，导出时按录制期间的墙钟换算成纳秒）
+// - 只在录制时记录；没在录制时一个区间只多一次 relaxed load
+// - 缓冲满了覆盖最老的事件，导出的是每个线程最近的 kEventsPerThread 个
+// - 构建时没开 RENDERSANDBOX_PROFILE 时 PROFILE_ZONE / PROFILE_THREAD 展开为空，区间完全不进代码
+// GPU 区间（GpuProfiler 在录制期间读回的）可以一起写进同一个文件，单独一个 "GPU" 轨道，时间轴对齐
+class CpuProfiler
+{
+public:
+    static constexpr int kEventsPerThread = 1 << 16;
+
+    // GPU 或其他来源的区间，时间和 NowNs 同一个时钟
+    struct ExternalEvent
+    {
+        std::string name;
+        std::uint64_t beginNs = 0;
+        std::uint64_t endNs = 0;
+    };
+
+    static std::uint64_t NowNs()
+    {
+        return (std::uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // 区间的时间戳：x86-64 上是 TSC，其他平台就是 NowNs
+    static std::uint64_t Ticks()
+    {
+#if (defined(_MSC_VER) && defined(_M_X64)) || defined(__x86_64__)
+        return __rdtsc();
+#else
+        return NowNs();
+#endif
+    }
+
+    static bool IsCapturing() { return s_Capturing.load(std::memory_order_relaxed); }
+    // 开始录制只记下起点时间，不清空各线程的环形缓冲；导出时丢掉起点之前开始的区间
+    static void StartCapture();
+    static void StopCapture();
+
+    // trace 里线程轨道的名字；name 要一直有效（字符串字面量）
+    static void SetThreadName(const char* name);
+
+    // 区间结束时调用，时间是 Ticks()；name 要一直有效（字符串字面量或 Intern 的结果）
+    static void Record(const char* name, std::uint64_t beginTicks, std::uint64_t endTicks);
+
+    // 运行时拼出来的名字（渲染图的 pass 名）换成一直有效的指针；加锁查表，只在录制时用
+    static const char* Intern(const std::string& name);
+
+    // 写 trace JSON。gpuEvents 可以为空；录制中调用会先停止录制
+    static bool WriteChromeTrace(const std::string& path, const std::vector<ExternalEvent>& gpuEvents);
+
+private:
+    static std::atomic<bool> s_Capturing;
+};
+
+// 构造时取开始时间，析构时记录；构造时没在录制（或 name 为空）就整个跳过
+class CpuZone
+{
+public:
+    explicit CpuZone(const char* name)
+        : m_Name(name), m_Begin(name && CpuProfiler::IsCapturing() ? CpuProfiler::Ticks() : 0) {}
+    ~CpuZone()
+    {
+        if (m_Begin) CpuProfiler::Record(m_Name, m_Begin, CpuProfiler::Ticks());
+    }
+
+    CpuZone(const CpuZone&) = delete;
+    CpuZone& operator=(const CpuZone&) = delete;
+
+private:
+    const char* m_Name;
+    std::uint64_t m_Begin;
+};
+
+#ifdef RENDERSANDBOX_PROFILE
+    #define PROFILE_CONCAT_INNER(a, b) a##b
+    #define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+    #define PROFILE_ZONE(name) CpuZone PROFILE_CONCAT(cpuZone_, __LINE__)(name)
+    #define PROFILE_ZONE_STRING(str) \
+        CpuZone PROFILE_CONCAT(cpuZone_, __LINE__)(CpuProfiler::IsCapturing() ? CpuProfiler::Intern(str) : nullptr)
+    #define PROFILE_THREAD(name) CpuProfiler::SetThreadName(name)
+#else
+    #define PROFILE_ZONE(name) ((void)0)
+    #define PROFILE_ZONE_STRING(str) ((void)0)
+    #define PROFILE_THREAD(name) ((void)0)
+#endif
@@ -0,0 +1,138 @@
+#include "FrameTimingLog.h"
+
+#include <algorithm>
+#include <cstdio>
+
+namespace
+{
+    struct Summary
+    {
+        double mean = 0.0, p50 = 0.0, p95 = 0.0, p99 = 0.0, max = 0.0;
+    };
+
+    Summary Summarize(std::vector<double> values)
+    {
+        Summary s;
+        if (values.empty()) return s;
+        std::sort(values.begin(), values.end());
+        double sum = 0.0;
+        for (double v : values) sum += v;
+        auto percentile = [&](double p) {
+            std::size_t i = (std::size_t)(p * (double)(values.size() - 1) + 0.5);
+            return values[std::min(i, values.size() - 1)];
+        };
+        s.mean = sum / (double)values.size();
+        s.p50 = percentile(0.50);
+        s.p95 = percentile(0.95);
+        s.p99 = percentile(0.99);
+        s.max = values.back();
+        return s;
+    }
+
+    void WriteDraws(std::FILE* f, const DrawStats::Counters& draws)
+    {
+        std::fprintf(f, "{ ");
+        for (int c = 0; c < DrawStats::kCounterCount; ++c)
+            std::fprintf(f, "\"%s\": %lld%s", DrawStats::Name((DrawStats::Counter)c), (long long)draws[c],
+                         c + 1 < DrawStats::kCounterCount ? ", " : " }");
+    }
+
+    void WriteSummary(std::FILE* f, const char* name, const Summary& s, bool last)
+    {
+        std::fprintf(f, "    \"%s\": { \"mean\": %.4f, \"p50\": %.4f, \"p95\": %.4f, \"p99\": %.4f, \"max\": %.4f }%s\n",
+                     name, s.mean, s.p50, s.p95, s.p99, s.max, last ? "" : ",");
+    }
+}
+
+void FrameTimingLog::Record(const Frame& frame, const std::vector<RenderGraph::PassInfo>& passes, bool measured)
+{
+    m_Frames.push_back(frame);
+    m_Measured.push_back(measured);
+    if (!measured) return;
+
+    for (const RenderGraph::PassInfo& pi : passes)
+    {
+        if (pi.culled) continue;
+        auto it = std::find_if(m_Passes.begin(), m_Passes.end(),
+                               [&](const PassTotals& t) { return t.name == pi.name; });
+        if (it == m_Passes.end())
+        {
+            m_Passes.push_back(PassTotals{ pi.name });
+            it = m_Passes.end() - 1;
+        }
+        it->cpuMs += pi.cpuMs;
+        it->gpuMs += pi.gpuMs;
+        ++it->samples;
+    }
+}
+
+bool FrameTimingLog::WriteJson(const std::string& path, int width, int height, float fixedDt, int warmup) const
+{
+    std::FILE* f = std::fopen(path.c_str(), "w");
+    if (!f)
+    {
+        std::fprintf(stderr, "[FrameTimingLog] Cannot write %s\n", path.c_str());
+        return false;
+    }
+
+    std::vector<double> wall, cpu, gpu;
+    for (std::size_t i = 0; i < m_Frames.size(); ++i)
+    {
+        if (!m_Measured[i]) continue;
+        wall.push_back(m_Frames[i].wallMs);
+        cpu.push_back(m_Frames[i].graphCpuMs);
+        // 开头几帧查询还没读回，GPU 为 0 的不算
+        if (m_Frames[i].gpuMs > 0.0) gpu.push_back(m_Frames[i].gpuMs);
+    }
+
+    std::fprintf(f, "{\n");
+    std::fprintf(f, "  \"width\": %d, \"height\": %d, \"fixedDt\": %.6f, \"frames\": %d, \"warmup\": %d, \"measured\": %d,\n",
+                 width, height, fixedDt, (int)m_Frames.size(), warmup, (int)wall.size());
+    std::fprintf(f, "  \"summary\": {\n");
+    WriteSummary(f, "wallMs", Summarize(wall), false);
+    WriteSummary(f, "graphCpuMs", Summarize(cpu), false);
+    WriteSummary(f, "gpuMs", Summarize(gpu), true);
+    std::fprintf(f, "  },\n");
+
+    // 计数没有时间那样的长尾，汇总只给平均和最大
+    std::fprintf(f, "  \"drawStats\": {\n");
+    for (int c = 0; c < DrawStats::kCounterCount; ++c)
+    {
+        double sum = 0.0;
+        long long maxValue = 0;
+        int n = 0;
+        for (std::size_t i = 0; i < m_Frames.size(); ++i)
+        {
+            if (!m_Measured[i]) continue;
+            sum += (double)m_Frames[i].draws[c];
+            maxValue = std::max(maxValue, (long long)m_Frames[i].draws[c]);
+            ++n;
+        }
+        std::fprintf(f, "    \"%s\": { \"mean\": %.2f, \"max\": %lld }%s\n", DrawStats::Name((DrawStats::Counter)c),
+                     n > 0 ? sum / n : 0.0, maxValue, c + 1 < DrawStats::kCounterCount ? "," : "");
+    }
+    std::fprintf(f, "  },\n");
+
+    std::fprintf(f, "  \"passes\": [\n");
+    for (std::size_t i = 0; i < m_Passes.size(); ++i)
+    {
+        const PassTotals& p = m_Passes[i];
+        const double n = p.samples > 0 ? (double)p.samples : 1.0;
+        std::fprintf(f, "    { \"name\": \"%s\", \"frames\": %d, \"cpuMs\": %.4f, \"gpuMs\": %.4f }%s\n",
+                     p.name.c_str(), p.samples, p.cpuMs / n, p.gpuMs / n, i + 1 < m_Passes.size() ? "," : "");
+    }
+    std::fprintf(f, "  ],\n");
+
+    std::fprintf(f, "  \"perFrame\": [\n");
+    for (std::size_t i = 0; i < m_Frames.size(); ++i)
+    {
+        const Frame& fr = m_Frames[i];
+        std::fprintf(f, "    { \"frame\": %d, \"wallMs\": %.4f, \"graphCpuMs\": %.4f, \"gpuMs\": %.4f, \"scale\": %.3f, \"warmup\": %s, \"draws\": ",
+                     fr.index, fr.wallMs, fr.graphCpuMs, fr.gpuMs, fr.renderScale, m_Measured[i] ? "false" : "true");
+        WriteDraws(f, fr.draws);
+        std::fprintf(f, " }%s\n", i + 1 < m_Frames.size() ? "," : "");
+    }
+    std::fprintf(f, "  ]\n}\n");
+    std::fclose(f);
+    return true;
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include <string>
+#include <vector>
+
+#include "render/DrawStats.h"
+#include "render/RenderGraph.h"
+
+// FrameTimingLog：headless 跑完后写的逐帧计时 JSON
+// - 每帧：墙钟帧时间、图的 CPU/GPU 时间、渲染比例
+// - 汇总（去掉 warmup 帧）：mean / p50 / p95 / p99 / max，以及每个 pass 的平均 CPU/GPU 时间
+// - 每帧和汇总里都带 DrawStats 的计数（draw、状态切换、上传字节）
+// GPU 时间来自图的计时查询，是几帧前读回的，所以逐帧数据里 GPU 一列和墙钟一列不是同一帧
+class FrameTimingLog
+{
+public:
+    struct Frame
+    {
+        int index = 0;
+        double wallMs = 0.0;
+        double graphCpuMs = 0.0;
+        double gpuMs = 0.0;
+        float renderScale = 1.0f;
+        DrawStats::Counters draws{};
+    };
+
+    void Record(const Frame& frame, const std::vector<RenderGraph::PassInfo>& passes, bool measured);
+
+    // width/height/fixedDt 原样写进 JSON，方便比较不同的运行
+    bool WriteJson(const std::string& path, int width, int height, float fixedDt, int warmup) const;
+
+    int FrameCount() const { return (int)m_Frames.size(); }
+
+private:
+    struct PassTotals
+    {
+        std::string name;
+        double cpuMs = 0.0;
+        double gpuMs = 0.0;
+        int samples = 0;
+    };
+
+    std::vector<Frame> m_Frames;
+    std::vector<bool> m_Measured;
+    std::vector<PassTotals> m_Passes;   // 按第一次出现的顺序
+};
@@ -0,0 +1,95 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__F16C__) || defined(__AVX2__)
+#include <immintrin.h>
+#define RENDERSANDBOX_HAS_F16C 1
+#endif
+
+// HalfFloat：float <-> IEEE 754 half（GL_HALF_FLOAT）转换
+// 标量版本做 round-to-nearest-even，和 F16C 指令的结果一致
+
+inline std::uint16_t FloatToHalf(float value)
+{
+    std::uint32_t f;
+    std::memcpy(&f, &value, sizeof(f));
+    std::uint32_t sign = (f >> 16) & 0x8000u;
+    f &= 0x7fffffffu;
+
+    std::uint16_t h;
+    if (f >= 0x47800000u) {
+        // >= 65536：溢出成 inf，NaN 保持 NaN
+        h = (f > 0x7f800000u) ? 0x7e00u : 0x7c00u;
+    } else if (f < 0x38800000u) {
+        // < 2^-14：半精度非规格化数，借 float 加法完成移位 + 舍入
+        float tmp;
+        std::memcpy(&tmp, &f, sizeof(tmp));
+        tmp += 0.5f;
+        std::uint32_t bits;
+        std::memcpy(&bits, &tmp, sizeof(bits));
+        h = (std::uint16_t)(bits - 0x3f000000u);
+    } else {
+        std::uint32_t mantOdd = (f >> 13) & 1u;
+        f += ((std::uint32_t)(15 - 127) << 23) + 0xfffu;
+        f += mantOdd;
+        h = (std::uint16_t)(f >> 13);
+    }
+    return (std::uint16_t)(h | sign);
+}
+
+inline float HalfToFloat(std::uint16_t h)
+{
+    std::uint32_t sign = (std::uint32_t)(h & 0x8000u) << 16;
+    std::uint32_t exponent = (h >> 10) & 0x1fu;
+    std::uint32_t mantissa = h & 0x3ffu;
+
+    std::uint32_t bits;
+    if (exponent == 0) {
+        if (mantissa == 0) {
+            bits = sign;
+        } else {
+            float v = (float)mantissa * (1.0f / 16777216.0f);  // mantissa * 2^-24
+            return sign ? -v : v;
+        }
+    } else if (exponent == 31) {
+        bits = sign | 0x7f800000u | (mantissa << 13);
+    } else {
+        bits = sign | ((exponent + 112u) << 23) | (mantissa << 13);
+    }
+
+    float out;
+    std::memcpy(&out, &bits, sizeof(out));
+    return out;
+}
+
+// 批量转换；编译时开启 F16C 时每次转 4 个
+inline void FloatToHalfArray(const float* src, std::uint16_t* dst, std::size_t count)
+{
+    std::size_t i = 0;
+#if defined(RENDERSANDBOX_HAS_F16C)
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 v = _mm_loadu_ps(src + i);
+        __m128i packed = _mm_cvtps_ph(v, _MM_FROUND_TO_NEAREST_INT);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + i), packed);
+    }
+#endif
+    for (; i < count; ++i)
+        dst[i] = FloatToHalf(src[i]);
+}
+
+inline void HalfToFloatArray(const std::uint16_t* src, float* dst, std::size_t count)
+{
+    std::size_t i = 0;
+#if defined(RENDERSANDBOX_HAS_F16C)
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128i packed = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + i));
+        _mm_storeu_ps(dst + i, _mm_cvtph_ps(packed));
+    }
+#endif
+    for (; i < count; ++i)
+        dst[i] = HalfToFloat(src[i]);
+}
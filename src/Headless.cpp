@@ -0,0 +1,300 @@
+#include "Headless.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#ifdef RENDERSANDBOX_HEADLESS
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+
+namespace
+{
+    void PrintUsage(const char* exe)
+    {
+        std::printf(
+            "Usage: %s [--headless] [options]\n"
+            "  --headless               render offscreen through EGL (no window, no input)\n"
+            "  --size WxH               output size (default 1280x720)\n"
+            "  --frames N               frames to render (default 300)\n"
+            "  --warmup N               frames excluded from the summary (default 10)\n"
+            "  --fps F                  fixed time step 1/F (default 60)\n"
+            "  --camera FILE            camera path: 't x y z yaw pitch [fov]' per line\n"
+            "  --timings FILE           timing JSON (default headless_timings.json)\n"
+            "  --gpu-profile FILE       GPU profiler scopes (.csv or .json)\n"
+            "  --trace FILE             record a Chrome trace from startup, written on exit\n"
+            "  --capture N[,N...]       frames to capture\n"
+            "  --capture-prefix P       capture file prefix (default 'capture')\n"
+            "  --capture-format F       png | exr | both (default png)\n"
+            "  --no-finish              don't glFinish every frame\n"
+            "  --dynamic-res            keep dynamic resolution on\n"
+            "  --record-frame N         record frame N's scene commands for FrameReplay\n"
+            "  --record-path FILE       command capture file (default frame.rsframe)\n"
+            "  --objects N              stress scene: object count (default 9)\n"
+            "  --models M               stress scene: distinct models (default 1)\n"
+            "  --materials K            stress scene: materials (default 3)\n"
+            "  --lights L               stress scene: point lights (default 2)\n"
+            "  --layout L               stress scene: grid | random | clustered (default grid)\n"
+            "  --spacing S              stress scene: mean distance between objects (default 1.5)\n"
+            "  --clusters C             stress scene: cluster count for the clustered layout (default 8)\n"
+            "  --seed S                 stress scene: random seed (default 1)\n"
+            "  --animate                stress scene: spin/bob objects, orbit lights\n"
+            "  --sweep AXIS=V[,V...]    step objects | materials | lights through the values\n"
+            "  --sweep-frames N         measured frames per sweep step (default 120)\n"
+            "  --sweep-out FILE         sweep results (default stress_sweep.json)\n",
+            exe);
+    }
+}
+
+bool ParseHeadlessOptions(int argc, char** argv, HeadlessOptions& options)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        const char* arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        bool usesValue = true;
+
+        if (std::strcmp(arg, "--headless") == 0) {
+            options.enabled = true;
+            usesValue = false;
+        } else if (std::strcmp(arg, "--no-finish") == 0) {
+            options.finishEachFrame = false;
+            usesValue = false;
+        } else if (std::strcmp(arg, "--dynamic-res") == 0) {
+            options.dynamicResolution = true;
+            usesValue = false;
+        } else if (std::strcmp(arg, "--animate") == 0) {
+            options.stressScene = true;
+            options.stress.animate = true;
+            usesValue = false;
+        } else if (std::strcmp(arg, "--help") == 0 || std::strcmp(arg, "-h") == 0) {
+            PrintUsage(argv[0]);
+            return false;
+        } else if (!value) {
+            std::fprintf(stderr, "[Headless] Missing value for %s\n", arg);
+            PrintUsage(argv[0]);
+            return false;
+        } else if (std::strcmp(arg, "--size") == 0) {
+            if (std::sscanf(value, "%dx%d", &options.width, &options.height) != 2 ||
+                options.width <= 0 || options.height <= 0) {
+                std::fprintf(stderr, "[Headless] Bad --size '%s'\n", value);
+                return false;
+            }
+        } else if (std::strcmp(arg, "--frames") == 0) {
+            options.frames = std::atoi(value);
+        } else if (std::strcmp(arg, "--warmup") == 0) {
+            options.warmup = std::atoi(value);
+        } else if (std::strcmp(arg, "--fps") == 0) {
+            options.fps = (float)std::atof(value);
+            if (options.fps <= 0.0f) options.fps = 60.0f;
+        } else if (std::strcmp(arg, "--camera") == 0) {
+            options.cameraPath = value;
+        } else if (std::strcmp(arg, "--timings") == 0) {
+            options.timingsPath = value;
+        } else if (std::strcmp(arg, "--gpu-profile") == 0) {
+            options.gpuProfilePath = value;
+        } else if (std::strcmp(arg, "--trace") == 0) {
+            options.tracePath = value;
+        } else if (std::strcmp(arg, "--capture") == 0) {
+            const char* p = value;
+            while (*p)
+            {
+                char* end = nullptr;
+                long frame = std::strtol(p, &end, 10);
+                if (end == p) break;
+                options.captureFrames.push_back((int)frame);
+                p = (*end == ',') ? end + 1 : end;
+            }
+        } else if (std::strcmp(arg, "--record-frame") == 0) {
+            options.recordFrame = std::atoi(value);
+        } else if (std::strcmp(arg, "--record-path") == 0) {
+            options.recordPath = value;
+        } else if (std::strcmp(arg, "--objects") == 0) {
+            options.stressScene = true;
+            options.stress.objects = std::atoi(value);
+        } else if (std::strcmp(arg, "--models") == 0) {
+            options.stressScene = true;
+            options.stress.models = std::atoi(value);
+        } else if (std::strcmp(arg, "--materials") == 0) {
+            options.stressScene = true;
+            options.stress.materials = std::atoi(value);
+        } else if (std::strcmp(arg, "--lights") == 0) {
+            options.stressScene = true;
+            options.stress.lights = std::atoi(value);
+        } else if (std::strcmp(arg, "--spacing") == 0) {
+            options.stressScene = true;
+            options.stress.spacing = (float)std::atof(value);
+        } else if (std::strcmp(arg, "--clusters") == 0) {
+            options.stressScene = true;
+            options.stress.clusters = std::atoi(value);
+        } else if (std::strcmp(arg, "--seed") == 0) {
+            options.stressScene = true;
+            options.stress.seed = (unsigned)std::strtoul(value, nullptr, 10);
+        } else if (std::strcmp(arg, "--layout") == 0) {
+            options.stressScene = true;
+            if (!StressSceneSettings::ParseLayout(value, options.stress.layout)) {
+                std::fprintf(stderr, "[Headless] Bad --layout '%s'\n", value);
+                return false;
+            }
+        } else if (std::strcmp(arg, "--sweep") == 0) {
+            const char* eq = std::strchr(value, '=');
+            if (!eq) {
+                std::fprintf(stderr, "[Headless] Bad --sweep '%s' (expected AXIS=V[,V...])\n", value);
+                return false;
+            }
+            options.stressScene = true;
+            options.sweepAxis.assign(value, eq - value);
+            options.sweepValues.clear();
+            const char* p = eq + 1;
+            while (*p)
+            {
+                char* end = nullptr;
+                long v = std::strtol(p, &end, 10);
+                if (end == p) break;
+                options.sweepValues.push_back((int)v);
+                p = (*end == ',') ? end + 1 : end;
+            }
+        } else if (std::strcmp(arg, "--sweep-frames") == 0) {
+            options.sweepFrames = std::atoi(value);
+        } else if (std::strcmp(arg, "--sweep-out") == 0) {
+            options.sweepPath = value;
+        } else if (std::strcmp(arg, "--capture-prefix") == 0) {
+            options.capturePrefix = value;
+        } else if (std::strcmp(arg, "--capture-format") == 0) {
+            options.capturePng = std::strcmp(value, "png") == 0 || std::strcmp(value, "both") == 0;
+            options.captureExr = std::strcmp(value, "exr") == 0 || std::strcmp(value, "both") == 0;
+            if (!options.capturePng && !options.captureExr) {
+                std::fprintf(stderr, "[Headless] Bad --capture-format '%s'\n", value);
+                return false;
+            }
+        } else {
+            std::fprintf(stderr, "[Headless] Unknown option %s\n", arg);
+            PrintUsage(argv[0]);
+            return false;
+        }
+        if (usesValue) ++i;
+    }
+    if (options.frames < 1) options.frames = 1;
+    if (options.warmup < 0) options.warmup = 0;
+    return true;
+}
+
+HeadlessContext::~HeadlessContext()
+{
+    Destroy();
+}
+
+#ifdef RENDERSANDBOX_HEADLESS
+
+bool HeadlessContext::Create()
+{
+    Destroy();
+
+    // 优先 Mesa 的 surfaceless 平台：不需要 X/Wayland，也不需要 DRM 设备（llvmpipe）
+    auto getPlatformDisplay = (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+    EGLDisplay display = EGL_NO_DISPLAY;
+    if (getPlatformDisplay)
+        display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+    if (display == EGL_NO_DISPLAY)
+        display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+
+    EGLint major = 0, minor = 0;
+    if (display == EGL_NO_DISPLAY || !eglInitialize(display, &major, &minor))
+    {
+        std::fprintf(stderr, "[Headless] eglInitialize failed: 0x%x\n", (unsigned)eglGetError());
+        return false;
+    }
+    m_Display = display;
+
+    if (!eglBindAPI(EGL_OPENGL_API))
+    {
+        std::fprintf(stderr, "[Headless] Desktop OpenGL not available through EGL\n");
+        Destroy();
+        return false;
+    }
+
+    const EGLint configAttribs[] = {
+        EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+        EGL_RED_SIZE, 8, EGL_GREEN_SIZE, 8, EGL_BLUE_SIZE, 8,
+        EGL_NONE
+    };
+    EGLConfig config = nullptr;
+    EGLint configCount = 0;
+    // surfaceless 平台上可能没有带 pbuffer 的配置，再放宽一次
+    if (!eglChooseConfig(display, configAttribs, &config, 1, &configCount) || configCount == 0)
+    {
+        const EGLint anyAttribs[] = { EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT, EGL_NONE };
+        if (!eglChooseConfig(display, anyAttribs, &config, 1, &configCount) || configCount == 0)
+            config = nullptr;
+    }
+
+    const EGLint contextAttribs[] = {
+        EGL_CONTEXT_MAJOR_VERSION, 3,
+        EGL_CONTEXT_MINOR_VERSION, 3,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+        EGL_NONE
+    };
+    EGLContext context = eglCreateContext(display, config, EGL_NO_CONTEXT, contextAttribs);
+    if (context == EGL_NO_CONTEXT)
+    {
+        std::fprintf(stderr, "[Headless] eglCreateContext (GL 3.3 core) failed: 0x%x\n", (unsigned)eglGetError());
+        Destroy();
+        return false;
+    }
+    m_Context = context;
+
+    // 先试不带 surface（EGL_KHR_surfaceless_context），不行再建一个 1x1 pbuffer
+    if (!eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context))
+    {
+        const EGLint pbufferAttribs[] = { EGL_WIDTH, 1, EGL_HEIGHT, 1, EGL_NONE };
+        EGLSurface surface = config ? eglCreatePbufferSurface(display, config, pbufferAttribs) : EGL_NO_SURFACE;
+        if (surface == EGL_NO_SURFACE || !eglMakeCurrent(display, surface, surface, context))
+        {
+            std::fprintf(stderr, "[Headless] eglMakeCurrent failed: 0x%x\n", (unsigned)eglGetError());
+            if (surface != EGL_NO_SURFACE) eglDestroySurface(display, surface);
+            Destroy();
+            return false;
+        }
+        m_Surface = surface;
+    }
+
+    std::printf("[Headless] EGL %d.%d, %s\n", major, minor, m_Surface ? "pbuffer" : "surfaceless");
+    return true;
+}
+
+void HeadlessContext::Destroy()
+{
+    if (!m_Display) return;
+    EGLDisplay display = (EGLDisplay)m_Display;
+    eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    if (m_Surface) eglDestroySurface(display, (EGLSurface)m_Surface);
+    if (m_Context) eglDestroyContext(display, (EGLContext)m_Context);
+    eglTerminate(display);
+    m_Display = m_Context = m_Surface = nullptr;
+}
+
+void* HeadlessContext::GetProcAddress(const char* name)
+{
+    return (void*)eglGetProcAddress(name);
+}
+
+#else
+
+bool HeadlessContext::Create()
+{
+    std::fprintf(stderr, "[Headless] Built without EGL support (RENDERSANDBOX_ENABLE_HEADLESS=OFF)\n");
+    return false;
+}
+
+void HeadlessContext::Destroy()
+{
+}
+
+void* HeadlessContext::GetProcAddress(const char*)
+{
+    return nullptr;
+}
+
+#endif
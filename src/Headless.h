@@ -0,0 +1,61 @@
+#pragma once
+#include <string>
+#include <vector>
+
+#include "StressScene.h"
+
+// --headless 的命令行参数：没有窗口、没有输入，按固定步长回放相机路径，结束后写计时 JSON
+struct HeadlessOptions
+{
+    bool enabled = false;
+    int width = 1280;
+    int height = 720;
+    int frames = 300;
+    int warmup = 10;                    // 前几帧不进统计（着色器编译、流送、IBL 缓存加载）
+    float fps = 60.0f;                  // 固定步长 1/fps，相机路径和自动曝光都按它推进
+    std::string cameraPath;             // 空：内置的绕原点环绕
+    std::string timingsPath = "headless_timings.json";
+    std::string gpuProfilePath;         // 非空：结束时导出 GpuProfiler（.csv 写 CSV，其余写 JSON）
+    std::string tracePath;              // 非空：从启动开始录 CPU/GPU trace，退出时写 Chrome trace JSON（窗口模式也可用）
+    std::vector<int> captureFrames;
+    std::string capturePrefix = "capture";
+    bool capturePng = true;             // 最终画面
+    bool captureExr = false;            // 后处理之前的 HDR 场景颜色
+    bool finishEachFrame = true;        // 没有 swap 节流：每帧 glFinish，墙钟时间才是真的帧时间
+    bool dynamicResolution = false;     // 默认固定分辨率，结果才可比
+    int recordFrame = -1;               // >= 0：把这一帧的场景命令流录下来（FrameCapture，给 FrameReplay 用；窗口模式也可用，从主循环第一帧起数）
+    std::string recordPath = "frame.rsframe";
+    // 压力场景：给了任何一个 --objects / --models / ... 就按 stress 生成场景并打开物体网格（窗口模式也可用）
+    bool stressScene = false;
+    StressSceneSettings stress;
+    std::string sweepAxis;              // 非空：按 sweepValues 逐档扫 objects / materials / lights，写 sweepPath
+    std::vector<int> sweepValues;
+    int sweepFrames = 120;              // 每档测的帧数（另有 warmup 帧不进统计）
+    std::string sweepPath = "stress_sweep.json";
+};
+
+// 解析失败（未知参数、缺值）时打印用法并返回 false；不带 --headless 时其余参数也照样解析
+bool ParseHeadlessOptions(int argc, char** argv, HeadlessOptions& options);
+
+// HeadlessContext：EGL surfaceless（不支持时退回 1x1 pbuffer）的 GL 3.3 core 上下文，Mesa llvmpipe 可用
+// 没有默认帧缓冲，画面要画进自己的 FBO。构建时没开 RENDERSANDBOX_HEADLESS 时 Create 直接失败
+class HeadlessContext
+{
+public:
+    HeadlessContext() = default;
+    ~HeadlessContext();
+
+    HeadlessContext(const HeadlessContext&) = delete;
+    HeadlessContext& operator=(const HeadlessContext&) = delete;
+
+    bool Create();
+    void Destroy();
+
+    // 给 gladLoadGLLoader 用
+    static void* GetProcAddress(const char* name);
+
+private:
+    void* m_Display = nullptr;      // EGLDisplay / EGLContext / EGLSurface（头文件里不引 EGL）
+    void* m_Context = nullptr;
+    void* m_Surface = nullptr;
+};
@@ -1,8 +1,22 @@
 #include "IBLBaker.h"
+#include "CpuProfiler.h"
+#include "IBLCache.h"
+#include "render/DrawStats.h"
+#include "render/GpuMemory.h"
+#include "render/GpuProfiler.h"
+#include "RadianceHDR.h"
 #include "Shader.h"
+#include "TextureHDR.h"
+#include "ThreadPool.h"
 #include <glad/glad.h>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
 
 //6个面的朝向 从原看向 +x/-x/+y/-y/+z/-z
 static const glm::mat4 s_CaptureViews[6] = {
@@ -14,145 +28,834 @@ static const glm::mat4 s_CaptureViews[6] = {
     glm::lookAt(glm::vec3(0), glm::vec3( 0, 0,-1), glm::vec3(0,-1, 0)), // -Z
 };
 
-void IBLBaker::Bake(uint32_t hdrTexID)
+// 分帧切换的步骤：上传 HDR，环境立方体分层捕获，生成环境 mip，prefilter 每个 mip 一步
+static const int s_SwapStepUpload     = 0;
+static const int s_SwapStepEnv        = 1;
+static const int s_SwapStepEnvMips    = 2;
+static const int s_SwapStepPrefilter  = 3;
+
+// 前后各 glFinish 一次，量的是真实 GPU 时间（只在烘焙时用）
+using BakeClock = std::chrono::high_resolution_clock;
+static BakeClock::time_point BeginGPUTiming()
+{
+    glFinish();
+    return BakeClock::now();
+}
+static double EndGPUTiming(BakeClock::time_point t0)
+{
+    glFinish();
+    return std::chrono::duration<double, std::milli>(BakeClock::now() - t0).count();
+}
+
+// 立方体贴图 mip 0 ~ mips-1 的显存（MB）
+static double CubemapMB(int size, int mips, uint32_t internalFormat)
+{
+    return GpuMemory::TextureBytes(internalFormat, size, size, 6, mips) / (1024.0 * 1024.0);
+}
+
+// 工作线程写，主线程在 done 之后读
+struct SwapDecode
+{
+    std::atomic<bool> done{false};
+    bool ok = false;
+    int width = 0;
+    int height = 0;
+    std::vector<uint16_t> pixels;
+    SH9 irradianceSH{};
+    double decodeMs = 0.0;
+    double shMs = 0.0;
+};
+
+struct IBLBaker::SwapState
+{
+    std::string path;
+    std::shared_ptr<SwapDecode> decode;
+    TextureHDR hdr;
+    uint32_t envCubemap = 0;
+    uint32_t prefilterMap = 0;
+    int step = 0;
+    int frames = 0;
+    std::chrono::high_resolution_clock::time_point start;
+};
+
+IBLBaker::IBLBaker(const IBLBakeSettings& settings)
+    : m_Settings(settings)
+{
+    m_Settings.prefilterMips = std::clamp(m_Settings.prefilterMips, 1, IBLBakeSettings::kMaxPrefilterMips);
+}
+// GL 对象平时由 Destroy 释放（main 在销毁上下文之前调）；Destroy 可以重复调，
+// 正常退出时这里什么都不删，main 提前 return 的路径上下文还在，由析构兜底
+IBLBaker::~IBLBaker()
+{
+    Destroy();
+}
+
+bool IBLBaker::Bake(const std::string& hdrPath, const std::string& cachePath)
+{
+    PROFILE_ZONE("IBLBaker::Bake");
+    m_EnvironmentPath = hdrPath;
+
+    auto t0 = std::chrono::high_resolution_clock::now();
+    auto elapsedMs = [&t0]() {
+        return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - t0).count();
+    };
+
+    uint64_t key = 0;
+    bool hasKey = ComputeCacheKey(hdrPath, key);
+    double hashMs = elapsedMs();
+
+    m_LoadedFromCache = hasKey && LoadCache(cachePath, key);
+    if (m_LoadedFromCache)
+    {
+        glFinish();  // 把上传也算进去
+        m_LastBakeMs = elapsedMs();
+        std::printf("[IBLBaker] Cache hit: %s (%.2f ms, hash %.2f ms)\n",
+                    cachePath.c_str(), m_LastBakeMs, hashMs);
+        return true;
+    }
+
+    TextureHDR hdr;
+    if (!hdr.Load(hdrPath)) return false;
+    Bake(hdr);
+    hdr.ReleaseHalfPixels();    // SH 已经投影完，写缓存之前先还掉 CPU 像素
+
+    bool saved = hasKey && SaveCache(cachePath, key);
+    glFinish();
+    m_LastBakeMs = elapsedMs();
+    std::printf("[IBLBaker] Rebuilt: %s (%.2f ms, hash %.2f ms)%s\n",
+                hdrPath.c_str(), m_LastBakeMs, hashMs, saved ? ", cache written" : "");
+    return true;
+}
+
+bool IBLBaker::ComputeCacheKey(const std::string& hdrPath, uint64_t& key) const
+{
+    return IBLCache::ComputeKey(hdrPath, m_Settings, "assets/shaders", key);
+}
+
+void IBLBaker::SetSettings(const IBLBakeSettings& settings)
+{
+    CancelSwap();
+    // BRDF LUT 和环境无关，平时换环境不重烘；只有它自己的参数变了才丢掉
+    if (settings.brdfLUTSize != m_Settings.brdfLUTSize || settings.brdfLUTSamples != m_Settings.brdfLUTSamples)
+    {
+        GpuMemory::FreeTexture(m_BrdfLUT);
+        if (m_BrdfLUT) glDeleteTextures(1, &m_BrdfLUT);
+        m_BrdfLUT = 0;
+    }
+    m_Settings = settings;
+    m_Settings.prefilterMips = std::clamp(m_Settings.prefilterMips, 1, IBLBakeSettings::kMaxPrefilterMips);
+}
+
+bool IBLBaker::LoadCache(const std::string& cachePath, uint64_t key)
+{
+    IBLCache cache;
+    if (!cache.Open(cachePath, key)) return false;
+    if (!cache.Find(IBLCache::Kind::EnvCubemap)) return false;
+
+    Destroy();
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    for (const IBLCache::Image& img : cache.Images())
+    {
+        GLenum target = img.cube ? GL_TEXTURE_CUBE_MAP : GL_TEXTURE_2D;
+        GLenum format = img.channels == 2 ? GL_RG : GL_RGB;
+
+        uint32_t tex = 0;
+        glGenTextures(1, &tex);
+        glBindTexture(target, tex);
+
+        const uint16_t* src = img.data;
+        for (int level = 0; level < img.levels; ++level)
+        {
+            int w = std::max(1, img.width >> level);
+            int h = std::max(1, img.height >> level);
+            for (int face = 0; face < img.Faces(); ++face)
+            {
+                GLenum faceTarget = img.cube ? GL_TEXTURE_CUBE_MAP_POSITIVE_X + face : GL_TEXTURE_2D;
+                glTexImage2D(faceTarget, level, img.internalFormat, w, h, 0, format, GL_HALF_FLOAT, src);
+                src += img.FaceHalfCount(level);
+            }
+        }
+
+        glTexParameteri(target, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(target, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        if (img.cube) glTexParameteri(target, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+        glTexParameteri(target, GL_TEXTURE_MIN_FILTER, img.levels > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+        glTexParameteri(target, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(target, GL_TEXTURE_MAX_LEVEL, img.levels - 1);
+        glBindTexture(target, 0);
+
+        const char* name = nullptr;
+        switch (img.kind)
+        {
+            case IBLCache::Kind::EnvCubemap: m_EnvCubemap = tex;    name = "IBL env cubemap"; break;
+            case IBLCache::Kind::Irradiance: m_IrradianceMap = tex; name = "IBL irradiance";  break;
+            case IBLCache::Kind::Prefilter:  m_PrefilterMap = tex;  name = "IBL prefilter";   break;
+            case IBLCache::Kind::BrdfLUT:    m_BrdfLUT = tex;       name = "IBL BRDF LUT";    break;
+            default: glDeleteTextures(1, &tex); break;
+        }
+        if (name)
+            GpuMemory::TrackTexture(tex, GpuMemory::Category::IBL, name,
+                                    GpuMemory::TextureBytes(img.internalFormat, img.width, img.height,
+                                                            img.Faces(), img.levels));
+    }
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+    m_HasIrradianceSH = cache.HasIrradianceSH();
+    m_IrradianceSH = cache.GetIrradianceSH();
+    m_SHBakeMs = 0.0;
+    return true;
+}
+
+bool IBLBaker::SaveCache(const std::string& cachePath, uint64_t key) const
+{
+    struct Source { IBLCache::Kind kind; uint32_t tex; bool cube; };
+    const Source sources[] = {
+        { IBLCache::Kind::EnvCubemap, m_EnvCubemap,    true  },
+        { IBLCache::Kind::Irradiance, m_IrradianceMap, true  },
+        { IBLCache::Kind::Prefilter,  m_PrefilterMap,  true  },
+        { IBLCache::Kind::BrdfLUT,    m_BrdfLUT,       false },
+    };
+
+    std::vector<IBLCache::Image> images;
+    std::vector<std::vector<uint16_t>> pixels;
+    images.reserve(4);
+    pixels.reserve(4);
+
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    for (const Source& s : sources)
+    {
+        if (!s.tex) continue;
+        GLenum target = s.cube ? GL_TEXTURE_CUBE_MAP : GL_TEXTURE_2D;
+        GLenum level0 = s.cube ? GL_TEXTURE_CUBE_MAP_POSITIVE_X : GL_TEXTURE_2D;
+        glBindTexture(target, s.tex);
+
+        IBLCache::Image img;
+        img.kind = s.kind;
+        img.cube = s.cube;
+        GLint internalFormat = 0, width = 0, height = 0;
+        glGetTexLevelParameteriv(level0, 0, GL_TEXTURE_INTERNAL_FORMAT, &internalFormat);
+        glGetTexLevelParameteriv(level0, 0, GL_TEXTURE_WIDTH, &width);
+        glGetTexLevelParameteriv(level0, 0, GL_TEXTURE_HEIGHT, &height);
+        img.internalFormat = (uint32_t)internalFormat;
+        img.width = width;
+        img.height = height;
+        img.channels = (internalFormat == GL_RG16F || internalFormat == GL_RG32F) ? 2 : 3;
+
+        // 已定义的 mip 层数：往下查到宽度为 0 为止
+        img.levels = 0;
+        for (int level = 0; level < 16; ++level)
+        {
+            GLint w = 0;
+            glGetTexLevelParameteriv(level0, level, GL_TEXTURE_WIDTH, &w);
+            if (w <= 0) break;
+            img.levels = level + 1;
+        }
+        if (img.levels == 0 || width <= 0 || height <= 0) continue;
+
+        std::vector<uint16_t> data(img.TotalHalfCount());
+        GLenum format = img.channels == 2 ? GL_RG : GL_RGB;
+        uint16_t* dst = data.data();
+        for (int level = 0; level < img.levels; ++level)
+        {
+            for (int face = 0; face < img.Faces(); ++face)
+            {
+                glGetTexImage(s.cube ? GL_TEXTURE_CUBE_MAP_POSITIVE_X + face : GL_TEXTURE_2D,
+                              level, format, GL_HALF_FLOAT, dst);
+                dst += img.FaceHalfCount(level);
+            }
+        }
+        glBindTexture(target, 0);
+
+        pixels.push_back(std::move(data));
+        img.data = pixels.back().data();
+        images.push_back(img);
+    }
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+
+    return IBLCache::Write(cachePath, key, m_HasIrradianceSH ? &m_IrradianceSH : nullptr, images);
+}
+
+void IBLBaker::EnsureCaptureFBO()
+{
+    // 相机在立方体中心、不开深度测试，只需要颜色附件
+    if (m_CaptureFBO) return;
+    glGenFramebuffers(1, &m_CaptureFBO);
+}
+
+void IBLBaker::Bake(const TextureHDR& hdr)
+{
+    if (hdr.GetHalfPixels().empty()) {
+        Bake(hdr.GetID(), hdr.IsRGBE());
+        return;
+    }
+
+    std::printf("[IBLBaker] Starting bake...\n");
+    CancelSwap();
+    ReleaseEnvironmentMaps();
+    BakeCubemap(hdr.GetID(), hdr.IsRGBE());
+    BakeIrradianceSH(hdr);
+    BakePrefilter();
+    if (!m_BrdfLUT) BakeBRDFLUT();   // 只和 BRDF 有关，换环境不用重烘
+    std::printf("[IBLBaker] Bake complete.\n");
+}
+
+void IBLBaker::Bake(uint32_t hdrTexID, bool hdrIsRGBE)
 {
     std::printf("[IBLBaker] Starting bake...\n");
-    BakeCubemap(hdrTexID);
+    CancelSwap();
+    ReleaseEnvironmentMaps();
+    BakeCubemap(hdrTexID, hdrIsRGBE);
     BakeIrradiance();
-    // BakePrefilter();     // 下一步
-    // BakeBRDFLUT();       // 下一步
+    BakePrefilter();
+    if (!m_BrdfLUT) BakeBRDFLUT();
     std::printf("[IBLBaker] Bake complete.\n");
 }
 
+int IBLBaker::SwapStepCount() const
+{
+    return s_SwapStepPrefilter + m_Settings.prefilterMips;
+}
+
+bool IBLBaker::BeginSwap(const std::string& hdrPath)
+{
+    CancelSwap();
+
+    m_Swap = std::make_unique<SwapState>();
+    m_Swap->path = hdrPath;
+    m_Swap->decode = std::make_shared<SwapDecode>();
+    m_Swap->start = std::chrono::high_resolution_clock::now();
+
+    // 解码和 SH 投影都是纯 CPU，放到工作线程；任务只持有 shared_ptr，被放弃也安全
+    std::shared_ptr<SwapDecode> decode = m_Swap->decode;
+    ThreadPool::Global().Submit([decode, hdrPath]() {
+        auto t0 = std::chrono::high_resolution_clock::now();
+        RadianceHDR image;
+        if (image.Load(hdrPath, RadianceHDR::Output::Half, true, &ThreadPool::Global()))
+        {
+            decode->width = image.Width();
+            decode->height = image.Height();
+            decode->pixels = image.ReleaseHalf();
+            auto t1 = std::chrono::high_resolution_clock::now();
+
+            SH9 radiance = ProjectEquirectToSH9(decode->pixels.data(), decode->width, decode->height,
+                                                &ThreadPool::Global());
+            decode->irradianceSH = RadianceToIrradianceSH9(radiance);
+            auto t2 = std::chrono::high_resolution_clock::now();
+
+            decode->decodeMs = std::chrono::duration<double, std::milli>(t1 - t0).count();
+            decode->shMs = std::chrono::duration<double, std::milli>(t2 - t1).count();
+            decode->ok = true;
+        }
+        decode->done.store(true, std::memory_order_release);
+    });
+
+    std::printf("[IBLBaker] Swap started: %s\n", hdrPath.c_str());
+    return true;
+}
+
+void IBLBaker::CancelSwap()
+{
+    if (!m_Swap) return;
+    GpuMemory::FreeTexture(m_Swap->envCubemap);
+    GpuMemory::FreeTexture(m_Swap->prefilterMap);
+    if (m_Swap->envCubemap)   glDeleteTextures(1, &m_Swap->envCubemap);
+    if (m_Swap->prefilterMap) glDeleteTextures(1, &m_Swap->prefilterMap);
+    m_Swap->hdr.Destroy();
+    m_Swap.reset();
+}
+
+float IBLBaker::GetSwapProgress() const
+{
+    if (!m_Swap) return 1.0f;
+    return (float)m_Swap->step / (float)SwapStepCount();
+}
+
+void IBLBaker::RunSwapStep(int step)
+{
+    SwapState& swap = *m_Swap;
+    if (step == s_SwapStepUpload)
+    {
+        // SH 在工作线程算过，CPU 像素上传完就没用了：移进 LoadFromHalf，随它返回释放
+        swap.hdr.LoadFromHalf(std::move(swap.decode->pixels), swap.decode->width, swap.decode->height,
+                              swap.path);
+        swap.envCubemap = CreateCubemap(m_Settings.envSize, m_Settings.EnvMips(), m_Settings.envFormat,
+                                        "IBL env cubemap");
+        swap.prefilterMap = CreateCubemap(m_Settings.prefilterSize, m_Settings.prefilterMips,
+                                          m_Settings.prefilterFormat, "IBL prefilter");
+    }
+    else if (step == s_SwapStepEnv)
+    {
+        CaptureEnv(swap.hdr.GetID(), false, swap.envCubemap);
+    }
+    else if (step == s_SwapStepEnvMips)
+    {
+        GenerateEnvMips(swap.envCubemap);
+        swap.hdr.Destroy();
+    }
+    else
+    {
+        PrefilterMip(swap.envCubemap, swap.prefilterMap, step - s_SwapStepPrefilter);
+    }
+}
+
+bool IBLBaker::UpdateSwap(int stepsPerFrame)
+{
+    if (!m_Swap) return false;
+    if (!m_Swap->decode->done.load(std::memory_order_acquire)) return false;
+
+    if (!m_Swap->decode->ok)
+    {
+        std::fprintf(stderr, "[IBLBaker] Swap failed to decode: %s\n", m_Swap->path.c_str());
+        CancelSwap();
+        return false;
+    }
+
+    if (!m_BrdfLUT) BakeBRDFLUT();
+
+    const int stepCount = SwapStepCount();
+    m_Swap->frames++;
+    int end = std::min(stepCount, m_Swap->step + std::max(stepsPerFrame, 1));
+    for (; m_Swap->step < end; m_Swap->step++)
+        RunSwapStep(m_Swap->step);
+
+    if (m_Swap->step < stepCount) return false;
+
+    // 全部完成：同一帧内整体替换，旧贴图随即释放
+    ReleaseEnvironmentMaps();
+    m_EnvCubemap = m_Swap->envCubemap;
+    m_PrefilterMap = m_Swap->prefilterMap;
+    m_IrradianceSH = m_Swap->decode->irradianceSH;
+    m_HasIrradianceSH = true;
+    m_SHBakeMs = m_Swap->decode->shMs;
+    m_EnvironmentPath = m_Swap->path;
+    m_LoadedFromCache = false;
+
+    auto now = std::chrono::high_resolution_clock::now();
+    m_LastBakeMs = std::chrono::duration<double, std::milli>(now - m_Swap->start).count();
+    std::printf("[IBLBaker] Swapped to %s: decode %.2f ms + SH %.2f ms (worker), %d steps over %d frames, %.2f ms total\n",
+                m_Swap->path.c_str(), m_Swap->decode->decodeMs, m_Swap->decode->shMs,
+                stepCount, m_Swap->frames, m_LastBakeMs);
+
+    m_Swap->envCubemap = m_Swap->prefilterMap = 0;
+    m_Swap.reset();
+    return true;
+}
+
+void IBLBaker::ReleaseEnvironmentMaps()
+{
+    GpuMemory::FreeTexture(m_EnvCubemap);
+    GpuMemory::FreeTexture(m_IrradianceMap);
+    GpuMemory::FreeTexture(m_PrefilterMap);
+    if (m_EnvCubemap)    glDeleteTextures(1, &m_EnvCubemap);
+    if (m_IrradianceMap) glDeleteTextures(1, &m_IrradianceMap);
+    if (m_PrefilterMap)  glDeleteTextures(1, &m_PrefilterMap);
+    m_EnvCubemap = m_IrradianceMap = m_PrefilterMap = 0;
+    m_HasIrradianceSH = false;
+}
+
 // 90° FOV，1:1 宽高比（每个面都是正方形）
 static const glm::mat4 s_CaptureProj =
     glm::perspective(glm::radians(90.0f),1.0f,0.1f,10.0f);
 
-void IBLBaker::BakeCubemap(uint32_t hdrTexID)
+// cubemap.geom 里每个面的 projection * view
+static void SetCaptureMatrices(Shader& shader)
+{
+    for (int face = 0; face < 6; face++)
+        shader.setUniformMat4("u_CaptureViewProj[" + std::to_string(face) + "]",
+                              s_CaptureProj * s_CaptureViews[face]);
+}
+
+uint32_t IBLBaker::CreateCubemap(int size, int mips, uint32_t internalFormat, const char* name)
 {
-    // 1) 创建 512×512 的 Cubemap 纹理（6 个面） 生成一个纹理对象 ID，存到 m_EnvCubemap 分配句柄
-    glGenTextures(1, &m_EnvCubemap);
-    //绑定到GL_TEXTURE_CUBE_MAP 目标 后续的操作都针对这个 Cubemap
-    glBindTexture(GL_TEXTURE_CUBE_MAP, m_EnvCubemap);
-    for (int i = 0; i < 6; i++)
+    uint32_t tex = 0;
+    glGenTextures(1, &tex);
+    glBindTexture(GL_TEXTURE_CUBE_MAP, tex);
+    for (int mip = 0; mip < mips; mip++)
     {
-     // GL_TEXTURE_CUBE_MAP_POSITIVE_X + i 依次对应 6 个面
-     glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i,
-                     0, GL_RGB16F, 512, 512, 0, GL_RGB, GL_FLOAT, nullptr);
+        int mipSize = std::max(1, size >> mip);
+        // GL_TEXTURE_CUBE_MAP_POSITIVE_X + i 依次对应 6 个面
+        for (int i = 0; i < 6; i++)
+            glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i,
+                         mip, internalFormat, mipSize, mipSize, 0, GL_RGB, GL_FLOAT, nullptr);
     }
     glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, mips > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
     glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAX_LEVEL, mips - 1);
+    glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
+    GpuMemory::TrackTexture(tex, GpuMemory::Category::IBL, name,
+                            GpuMemory::TextureBytes(internalFormat, size, size, 6, mips));
+    return tex;
+}
 
-    // 2) 创建离屏 FBO（只需要颜色附件，不需要深度）
-    glGenFramebuffers(1, &m_CaptureFBO);
-    glGenRenderbuffers(1, &m_CaptureRBO);
+void IBLBaker::BeginCapture(uint32_t target, int mip, int size)
+{
+    // 整张立方体的第 mip 层作为分层附件（6 个 layer = 6 个面），gl_Layer 决定写哪个面
+    EnsureCaptureFBO();
     glBindFramebuffer(GL_FRAMEBUFFER, m_CaptureFBO);
-    glBindRenderbuffer(GL_RENDERBUFFER, m_CaptureRBO);
-    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, 512, 512);
-    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT,
-                              GL_RENDERBUFFER, m_CaptureRBO);
+    glFramebufferTexture(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, target, mip);
+
+    GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    if (status != GL_FRAMEBUFFER_COMPLETE)
+        std::printf("[IBLBaker] FBO incomplete! Status: 0x%X\n", status);
 
-    // 用转换shader渲染六次
-    Shader convShader("assets/shaders/cubemap.vert",
-                  "assets/shaders/equirect_to_cubemap.frag");
+    glViewport(0, 0, size, size);
+    glDisable(GL_CULL_FACE);   // ← 烘焙前禁用剔除（相机在立方体里面）
+    glDisable(GL_DEPTH_TEST);
+    glClear(GL_COLOR_BUFFER_BIT);
+}
+
+void IBLBaker::EndCapture()
+{
+    glEnable(GL_DEPTH_TEST);
+    glEnable(GL_CULL_FACE);    // ← 烘焙后恢复（主循环里也会按开关重新设置）
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
 
+void IBLBaker::CaptureEnv(uint32_t hdrTexID, bool hdrIsRGBE, uint32_t envCubemap)
+{
+    // 转换 shader 只编译一次，分帧切换时也会用到
+    if (!m_EquirectShader)
+        m_EquirectShader = std::make_unique<Shader>("assets/shaders/cubemap.vert",
+                                                    "assets/shaders/cubemap.geom",
+                                                    "assets/shaders/equirect_to_cubemap.frag", "");
+    Shader& convShader = *m_EquirectShader;
     convShader.Bind();
     convShader.setUniform1i("u_EquirectMap", 0);
-    convShader.setUniformMat4("u_Projection", s_CaptureProj);
+    convShader.setUniform1i("u_RGBE", hdrIsRGBE ? 1 : 0);
+    SetCaptureMatrices(convShader);
 
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, hdrTexID);
 
-    glViewport(0, 0, 512, 512);
-    glBindFramebuffer(GL_FRAMEBUFFER, m_CaptureFBO);
+    // 一次 draw 写满第 0 层的 6 个面
+    GpuScope scope("IBL capture env");
+    BeginCapture(envCubemap, 0, m_Settings.envSize);
+    RenderCube();
+    EndCapture();
+}
 
-    GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
-    if (status != GL_FRAMEBUFFER_COMPLETE)
-        std::printf("[IBLBaker] FBO incomplete! Status: 0x%X\n", status);
-    else
-        std::printf("[IBLBaker] FBO complete. EnvCubemap ID: %u\n", m_EnvCubemap);
+void IBLBaker::GenerateEnvMips(uint32_t envCubemap)
+{
+    // prefilter 按 PDF 从模糊的 mip 采样
+    GpuScope scope("IBL env mips");
+    glBindTexture(GL_TEXTURE_CUBE_MAP, envCubemap);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glGenerateMipmap(GL_TEXTURE_CUBE_MAP);
+    glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
+}
 
-    glDisable(GL_CULL_FACE);   // ← 烘焙前禁用剔除
+void IBLBaker::PrefilterMip(uint32_t envCubemap, uint32_t prefilterMap, int mip)
+{
+    if (!m_PrefilterShader)
+        m_PrefilterShader = std::make_unique<Shader>("assets/shaders/cubemap.vert",
+                                                     "assets/shaders/cubemap.geom",
+                                                     "assets/shaders/prefilter.frag", "");
+    int size = std::max(1, m_Settings.prefilterSize >> mip);
+    float roughness = (float)mip / (float)std::max(m_Settings.prefilterMips - 1, 1);
+
+    Shader& prefilterShader = *m_PrefilterShader;
+    prefilterShader.Bind();
+    prefilterShader.setUniform1i("u_EnvMap", 0);
+    prefilterShader.setUniform1f("u_EnvResolution", (float)m_Settings.envSize);
+    SetCaptureMatrices(prefilterShader);
+    prefilterShader.setUniform1f("u_Roughness", roughness);
+    prefilterShader.setUniform1i("u_SampleCount", m_Settings.prefilterSamples[mip]);
+    prefilterShader.setUniform1f("u_OutputResolution", (float)size);
 
-    for (int i = 0; i < 6; i++)
-    {
-        //切换到离屏fbo
-        convShader.setUniformMat4("u_View", s_CaptureViews[i]);
-        // 把 Cubemap 的第 i 个面挂到 FBO 的颜色附件上
-        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
-                               GL_TEXTURE_CUBE_MAP_POSITIVE_X + i,
-                               m_EnvCubemap, 0);
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-        RenderCube();  // 画单位立方体
-    }
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_CUBE_MAP, envCubemap);
+
+    char scopeName[32];
+    std::snprintf(scopeName, sizeof(scopeName), "IBL prefilter mip %d", mip);
+    GpuScope scope(scopeName);
+    BeginCapture(prefilterMap, mip, size);
+    RenderCube();
+    EndCapture();
+}
 
-    glEnable(GL_CULL_FACE);    // ← 烘焙后恢复（可选，主循环里也会设置）
+void IBLBaker::BakeCubemap(uint32_t hdrTexID, bool hdrIsRGBE)
+{
+    const int size = m_Settings.envSize;
+    const int mips = m_Settings.EnvMips();
 
+    // 1) 创建 Cubemap（6 个面，带完整 mip 链）
+    m_EnvCubemap = CreateCubemap(size, mips, m_Settings.envFormat, "IBL env cubemap");
 
+    // 2) 用转换 shader 一次画完 6 个面
+    auto t0 = BeginGPUTiming();
+    CaptureEnv(hdrTexID, hdrIsRGBE, m_EnvCubemap);
+    double captureMs = EndGPUTiming(t0);
 
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    // 3) 生成 mipmap
+    auto t1 = BeginGPUTiming();
+    GenerateEnvMips(m_EnvCubemap);
+    double mipsMs = EndGPUTiming(t1);
+
+    std::printf("[IBLBaker] Env cubemap %dx%d %s, %d mips (%.1f MB): capture %.2f ms, mips %.2f ms\n",
+                size, size, IBLCache::FormatName(m_Settings.envFormat), mips,
+                CubemapMB(size, mips, m_Settings.envFormat), captureMs, mipsMs);
 }
 
 void IBLBaker::BakeIrradiance()
 {
-    // 1) 创建 32×32 的 IrradianceMap（低分辨率就够，因为是模糊结果）
-    glGenTextures(1, &m_IrradianceMap);
-    glBindTexture(GL_TEXTURE_CUBE_MAP, m_IrradianceMap);
-    for (int i = 0; i < 6; i++)
-    {
-        glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i,
-                     0, GL_RGB16F, 32, 32, 0, GL_RGB, GL_FLOAT, nullptr);
-    }
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    const int size = m_Settings.irradianceSize;
 
-    // 2) 复用已有的 FBO，但 RBO 要改成 32×32
-    glBindFramebuffer(GL_FRAMEBUFFER, m_CaptureFBO);
-    glBindRenderbuffer(GL_RENDERBUFFER, m_CaptureRBO);
-    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, 32, 32);
+    // 1) 低分辨率就够，因为是模糊结果
+    m_IrradianceMap = CreateCubemap(size, 1, m_Settings.irradianceFormat, "IBL irradiance");
 
-    // 3) 卷积 shader（顶点复用 cubemap.vert，只需要位置+方向）
+    // 2) 卷积 shader，和环境捕获一样一次画完 6 个面
     Shader irrShader("assets/shaders/cubemap.vert",
-                     "assets/shaders/irradiance_convolution.frag");
+                     "assets/shaders/cubemap.geom",
+                     "assets/shaders/irradiance_convolution.frag", "");
     irrShader.Bind();
     irrShader.setUniform1i("u_EnvMap", 0);
-    irrShader.setUniformMat4("u_Projection", s_CaptureProj);
+    SetCaptureMatrices(irrShader);
 
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_CUBE_MAP, m_EnvCubemap); // 输入：上一步烘好的 Cubemap
 
-    glViewport(0, 0, 32, 32);
-    glDisable(GL_CULL_FACE);
-
-    for (int i = 0; i < 6; i++)
+    auto t0 = BeginGPUTiming();
     {
-        irrShader.setUniformMat4("u_View", s_CaptureViews[i]);
-        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
-                               GL_TEXTURE_CUBE_MAP_POSITIVE_X + i,
-                               m_IrradianceMap, 0);
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        GpuScope scope("IBL irradiance");
+        BeginCapture(m_IrradianceMap, 0, size);
         RenderCube();
+        EndCapture();
     }
+    double ms = EndGPUTiming(t0);
 
-    glEnable(GL_CULL_FACE);
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    std::printf("[IBLBaker] Irradiance convolution %dx%d %s (%.2f MB): %.2f ms\n",
+                size, size, IBLCache::FormatName(m_Settings.irradianceFormat),
+                CubemapMB(size, 1, m_Settings.irradianceFormat), ms);
+}
+
+
+void IBLBaker::BakeIrradianceSH(const TextureHDR& hdr)
+{
+    auto t0 = std::chrono::high_resolution_clock::now();
+
+    SH9 radiance = ProjectEquirectToSH9(hdr.GetHalfPixels().data(), hdr.GetWidth(), hdr.GetHeight(),
+                                        &ThreadPool::Global());
+    m_IrradianceSH = RadianceToIrradianceSH9(radiance);
+    m_HasIrradianceSH = true;
+
+    auto t1 = std::chrono::high_resolution_clock::now();
+    m_SHBakeMs = std::chrono::duration<double, std::milli>(t1 - t0).count();
+    std::printf("[IBLBaker] SH9 irradiance from %dx%d equirect: %.2f ms (%u threads)\n",
+                hdr.GetWidth(), hdr.GetHeight(), m_SHBakeMs, ThreadPool::Global().ThreadCount() + 1);
 }
 
+IBLBaker::IrradianceDiff IBLBaker::CompareSHWithConvolution()
+{
+    IrradianceDiff diff;
+    diff.shBakeMs = m_SHBakeMs;
+    if (!m_HasIrradianceSH || !m_EnvCubemap) return diff;
+
+    // 1) 需要时跑一次原来的卷积 shader（glFinish 包住，计的是真实 GPU 时间）
+    if (!m_IrradianceMap) {
+        auto t0 = BeginGPUTiming();
+        BakeIrradiance();
+        diff.gpuBakeMs = EndGPUTiming(t0);
+    }
+
+    // 2) 读回 6 个面，逐 texel 和 SH 求值对比
+    GLint size = 0;
+    glBindTexture(GL_TEXTURE_CUBE_MAP, m_IrradianceMap);
+    glGetTexLevelParameteriv(GL_TEXTURE_CUBE_MAP_POSITIVE_X, 0, GL_TEXTURE_WIDTH, &size);
+    if (size <= 0) return diff;
+    std::vector<float> face((std::size_t)size * size * 3);
+    double sumSq = 0.0, sumRelSq = 0.0;
+    std::size_t count = 0;
+
+    for (int f = 0; f < 6; ++f)
+    {
+        glGetTexImage(GL_TEXTURE_CUBE_MAP_POSITIVE_X + f, 0, GL_RGB, GL_FLOAT, face.data());
+        for (int y = 0; y < size; ++y)
+        {
+            for (int x = 0; x < size; ++x)
+            {
+                glm::vec3 dir = glm::normalize(CubeFaceDirection(f, (x + 0.5f) / size, (y + 0.5f) / size));
+                glm::vec3 sh = EvalSH9(m_IrradianceSH, dir);
+                const float* ref = &face[((std::size_t)y * size + x) * 3];
+                for (int c = 0; c < 3; ++c)
+                {
+                    float err = std::fabs(sh[c] - ref[c]);
+                    float rel = err / std::max(ref[c], 1e-3f);
+                    sumSq += (double)err * err;
+                    sumRelSq += (double)rel * rel;
+                    diff.maxError = std::max(diff.maxError, err);
+                    diff.maxRelError = std::max(diff.maxRelError, rel);
+                    ++count;
+                }
+            }
+        }
+    }
+    glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
+
+    diff.rmsError = (float)std::sqrt(sumSq / (double)count);
+    diff.relRmsError = (float)std::sqrt(sumRelSq / (double)count);
+    std::printf("[IBLBaker] SH9 vs convolution: RMS %.4f, max %.4f, rel RMS %.2f%%, max rel %.2f%% "
+                "(SH %.2f ms CPU, convolution %.2f ms GPU)\n",
+                diff.rmsError, diff.maxError, diff.relRmsError * 100.0f, diff.maxRelError * 100.0f,
+                diff.shBakeMs, diff.gpuBakeMs);
+    return diff;
+}
 
 void IBLBaker::BakePrefilter()
 {
-    // 下一步实现
+    const int size = m_Settings.prefilterSize;
+    const int mips = m_Settings.prefilterMips;
+
+    // 每级对应一个 roughness = mip / (mipCount - 1)，每级一次 draw
+    m_PrefilterMap = CreateCubemap(size, mips, m_Settings.prefilterFormat, "IBL prefilter");
+
+    double totalMs = 0.0;
+    long long totalSamples = 0;
+    for (int mip = 0; mip < mips; mip++)
+    {
+        auto t0 = BeginGPUTiming();
+        PrefilterMip(m_EnvCubemap, m_PrefilterMap, mip);
+        double ms = EndGPUTiming(t0);
+        totalMs += ms;
+
+        int mipSize = std::max(1, size >> mip);
+        long long taps = (long long)mipSize * mipSize * 6 * m_Settings.prefilterSamples[mip];
+        totalSamples += taps;
+        std::printf("[IBLBaker]   prefilter mip %d (%dx%d, roughness %.2f, %d samples, %.2fM taps): %.2f ms\n",
+                    mip, mipSize, mipSize, (float)mip / (float)std::max(mips - 1, 1),
+                    m_Settings.prefilterSamples[mip], taps / 1.0e6, ms);
+    }
+
+    std::printf("[IBLBaker] Prefilter %dx%d %s, %d mips (%.1f MB, %.1fM taps): %.2f ms\n",
+                size, size, IBLCache::FormatName(m_Settings.prefilterFormat), mips,
+                CubemapMB(size, mips, m_Settings.prefilterFormat), totalSamples / 1.0e6, totalMs);
 }
 
 void IBLBaker::BakeBRDFLUT()
 {
-    // 下一步实现
+    const int size = m_Settings.brdfLUTSize;
+    auto t0 = BeginGPUTiming();
+
+    // 1) RG16F：R = F0 的系数 A，G = 偏移 B
+    glGenTextures(1, &m_BrdfLUT);
+    glBindTexture(GL_TEXTURE_2D, m_BrdfLUT);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RG16F, size, size, 0, GL_RG, GL_FLOAT, nullptr);
+    GpuMemory::TrackTexture(m_BrdfLUT, GpuMemory::Category::IBL, "IBL BRDF LUT",
+                            GpuMemory::TextureBytes(GL_RG16F, size, size));
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    // 2) 全屏四边形画一次
+    Shader brdfShader("assets/shaders/brdf_lut.vert",
+                      "assets/shaders/brdf_lut.frag");
+    brdfShader.Bind();
+    brdfShader.setUniform1i("u_SampleCount", m_Settings.brdfLUTSamples);
+
+    EnsureCaptureFBO();
+    glBindFramebuffer(GL_FRAMEBUFFER, m_CaptureFBO);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_BrdfLUT, 0);
+
+    glViewport(0, 0, size, size);
+    glDisable(GL_DEPTH_TEST);
+    {
+        GpuScope scope("IBL BRDF LUT");
+        glClear(GL_COLOR_BUFFER_BIT);
+        RenderQuad();
+    }
+    glEnable(GL_DEPTH_TEST);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    std::printf("[IBLBaker] BRDF LUT %dx%d, %d samples: %.2f ms\n",
+                size, size, m_Settings.brdfLUTSamples, EndGPUTiming(t0));
+}
+
+float IBLBaker::GetPrefilterMaxLod() const
+{
+    return (float)(m_Settings.prefilterMips - 1);
+}
+
+void IBLBaker::ApplyToShader(Shader& shader, bool useSH, bool useSpecular, bool bindTextures) const
+{
+    shader.setUniform1i("u_IrradianceMap", 2);
+    if (bindTextures)
+    {
+        glActiveTexture(GL_TEXTURE2);
+        DrawStats::BindTexture();
+        glBindTexture(GL_TEXTURE_CUBE_MAP, m_IrradianceMap);
+    }
+    shader.setUniform1i("u_UseSH", useSH ? 1 : 0);
+    shader.setUniform3fv("u_SH", 9, &m_IrradianceSH.coeffs[0].x);
+    shader.setUniform1i("u_PrefilterMap", 3);
+    shader.setUniform1i("u_BrdfLUT", 4);
+    shader.setUniform1f("u_PrefilterMaxLod", GetPrefilterMaxLod());
+    shader.setUniform1i("u_UseSpecularIBL", useSpecular ? 1 : 0);
+    if (bindTextures)
+    {
+        glActiveTexture(GL_TEXTURE3);
+        DrawStats::BindTexture();
+        glBindTexture(GL_TEXTURE_CUBE_MAP, m_PrefilterMap);
+        glActiveTexture(GL_TEXTURE4);
+        DrawStats::BindTexture();
+        glBindTexture(GL_TEXTURE_2D, m_BrdfLUT);
+    }
+}
+
+IBLBaker::BRDFLUTDiff IBLBaker::CompareBRDFLUT(int stride)
+{
+    BRDFLUTDiff diff;
+    if (!m_BrdfLUT || stride <= 0) return diff;
+
+    GLint size = 0;
+    glBindTexture(GL_TEXTURE_2D, m_BrdfLUT);
+    glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &size);
+    const int samples = m_Settings.brdfLUTSamples;
+    std::vector<float> gpu((std::size_t)size * size * 2);
+    glGetTexImage(GL_TEXTURE_2D, 0, GL_RG, GL_FLOAT, gpu.data());
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    // CPU 参考只算抽查的 texel（整张 512² 在 CPU 上要好几秒）
+    auto t0 = std::chrono::high_resolution_clock::now();
+    const int n = (size + stride - 1) / stride;
+    std::vector<float> err((std::size_t)n * n, 0.0f);
+    auto compareRows = [&](int begin, int end) {
+        for (int j = begin; j < end; ++j)
+        {
+            int y = j * stride + stride / 2;
+            if (y >= size) continue;
+            for (int i = 0; i < n; ++i)
+            {
+                int x = i * stride + stride / 2;
+                if (x >= size) continue;
+                float NdotV = ((float)x + 0.5f) / (float)size;
+                float roughness = ((float)y + 0.5f) / (float)size;
+                glm::vec2 ref = IntegrateBRDF(NdotV, roughness, samples);
+                const float* g = &gpu[((std::size_t)y * size + x) * 2];
+                err[(std::size_t)j * n + i] = std::max(std::fabs(g[0] - ref.x), std::fabs(g[1] - ref.y));
+            }
+        }
+    };
+    ThreadPool::Global().ParallelFor(n, compareRows, 1);
+    auto t1 = std::chrono::high_resolution_clock::now();
+    diff.cpuMs = std::chrono::duration<double, std::milli>(t1 - t0).count();
+
+    double sumSq = 0.0;
+    for (float e : err)
+    {
+        sumSq += (double)e * e;
+        diff.maxError = std::max(diff.maxError, e);
+    }
+    diff.texels = (int)err.size();
+    diff.rmsError = (float)std::sqrt(sumSq / (double)std::max<std::size_t>(err.size(), 1));
+
+    std::printf("[IBLBaker] BRDF LUT vs CPU reference (%d texels): RMS %.5f, max %.5f (CPU %.2f ms)\n",
+                diff.texels, diff.rmsError, diff.maxError, diff.cpuMs);
+    return diff;
 }
 
 void IBLBaker::RenderCube()
@@ -211,25 +914,63 @@ void IBLBaker::RenderCube()
         glBindVertexArray(m_CubeVAO);
         glBindBuffer(GL_ARRAY_BUFFER, m_CubeVBO);
         glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+        GpuMemory::TrackBuffer(m_CubeVBO, GpuMemory::Category::IBL, "IBL cube", sizeof(vertices));
         glEnableVertexAttribArray(0);
         glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
         glBindVertexArray(0);
     }
 
+    DrawStats::BindVertexArray();
     glBindVertexArray(m_CubeVAO);
-    glDrawArrays(GL_TRIANGLES, 0, 36);
+    DrawStats::DrawArrays(GL_TRIANGLES, 0, 36);
     glBindVertexArray(0);
 }
 
 void IBLBaker::RenderQuad()
 {
-    // 下一步实现（BRDF LUT 用）
+    // 懒加载：位置(3) + UV(2)，三角形带 4 个顶点盖满 NDC
+    if (m_QuadVAO == 0)
+    {
+        float vertices[] = {
+            -1.0f,  1.0f, 0.0f,  0.0f, 1.0f,
+            -1.0f, -1.0f, 0.0f,  0.0f, 0.0f,
+             1.0f,  1.0f, 0.0f,  1.0f, 1.0f,
+             1.0f, -1.0f, 0.0f,  1.0f, 0.0f,
+        };
+
+        glGenVertexArrays(1, &m_QuadVAO);
+        glGenBuffers(1, &m_QuadVBO);
+        glBindVertexArray(m_QuadVAO);
+        glBindBuffer(GL_ARRAY_BUFFER, m_QuadVBO);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+        GpuMemory::TrackBuffer(m_QuadVBO, GpuMemory::Category::IBL, "IBL quad", sizeof(vertices));
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
+        glBindVertexArray(0);
+    }
+
+    DrawStats::BindVertexArray();
+    glBindVertexArray(m_QuadVAO);
+    DrawStats::DrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    glBindVertexArray(0);
 }
 
 
 
 void IBLBaker::Destroy()
 {
+    CancelSwap();
+    m_EquirectShader.reset();
+    m_PrefilterShader.reset();
+
+    GpuMemory::FreeTexture(m_EnvCubemap);
+    GpuMemory::FreeTexture(m_IrradianceMap);
+    GpuMemory::FreeTexture(m_PrefilterMap);
+    GpuMemory::FreeTexture(m_BrdfLUT);
+    GpuMemory::FreeBuffer(m_CubeVBO);
+    GpuMemory::FreeBuffer(m_QuadVBO);
     if (m_EnvCubemap)    glDeleteTextures(1, &m_EnvCubemap);
     if (m_IrradianceMap) glDeleteTextures(1, &m_IrradianceMap);
     if (m_PrefilterMap)  glDeleteTextures(1, &m_PrefilterMap);
@@ -239,9 +980,9 @@ void IBLBaker::Destroy()
     if (m_QuadVAO)       glDeleteVertexArrays(1, &m_QuadVAO);
     if (m_QuadVBO)       glDeleteBuffers(1, &m_QuadVBO);
     if (m_CaptureFBO)    glDeleteFramebuffers(1, &m_CaptureFBO);
-    if (m_CaptureRBO)    glDeleteRenderbuffers(1, &m_CaptureRBO);
 
     m_EnvCubemap = m_IrradianceMap = m_PrefilterMap = m_BrdfLUT = 0;
+    m_HasIrradianceSH = false;
     m_CubeVAO = m_CubeVBO = m_QuadVAO = m_QuadVBO = 0;
-    m_CaptureFBO = m_CaptureRBO = 0;
+    m_CaptureFBO = 0;
 }
@@ -1,13 +1,94 @@
 #pragma once
 #include <cstdint>
+#include <memory>
+#include <string>
+#include "IBLCache.h"
+#include "IBLMath.h"
+
+class Shader;
+class TextureHDR;
 
 class IBLBaker
 {
 public:
-    // 程序启动时调用一次，传入 HDR 纹理 ID
-    void Bake(uint32_t hdrTexID);
+    explicit IBLBaker(const IBLBakeSettings& settings = IBLBakeSettings());
+    ~IBLBaker();
+
+    IBLBaker(const IBLBaker&) = delete;
+    IBLBaker& operator=(const IBLBaker&) = delete;
+
+    // SH 辐照度和 GPU 卷积结果的逐 texel 对比（irradianceSize² x 6）
+    struct IrradianceDiff
+    {
+        float  rmsError = 0.0f;     // 绝对误差的 RMS
+        float  maxError = 0.0f;     // 最大绝对误差
+        float  relRmsError = 0.0f;  // 相对误差的 RMS
+        float  maxRelError = 0.0f;
+        double gpuBakeMs = 0.0;     // 卷积 shader 耗时（glFinish 计时）
+        double shBakeMs = 0.0;
+    };
+
+    // GPU 烘焙的 BRDF LUT 和 CPU 参考（IntegrateBRDF）的对比
+    struct BRDFLUTDiff
+    {
+        float  rmsError = 0.0f;
+        float  maxError = 0.0f;
+        int    texels = 0;          // 抽查的 texel 数
+        double cpuMs = 0.0;         // CPU 参考耗时
+    };
+
+    // 带磁盘缓存的入口（程序启动时调用一次）
+    // key = HDR 文件内容哈希 + 烘焙分辨率 + 烘焙 shader 源码哈希
+    // 命中：mmap 缓存文件直接上传，不解码 HDR，也不跑任何离屏 FBO；未命中：解码 + Bake(hdr) + 写缓存
+    bool Bake(const std::string& hdrPath, const std::string& cachePath);
+    // 环境立方体在 GPU 上转换，
+    // 漫反射辐照度从 CPU 端像素投影成 SH9（不跑卷积 shader，也没有辐照度立方体）
+    void Bake(const TextureHDR& hdr);
+    // 只有 GPU 纹理时用：传入 HDR 纹理 ID，辐照度走卷积 shader
+    // hdrIsRGBE：纹理是 RGBE8 原始数据（TextureHDR::IsRGBE），转换时在 shader 里解码
+    void Bake(uint32_t hdrTexID, bool hdrIsRGBE = false);
+    // 释放所有 GL 对象（包括进行中的切换）；需要在 GL 上下文销毁前调用
     void Destroy();
 
+    // 烘焙分辨率 / 格式 / 采样数，下一次 Bake 或 BeginSwap 起生效（会放弃进行中的切换）
+    // BRDF LUT 的参数变了会在下次烘焙时重建
+    void SetSettings(const IBLBakeSettings& settings);
+    const IBLBakeSettings& GetSettings() const { return m_Settings; }
+
+    // ---- 运行时切换环境（不卡帧）----
+    // 工作线程解码 HDR 并投影 SH；主线程每帧只做有限几步 GPU 烘焙
+    // （上传 HDR、环境立方体一次分层捕获、一次 mip 生成、prefilter 每个 mip 各算一步）
+    // 全部完成前渲染继续用旧贴图，完成后在同一帧里整体替换，旧贴图随即释放
+    // 再次调用会放弃进行中的切换
+    bool BeginSwap(const std::string& hdrPath);
+    // 每帧调用一次（在画场景之前）；本帧完成切换时返回 true
+    bool UpdateSwap(int stepsPerFrame);
+    void CancelSwap();
+    bool IsSwapping() const { return m_Swap != nullptr; }
+    // 0~1；后台解码期间为 0
+    float GetSwapProgress() const;
+    int SwapStepCount() const;
+    const std::string& GetEnvironmentPath() const { return m_EnvironmentPath; }
+
+    bool HasIrradianceSH() const { return m_HasIrradianceSH; }
+    // 已经卷积并除以 π，pbr.frag 里求值后直接乘 albedo
+    const SH9& GetIrradianceSH() const { return m_IrradianceSH; }
+    double GetSHBakeMs() const { return m_SHBakeMs; }
+
+    // 误差报告：需要时先跑一次卷积 shader，然后读回和 SH 求值对比
+    IrradianceDiff CompareSHWithConvolution();
+    // 读回 BRDF LUT，隔 stride 个 texel 抽查一个，和 CPU 参考比较（同样的采样数和 Hammersley 序列）
+    BRDFLUTDiff CompareBRDFLUT(int stride = 16);
+    // pbr.frag 里 textureLod 的最大 lod
+    float GetPrefilterMaxLod() const;
+    // 把 IBL 交给 pbr.frag：irradiance / prefilter / BRDF LUT 固定在 2 / 3 / 4 号纹理单元
+    // bindTextures = false 只设 uniform（同一帧里已经有别的 shader 绑过这几张贴图）
+    void ApplyToShader(Shader& shader, bool useSH, bool useSpecular, bool bindTextures) const;
+
+    // 最近一次 Bake(hdrPath, cachePath) 的结果：是否命中缓存、总耗时
+    bool WasLoadedFromCache() const { return m_LoadedFromCache; }
+    double GetLastBakeMs() const { return m_LastBakeMs; }
+
     uint32_t GetEnvCubemap()    const { return m_EnvCubemap; }
     uint32_t GetIrradianceMap() const { return m_IrradianceMap; }
     uint32_t GetPrefilterMap()  const { return m_PrefilterMap; }
@@ -18,24 +99,51 @@ public:
 
 private:
     //输入：HDR 全景图（2D 纹理）
-    //输出：m_EnvCubemap（Cubemap，512×512×6）
+    //输出：m_EnvCubemap（Cubemap，envSize²×6，envFormat，完整 mip 链）
     //作用：把球面全景图转成立方体贴图，方便用方向向量采样
-    void BakeCubemap(uint32_t hdrTexID);
+    void BakeCubemap(uint32_t hdrTexID, bool hdrIsRGBE);
     //输入：m_EnvCubemap
-    //输出：m_IrradianceMap（Cubemap，32×32×6）
+    //输出：m_IrradianceMap（Cubemap，irradianceSize²×6）
     //作用：把环境图模糊成"各方向的平均光照"，给漫反射用
     void BakeIrradiance();
+    //输入：HDR 全景图的 CPU 像素
+    //输出：m_IrradianceSH（9 个 RGB 系数）
+    //作用：线程池 + SIMD 做球谐投影，替代上面的卷积
+    void BakeIrradianceSH(const TextureHDR& hdr);
     //输入：m_EnvCubemap
-    //输出：m_PrefilterMap（Cubemap，128×128×6，5 级 mipmap）
+    //输出：m_PrefilterMap（Cubemap，prefilterSize²×6，prefilterMips 级 mipmap）
     //作用：按不同 roughness 分级模糊，给镜面反射用
+    //      GGX 重要性采样 + 按 PDF 选源 mip，采样数随 roughness 增加
     void BakePrefilter();
     //输入：无（纯数学计算）
-    //输出：m_BrdfLUT（2D 纹理，512×512）
+    //输出：m_BrdfLUT（2D 纹理，brdfLUTSize²，RG16F）
     //作用：预计算 Fresnel 和 roughness 对镜面反射的影响
     void BakeBRDFLUT();
 
     void RenderQuad();   // 渲染全屏四边形（BRDF LUT 用）
 
+    // 离屏 FBO 只在真正需要渲染时才创建（缓存命中时一直不需要）
+    void EnsureCaptureFBO();
+    // 释放和环境有关的贴图（BRDF LUT 与环境无关，保留）
+    void ReleaseEnvironmentMaps();
+
+    // 烘焙的最小单位，同步烘焙和分帧切换共用
+    // 捕获都是一次 draw 写满 6 个面：整张立方体的第 mip 层作为分层附件，cubemap.geom 按 gl_Layer 分面
+    // name: 显存统计里的资源名
+    uint32_t CreateCubemap(int size, int mips, uint32_t internalFormat, const char* name);
+    void BeginCapture(uint32_t target, int mip, int size);
+    void EndCapture();
+    void CaptureEnv(uint32_t hdrTexID, bool hdrIsRGBE, uint32_t envCubemap);
+    void GenerateEnvMips(uint32_t envCubemap);
+    void PrefilterMip(uint32_t envCubemap, uint32_t prefilterMap, int mip);
+    // 分帧切换的第 step 步
+    void RunSwapStep(int step);
+
+    bool ComputeCacheKey(const std::string& hdrPath, uint64_t& key) const;
+    // 读：mmap 后逐面/逐 mip 直接 glTexImage2D；写：glGetTexImage 读回成 half
+    bool LoadCache(const std::string& cachePath, uint64_t key);
+    bool SaveCache(const std::string& cachePath, uint64_t key) const;
+
     uint32_t m_EnvCubemap    = 0;
     uint32_t m_IrradianceMap = 0;
     uint32_t m_PrefilterMap  = 0;
@@ -45,6 +153,23 @@ private:
     uint32_t m_CubeVAO = 0, m_CubeVBO = 0;
     uint32_t m_QuadVAO = 0, m_QuadVBO = 0;
 
-    // 离屏渲染用的 FBO
-    uint32_t m_CaptureFBO = 0, m_CaptureRBO = 0;
+    // 离屏渲染用的 FBO（只有颜色附件，不需要深度）
+    uint32_t m_CaptureFBO = 0;
+
+    IBLBakeSettings m_Settings;
+
+    SH9    m_IrradianceSH{};
+    bool   m_HasIrradianceSH = false;
+    double m_SHBakeMs = 0.0;
+
+    bool   m_LoadedFromCache = false;
+    double m_LastBakeMs = 0.0;
+    std::string m_EnvironmentPath;
+
+    // 分帧烘焙时反复用到的 shader，只编译一次
+    std::unique_ptr<Shader> m_EquirectShader;
+    std::unique_ptr<Shader> m_PrefilterShader;
+
+    struct SwapState;
+    std::unique_ptr<SwapState> m_Swap;
 };
@@ -0,0 +1,305 @@
+#include "IBLCache.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+
+static const char          kMagic[8] = { 'R', 'S', 'I', 'B', 'L', 'C', 'H', 'E' };
+// 格式有任何变化都要改这个版本号（旧缓存会被当作未命中）
+static const std::uint32_t kFormatVersion = 1;
+
+struct FileHeader
+{
+    char          magic[8];
+    std::uint32_t version;
+    std::uint32_t entryCount;
+    std::uint64_t key;
+    std::uint32_t hasSH;
+    float         sh[27];
+};
+
+struct EntryHeader
+{
+    std::uint32_t kind;
+    std::uint32_t cube;
+    std::uint32_t internalFormat;
+    std::uint32_t width;
+    std::uint32_t height;
+    std::uint32_t levels;
+    std::uint32_t channels;
+    std::uint32_t reserved;
+    std::uint64_t offset;      // 相对文件开头，16 字节对齐
+    std::uint64_t halfCount;
+};
+
+static std::uint64_t AlignUp16(std::uint64_t v)
+{
+    return (v + 15u) & ~std::uint64_t(15u);
+}
+
+std::size_t IBLCache::Image::FaceHalfCount(int level) const
+{
+    std::size_t w = (std::size_t)std::max(1, width >> level);
+    std::size_t h = (std::size_t)std::max(1, height >> level);
+    return w * h * (std::size_t)channels;
+}
+
+std::size_t IBLCache::Image::TotalHalfCount() const
+{
+    std::size_t total = 0;
+    for (int level = 0; level < levels; ++level)
+        total += FaceHalfCount(level) * (std::size_t)Faces();
+    return total;
+}
+
+std::uint64_t IBLCache::HashBytes(const void* data, std::size_t size, std::uint64_t seed)
+{
+    const std::uint64_t kPrime = 0x100000001b3ull;
+    const std::uint8_t* p = static_cast<const std::uint8_t*>(data);
+    std::uint64_t h = seed;
+
+    std::size_t i = 0;
+    for (; i + 8 <= size; i += 8)
+    {
+        std::uint64_t word;
+        std::memcpy(&word, p + i, 8);
+        h = (h ^ word) * kPrime;
+    }
+    for (; i < size; ++i)
+        h = (h ^ p[i]) * kPrime;
+
+    // 按字处理时高位扩散不够，最后做一次 murmur3 的 fmix64
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdull;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ull;
+    h ^= h >> 33;
+    return h;
+}
+
+bool IBLCache::HashFile(const std::string& path, std::uint64_t& hash, std::uint64_t seed)
+{
+    MappedFile file;
+    if (!file.Open(path)) return false;
+    hash = HashBytes(file.Data(), file.Size(), seed);
+    return true;
+}
+
+const char* IBLCache::FormatName(std::uint32_t internalFormat)
+{
+    switch (internalFormat)
+    {
+        case kFormatRGB16F:     return "RGB16F";
+        case kFormatRG16F:      return "RG16F";
+        case kFormatR11G11B10F: return "R11F_G11F_B10F";
+    }
+    return "?";
+}
+
+int IBLCache::FormatBytesPerTexel(std::uint32_t internalFormat)
+{
+    switch (internalFormat)
+    {
+        case kFormatRGB16F:     return 6;
+        case kFormatRG16F:      return 4;
+        case kFormatR11G11B10F: return 4;
+    }
+    return 16;
+}
+
+bool IBLCache::ComputeKey(const std::string& hdrPath, const IBLBakeSettings& settings,
+                          const std::string& shaderDir, std::uint64_t& key)
+{
+    // 烘焙用到的 shader：源码参与 key
+    static const char* const kBakeShaders[] = {
+        "cubemap.vert",
+        "cubemap.geom",
+        "equirect_to_cubemap.frag",
+        "irradiance_convolution.frag",
+        "prefilter.frag",
+        "brdf_lut.vert",
+        "brdf_lut.frag",
+    };
+
+    std::uint64_t h = 0;
+    if (!HashFile(hdrPath, h)) {
+        std::fprintf(stderr, "[IBLCache] Cannot hash HDR: %s\n", hdrPath.c_str());
+        return false;
+    }
+
+    // 烘焙参数：分辨率、格式、采样数 + 辐照度走 SH9
+    std::vector<std::uint32_t> params = {
+        (std::uint32_t)settings.envSize, (std::uint32_t)settings.irradianceSize, 9u,
+        (std::uint32_t)settings.prefilterSize, (std::uint32_t)settings.prefilterMips,
+        (std::uint32_t)settings.brdfLUTSize, (std::uint32_t)settings.brdfLUTSamples,
+        settings.envFormat, settings.irradianceFormat, settings.prefilterFormat,
+    };
+    for (int mip = 0; mip < settings.prefilterMips && mip < IBLBakeSettings::kMaxPrefilterMips; ++mip)
+        params.push_back((std::uint32_t)settings.prefilterSamples[mip]);
+    h = HashBytes(params.data(), params.size() * sizeof(std::uint32_t), h);
+
+    for (const char* name : kBakeShaders)
+    {
+        std::string shaderPath = shaderDir + "/" + name;
+        if (!HashFile(shaderPath, h, h)) {
+            std::fprintf(stderr, "[IBLCache] Cannot hash shader: %s\n", shaderPath.c_str());
+            return false;
+        }
+    }
+
+    key = h;
+    return true;
+}
+
+bool IBLCache::Write(const std::string& path, std::uint64_t key, const SH9* irradianceSH,
+                     const std::vector<Image>& images)
+{
+    FileHeader header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kFormatVersion;
+    header.entryCount = (std::uint32_t)images.size();
+    header.key = key;
+    header.hasSH = irradianceSH ? 1u : 0u;
+    if (irradianceSH)
+        for (int k = 0; k < 9; ++k)
+            for (int c = 0; c < 3; ++c)
+                header.sh[k * 3 + c] = irradianceSH->coeffs[k][c];
+
+    std::vector<EntryHeader> entries(images.size());
+    std::uint64_t offset = AlignUp16(sizeof(FileHeader) + sizeof(EntryHeader) * entries.size());
+    for (std::size_t i = 0; i < images.size(); ++i)
+    {
+        const Image& img = images[i];
+        EntryHeader& e = entries[i];
+        e = EntryHeader{};
+        e.kind = (std::uint32_t)img.kind;
+        e.cube = img.cube ? 1u : 0u;
+        e.internalFormat = img.internalFormat;
+        e.width = (std::uint32_t)img.width;
+        e.height = (std::uint32_t)img.height;
+        e.levels = (std::uint32_t)img.levels;
+        e.channels = (std::uint32_t)img.channels;
+        e.offset = offset;
+        e.halfCount = img.TotalHalfCount();
+        offset = AlignUp16(offset + e.halfCount * sizeof(std::uint16_t));
+    }
+
+    std::error_code ec;
+    std::filesystem::path target(path);
+    if (target.has_parent_path())
+        std::filesystem::create_directories(target.parent_path(), ec);
+
+    std::string tmpPath = path + ".tmp";
+    std::FILE* f = std::fopen(tmpPath.c_str(), "wb");
+    if (!f) {
+        std::fprintf(stderr, "[IBLCache] Cannot write: %s\n", tmpPath.c_str());
+        return false;
+    }
+
+    static const std::uint8_t kZeros[16] = {};
+    bool ok = std::fwrite(&header, sizeof(header), 1, f) == 1;
+    if (!entries.empty())
+        ok = ok && std::fwrite(entries.data(), sizeof(EntryHeader), entries.size(), f) == entries.size();
+
+    std::uint64_t written = sizeof(FileHeader) + sizeof(EntryHeader) * entries.size();
+    for (std::size_t i = 0; i < images.size() && ok; ++i)
+    {
+        std::size_t pad = (std::size_t)(entries[i].offset - written);
+        ok = ok && (pad == 0 || std::fwrite(kZeros, 1, pad, f) == pad);
+        ok = ok && std::fwrite(images[i].data, sizeof(std::uint16_t), entries[i].halfCount, f) == entries[i].halfCount;
+        written = entries[i].offset + entries[i].halfCount * sizeof(std::uint16_t);
+    }
+    ok = (std::fclose(f) == 0) && ok;
+
+    if (ok) {
+        std::filesystem::rename(tmpPath, target, ec);
+        ok = !ec;
+    }
+    if (!ok) {
+        std::filesystem::remove(tmpPath, ec);
+        std::fprintf(stderr, "[IBLCache] Failed to write: %s\n", path.c_str());
+    }
+    return ok;
+}
+
+bool IBLCache::Open(const std::string& path, std::uint64_t expectedKey)
+{
+    if (!Open(path)) return false;
+    if (m_Key != expectedKey) {
+        Close();
+        return false;
+    }
+    return true;
+}
+
+bool IBLCache::Open(const std::string& path)
+{
+    Close();
+    if (!m_File.Open(path)) return false;
+
+    const std::uint8_t* base = m_File.Data();
+    std::size_t size = m_File.Size();
+
+    FileHeader header;
+    if (size < sizeof(header)) { Close(); return false; }
+    std::memcpy(&header, base, sizeof(header));
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 ||
+        header.version != kFormatVersion) {
+        Close();
+        return false;
+    }
+
+    std::size_t tableEnd = sizeof(FileHeader) + sizeof(EntryHeader) * (std::size_t)header.entryCount;
+    if (header.entryCount > 64 || tableEnd > size) { Close(); return false; }
+
+    for (std::uint32_t i = 0; i < header.entryCount; ++i)
+    {
+        EntryHeader e;
+        std::memcpy(&e, base + sizeof(FileHeader) + sizeof(EntryHeader) * i, sizeof(e));
+
+        Image img;
+        img.kind = (Kind)e.kind;
+        img.cube = e.cube != 0;
+        img.internalFormat = e.internalFormat;
+        img.width = (int)e.width;
+        img.height = (int)e.height;
+        img.levels = (int)e.levels;
+        img.channels = (int)e.channels;
+
+        // 头里的数字和数据区对不上就当坏文件
+        bool sane = img.width > 0 && img.height > 0 && img.levels > 0 && img.levels <= 16 &&
+                    (img.channels == 2 || img.channels == 3) && (e.offset & 15u) == 0 &&
+                    e.halfCount == img.TotalHalfCount() &&
+                    e.offset >= tableEnd && e.offset + e.halfCount * sizeof(std::uint16_t) <= size;
+        if (!sane) {
+            std::fprintf(stderr, "[IBLCache] Corrupt entry %u in %s\n", i, path.c_str());
+            Close();
+            return false;
+        }
+
+        img.data = reinterpret_cast<const std::uint16_t*>(base + e.offset);
+        m_Images.push_back(img);
+    }
+
+    m_Key = header.key;
+    m_HasSH = header.hasSH != 0;
+    for (int k = 0; k < 9; ++k)
+        m_SH.coeffs[k] = glm::vec3(header.sh[k * 3 + 0], header.sh[k * 3 + 1], header.sh[k * 3 + 2]);
+    return true;
+}
+
+void IBLCache::Close()
+{
+    m_File.Close();
+    m_Images.clear();
+    m_HasSH = false;
+    m_Key = 0;
+}
+
+const IBLCache::Image* IBLCache::Find(Kind kind) const
+{
+    for (const Image& img : m_Images)
+        if (img.kind == kind) return &img;
+    return nullptr;
+}
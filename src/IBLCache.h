@@ -0,0 +1,123 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "IBLMath.h"
+#include "MappedFile.h"
+
+struct IBLBakeSettings;
+
+// IBLCache：IBL 烘焙结果的缓存文件（.iblcache）
+// 纯 CPU 代码，不碰 GL：IBLBaker 负责读回/上传，离线工具也能直接写同样的格式
+// 布局（小端）：
+//   FileHeader
+//   EntryHeader × entryCount
+//   像素数据：每个条目 16 字节对齐；mip 从大到小，每个 mip 内依次是各个面（+X,-X,+Y,-Y,+Z,-Z），half
+// 读取时整个文件 mmap 进来，Image::data 直接指向映射内存，上传时不再拷贝
+class IBLCache
+{
+public:
+    enum class Kind : std::uint32_t
+    {
+        EnvCubemap = 0,
+        Irradiance = 1,
+        Prefilter  = 2,
+        BrdfLUT    = 3,
+    };
+
+    struct Image
+    {
+        Kind kind = Kind::EnvCubemap;
+        bool cube = true;                   // false：普通 2D 纹理（BRDF LUT）
+        std::uint32_t internalFormat = 0;   // GL 内部格式枚举值，原样交给 glTexImage2D
+        int width = 0;
+        int height = 0;
+        int levels = 1;
+        int channels = 3;                   // 3 = RGB，2 = RG
+        const std::uint16_t* data = nullptr;
+
+        int Faces() const { return cube ? 6 : 1; }
+        // 第 level 层单个面的 half 个数
+        std::size_t FaceHalfCount(int level) const;
+        // 所有 mip、所有面加起来的 half 个数
+        std::size_t TotalHalfCount() const;
+    };
+
+    // Image::internalFormat 用到的 GL 枚举值（离线工具不包含 GL 头）
+    static constexpr std::uint32_t kFormatRGB16F = 0x881B;
+    static constexpr std::uint32_t kFormatRG16F  = 0x822F;
+    static constexpr std::uint32_t kFormatR11G11B10F = 0x8C3A;
+    // 日志用的格式名和每 texel 字节数（未知格式按 RGBA32F 估）
+    static const char* FormatName(std::uint32_t internalFormat);
+    static int FormatBytesPerTexel(std::uint32_t internalFormat);
+
+    // 64 位哈希（FNV-1a，按 8 字节一组吃数据，最后再混一次）
+    static constexpr std::uint64_t kHashSeed = 0xcbf29ce484222325ull;
+    static std::uint64_t HashBytes(const void* data, std::size_t size, std::uint64_t seed = kHashSeed);
+    // 整个文件内容的哈希（mmap 读）；文件不存在返回 false
+    static bool HashFile(const std::string& path, std::uint64_t& hash, std::uint64_t seed = kHashSeed);
+
+    // 缓存 key = HDR 文件内容哈希 + 烘焙参数 + 烘焙 shader 源码哈希（shaderDir 下）
+    // 改 shader 或参数后旧缓存自动失效；离线烘焙用同一个 key，运行时可以直接命中
+    static bool ComputeKey(const std::string& hdrPath, const IBLBakeSettings& settings,
+                           const std::string& shaderDir, std::uint64_t& key);
+
+    // 写缓存：先写 path.tmp 再改名，写到一半退出也不会留下坏文件
+    static bool Write(const std::string& path, std::uint64_t key, const SH9* irradianceSH,
+                      const std::vector<Image>& images);
+
+    IBLCache() = default;
+    IBLCache(const IBLCache&) = delete;
+    IBLCache& operator=(const IBLCache&) = delete;
+
+    // 打开并校验：文件不存在、版本/key 不符或大小对不上都返回 false
+    bool Open(const std::string& path, std::uint64_t expectedKey);
+    // 不校验 key（对比工具用）
+    bool Open(const std::string& path);
+    void Close();
+
+    const Image* Find(Kind kind) const;
+    const std::vector<Image>& Images() const { return m_Images; }
+    bool HasIrradianceSH() const { return m_HasSH; }
+    const SH9& GetIrradianceSH() const { return m_SH; }
+    std::size_t FileSize() const { return m_File.Size(); }
+    std::uint64_t Key() const { return m_Key; }
+
+private:
+    MappedFile m_File;
+    std::vector<Image> m_Images;
+    SH9 m_SH{};
+    bool m_HasSH = false;
+    std::uint64_t m_Key = 0;
+};
+
+// IBL 烘焙参数：运行时 IBLBaker 和离线 iblbake 共用，全部参与缓存 key
+struct IBLBakeSettings
+{
+    static constexpr int kMaxPrefilterMips = 8;
+
+    int envSize = 512;
+    int irradianceSize = 32;
+    int prefilterSize = 128;
+    int prefilterMips = 5;
+    // 每个 prefilter mip 的采样数：源 mip 按 PDF 选，少量样本就够平滑；
+    // 粗糙的 mip 分辨率低、波瓣宽，多给样本总开销也不大
+    int prefilterSamples[kMaxPrefilterMips] = { 1, 32, 64, 128, 256, 256, 256, 256 };
+    int brdfLUTSize = 512;
+    int brdfLUTSamples = 512;
+    // 立方体贴图的 GL 内部格式（IBLCache::kFormat*）；R11F_G11F_B10F 比 RGB16F 省 1/3 显存，
+    // 精度（5~6 位尾数）对环境光足够。BRDF LUT 固定 RG16F
+    std::uint32_t envFormat = IBLCache::kFormatRGB16F;
+    std::uint32_t irradianceFormat = IBLCache::kFormatRGB16F;
+    std::uint32_t prefilterFormat = IBLCache::kFormatRGB16F;
+
+    // 环境立方体完整 mip 链的层数（512 -> 1）
+    int EnvMips() const
+    {
+        int mips = 1;
+        while ((envSize >> mips) > 0) mips++;
+        return mips;
+    }
+};
@@ -0,0 +1,558 @@
+#include "IBLMath.h"
+
+#include "HalfFloat.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+static const float kPi = 3.14159265358979f;
+
+// 实数 SH 基函数常数
+static const float kY00 = 0.282095f;
+static const float kY1  = 0.488603f;
+static const float kY2n = 1.092548f;  // xy, yz, xz
+static const float kY20 = 0.315392f;  // 3z^2 - 1
+static const float kY22 = 0.546274f;  // x^2 - y^2
+
+// 一行里和列相关的 6 个矩：Σc、Σc·x、Σc·z、Σc·xz、Σc·x²、Σc·z²（c = R/G/B）
+// 同一行的仰角相同，y 是常数，所以 SH 的 9 项都能由这些矩组合出来
+struct RowMoments
+{
+    float s0[3], sx[3], sz[3], sxz[3], sxx[3], szz[3];
+};
+
+static void AccumulateRow(const float* r, const float* g, const float* b,
+                          const float* cosPhi, const float* sinPhi,
+                          float cosElev, int width, RowMoments& out)
+{
+    const float* ch[3] = { r, g, b };
+    int x0 = 0;
+
+#if defined(__AVX2__)
+    // 8 列一组：x = cosE·cosφ，z = cosE·sinφ
+    __m256 acc[6][3];
+    for (int m = 0; m < 6; ++m)
+        for (int c = 0; c < 3; ++c)
+            acc[m][c] = _mm256_setzero_ps();
+
+    const __m256 ce = _mm256_set1_ps(cosElev);
+    for (; x0 + 8 <= width; x0 += 8)
+    {
+        __m256 x = _mm256_mul_ps(ce, _mm256_loadu_ps(cosPhi + x0));
+        __m256 z = _mm256_mul_ps(ce, _mm256_loadu_ps(sinPhi + x0));
+        __m256 xz = _mm256_mul_ps(x, z);
+        __m256 xx = _mm256_mul_ps(x, x);
+        __m256 zz = _mm256_mul_ps(z, z);
+        for (int c = 0; c < 3; ++c)
+        {
+            __m256 v = _mm256_loadu_ps(ch[c] + x0);
+            acc[0][c] = _mm256_add_ps(acc[0][c], v);
+            acc[1][c] = _mm256_fmadd_ps(v, x, acc[1][c]);
+            acc[2][c] = _mm256_fmadd_ps(v, z, acc[2][c]);
+            acc[3][c] = _mm256_fmadd_ps(v, xz, acc[3][c]);
+            acc[4][c] = _mm256_fmadd_ps(v, xx, acc[4][c]);
+            acc[5][c] = _mm256_fmadd_ps(v, zz, acc[5][c]);
+        }
+    }
+
+    float* dst[6] = { out.s0, out.sx, out.sz, out.sxz, out.sxx, out.szz };
+    for (int m = 0; m < 6; ++m)
+    {
+        for (int c = 0; c < 3; ++c)
+        {
+            alignas(32) float lanes[8];
+            _mm256_store_ps(lanes, acc[m][c]);
+            dst[m][c] = lanes[0] + lanes[1] + lanes[2] + lanes[3]
+                      + lanes[4] + lanes[5] + lanes[6] + lanes[7];
+        }
+    }
+#else
+    for (int c = 0; c < 3; ++c)
+        out.s0[c] = out.sx[c] = out.sz[c] = out.sxz[c] = out.sxx[c] = out.szz[c] = 0.0f;
+#endif
+
+    for (int i = x0; i < width; ++i)
+    {
+        float x = cosElev * cosPhi[i];
+        float z = cosElev * sinPhi[i];
+        for (int c = 0; c < 3; ++c)
+        {
+            float v = ch[c][i];
+            out.s0[c]  += v;
+            out.sx[c]  += v * x;
+            out.sz[c]  += v * z;
+            out.sxz[c] += v * x * z;
+            out.sxx[c] += v * x * x;
+            out.szz[c] += v * z * z;
+        }
+    }
+}
+
+SH9 ProjectEquirectToSH9(const std::uint16_t* halfRGB, int width, int height, ThreadPool* pool)
+{
+    SH9 result{};
+    if (!halfRGB || width <= 0 || height <= 0) return result;
+
+    // 每列的方位角：u = (i + 0.5) / w，φ = (u - 0.5) · 2π，满足 atan(z, x) = φ
+    std::vector<float> cosPhi(width), sinPhi(width);
+    for (int i = 0; i < width; ++i)
+    {
+        float phi = (((float)i + 0.5f) / (float)width - 0.5f) * 2.0f * kPi;
+        cosPhi[i] = std::cos(phi);
+        sinPhi[i] = std::sin(phi);
+    }
+
+    // 每个像素的立体角 = (2π / w)(π / h) cosE
+    const float pixelArea = (2.0f * kPi / (float)width) * (kPi / (float)height);
+
+    std::mutex mergeMutex;
+    double total[9][3] = {};
+
+    auto projectRows = [&](int begin, int end) {
+        std::vector<float> rgb((std::size_t)width * 3);
+        std::vector<float> r(width), g(width), b(width);
+        double local[9][3] = {};
+
+        for (int row = begin; row < end; ++row)
+        {
+            HalfToFloatArray(halfRGB + (std::size_t)row * width * 3, rgb.data(), rgb.size());
+            for (int i = 0; i < width; ++i)
+            {
+                r[i] = rgb[i * 3 + 0];
+                g[i] = rgb[i * 3 + 1];
+                b[i] = rgb[i * 3 + 2];
+            }
+
+            // v = (row + 0.5) / h，仰角 E = (v - 0.5) · π，y = sinE
+            float elev = (((float)row + 0.5f) / (float)height - 0.5f) * kPi;
+            float y = std::sin(elev);
+            float cosE = std::cos(elev);
+            float weight = pixelArea * cosE;
+
+            RowMoments m;
+            AccumulateRow(r.data(), g.data(), b.data(), cosPhi.data(), sinPhi.data(), cosE, width, m);
+
+            for (int c = 0; c < 3; ++c)
+            {
+                local[0][c] += weight * kY00 * m.s0[c];
+                local[1][c] += weight * kY1 * y * m.s0[c];
+                local[2][c] += weight * kY1 * m.sz[c];
+                local[3][c] += weight * kY1 * m.sx[c];
+                local[4][c] += weight * kY2n * y * m.sx[c];
+                local[5][c] += weight * kY2n * y * m.sz[c];
+                local[6][c] += weight * kY20 * (3.0f * m.szz[c] - m.s0[c]);
+                local[7][c] += weight * kY2n * m.sxz[c];
+                local[8][c] += weight * kY22 * (m.sxx[c] - y * y * m.s0[c]);
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(mergeMutex);
+        for (int k = 0; k < 9; ++k)
+            for (int c = 0; c < 3; ++c)
+                total[k][c] += local[k][c];
+    };
+
+    if (pool)
+        pool->ParallelFor(height, projectRows, 8);
+    else
+        projectRows(0, height);
+
+    for (int k = 0; k < 9; ++k)
+        result.coeffs[k] = glm::vec3((float)total[k][0], (float)total[k][1], (float)total[k][2]);
+    return result;
+}
+
+SH9 RadianceToIrradianceSH9(const SH9& radiance)
+{
+    // A0 = π, A1 = 2π/3, A2 = π/4，再统一除以 π
+    static const float kBand[9] = {
+        1.0f,
+        2.0f / 3.0f, 2.0f / 3.0f, 2.0f / 3.0f,
+        0.25f, 0.25f, 0.25f, 0.25f, 0.25f,
+    };
+
+    SH9 out;
+    for (int k = 0; k < 9; ++k)
+        out.coeffs[k] = radiance.coeffs[k] * kBand[k];
+    return out;
+}
+
+glm::vec3 EvalSH9(const SH9& sh, const glm::vec3& n)
+{
+    glm::vec3 result = sh.coeffs[0] * kY00
+                     + sh.coeffs[1] * (kY1 * n.y)
+                     + sh.coeffs[2] * (kY1 * n.z)
+                     + sh.coeffs[3] * (kY1 * n.x)
+                     + sh.coeffs[4] * (kY2n * n.x * n.y)
+                     + sh.coeffs[5] * (kY2n * n.y * n.z)
+                     + sh.coeffs[6] * (kY20 * (3.0f * n.z * n.z - 1.0f))
+                     + sh.coeffs[7] * (kY2n * n.x * n.z)
+                     + sh.coeffs[8] * (kY22 * (n.x * n.x - n.y * n.y));
+    return glm::max(result, glm::vec3(0.0f));
+}
+
+glm::vec3 CubeFaceDirection(int face, float u, float v)
+{
+    // OpenGL 规范 8.13：sc/tc ∈ [-1, 1]
+    float sc = 2.0f * u - 1.0f;
+    float tc = 2.0f * v - 1.0f;
+    switch (face)
+    {
+        case 0:  return glm::vec3( 1.0f, -tc, -sc);  // +X
+        case 1:  return glm::vec3(-1.0f, -tc,  sc);  // -X
+        case 2:  return glm::vec3(  sc, 1.0f,  tc);  // +Y
+        case 3:  return glm::vec3(  sc, -1.0f, -tc); // -Y
+        case 4:  return glm::vec3(  sc, -tc, 1.0f);  // +Z
+        default: return glm::vec3( -sc, -tc, -1.0f); // -Z
+    }
+}
+
+glm::vec2 Hammersley(std::uint32_t i, std::uint32_t n)
+{
+    std::uint32_t bits = i;
+    bits = (bits << 16u) | (bits >> 16u);
+    bits = ((bits & 0x55555555u) << 1u) | ((bits & 0xAAAAAAAAu) >> 1u);
+    bits = ((bits & 0x33333333u) << 2u) | ((bits & 0xCCCCCCCCu) >> 2u);
+    bits = ((bits & 0x0F0F0F0Fu) << 4u) | ((bits & 0xF0F0F0F0u) >> 4u);
+    bits = ((bits & 0x00FF00FFu) << 8u) | ((bits & 0xFF00FF00u) >> 8u);
+    return glm::vec2((float)i / (float)n, (float)bits * 2.3283064365386963e-10f);
+}
+
+glm::vec3 ImportanceSampleGGX(const glm::vec2& xi, float roughness)
+{
+    float a = roughness * roughness;
+
+    float phi      = 2.0f * kPi * xi.x;
+    float cosTheta = std::sqrt((1.0f - xi.y) / (1.0f + (a * a - 1.0f) * xi.y));
+    float sinTheta = std::sqrt(1.0f - cosTheta * cosTheta);
+
+    return glm::vec3(std::cos(phi) * sinTheta, std::sin(phi) * sinTheta, cosTheta);
+}
+
+// IBL 用的 k = a / 2
+static float GeometrySchlickGGX_IBL(float NdotV, float roughness)
+{
+    float k = (roughness * roughness) / 2.0f;
+    return NdotV / (NdotV * (1.0f - k) + k);
+}
+
+glm::vec2 IntegrateBRDF(float NdotV, float roughness, int sampleCount)
+{
+    glm::vec3 v(std::sqrt(1.0f - NdotV * NdotV), 0.0f, NdotV);
+
+    float A = 0.0f;
+    float B = 0.0f;
+    for (int i = 0; i < sampleCount; ++i)
+    {
+        glm::vec2 xi = Hammersley((std::uint32_t)i, (std::uint32_t)sampleCount);
+        glm::vec3 h  = ImportanceSampleGGX(xi, roughness);
+        glm::vec3 l  = glm::normalize(2.0f * glm::dot(v, h) * h - v);
+
+        float NdotL = std::max(l.z, 0.0f);
+        float NdotH = std::max(h.z, 0.0f);
+        float VdotH = std::max(glm::dot(v, h), 0.0f);
+        if (NdotL > 0.0f)
+        {
+            float G = GeometrySchlickGGX_IBL(NdotV, roughness) * GeometrySchlickGGX_IBL(NdotL, roughness);
+            float G_Vis = (G * VdotH) / (NdotH * NdotV);
+            float Fc = std::pow(1.0f - VdotH, 5.0f);
+            A += (1.0f - Fc) * G_Vis;
+            B += Fc * G_Vis;
+        }
+    }
+    return glm::vec2(A, B) / (float)sampleCount;
+}
+
+std::vector<float> BakeBRDFLUTReference(int size, int sampleCount, ThreadPool* pool)
+{
+    std::vector<float> lut((std::size_t)size * size * 2);
+    auto bakeRows = [&](int begin, int end) {
+        std::vector<glm::vec3> hs((std::size_t)sampleCount);
+        for (int y = begin; y < end; ++y)
+        {
+            // 同一行 roughness 相同，半程向量序列和 N·V 无关，整行共用
+            float roughness = ((float)y + 0.5f) / (float)size;
+            for (int i = 0; i < sampleCount; ++i)
+                hs[i] = ImportanceSampleGGX(Hammersley((std::uint32_t)i, (std::uint32_t)sampleCount), roughness);
+
+            float k = (roughness * roughness) / 2.0f;
+            for (int x = 0; x < size; ++x)
+            {
+                float NdotV = ((float)x + 0.5f) / (float)size;
+                glm::vec3 v(std::sqrt(1.0f - NdotV * NdotV), 0.0f, NdotV);
+                float gv = NdotV / (NdotV * (1.0f - k) + k);
+
+                float A = 0.0f;
+                float B = 0.0f;
+                for (const glm::vec3& h : hs)
+                {
+                    float VdotH = glm::dot(v, h);
+                    float NdotL = 2.0f * VdotH * h.z - v.z;   // L = 2(V·H)H - V 的 z 分量
+                    if (NdotL <= 0.0f) continue;
+                    VdotH = std::max(VdotH, 0.0f);
+
+                    float G = gv * (NdotL / (NdotL * (1.0f - k) + k));
+                    float G_Vis = (G * VdotH) / (h.z * NdotV);
+                    float t = 1.0f - VdotH;
+                    float Fc = t * t * t * t * t;
+                    A += (1.0f - Fc) * G_Vis;
+                    B += Fc * G_Vis;
+                }
+
+                float* dst = &lut[((std::size_t)y * size + x) * 2];
+                dst[0] = A / (float)sampleCount;
+                dst[1] = B / (float)sampleCount;
+            }
+        }
+    };
+
+    if (pool)
+        pool->ParallelFor(size, bakeRows, 1);
+    else
+        bakeRows(0, size);
+    return lut;
+}
+
+void CubemapF::Allocate(int faceSize, int levelCount)
+{
+    size = faceSize;
+    levels = levelCount;
+    faces.assign((std::size_t)levelCount * 6, std::vector<float>());
+    for (int level = 0; level < levelCount; ++level)
+    {
+        std::size_t s = (std::size_t)LevelSize(level);
+        for (int face = 0; face < 6; ++face)
+            faces[(std::size_t)level * 6 + face].assign(s * s * 3, 0.0f);
+    }
+}
+
+// 双线性采样一张 RGB float 图，坐标是 texel 单位（texel 中心在 +0.5），边缘 clamp
+static void SampleBilinear(const float* img, int w, int h, float x, float y, float out[3])
+{
+    x -= 0.5f;
+    y -= 0.5f;
+    float fx = std::floor(x), fy = std::floor(y);
+    float tx = x - fx, ty = y - fy;
+    int x0 = std::min(std::max((int)fx, 0), w - 1);
+    int y0 = std::min(std::max((int)fy, 0), h - 1);
+    int x1 = std::min(std::max((int)fx + 1, 0), w - 1);
+    int y1 = std::min(std::max((int)fy + 1, 0), h - 1);
+
+    const float* p00 = img + ((std::size_t)y0 * w + x0) * 3;
+    const float* p10 = img + ((std::size_t)y0 * w + x1) * 3;
+    const float* p01 = img + ((std::size_t)y1 * w + x0) * 3;
+    const float* p11 = img + ((std::size_t)y1 * w + x1) * 3;
+    for (int c = 0; c < 3; ++c)
+    {
+        float top = p00[c] + (p10[c] - p00[c]) * tx;
+        float bottom = p01[c] + (p11[c] - p01[c]) * tx;
+        out[c] = top + (bottom - top) * ty;
+    }
+}
+
+void EquirectToCubemap(const std::uint16_t* halfRGB, int width, int height, CubemapF& cube, ThreadPool* pool)
+{
+    if (!halfRGB || cube.levels == 0) return;
+
+    // 先整体转成 float（F16C 批量转换），采样时不用逐像素解 half
+    std::vector<float> src((std::size_t)width * height * 3);
+    auto convertRows = [&](int begin, int end) {
+        std::size_t rowHalfs = (std::size_t)width * 3;
+        HalfToFloatArray(halfRGB + (std::size_t)begin * rowHalfs, src.data() + (std::size_t)begin * rowHalfs,
+                         (std::size_t)(end - begin) * rowHalfs);
+    };
+    if (pool) pool->ParallelFor(height, convertRows, 16);
+    else convertRows(0, height);
+
+    const int size = cube.size;
+    // 6 个面的所有行一起切块
+    auto resampleRows = [&](int begin, int end) {
+        for (int r = begin; r < end; ++r)
+        {
+            int face = r / size;
+            int y = r % size;
+            float* dst = cube.Face(0, face) + (std::size_t)y * size * 3;
+            for (int x = 0; x < size; ++x)
+            {
+                glm::vec3 d = glm::normalize(CubeFaceDirection(face, ((float)x + 0.5f) / size, ((float)y + 0.5f) / size));
+                // 和 equirect_to_cubemap.frag 一样：uv = (atan(z, x) / 2π + 0.5, asin(y) / π + 0.5)
+                float u = std::atan2(d.z, d.x) / (2.0f * kPi) + 0.5f;
+                float v = std::asin(std::min(std::max(d.y, -1.0f), 1.0f)) / kPi + 0.5f;
+                SampleBilinear(src.data(), width, height, u * width, v * height, dst + (std::size_t)x * 3);
+            }
+        }
+    };
+    if (pool) pool->ParallelFor(size * 6, resampleRows, 4);
+    else resampleRows(0, size * 6);
+}
+
+void GenerateCubemapMips(CubemapF& cube, ThreadPool* pool)
+{
+    for (int level = 1; level < cube.levels; ++level)
+    {
+        int srcSize = cube.LevelSize(level - 1);
+        int dstSize = cube.LevelSize(level);
+        auto downsample = [&](int begin, int end) {
+            for (int r = begin; r < end; ++r)
+            {
+                int face = r / dstSize;
+                int y = r % dstSize;
+                const float* src = cube.Face(level - 1, face);
+                float* dst = cube.Face(level, face) + (std::size_t)y * dstSize * 3;
+                int y0 = std::min(y * 2, srcSize - 1);
+                int y1 = std::min(y * 2 + 1, srcSize - 1);
+                const float* row0 = src + (std::size_t)y0 * srcSize * 3;
+                const float* row1 = src + (std::size_t)y1 * srcSize * 3;
+                for (int x = 0; x < dstSize; ++x)
+                {
+                    int x0 = std::min(x * 2, srcSize - 1) * 3;
+                    int x1 = std::min(x * 2 + 1, srcSize - 1) * 3;
+                    for (int c = 0; c < 3; ++c)
+                        dst[x * 3 + c] = 0.25f * (row0[x0 + c] + row0[x1 + c] + row1[x0 + c] + row1[x1 + c]);
+                }
+            }
+        };
+        if (pool) pool->ParallelFor(dstSize * 6, downsample, 8);
+        else downsample(0, dstSize * 6);
+    }
+}
+
+// 方向 -> (面, u, v)，CubeFaceDirection 的逆（OpenGL 规范 8.13）
+static int DirectionToFace(const glm::vec3& d, float& u, float& v)
+{
+    float ax = std::fabs(d.x), ay = std::fabs(d.y), az = std::fabs(d.z);
+    int face;
+    float sc, tc, ma;
+    if (ax >= ay && ax >= az) {
+        ma = ax;
+        if (d.x > 0.0f) { face = 0; sc = -d.z; tc = -d.y; }
+        else            { face = 1; sc =  d.z; tc = -d.y; }
+    } else if (ay >= az) {
+        ma = ay;
+        if (d.y > 0.0f) { face = 2; sc = d.x; tc =  d.z; }
+        else            { face = 3; sc = d.x; tc = -d.z; }
+    } else {
+        ma = az;
+        if (d.z > 0.0f) { face = 4; sc =  d.x; tc = -d.y; }
+        else            { face = 5; sc = -d.x; tc = -d.y; }
+    }
+    u = 0.5f * (sc / ma + 1.0f);
+    v = 0.5f * (tc / ma + 1.0f);
+    return face;
+}
+
+glm::vec3 SampleCubemap(const CubemapF& cube, const glm::vec3& dir, float lod)
+{
+    float u, v;
+    int face = DirectionToFace(dir, u, v);
+
+    lod = std::min(std::max(lod, 0.0f), (float)(cube.levels - 1));
+    int l0 = (int)lod;
+    int l1 = std::min(l0 + 1, cube.levels - 1);
+    float t = lod - (float)l0;
+
+    float a[3], b[3];
+    int s0 = cube.LevelSize(l0);
+    SampleBilinear(cube.Face(l0, face), s0, s0, u * s0, v * s0, a);
+    if (t <= 0.0f || l1 == l0)
+        return glm::vec3(a[0], a[1], a[2]);
+
+    int s1 = cube.LevelSize(l1);
+    SampleBilinear(cube.Face(l1, face), s1, s1, u * s1, v * s1, b);
+    return glm::vec3(a[0] + (b[0] - a[0]) * t, a[1] + (b[1] - a[1]) * t, a[2] + (b[2] - a[2]) * t);
+}
+
+void PrefilterCubemapLevel(const CubemapF& env, CubemapF& out, int level, float roughness,
+                           int sampleCount, ThreadPool* pool)
+{
+    // 1) 切线空间（N = +Z）里的采样方向、权重和源 mip，和 prefilter.frag 同样的公式
+    struct Tap
+    {
+        glm::vec3 l;
+        float weight;   // N·L
+        float lod;
+    };
+    const int outSize = out.LevelSize(level);
+    const float envSize = (float)env.size;
+    const float saTexel = 4.0f * kPi / (6.0f * envSize * envSize);
+    const float minMip = std::max(std::log2(envSize / (float)outSize), 0.0f);
+    const float a2 = roughness * roughness * roughness * roughness;
+
+    std::vector<Tap> taps;
+    taps.reserve(sampleCount);
+    const glm::vec3 n(0.0f, 0.0f, 1.0f);
+    for (int i = 0; i < sampleCount; ++i)
+    {
+        glm::vec3 h = ImportanceSampleGGX(Hammersley((std::uint32_t)i, (std::uint32_t)sampleCount), roughness);
+        glm::vec3 l = glm::normalize(2.0f * h.z * h - n);
+        if (l.z <= 0.0f) continue;
+
+        float NdotH = std::max(h.z, 0.0f);
+        float denom = NdotH * NdotH * (a2 - 1.0f) + 1.0f;
+        float D = a2 / (kPi * denom * denom);
+        float pdf = D * NdotH / (4.0f * NdotH) + 0.0001f;
+        float saSample = 1.0f / ((float)sampleCount * pdf + 0.0001f);
+        float lod = roughness == 0.0f ? 0.0f : 0.5f * std::log2(saSample / saTexel) + 1.0f;
+        taps.push_back({ l, l.z, std::max(lod, minMip) });
+    }
+
+    // 2) 每个 texel：建和 prefilter.frag 相同的切线基，只在这里变换一次后采样
+    auto filterRows = [&](int begin, int end) {
+        for (int r = begin; r < end; ++r)
+        {
+            int face = r / outSize;
+            int y = r % outSize;
+            float* dst = out.Face(level, face) + (std::size_t)y * outSize * 3;
+            for (int x = 0; x < outSize; ++x)
+            {
+                glm::vec3 N = glm::normalize(CubeFaceDirection(face, ((float)x + 0.5f) / outSize, ((float)y + 0.5f) / outSize));
+                glm::vec3 up        = std::fabs(N.z) < 0.999f ? glm::vec3(0.0f, 0.0f, 1.0f) : glm::vec3(1.0f, 0.0f, 0.0f);
+                glm::vec3 tangent   = glm::normalize(glm::cross(up, N));
+                glm::vec3 bitangent = glm::cross(N, tangent);
+
+                glm::vec3 color(0.0f);
+                float totalWeight = 0.0f;
+                for (const Tap& tap : taps)
+                {
+                    glm::vec3 L = tangent * tap.l.x + bitangent * tap.l.y + N * tap.l.z;
+                    color += SampleCubemap(env, L, tap.lod) * tap.weight;
+                    totalWeight += tap.weight;
+                }
+                color /= std::max(totalWeight, 0.0001f);
+                dst[x * 3 + 0] = color.x;
+                dst[x * 3 + 1] = color.y;
+                dst[x * 3 + 2] = color.z;
+            }
+        }
+    };
+    if (pool) pool->ParallelFor(outSize * 6, filterRows, 1);
+    else filterRows(0, outSize * 6);
+}
+
+void EvalSH9ToCubemap(const SH9& sh, CubemapF& out)
+{
+    int size = out.LevelSize(0);
+    for (int face = 0; face < 6; ++face)
+    {
+        float* dst = out.Face(0, face);
+        for (int y = 0; y < size; ++y)
+        {
+            for (int x = 0; x < size; ++x)
+            {
+                glm::vec3 d = glm::normalize(CubeFaceDirection(face, ((float)x + 0.5f) / size, ((float)y + 0.5f) / size));
+                glm::vec3 e = EvalSH9(sh, d);
+                float* p = dst + ((std::size_t)y * size + x) * 3;
+                p[0] = e.x;
+                p[1] = e.y;
+                p[2] = e.z;
+            }
+        }
+    }
+}
@@ -0,0 +1,81 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+class ThreadPool;
+
+// IBLMath：IBL 相关的 CPU 端数学，IBLBaker 和离线工具共用
+// 方向约定和 shader 保持一致：
+// - 全景图：uv = (atan(z, x) / 2π + 0.5, asin(y) / π + 0.5)，与 equirect_to_cubemap.frag 相同
+// - 立方体贴图：OpenGL 规范里的面朝向（IBLBaker 的 s_CaptureViews 就是按它摆的）
+
+// 9 系数（l <= 2）球谐，每个系数一个 RGB
+struct SH9
+{
+    glm::vec3 coeffs[9];
+};
+
+// 全景图（RGB half，行顺序与上传的纹理一致，即 v = 0 在第 0 行）投影到 SH9 辐射度
+// 按行分给线程池，行内用 SIMD 累加；pool 为空时单线程
+SH9 ProjectEquirectToSH9(const std::uint16_t* halfRGB, int width, int height, ThreadPool* pool);
+
+// 辐射度 SH -> 辐照度 SH（Ramamoorthi & Hanrahan 的余弦卷积 A_l），
+// 并除以 π，使 EvalSH9 的结果和 irradiance_convolution.frag 输出的量纲一致（pbr.frag 直接乘 albedo）
+SH9 RadianceToIrradianceSH9(const SH9& radiance);
+
+// 在方向 n（单位向量）上求值
+glm::vec3 EvalSH9(const SH9& sh, const glm::vec3& n);
+
+// 立方体第 face 面（+X,-X,+Y,-Y,+Z,-Z）上 (u, v) ∈ [0,1] 对应的方向（未归一化）
+// v = 0 对应 glGetTexImage 读回的第 0 行
+glm::vec3 CubeFaceDirection(int face, float u, float v);
+
+// ---- 镜面 IBL（分裂求和），和 prefilter.frag / brdf_lut.frag 逐行对应 ----
+
+// Hammersley 低差异序列的第 i 个点（共 n 个）
+glm::vec2 Hammersley(std::uint32_t i, std::uint32_t n);
+
+// 按 GGX 分布（a = roughness²）采样半程向量，返回切线空间（N = +Z）里的方向，不做旋转
+// 和 brdf_lut.frag 的同名函数一致；要 N 周围的方向时由调用方按 prefilter.frag 的切线基变换
+glm::vec3 ImportanceSampleGGX(const glm::vec2& xi, float roughness);
+
+// BRDF LUT 的一个 texel：返回 (A, B)，镜面项 = prefiltered · (F0·A + B)
+glm::vec2 IntegrateBRDF(float NdotV, float roughness, int sampleCount);
+
+// 整张 BRDF LUT 的 CPU 参考（size × size，u = N·V，v = roughness，取 texel 中心）
+// 输出按行交错的 RG float；按行分给线程池
+std::vector<float> BakeBRDFLUTReference(int size, int sampleCount, ThreadPool* pool);
+
+// ---- CPU 端立方体贴图（离线 iblbake 用；和 GPU 烘焙同样的约定，结果在容差内一致）----
+
+// RGB float，每个 mip 每个面一块连续内存
+struct CubemapF
+{
+    int size = 0;     // 第 0 层边长
+    int levels = 0;
+    std::vector<std::vector<float>> faces;  // 下标 = level * 6 + face
+
+    void Allocate(int faceSize, int levelCount);
+    int LevelSize(int level) const { return std::max(1, size >> level); }
+    float* Face(int level, int face) { return faces[(std::size_t)level * 6 + face].data(); }
+    const float* Face(int level, int face) const { return faces[(std::size_t)level * 6 + face].data(); }
+};
+
+// 全景图 -> 立方体第 0 层：双线性 + clamp（和 equirect_to_cubemap.frag 在 GL_LINEAR 纹理上采样一致）
+void EquirectToCubemap(const std::uint16_t* halfRGB, int width, int height, CubemapF& cube, ThreadPool* pool);
+
+// 2x2 盒式滤波补全 mip 链（对应 glGenerateMipmap）
+void GenerateCubemapMips(CubemapF& cube, ThreadPool* pool);
+
+// 三线性采样：面内双线性（边缘 clamp），mip 之间线性
+glm::vec3 SampleCubemap(const CubemapF& cube, const glm::vec3& dir, float lod);
+
+// prefilter.frag 的 CPU 版：把 env 按 roughness 预滤波写进 out 的第 level 层
+// 同一层里每个 texel 的切线空间采样方向和源 mip 都一样（N = V = R），预先算好只做变换 + 采样
+void PrefilterCubemapLevel(const CubemapF& env, CubemapF& out, int level, float roughness,
+                           int sampleCount, ThreadPool* pool);
+
+// SH9 辐照度在立方体每个 texel 中心求值（写进 out 的第 0 层）
+void EvalSH9ToCubemap(const SH9& sh, CubemapF& out);
@@ -0,0 +1,125 @@
+#include "ImageWriter.h"
+
+#include "HalfFloat.h"
+
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include <stb_image_write.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+    // EXR 全部小端
+    void PutU8(std::vector<unsigned char>& out, std::uint8_t v) { out.push_back(v); }
+    void PutI32(std::vector<unsigned char>& out, std::int32_t v)
+    {
+        for (int i = 0; i < 4; ++i) out.push_back((unsigned char)(((std::uint32_t)v >> (8 * i)) & 0xFF));
+    }
+    void PutU64(std::vector<unsigned char>& out, std::uint64_t v)
+    {
+        for (int i = 0; i < 8; ++i) out.push_back((unsigned char)((v >> (8 * i)) & 0xFF));
+    }
+    void PutF32(std::vector<unsigned char>& out, float v)
+    {
+        std::uint32_t bits;
+        std::memcpy(&bits, &v, 4);
+        PutI32(out, (std::int32_t)bits);
+    }
+    void PutString(std::vector<unsigned char>& out, const char* s)
+    {
+        out.insert(out.end(), s, s + std::strlen(s) + 1);
+    }
+    void PutAttribute(std::vector<unsigned char>& out, const char* name, const char* type, int size)
+    {
+        PutString(out, name);
+        PutString(out, type);
+        PutI32(out, size);
+    }
+}
+
+bool ImageWriter::WritePng(const std::string& path, int width, int height, const unsigned char* rgba)
+{
+    stbi_flip_vertically_on_write(1);
+    int ok = stbi_write_png(path.c_str(), width, height, 4, rgba, width * 4);
+    stbi_flip_vertically_on_write(0);
+    if (!ok)
+        std::fprintf(stderr, "[ImageWriter] Failed to write %s\n", path.c_str());
+    return ok != 0;
+}
+
+bool ImageWriter::WriteExr(const std::string& path, int width, int height, const float* rgb)
+{
+    if (width <= 0 || height <= 0) return false;
+
+    std::vector<unsigned char> out;
+    out.reserve(512 + (std::size_t)height * (8 + 8 + (std::size_t)width * 6));
+
+    // magic + 版本 2（单部分 scanline）
+    PutI32(out, 20000630);
+    PutI32(out, 2);
+
+    // 通道按名字排序：B G R，都是 HALF
+    static const char* kChannels[3] = { "B", "G", "R" };
+    PutAttribute(out, "channels", "chlist", 3 * (2 + 16) + 1);
+    for (const char* name : kChannels)
+    {
+        PutString(out, name);
+        PutI32(out, 1);             // HALF
+        PutU8(out, 0);              // pLinear
+        PutU8(out, 0); PutU8(out, 0); PutU8(out, 0);
+        PutI32(out, 1);             // xSampling
+        PutI32(out, 1);             // ySampling
+    }
+    PutU8(out, 0);
+
+    PutAttribute(out, "compression", "compression", 1);
+    PutU8(out, 0);                  // NO_COMPRESSION
+    PutAttribute(out, "dataWindow", "box2i", 16);
+    PutI32(out, 0); PutI32(out, 0); PutI32(out, width - 1); PutI32(out, height - 1);
+    PutAttribute(out, "displayWindow", "box2i", 16);
+    PutI32(out, 0); PutI32(out, 0); PutI32(out, width - 1); PutI32(out, height - 1);
+    PutAttribute(out, "lineOrder", "lineOrder", 1);
+    PutU8(out, 0);                  // INCREASING_Y
+    PutAttribute(out, "pixelAspectRatio", "float", 4);
+    PutF32(out, 1.0f);
+    PutAttribute(out, "screenWindowCenter", "v2f", 8);
+    PutF32(out, 0.0f); PutF32(out, 0.0f);
+    PutAttribute(out, "screenWindowWidth", "float", 4);
+    PutF32(out, 1.0f);
+    PutU8(out, 0);                  // 头结束
+
+    // 偏移表：每行一个块（未压缩时一块一行）
+    const std::size_t lineBytes = (std::size_t)width * 3 * 2;
+    const std::size_t tableStart = out.size();
+    const std::size_t firstBlock = tableStart + (std::size_t)height * 8;
+    for (int y = 0; y < height; ++y)
+        PutU64(out, firstBlock + (std::size_t)y * (8 + lineBytes));
+
+    for (int y = 0; y < height; ++y)
+    {
+        PutI32(out, y);
+        PutI32(out, (std::int32_t)lineBytes);
+        // EXR 第 0 行在最上面
+        const float* row = rgb + (std::size_t)(height - 1 - y) * width * 3;
+        for (int c = 2; c >= 0; --c)
+            for (int x = 0; x < width; ++x)
+            {
+                std::uint16_t h = FloatToHalf(row[x * 3 + c]);
+                out.push_back((unsigned char)(h & 0xFF));
+                out.push_back((unsigned char)(h >> 8));
+            }
+    }
+
+    std::FILE* f = std::fopen(path.c_str(), "wb");
+    if (!f)
+    {
+        std::fprintf(stderr, "[ImageWriter] Failed to write %s\n", path.c_str());
+        return false;
+    }
+    bool ok = std::fwrite(out.data(), 1, out.size(), f) == out.size();
+    std::fclose(f);
+    return ok;
+}
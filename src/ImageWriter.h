@@ -0,0 +1,11 @@
+#pragma once
+#include <string>
+
+// 截图写盘：像素按 GL 的习惯自下而上，写文件时翻成自上而下
+namespace ImageWriter
+{
+    // RGBA8
+    bool WritePng(const std::string& path, int width, int height, const unsigned char* rgba);
+    // RGB float -> 未压缩 scanline EXR（half，B/G/R 三通道），不依赖 OpenEXR
+    bool WriteExr(const std::string& path, int width, int height, const float* rgb);
+}
@@ -0,0 +1,33 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// MappedFile：只读内存映射一个文件（Windows: CreateFileMapping，其他: mmap）
+// 大文件（缓存、HDR 原图）不用先 read 进一块缓冲区，按需由系统分页读入
+class MappedFile
+{
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool Open(const std::string& path);
+    void Close();
+
+    bool IsOpen() const { return m_Data != nullptr; }
+    const std::uint8_t* Data() const { return m_Data; }
+    std::size_t Size() const { return m_Size; }
+
+private:
+    const std::uint8_t* m_Data = nullptr;
+    std::size_t m_Size = 0;
+#ifdef _WIN32
+    void* m_File = nullptr;
+    void* m_Mapping = nullptr;
+#else
+    int m_Fd = -1;
+#endif
+};
@@ -1,5 +1,6 @@
 // Material.h
 #pragma once
+#include <cstdint>
 #include <glm/glm.hpp>
 
 class Shader;
@@ -19,5 +20,10 @@ struct Material
     float      roughness = 0.5f;
     float      ao        = 1.0f;
 
+    // 打包进纹理数组后的位置（TextureArrayPacker），Renderer 的 instanced 路径用
+    // albedoArray = 0 表示没打包，只能走逐物体绘制
+    std::uint32_t albedoArray = 0;
+    int           albedoLayer = -1;
+
     void Bind(const glm::vec3& viewPos) const;
 };
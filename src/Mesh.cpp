@@ -1,15 +1,18 @@
 #include "Mesh.h"
+#include "render/DrawStats.h"
+#include "render/GpuMemory.h"
 
 #include <cstddef>
 #include <utility>
 
 #include <glad/glad.h>
+#include <glm/glm.hpp>
 
-Mesh::Mesh(std::vector<MeshVertex> vertices, std::vector<unsigned int> indices)
+Mesh::Mesh(std::vector<MeshVertex> vertices, std::vector<unsigned int> indices, const std::string& name)
     : m_Vertices(std::move(vertices)),
       m_Indices(std::move(indices))
 {
-    Setup();
+    Setup(name);
 }
 
 Mesh::~Mesh()
@@ -32,10 +35,12 @@ Mesh& Mesh::operator=(Mesh&& other) noexcept
     m_VAO = other.m_VAO;
     m_VBO = other.m_VBO;
     m_EBO = other.m_EBO;
+    m_InstanceVbo = other.m_InstanceVbo;
 
     other.m_VAO = 0;
     other.m_VBO = 0;
     other.m_EBO = 0;
+    other.m_InstanceVbo = 0;
     return *this;
 }
 
@@ -44,7 +49,7 @@ bool Mesh::IsValid() const
     return m_VAO != 0 && !m_Indices.empty();
 }
 
-void Mesh::Setup()
+void Mesh::Setup(const std::string& name)
 {
     if (m_Vertices.empty() || m_Indices.empty()) return;
 
@@ -58,17 +63,21 @@ void Mesh::Setup()
 
     // 3) 上传顶点数据
     glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
+    DrawStats::Upload((std::int64_t)(m_Vertices.size() * sizeof(MeshVertex)));
     glBufferData(GL_ARRAY_BUFFER,
                  static_cast<GLsizeiptr>(m_Vertices.size() * sizeof(MeshVertex)),
                  m_Vertices.data(),
                  GL_STATIC_DRAW);
+    GpuMemory::TrackBuffer(m_VBO, GpuMemory::Category::Meshes, name, m_Vertices.size() * sizeof(MeshVertex));
 
     // 4) 上传索引数据
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_EBO);
+    DrawStats::Upload((std::int64_t)(m_Indices.size() * sizeof(unsigned int)));
     glBufferData(GL_ELEMENT_ARRAY_BUFFER,
                  static_cast<GLsizeiptr>(m_Indices.size() * sizeof(unsigned int)),
                  m_Indices.data(),
                  GL_STATIC_DRAW);
+    GpuMemory::TrackBuffer(m_EBO, GpuMemory::Category::Meshes, name, m_Indices.size() * sizeof(unsigned int));
 
     // 5) 顶点布局：location 0/1/2 -> position/normal/uv
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(MeshVertex), (void*)offsetof(MeshVertex, position));
@@ -87,10 +96,12 @@ void Mesh::Setup()
 void Mesh::Destroy()
 {
     if (m_EBO) {
+        GpuMemory::FreeBuffer(m_EBO);
         glDeleteBuffers(1, &m_EBO);
         m_EBO = 0;
     }
     if (m_VBO) {
+        GpuMemory::FreeBuffer(m_VBO);
         glDeleteBuffers(1, &m_VBO);
         m_VBO = 0;
     }
@@ -104,8 +115,48 @@ void Mesh::Draw() const
 {
     if (!IsValid()) return;
 
+    DrawStats::BindVertexArray();
     glBindVertexArray(m_VAO);
-    glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(m_Indices.size()), GL_UNSIGNED_INT, nullptr);
+    DrawStats::DrawElements(GL_TRIANGLES, static_cast<int>(m_Indices.size()));
     glBindVertexArray(0);
 }
 
+
+void Mesh::BindInstanceBuffer(unsigned int instanceVbo)
+{
+    if (!m_VAO || m_InstanceVbo == instanceVbo) return;
+    m_InstanceVbo = instanceVbo;
+
+    // 布局和 Renderer::InstanceData 一致：mat4 model + vec4 color + vec4 params
+    const GLsizei stride = sizeof(glm::mat4) + 2 * sizeof(glm::vec4);
+
+    glBindVertexArray(m_VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVbo);
+
+    // mat4 占 4 个连续 location（3~6），每列一个 vec4
+    for (int col = 0; col < 4; ++col)
+    {
+        GLuint loc = 3 + col;
+        glEnableVertexAttribArray(loc);
+        glVertexAttribPointer(loc, 4, GL_FLOAT, GL_FALSE, stride, (void*)(sizeof(glm::vec4) * col));
+        glVertexAttribDivisor(loc, 1);
+    }
+    glEnableVertexAttribArray(7);
+    glVertexAttribPointer(7, 4, GL_FLOAT, GL_FALSE, stride, (void*)(sizeof(glm::mat4)));
+    glVertexAttribDivisor(7, 1);
+    glEnableVertexAttribArray(8);
+    glVertexAttribPointer(8, 4, GL_FLOAT, GL_FALSE, stride, (void*)(sizeof(glm::mat4) + sizeof(glm::vec4)));
+    glVertexAttribDivisor(8, 1);
+
+    glBindVertexArray(0);
+}
+
+void Mesh::DrawInstanced(int instanceCount) const
+{
+    if (!IsValid() || instanceCount <= 0) return;
+
+    DrawStats::BindVertexArray();
+    glBindVertexArray(m_VAO);
+    DrawStats::DrawElements(GL_TRIANGLES, static_cast<int>(m_Indices.size()), instanceCount);
+    glBindVertexArray(0);
+}
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <string>
 #include <vector>
 
 #include <glm/glm.hpp>
@@ -15,7 +16,8 @@ class Mesh
 {
 public:
     Mesh() = default;
-    Mesh(std::vector<MeshVertex> vertices, std::vector<unsigned int> indices);
+    // name: 显存统计里的资源名（通常是模型路径）
+    Mesh(std::vector<MeshVertex> vertices, std::vector<unsigned int> indices, const std::string& name = "mesh");
     ~Mesh();
 
     Mesh(const Mesh&) = delete;
@@ -27,8 +29,15 @@ public:
     bool IsValid() const;
     void Draw() const;
 
+    // 把每实例属性（location 3~8，见 Renderer::InstanceData）挂到这个 mesh 的 VAO 上
+    // instanceVbo 只需设置一次，之后每帧改 buffer 内容即可
+    void BindInstanceBuffer(unsigned int instanceVbo);
+    void DrawInstanced(int instanceCount) const;
+
+    int IndexCount() const { return (int)m_Indices.size(); }
+
 private:
-    void Setup();
+    void Setup(const std::string& name);
     void Destroy();
 
     std::vector<MeshVertex> m_Vertices;
@@ -37,5 +46,6 @@ private:
     unsigned int m_VAO = 0;
     unsigned int m_VBO = 0;
     unsigned int m_EBO = 0;
+    unsigned int m_InstanceVbo = 0;
 };
 
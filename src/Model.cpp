@@ -1,4 +1,5 @@
 #include "Model.h"
+#include "CpuProfiler.h"
 
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
@@ -8,6 +9,7 @@
 
 bool Model::Load(const std::string& path)
 {
+    PROFILE_ZONE("Model::Load");
     Assimp::Importer importer;
     // aiProcess_Triangulate :	把四边形/多边形面拆成三角形
     // aiProcess_GenNormals : 如果模型没有法线，自动生成
@@ -28,11 +30,23 @@ bool Model::Load(const std::string& path)
 
     m_Meshes.clear();
     m_HasBounds = false;
+    m_Path = path;
     ProcessNode(scene->mRootNode, scene);
     std::fprintf(stdout, "[Model] Loaded: %s | Meshes: %zu\n", path.c_str(), m_Meshes.size());
     return true;
 }
 
+bool Model::LoadFromMesh(std::vector<MeshVertex> vertices, std::vector<unsigned int> indices, const std::string& name)
+{
+    m_Meshes.clear();
+    m_HasBounds = false;
+    m_Path = name;
+    if (vertices.empty() || indices.empty()) return false;
+    ExpandBounds(vertices, m_BoundsMin, m_BoundsMax, m_HasBounds);
+    m_Meshes.emplace_back(std::move(vertices), std::move(indices), m_Path);
+    return true;
+}
+
 void Model::Draw() const
 {
     for (const auto& mesh : m_Meshes)
@@ -41,6 +55,22 @@ void Model::Draw() const
     }
 }
 
+void Model::BindInstanceBuffer(unsigned int instanceVbo)
+{
+    for (auto& mesh : m_Meshes)
+    {
+        mesh.BindInstanceBuffer(instanceVbo);
+    }
+}
+
+void Model::DrawInstanced(int instanceCount) const
+{
+    for (const auto& mesh : m_Meshes)
+    {
+        mesh.DrawInstanced(instanceCount);
+    }
+}
+
 void Model::ProcessNode(aiNode* node, const aiScene* scene)
 {
     //处理当前节点上挂的所有mesh
@@ -58,6 +88,17 @@ Mesh Model::ProcessMesh(aiMesh* mesh)
 {
     std::vector<MeshVertex> vertices;
     std::vector<unsigned int> indices;
+    ExtractMesh(mesh, vertices, indices);
+    ExpandBounds(vertices, m_BoundsMin, m_BoundsMax, m_HasBounds);
+    return Mesh(std::move(vertices), std::move(indices), m_Path);
+}
+
+void Model::ExtractMesh(const aiMesh* mesh, std::vector<MeshVertex>& vertices, std::vector<unsigned int>& indices)
+{
+    vertices.clear();
+    indices.clear();
+    vertices.reserve(mesh->mNumVertices);
+    indices.reserve((std::size_t)mesh->mNumFaces * 3);
 
     //遍历所有顶点
     for (unsigned int i = 0; i<mesh->mNumVertices; i++)
@@ -75,23 +116,6 @@ Mesh Model::ProcessMesh(aiMesh* mesh)
             };
         }
         vertices.push_back(vertex);
-
-        if (!m_HasBounds)
-        {
-            m_BoundsMin = vertex.position;
-            m_BoundsMax = vertex.position;
-            m_HasBounds = true;
-        }
-        else
-        {
-            m_BoundsMin.x = std::min(m_BoundsMin.x, vertex.position.x);
-            m_BoundsMin.y = std::min(m_BoundsMin.y, vertex.position.y);
-            m_BoundsMin.z = std::min(m_BoundsMin.z, vertex.position.z);
-
-            m_BoundsMax.x = std::max(m_BoundsMax.x, vertex.position.x);
-            m_BoundsMax.y = std::max(m_BoundsMax.y, vertex.position.y);
-            m_BoundsMax.z = std::max(m_BoundsMax.z, vertex.position.z);
-        }
     }
     //遍历所有面 取出索引
     for (unsigned int i = 0; i< mesh->mNumFaces; i++)
@@ -102,7 +126,31 @@ Mesh Model::ProcessMesh(aiMesh* mesh)
             indices.push_back(face.mIndices[j]);
         }
     }
-    return Mesh(std::move(vertices), std::move(indices));
+}
+
+void Model::ExpandBounds(const std::vector<MeshVertex>& vertices, glm::vec3& boundsMin, glm::vec3& boundsMax,
+                         bool& valid)
+{
+    if (vertices.empty()) return;
+    if (!valid)
+    {
+        boundsMin = vertices[0].position;
+        boundsMax = vertices[0].position;
+        valid = true;
+    }
+    for (const MeshVertex& v : vertices)
+    {
+        boundsMin = glm::min(boundsMin, v.position);
+        boundsMax = glm::max(boundsMax, v.position);
+    }
+}
+
+int Model::TriangleCount() const
+{
+    int count = 0;
+    for (const auto& mesh : m_Meshes)
+        count += mesh.IndexCount() / 3;
+    return count;
 }
 
 float Model::GetRadius() const
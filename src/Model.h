@@ -19,9 +19,17 @@ public:
     //加载模型文件
     bool Load(const std::string& path);
 
+    // 用现成的顶点/索引建一个只有一个 Mesh 的模型（程序化几何，例如 StressScene 的球和圆环）
+    // name: 显存统计里的资源名
+    bool LoadFromMesh(std::vector<MeshVertex> vertices, std::vector<unsigned int> indices, const std::string& name);
+
     //绘制子Mesh
     void Draw() const;
 
+    // instanced 绘制：所有子 Mesh 共用同一份实例数据
+    void BindInstanceBuffer(unsigned int instanceVbo);
+    void DrawInstanced(int instanceCount) const;
+
     bool isValid() const
     {
         return !m_Meshes.empty();
@@ -31,12 +39,21 @@ public:
     glm::vec3 GetBoundsMax() const { return m_BoundsMax; }
     glm::vec3 GetCenter() const { return (m_BoundsMin + m_BoundsMax) * 0.5f; }
     float GetRadius() const;
+    int TriangleCount() const;
+
+    // ProcessMesh 的纯 CPU 部分，不碰 GL（RenderSandboxBench 直接调）
+    // 顶点/索引拷贝：只取第 0 套 UV，面按 mIndices 原样展开
+    static void ExtractMesh(const aiMesh* mesh, std::vector<MeshVertex>& vertices, std::vector<unsigned int>& indices);
+    // 把顶点位置并进包围盒；valid = false 时用第一个顶点初始化
+    static void ExpandBounds(const std::vector<MeshVertex>& vertices, glm::vec3& boundsMin, glm::vec3& boundsMax,
+                             bool& valid);
 
 private:
     std::vector<Mesh> m_Meshes;
     void ProcessNode(aiNode* node, const aiScene* scene);
     Mesh ProcessMesh(aiMesh* mesh);
 
+    std::string m_Path; // 显存统计里 mesh 的资源名
     glm::vec3 m_BoundsMin{0.0f};
     glm::vec3 m_BoundsMax{0.0f};
     bool m_HasBounds = false;
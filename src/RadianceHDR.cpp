@@ -0,0 +1,259 @@
+#include "RadianceHDR.h"
+
+#include "HalfFloat.h"
+#include "ThreadPool.h"
+
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+// RGBE 指数 -> 缩放系数查表：ldexp(1, e - 136)，e = 0 表示黑色
+static const float* ExponentTable()
+{
+    static float s_Table[256];
+    static bool s_Init = [] {
+        s_Table[0] = 0.0f;
+        for (int e = 1; e < 256; ++e)
+            s_Table[e] = std::ldexp(1.0f, e - (128 + 8));
+        return true;
+    }();
+    (void)s_Init;
+    return s_Table;
+}
+
+void RadianceHDR::RGBEToFloat(const std::uint8_t rgbe[4], float out[3])
+{
+    float scale = ExponentTable()[rgbe[3]];
+    out[0] = rgbe[0] * scale;
+    out[1] = rgbe[1] * scale;
+    out[2] = rgbe[2] * scale;
+}
+
+void RadianceHDR::Clear()
+{
+    m_Width = m_Height = 0;
+    m_Half.clear();
+    m_Half.shrink_to_fit();
+    m_RGBE.clear();
+    m_RGBE.shrink_to_fit();
+}
+
+bool RadianceHDR::Load(const std::string& path, Output output, bool flipY, ThreadPool* pool)
+{
+    std::ifstream file(path, std::ios::in | std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        std::fprintf(stderr, "[RadianceHDR] Failed to open: %s\n", path.c_str());
+        return false;
+    }
+
+    std::streamsize size = file.tellg();
+    file.seekg(0, std::ios::beg);
+    std::vector<std::uint8_t> bytes((std::size_t)size);
+    if (size <= 0 || !file.read(reinterpret_cast<char*>(bytes.data()), size)) {
+        std::fprintf(stderr, "[RadianceHDR] Failed to read: %s\n", path.c_str());
+        return false;
+    }
+
+    if (!Decode(bytes.data(), bytes.size(), output, flipY, pool)) {
+        std::fprintf(stderr, "[RadianceHDR] Unsupported or corrupt file: %s\n", path.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool RadianceHDR::ParseHeader(const std::uint8_t* data, std::size_t size, std::size_t& offset)
+{
+    // 逐行读取文本头，空行结束；之后是分辨率行 "-Y H +X W"
+    auto readLine = [&](std::string& line) {
+        line.clear();
+        while (offset < size && data[offset] != '\n')
+            line.push_back((char)data[offset++]);
+        if (offset >= size) return false;
+        ++offset;  // 跳过 '\n'
+        return true;
+    };
+
+    std::string line;
+    if (!readLine(line)) return false;
+    if (line != "#?RADIANCE" && line != "#?RGBE") return false;
+
+    bool validFormat = true;
+    for (;;)
+    {
+        if (!readLine(line)) return false;
+        if (line.empty()) break;
+        if (line.compare(0, 7, "FORMAT=") == 0)
+            validFormat = (line == "FORMAT=32-bit_rle_rgbe");
+    }
+    if (!validFormat) return false;
+
+    if (!readLine(line)) return false;
+    // 只支持标准朝向（和 stb_image 一样）
+    int w = 0, h = 0;
+    if (std::sscanf(line.c_str(), "-Y %d +X %d", &h, &w) != 2) return false;
+    if (w <= 0 || h <= 0 || w > (1 << 24) / 4 || h > (1 << 24) / 4) return false;
+
+    m_Width = w;
+    m_Height = h;
+    return true;
+}
+
+bool RadianceHDR::LocateScanlines(const std::uint8_t* data, std::size_t size, std::size_t offset,
+                                  std::vector<std::size_t>& rowOffsets, bool& rle) const
+{
+    rowOffsets.resize((std::size_t)m_Height);
+
+    // 宽度不在 [8, 32767] 内时不可能是新式 RLE；否则看第一条扫描线的 2,2,hi,lo 标记
+    rle = false;
+    if (m_Width >= 8 && m_Width < 32768 && offset + 4 <= size) {
+        const std::uint8_t* p = data + offset;
+        rle = (p[0] == 2 && p[1] == 2 && (p[2] & 0x80) == 0);
+    }
+
+    if (!rle) {
+        std::size_t rowBytes = (std::size_t)m_Width * 4;
+        if (offset + rowBytes * m_Height > size) return false;
+        for (int y = 0; y < m_Height; ++y)
+            rowOffsets[y] = offset + rowBytes * y;
+        return true;
+    }
+
+    // RLE：每条扫描线 = 4 字节头 + 4 个通道各自的游程，只跳字节不解码
+    for (int y = 0; y < m_Height; ++y)
+    {
+        if (offset + 4 > size) return false;
+        const std::uint8_t* p = data + offset;
+        if (p[0] != 2 || p[1] != 2 || ((p[2] << 8) | p[3]) != m_Width) return false;
+        rowOffsets[y] = offset;
+        offset += 4;
+
+        for (int c = 0; c < 4; ++c)
+        {
+            int x = 0;
+            while (x < m_Width)
+            {
+                if (offset >= size) return false;
+                int count = data[offset++];
+                if (count > 128) {
+                    count -= 128;
+                    offset += 1;
+                } else {
+                    if (count == 0) return false;
+                    offset += (std::size_t)count;
+                }
+                x += count;
+            }
+            if (x != m_Width || offset > size) return false;
+        }
+    }
+    return true;
+}
+
+bool RadianceHDR::DecodeScanline(const std::uint8_t* data, std::size_t size, std::size_t offset,
+                                 bool rle, std::uint8_t* rgbeRow) const
+{
+    if (!rle) {
+        std::memcpy(rgbeRow, data + offset, (std::size_t)m_Width * 4);
+        return true;
+    }
+
+    // 通道是平面存储的：先 R 整行，再 G、B、E，解出来交错写回 RGBE
+    offset += 4;
+    for (int c = 0; c < 4; ++c)
+    {
+        int x = 0;
+        while (x < m_Width)
+        {
+            if (offset >= size) return false;
+            int count = data[offset++];
+            if (count > 128) {
+                count -= 128;
+                if (x + count > m_Width || offset >= size) return false;
+                std::uint8_t value = data[offset++];
+                for (int i = 0; i < count; ++i)
+                    rgbeRow[(x + i) * 4 + c] = value;
+            } else {
+                if (x + count > m_Width || offset + count > size) return false;
+                for (int i = 0; i < count; ++i)
+                    rgbeRow[(x + i) * 4 + c] = data[offset + i];
+                offset += (std::size_t)count;
+            }
+            x += count;
+        }
+    }
+    return true;
+}
+
+bool RadianceHDR::Decode(const std::uint8_t* data, std::size_t size, Output output,
+                         bool flipY, ThreadPool* pool)
+{
+    Clear();
+    m_Output = output;
+
+    std::size_t offset = 0;
+    if (!ParseHeader(data, size, offset)) {
+        Clear();
+        return false;
+    }
+
+    std::vector<std::size_t> rowOffsets;
+    bool rle = false;
+    if (!LocateScanlines(data, size, offset, rowOffsets, rle)) {
+        Clear();
+        return false;
+    }
+
+    const std::size_t pixelCount = (std::size_t)m_Width * m_Height;
+    if (output == Output::Half)
+        m_Half.resize(pixelCount * 3);
+    else
+        m_RGBE.resize(pixelCount * 4);
+
+    const float* expTable = ExponentTable();
+    std::atomic<bool> failed{false};
+
+    auto decodeRows = [&](int begin, int end) {
+        // 每个任务一份扫描线缓冲，避免线程间共享
+        std::vector<std::uint8_t> rgbeRow(output == Output::Half ? (std::size_t)m_Width * 4 : 0);
+        std::vector<float> floatRow(output == Output::Half ? (std::size_t)m_Width * 3 : 0);
+
+        for (int y = begin; y < end; ++y)
+        {
+            int dstY = flipY ? (m_Height - 1 - y) : y;
+            std::uint8_t* rgbe = (output == Output::Half)
+                ? rgbeRow.data()
+                : m_RGBE.data() + (std::size_t)dstY * m_Width * 4;
+
+            if (!DecodeScanline(data, size, rowOffsets[y], rle, rgbe)) {
+                failed = true;
+                return;
+            }
+            if (output != Output::Half) continue;
+
+            for (int x = 0; x < m_Width; ++x)
+            {
+                const std::uint8_t* p = rgbe + x * 4;
+                float scale = expTable[p[3]];
+                floatRow[x * 3 + 0] = p[0] * scale;
+                floatRow[x * 3 + 1] = p[1] * scale;
+                floatRow[x * 3 + 2] = p[2] * scale;
+            }
+            FloatToHalfArray(floatRow.data(),
+                             m_Half.data() + (std::size_t)dstY * m_Width * 3,
+                             (std::size_t)m_Width * 3);
+        }
+    };
+
+    if (pool)
+        pool->ParallelFor(m_Height, decodeRows, 16);
+    else
+        decodeRows(0, m_Height);
+
+    if (failed) {
+        Clear();
+        return false;
+    }
+    return true;
+}
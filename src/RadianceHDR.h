@@ -0,0 +1,57 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+class ThreadPool;
+
+// RadianceHDR：Radiance .hdr（RGBE）读取器，替代 stbi_loadf 给环境贴图用
+// - 先顺序扫一遍定位每条扫描线的起点（RLE 只需要跳字节，很快）
+// - 再把扫描线分给线程池并行解 RLE，RGBE 直接转成 half（F16C）
+// 输出：
+// - Half：RGB 半精度，每像素 6 字节，可直接 GL_HALF_FLOAT 上传
+// - RGBE：原始 RGBE8，每像素 4 字节，上传成 GL_RGBA8，在 shader 里解码
+class RadianceHDR
+{
+public:
+    enum class Output
+    {
+        Half,
+        RGBE,
+    };
+
+    bool Load(const std::string& path, Output output = Output::Half, bool flipY = true,
+              ThreadPool* pool = nullptr);
+    // 从内存解析（data 是整个文件内容）
+    bool Decode(const std::uint8_t* data, std::size_t size, Output output = Output::Half,
+                bool flipY = true, ThreadPool* pool = nullptr);
+    void Clear();
+
+    int Width() const { return m_Width; }
+    int Height() const { return m_Height; }
+    Output GetOutput() const { return m_Output; }
+
+    // width * height * 3 个 half
+    const std::uint16_t* HalfData() const { return m_Half.data(); }
+    // width * height * 4 个字节
+    const std::uint8_t* RGBEData() const { return m_RGBE.data(); }
+    // 把 half 数据的所有权交出去（避免再拷一份）
+    std::vector<std::uint16_t> ReleaseHalf() { return std::move(m_Half); }
+
+    // 把一个 RGBE 像素解成线性 float，和 stb_image 的 stbi__hdr_convert 一致
+    static void RGBEToFloat(const std::uint8_t rgbe[4], float out[3]);
+
+private:
+    bool ParseHeader(const std::uint8_t* data, std::size_t size, std::size_t& offset);
+    bool LocateScanlines(const std::uint8_t* data, std::size_t size, std::size_t offset,
+                         std::vector<std::size_t>& rowOffsets, bool& rle) const;
+    bool DecodeScanline(const std::uint8_t* data, std::size_t size, std::size_t offset,
+                        bool rle, std::uint8_t* rgbeRow) const;
+
+    int m_Width = 0;
+    int m_Height = 0;
+    Output m_Output = Output::Half;
+    std::vector<std::uint16_t> m_Half;
+    std::vector<std::uint8_t> m_RGBE;
+};
@@ -0,0 +1,527 @@
+#include "SceneStore.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+static const float kDegToRad = 3.14159265358979f / 180.0f;
+
+// 欧拉角（度）-> 四元数，和 Transform::ToMatrix 一样是 Rx * Ry * Rz
+static glm::quat EulerDegToQuat(const glm::vec3& deg)
+{
+    float hx = deg.x * kDegToRad * 0.5f, hy = deg.y * kDegToRad * 0.5f, hz = deg.z * kDegToRad * 0.5f;
+    float cx = std::cos(hx), sx = std::sin(hx);
+    float cy = std::cos(hy), sy = std::sin(hy);
+    float cz = std::cos(hz), sz = std::sin(hz);
+
+    // qx * qy
+    float aw = cx * cy, ax = sx * cy, ay = cx * sy, az = sx * sy;
+    // (qx * qy) * qz
+    return glm::quat(aw * cz - az * sz,
+                     ax * cz + ay * sz,
+                     ay * cz - ax * sz,
+                     az * cz + aw * sz);
+}
+
+// 单个实体的 TRS 矩阵（列主序，和 glm 一致），四元数要求已归一化
+static inline void LocalMatrix(float px, float py, float pz, float x, float y, float z, float w,
+                               float sx, float sy, float sz, glm::mat4& m)
+{
+    float xx = x * x, yy = y * y, zz = z * z;
+    float xy = x * y, xz = x * z, yz = y * z;
+    float wx = w * x, wy = w * y, wz = w * z;
+
+    m[0] = glm::vec4((1.0f - 2.0f * (yy + zz)) * sx, 2.0f * (xy + wz) * sx, 2.0f * (xz - wy) * sx, 0.0f);
+    m[1] = glm::vec4(2.0f * (xy - wz) * sy, (1.0f - 2.0f * (xx + zz)) * sy, 2.0f * (yz + wx) * sy, 0.0f);
+    m[2] = glm::vec4(2.0f * (xz + wy) * sz, 2.0f * (yz - wx) * sz, (1.0f - 2.0f * (xx + yy)) * sz, 0.0f);
+    m[3] = glm::vec4(px, py, pz, 1.0f);
+}
+
+#if defined(__AVX2__)
+// 8x8 转置：r[k] 的第 l 个元素 -> r[l] 的第 k 个元素
+static inline void Transpose8x8(__m256 r[8])
+{
+    __m256 t0 = _mm256_unpacklo_ps(r[0], r[1]), t1 = _mm256_unpackhi_ps(r[0], r[1]);
+    __m256 t2 = _mm256_unpacklo_ps(r[2], r[3]), t3 = _mm256_unpackhi_ps(r[2], r[3]);
+    __m256 t4 = _mm256_unpacklo_ps(r[4], r[5]), t5 = _mm256_unpackhi_ps(r[4], r[5]);
+    __m256 t6 = _mm256_unpacklo_ps(r[6], r[7]), t7 = _mm256_unpackhi_ps(r[6], r[7]);
+
+    __m256 u0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+    __m256 u1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+    __m256 u2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+    __m256 u3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+    __m256 u4 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(1, 0, 1, 0));
+    __m256 u5 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(3, 2, 3, 2));
+    __m256 u6 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(1, 0, 1, 0));
+    __m256 u7 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(3, 2, 3, 2));
+
+    r[0] = _mm256_permute2f128_ps(u0, u4, 0x20);
+    r[1] = _mm256_permute2f128_ps(u1, u5, 0x20);
+    r[2] = _mm256_permute2f128_ps(u2, u6, 0x20);
+    r[3] = _mm256_permute2f128_ps(u3, u7, 0x20);
+    r[4] = _mm256_permute2f128_ps(u0, u4, 0x31);
+    r[5] = _mm256_permute2f128_ps(u1, u5, 0x31);
+    r[6] = _mm256_permute2f128_ps(u2, u6, 0x31);
+    r[7] = _mm256_permute2f128_ps(u3, u7, 0x31);
+}
+#endif
+
+void SceneStore::ComputeLocalMatrices(const float* px, const float* py, const float* pz,
+                                      const float* qx, const float* qy, const float* qz, const float* qw,
+                                      const float* sx, const float* sy, const float* sz,
+                                      const std::uint8_t* dirty, std::size_t first, std::size_t last,
+                                      glm::mat4* out)
+{
+    std::size_t i = first;
+
+#if defined(__AVX2__)
+    // 8 个一组：寄存器里每个分量一行（8 个实体），两次 8x8 转置变成每个实体 16 个连续的 float 直接写
+    // 一组里一个脏的都没有就整组跳过，部分脏的只写脏的那几个
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 two = _mm256_set1_ps(2.0f);
+    const std::uint64_t allDirty = 0x0101010101010101ull;
+    for (; i + 8 <= last; i += 8)
+    {
+        std::uint64_t mask = allDirty;
+        if (dirty)
+        {
+            std::memcpy(&mask, dirty + i, sizeof(mask));
+            if (!mask) continue;
+        }
+
+        __m256 x = _mm256_loadu_ps(qx + i);
+        __m256 y = _mm256_loadu_ps(qy + i);
+        __m256 z = _mm256_loadu_ps(qz + i);
+        __m256 w = _mm256_loadu_ps(qw + i);
+        __m256 x2 = _mm256_mul_ps(x, two);
+        __m256 y2 = _mm256_mul_ps(y, two);
+        __m256 z2 = _mm256_mul_ps(z, two);
+
+        __m256 xx = _mm256_mul_ps(x, x2), yy = _mm256_mul_ps(y, y2), zz = _mm256_mul_ps(z, z2);
+        __m256 xy = _mm256_mul_ps(x, y2), xz = _mm256_mul_ps(x, z2), yz = _mm256_mul_ps(y, z2);
+        __m256 wx = _mm256_mul_ps(w, x2), wy = _mm256_mul_ps(w, y2), wz = _mm256_mul_ps(w, z2);
+
+        __m256 s0 = _mm256_loadu_ps(sx + i);
+        __m256 s1 = _mm256_loadu_ps(sy + i);
+        __m256 s2 = _mm256_loadu_ps(sz + i);
+
+        // 列主序的 16 个元素，前 8 个是第 0、1 列，后 8 个是第 2、3 列
+        __m256 lo[8] = {
+            _mm256_mul_ps(_mm256_sub_ps(one, _mm256_add_ps(yy, zz)), s0),
+            _mm256_mul_ps(_mm256_add_ps(xy, wz), s0),
+            _mm256_mul_ps(_mm256_sub_ps(xz, wy), s0),
+            zero,
+            _mm256_mul_ps(_mm256_sub_ps(xy, wz), s1),
+            _mm256_mul_ps(_mm256_sub_ps(one, _mm256_add_ps(xx, zz)), s1),
+            _mm256_mul_ps(_mm256_add_ps(yz, wx), s1),
+            zero,
+        };
+        __m256 hi[8] = {
+            _mm256_mul_ps(_mm256_add_ps(xz, wy), s2),
+            _mm256_mul_ps(_mm256_sub_ps(yz, wx), s2),
+            _mm256_mul_ps(_mm256_sub_ps(one, _mm256_add_ps(xx, yy)), s2),
+            zero,
+            _mm256_loadu_ps(px + i),
+            _mm256_loadu_ps(py + i),
+            _mm256_loadu_ps(pz + i),
+            one,
+        };
+        Transpose8x8(lo);
+        Transpose8x8(hi);
+
+        for (int l = 0; l < 8; ++l)
+        {
+            if (mask != allDirty && !dirty[i + l]) continue;
+            float* m = &out[i + l][0][0];
+            _mm256_storeu_ps(m, lo[l]);
+            _mm256_storeu_ps(m + 8, hi[l]);
+        }
+    }
+#endif
+
+    for (; i < last; ++i)
+    {
+        if (dirty && !dirty[i]) continue;
+        LocalMatrix(px[i], py[i], pz[i], qx[i], qy[i], qz[i], qw[i], sx[i], sy[i], sz[i], out[i]);
+    }
+}
+
+// 按 order 重排一列：新数组的第 i 个是旧数组的第 order[i] 个
+template <class T>
+static void Permute(std::vector<T>& column, const std::vector<std::uint32_t>& order)
+{
+    std::vector<T> sorted;
+    sorted.reserve(order.size());
+    for (std::uint32_t from : order)
+        sorted.push_back(column[from]);
+    column.swap(sorted);
+}
+
+std::uint32_t SceneStore::AddMaterial(const Material& material)
+{
+    m_Materials.push_back(material);
+    return (std::uint32_t)(m_Materials.size() - 1);
+}
+
+std::uint32_t SceneStore::Resolve(SceneHandle handle) const
+{
+    if (handle.index >= m_Slots.size()) return kNone;
+    const Slot& slot = m_Slots[handle.index];
+    return slot.generation == handle.generation ? slot.dense : kNone;
+}
+
+void SceneStore::MarkDirty(std::uint32_t dense)
+{
+    m_Dirty[dense] = 1;
+    if (m_DirtyBegin == m_DirtyEnd)
+    {
+        m_DirtyBegin = dense;
+        m_DirtyEnd = dense + 1;
+    }
+    else
+    {
+        m_DirtyBegin = std::min<std::size_t>(m_DirtyBegin, dense);
+        m_DirtyEnd = std::max<std::size_t>(m_DirtyEnd, dense + 1);
+    }
+}
+
+void SceneStore::MarkAllDirty()
+{
+    std::fill(m_Dirty.begin(), m_Dirty.end(), (std::uint8_t)1);
+    m_DirtyBegin = 0;
+    m_DirtyEnd = m_Dirty.size();
+}
+
+void SceneStore::Reserve(std::size_t count)
+{
+    for (std::vector<float>* column : { &m_PosX, &m_PosY, &m_PosZ, &m_RotX, &m_RotY, &m_RotZ, &m_RotW,
+                                        &m_ScaleX, &m_ScaleY, &m_ScaleZ })
+        column->reserve(count);
+    m_World.reserve(count);
+    m_Parent.reserve(count);
+    m_Material.reserve(count);
+    m_Model.reserve(count);
+    m_Dirty.reserve(count);
+    m_DenseToSlot.reserve(count);
+    m_Slots.reserve(count);
+}
+
+SceneHandle SceneStore::Create(const Transform& transform, std::uint32_t material, std::uint32_t model,
+                               SceneHandle parent)
+{
+    std::uint32_t slot;
+    if (!m_FreeSlots.empty())
+    {
+        slot = m_FreeSlots.back();
+        m_FreeSlots.pop_back();
+    }
+    else
+    {
+        slot = (std::uint32_t)m_Slots.size();
+        m_Slots.push_back(Slot{});
+    }
+
+    std::uint32_t dense = (std::uint32_t)m_World.size();
+    m_Slots[slot].dense = dense;
+    m_DenseToSlot.push_back(slot);
+
+    glm::quat q = EulerDegToQuat(transform.rotationEulerDeg);
+    m_PosX.push_back(transform.position.x);
+    m_PosY.push_back(transform.position.y);
+    m_PosZ.push_back(transform.position.z);
+    m_RotX.push_back(q.x);
+    m_RotY.push_back(q.y);
+    m_RotZ.push_back(q.z);
+    m_RotW.push_back(q.w);
+    m_ScaleX.push_back(transform.scale.x);
+    m_ScaleY.push_back(transform.scale.y);
+    m_ScaleZ.push_back(transform.scale.z);
+    m_World.push_back(glm::mat4(1.0f));
+    m_Parent.push_back(kNone);
+    m_Material.push_back(material);
+    m_Model.push_back(model);
+    m_Dirty.push_back(0);
+    MarkDirty(dense);
+
+    SceneHandle handle{ slot, m_Slots[slot].generation };
+    if (parent.IsValid()) SetParent(handle, parent);
+    return handle;
+}
+
+void SceneStore::Destroy(SceneHandle handle)
+{
+    std::uint32_t d = Resolve(handle);
+    if (d == kNone) return;
+
+    if (m_Parent[d] != kNone)
+    {
+        m_Parent[d] = kNone;
+        --m_ParentedCount;
+    }
+    // 子节点在 Compact 里挂回根
+    Slot& slot = m_Slots[handle.index];
+    slot.dense = kNone;
+    ++slot.generation;
+    m_FreeSlots.push_back(handle.index);
+    m_DenseToSlot[d] = kNone;
+    ++m_DeadCount;
+}
+
+void SceneStore::Clear()
+{
+    for (std::uint32_t slot : m_DenseToSlot)
+    {
+        if (slot == kNone) continue;
+        m_Slots[slot].dense = kNone;
+        ++m_Slots[slot].generation;
+        m_FreeSlots.push_back(slot);
+    }
+    m_DenseToSlot.clear();
+    for (std::vector<float>* column : { &m_PosX, &m_PosY, &m_PosZ, &m_RotX, &m_RotY, &m_RotZ, &m_RotW,
+                                        &m_ScaleX, &m_ScaleY, &m_ScaleZ })
+        column->clear();
+    m_World.clear();
+    m_Parent.clear();
+    m_Material.clear();
+    m_Model.clear();
+    m_Dirty.clear();
+    m_Materials.clear();
+    m_DirtyBegin = m_DirtyEnd = 0;
+    m_ParentedCount = 0;
+    m_DeadCount = 0;
+    m_NeedsReorder = false;
+}
+
+bool SceneStore::SetParent(SceneHandle child, SceneHandle parent)
+{
+    std::uint32_t c = Resolve(child);
+    if (c == kNone) return false;
+    std::uint32_t p = kNone;
+    if (parent.IsValid())
+    {
+        p = Resolve(parent);
+        if (p == kNone) return false;
+    }
+
+    // 从新父节点往上走，碰到自己就是成环
+    for (std::uint32_t a = p; a != kNone; a = m_Parent[a])
+    {
+        if (a == c) return false;
+    }
+
+    if (m_Parent[c] == kNone && p != kNone) ++m_ParentedCount;
+    else if (m_Parent[c] != kNone && p == kNone) --m_ParentedCount;
+    m_Parent[c] = p;
+    if (p != kNone && p > c) m_NeedsReorder = true;
+    MarkDirty(c);
+    return true;
+}
+
+SceneHandle SceneStore::GetParent(SceneHandle handle) const
+{
+    std::uint32_t d = Resolve(handle);
+    if (d == kNone || m_Parent[d] == kNone) return SceneHandle();
+    std::uint32_t slot = m_DenseToSlot[m_Parent[d]];
+    if (slot == kNone) return SceneHandle();
+    return SceneHandle{ slot, m_Slots[slot].generation };
+}
+
+void SceneStore::SetPosition(SceneHandle handle, const glm::vec3& position)
+{
+    std::uint32_t d = Resolve(handle);
+    if (d == kNone) return;
+    m_PosX[d] = position.x;
+    m_PosY[d] = position.y;
+    m_PosZ[d] = position.z;
+    MarkDirty(d);
+}
+
+void SceneStore::SetRotation(SceneHandle handle, const glm::quat& rotation)
+{
+    std::uint32_t d = Resolve(handle);
+    if (d == kNone) return;
+    float len = std::sqrt(rotation.x * rotation.x + rotation.y * rotation.y +
+                          rotation.z * rotation.z + rotation.w * rotation.w);
+    float inv = len > 0.0f ? 1.0f / len : 0.0f;
+    m_RotX[d] = rotation.x * inv;
+    m_RotY[d] = rotation.y * inv;
+    m_RotZ[d] = rotation.z * inv;
+    m_RotW[d] = len > 0.0f ? rotation.w * inv : 1.0f;
+    MarkDirty(d);
+}
+
+void SceneStore::SetRotationEuler(SceneHandle handle, const glm::vec3& eulerDeg)
+{
+    SetRotation(handle, EulerDegToQuat(eulerDeg));
+}
+
+void SceneStore::SetScale(SceneHandle handle, const glm::vec3& scale)
+{
+    std::uint32_t d = Resolve(handle);
+    if (d == kNone) return;
+    m_ScaleX[d] = scale.x;
+    m_ScaleY[d] = scale.y;
+    m_ScaleZ[d] = scale.z;
+    MarkDirty(d);
+}
+
+void SceneStore::SetTransform(SceneHandle handle, const Transform& transform)
+{
+    SetPosition(handle, transform.position);
+    SetRotationEuler(handle, transform.rotationEulerDeg);
+    SetScale(handle, transform.scale);
+}
+
+void SceneStore::SetMaterial(SceneHandle handle, std::uint32_t material)
+{
+    std::uint32_t d = Resolve(handle);
+    if (d != kNone) m_Material[d] = material;
+}
+
+void SceneStore::SetModel(SceneHandle handle, std::uint32_t model)
+{
+    std::uint32_t d = Resolve(handle);
+    if (d != kNone) m_Model[d] = model;
+}
+
+glm::vec3 SceneStore::GetPosition(SceneHandle handle) const
+{
+    std::uint32_t d = Resolve(handle);
+    if (d == kNone) return glm::vec3(0.0f);
+    return glm::vec3(m_PosX[d], m_PosY[d], m_PosZ[d]);
+}
+
+glm::quat SceneStore::GetRotation(SceneHandle handle) const
+{
+    std::uint32_t d = Resolve(handle);
+    if (d == kNone) return glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+    return glm::quat(m_RotW[d], m_RotX[d], m_RotY[d], m_RotZ[d]);
+}
+
+glm::vec3 SceneStore::GetScale(SceneHandle handle) const
+{
+    std::uint32_t d = Resolve(handle);
+    if (d == kNone) return glm::vec3(1.0f);
+    return glm::vec3(m_ScaleX[d], m_ScaleY[d], m_ScaleZ[d]);
+}
+
+void SceneStore::Compact()
+{
+    if (!m_DeadCount && !m_NeedsReorder) return;
+    const std::size_t n = m_World.size();
+
+    // 父节点已销毁的挂回根；世界矩阵要按局部变换重算
+    for (std::size_t d = 0; d < n; ++d)
+    {
+        std::uint32_t p = m_Parent[d];
+        if (m_DenseToSlot[d] != kNone && p != kNone && m_DenseToSlot[p] == kNone)
+        {
+            m_Parent[d] = kNone;
+            --m_ParentedCount;
+            m_Dirty[d] = 1;
+        }
+    }
+
+    std::vector<std::uint32_t> order;
+    order.reserve(n - m_DeadCount);
+    for (std::size_t d = 0; d < n; ++d)
+    {
+        if (m_DenseToSlot[d] != kNone) order.push_back((std::uint32_t)d);
+    }
+
+    if (m_NeedsReorder)
+    {
+        // 按深度稳定排序：父节点深度一定比子节点小，同一深度保持原来的相对顺序
+        std::vector<int> depth(n, -1);
+        std::vector<std::uint32_t> chain;
+        for (std::uint32_t d : order)
+        {
+            std::uint32_t a = d;
+            while (depth[a] < 0 && m_Parent[a] != kNone)
+            {
+                chain.push_back(a);
+                a = m_Parent[a];
+            }
+            if (depth[a] < 0) depth[a] = 0;
+            for (auto it = chain.rbegin(); it != chain.rend(); ++it)
+                depth[*it] = depth[m_Parent[*it]] + 1;
+            chain.clear();
+        }
+        std::stable_sort(order.begin(), order.end(),
+                         [&](std::uint32_t a, std::uint32_t b) { return depth[a] < depth[b]; });
+    }
+
+    std::vector<std::uint32_t> remap(n, kNone);
+    for (std::size_t i = 0; i < order.size(); ++i)
+        remap[order[i]] = (std::uint32_t)i;
+
+    for (std::vector<float>* column : { &m_PosX, &m_PosY, &m_PosZ, &m_RotX, &m_RotY, &m_RotZ, &m_RotW,
+                                        &m_ScaleX, &m_ScaleY, &m_ScaleZ })
+        Permute(*column, order);
+    Permute(m_World, order);
+    Permute(m_Parent, order);
+    Permute(m_Material, order);
+    Permute(m_Model, order);
+    Permute(m_Dirty, order);
+    Permute(m_DenseToSlot, order);
+
+    for (std::size_t i = 0; i < order.size(); ++i)
+    {
+        if (m_Parent[i] != kNone) m_Parent[i] = remap[m_Parent[i]];
+        m_Slots[m_DenseToSlot[i]].dense = (std::uint32_t)i;
+    }
+
+    // 下标全变了，脏区间按脏标记重新找
+    m_DirtyBegin = m_DirtyEnd = 0;
+    for (std::size_t i = 0; i < order.size(); ++i)
+    {
+        if (m_Dirty[i]) MarkDirty((std::uint32_t)i);
+    }
+
+    m_DeadCount = 0;
+    m_NeedsReorder = false;
+}
+
+std::size_t SceneStore::Update()
+{
+    Compact();
+    if (m_DirtyBegin == m_DirtyEnd) return 0;
+
+    const std::size_t begin = m_DirtyBegin;
+    std::size_t end = m_DirtyEnd;
+    const bool hierarchy = m_ParentedCount > 0;
+
+    // 父节点脏了子节点也脏；父在子前，一趟就能传到底
+    if (hierarchy)
+    {
+        end = m_World.size();
+        for (std::size_t d = begin; d < end; ++d)
+        {
+            std::uint32_t p = m_Parent[d];
+            if (p != kNone && m_Dirty[p]) m_Dirty[d] = 1;
+        }
+    }
+
+    ComputeLocalMatrices(m_PosX.data(), m_PosY.data(), m_PosZ.data(),
+                         m_RotX.data(), m_RotY.data(), m_RotZ.data(), m_RotW.data(),
+                         m_ScaleX.data(), m_ScaleY.data(), m_ScaleZ.data(),
+                         m_Dirty.data(), begin, end, m_World.data());
+
+    std::size_t updated = 0;
+    for (std::size_t d = begin; d < end; ++d)
+    {
+        if (!m_Dirty[d]) continue;
+        ++updated;
+        std::uint32_t p = m_Parent[d];
+        if (p != kNone) m_World[d] = m_World[p] * m_World[d];
+    }
+
+    std::memset(m_Dirty.data() + begin, 0, end - begin);
+    m_DirtyBegin = m_DirtyEnd = 0;
+    return updated;
+}
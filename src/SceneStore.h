@@ -0,0 +1,127 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include "Material.h"
+#include "Transform.h"
+
+// 实体句柄：槽位下标 + 代数。实体销毁后槽位的代数加一，旧句柄自然失效
+// 句柄在排序 / 压缩之后依然有效（变的是稠密下标，不是槽位）
+struct SceneHandle
+{
+    static constexpr std::uint32_t kInvalid = 0xFFFFFFFFu;
+
+    std::uint32_t index = kInvalid;
+    std::uint32_t generation = 0;
+
+    bool IsValid() const { return index != kInvalid; }
+    bool operator==(const SceneHandle& o) const { return index == o.index && generation == o.generation; }
+    bool operator!=(const SceneHandle& o) const { return !(*this == o); }
+};
+
+// SceneStore：面向数据的场景存储，替代 std::vector<Object> + 裸 Material*
+// - 位置 / 四元数 / 缩放按分量各存一列（SoA），世界矩阵缓存在连续数组里，渲染直接按稠密下标读
+// - 材质归 store 所有，实体只记材质 id；外部拿句柄，不再拿会悬空的指针
+// - 改了哪个实体就标脏，并扩大脏区间 [begin, end)；Update 只在脏区间里按 8 个一组跑 SIMD 内核
+// - 父子层级：稠密数组始终保持"父在子前"，所以一趟顺序扫描就能把世界矩阵从根传到叶子
+// - Destroy / 违反顺序的 SetParent 只记一笔，下一次 Update 时统一压缩、重排
+//   读稠密数组（Count / WorldMatrix / ...At）之前要先 Update
+class SceneStore
+{
+public:
+    static constexpr std::uint32_t kNone = 0xFFFFFFFFu;
+
+    // ---------------- 材质 ----------------
+    std::uint32_t AddMaterial(const Material& material);
+    Material& GetMaterial(std::uint32_t id) { return m_Materials[id]; }
+    const Material& GetMaterial(std::uint32_t id) const { return m_Materials[id]; }
+    int MaterialCount() const { return (int)m_Materials.size(); }
+
+    // ---------------- 实体 ----------------
+    // model 是调用方自己的模型 id（store 不关心模型是什么）；parent 无效时是根节点
+    SceneHandle Create(const Transform& transform, std::uint32_t material, std::uint32_t model,
+                       SceneHandle parent = SceneHandle());
+    void Destroy(SceneHandle handle);
+    bool IsAlive(SceneHandle handle) const { return Resolve(handle) != kNone; }
+    // 清空实体和材质，槽位代数保留（旧句柄不会误中新实体）
+    void Clear();
+    void Reserve(std::size_t count);
+
+    // 成环时返回 false，什么都不改；parent 无效表示挂回根
+    bool SetParent(SceneHandle child, SceneHandle parent);
+    SceneHandle GetParent(SceneHandle handle) const;
+
+    // 局部变换（相对父节点）；欧拉角和 Transform 的约定一致：度，X -> Y -> Z
+    void SetPosition(SceneHandle handle, const glm::vec3& position);
+    void SetRotation(SceneHandle handle, const glm::quat& rotation);
+    void SetRotationEuler(SceneHandle handle, const glm::vec3& eulerDeg);
+    void SetScale(SceneHandle handle, const glm::vec3& scale);
+    void SetTransform(SceneHandle handle, const Transform& transform);
+    void SetMaterial(SceneHandle handle, std::uint32_t material);
+    void SetModel(SceneHandle handle, std::uint32_t model);
+
+    glm::vec3 GetPosition(SceneHandle handle) const;
+    glm::quat GetRotation(SceneHandle handle) const;
+    glm::vec3 GetScale(SceneHandle handle) const;
+
+    void MarkAllDirty();
+
+    // 压缩 / 重排，然后重算所有脏实体的世界矩阵；返回这次更新了多少个矩阵
+    std::size_t Update();
+
+    // ---------------- 按稠密下标读（Update 之后） ----------------
+    int Count() const { return (int)m_World.size(); }
+    const glm::mat4& WorldMatrix(int i) const { return m_World[i]; }
+    const glm::mat4* WorldMatrices() const { return m_World.data(); }
+    std::uint32_t MaterialAt(int i) const { return m_Material[i]; }
+    std::uint32_t ModelAt(int i) const { return m_Model[i]; }
+    SceneHandle HandleAt(int i) const { return SceneHandle{ m_DenseToSlot[i], m_Slots[m_DenseToSlot[i]].generation }; }
+    // 句柄 -> 稠密下标（Update 之后有效），句柄失效时返回 -1
+    int DenseIndex(SceneHandle handle) const { std::uint32_t d = Resolve(handle); return d == kNone ? -1 : (int)d; }
+
+    bool HasHierarchy() const { return m_ParentedCount > 0; }
+
+    // 一批实体的局部 TRS -> 矩阵，[first, last) 里 dirty 非零的才写（dirty 为空时全写）
+    // 公开出来给 bench 对比用；AVX2 下 8 个一组，否则逐个标量
+    static void ComputeLocalMatrices(const float* px, const float* py, const float* pz,
+                                     const float* qx, const float* qy, const float* qz, const float* qw,
+                                     const float* sx, const float* sy, const float* sz,
+                                     const std::uint8_t* dirty, std::size_t first, std::size_t last,
+                                     glm::mat4* out);
+
+private:
+    struct Slot
+    {
+        std::uint32_t dense = kNone;
+        std::uint32_t generation = 0;
+    };
+
+    std::uint32_t Resolve(SceneHandle handle) const;
+    void MarkDirty(std::uint32_t dense);
+    void Compact();
+
+    std::vector<Material> m_Materials;
+
+    // 句柄 -> 稠密下标
+    std::vector<Slot> m_Slots;
+    std::vector<std::uint32_t> m_FreeSlots;
+    std::vector<std::uint32_t> m_DenseToSlot;      // 已销毁、还没压缩的是 kNone
+
+    // 稠密数组（SoA），下标一致
+    std::vector<float> m_PosX, m_PosY, m_PosZ;
+    std::vector<float> m_RotX, m_RotY, m_RotZ, m_RotW;
+    std::vector<float> m_ScaleX, m_ScaleY, m_ScaleZ;
+    std::vector<glm::mat4> m_World;
+    std::vector<std::uint32_t> m_Parent;            // 父节点的稠密下标，kNone 是根
+    std::vector<std::uint32_t> m_Material;
+    std::vector<std::uint32_t> m_Model;
+    std::vector<std::uint8_t> m_Dirty;
+
+    std::size_t m_DirtyBegin = 0;                   // 脏区间 [begin, end)，空区间 begin == end
+    std::size_t m_DirtyEnd = 0;
+    std::size_t m_ParentedCount = 0;
+    std::size_t m_DeadCount = 0;
+    bool m_NeedsReorder = false;                    // 有子节点排到了父节点前面
+};
@@ -1,4 +1,6 @@
 #include "Shader.h"
+#include "CpuProfiler.h"
+#include "render/DrawStats.h"
 
 #include <glad/glad.h>
 #include <cstdio>
@@ -12,6 +14,7 @@ static const char* ShaderTypeToString(unsigned int type)
     switch (type) {
         case GL_VERTEX_SHADER:   return "VERTEX";
         case GL_FRAGMENT_SHADER: return "FRAGMENT";
+        case GL_GEOMETRY_SHADER: return "GEOMETRY";
         default:                 return "UNKNOWN";
     }
 }
@@ -29,6 +32,19 @@ std::string Shader::ReadFile(const std::string& filepath)
     return ss.str();
 }
 
+std::string Shader::InjectDefines(const std::string& source, const std::string& defines)
+{
+    if (defines.empty()) return source;
+
+    // GLSL 要求 #version 必须是第一条语句，宏只能插在它后面
+    std::size_t pos = source.find("#version");
+    if (pos == std::string::npos) return defines + source;
+
+    std::size_t lineEnd = source.find('\n', pos);
+    if (lineEnd == std::string::npos) return source + "\n" + defines;
+    return source.substr(0, lineEnd + 1) + defines + source.substr(lineEnd + 1);
+}
+
 unsigned int Shader::CompileShader(unsigned int type, const std::string& source)
 {
     //创建shader对象 type为传进来的比如GL_VERTEX_SHADER GL_FRAGMENT_SHADER
@@ -60,9 +76,11 @@ unsigned int Shader::CompileShader(unsigned int type, const std::string& source)
     return id;
 }
 
-//将顶点着色器和片段着色器 组合成一个可用的program 后续添加额外着色器会扩展
-unsigned int Shader::CreateShaderProgram(const std::string& vertexSrc, const std::string& fragmentSrc)
+//将顶点着色器、（可选的）几何着色器和片段着色器 组合成一个可用的program
+unsigned int Shader::CreateShaderProgram(const std::string& vertexSrc, const std::string& fragmentSrc,
+                                         const std::string& geometrySrc)
 {
+    PROFILE_ZONE("Shader compile");
     //创建program
     unsigned int program = glCreateProgram();
 
@@ -70,16 +88,21 @@ unsigned int Shader::CreateShaderProgram(const std::string& vertexSrc, const std
     unsigned int vs = CompileShader(GL_VERTEX_SHADER, vertexSrc);
     //编译片段着色器
     unsigned int fs = CompileShader(GL_FRAGMENT_SHADER, fragmentSrc);
+    //几何着色器可选（分层渲染用），空串表示没有
+    bool hasGeometry = !geometrySrc.empty();
+    unsigned int gs = hasGeometry ? CompileShader(GL_GEOMETRY_SHADER, geometrySrc) : 0;
 
-    if (vs == 0 || fs == 0) {
+    if (vs == 0 || fs == 0 || (hasGeometry && gs == 0)) {
         if (vs) glDeleteShader(vs);
         if (fs) glDeleteShader(fs);
+        if (gs) glDeleteShader(gs);
         glDeleteProgram(program);
         return 0;
     }
 
     //挂载和连接
     glAttachShader(program, vs);
+    if (gs) glAttachShader(program, gs);
     glAttachShader(program, fs);
     glLinkProgram(program);
 
@@ -97,6 +120,7 @@ unsigned int Shader::CreateShaderProgram(const std::string& vertexSrc, const std
 
         glDeleteShader(vs);
         glDeleteShader(fs);
+        if (gs) glDeleteShader(gs);
         glDeleteProgram(program);
         return 0;
     }
@@ -104,8 +128,10 @@ unsigned int Shader::CreateShaderProgram(const std::string& vertexSrc, const std
     //清理
     glDetachShader(program, vs);
     glDetachShader(program, fs);
+    if (gs) glDetachShader(program, gs);
     glDeleteShader(vs);
     glDeleteShader(fs);
+    if (gs) glDeleteShader(gs);
 
     return program;
 }
@@ -141,6 +167,49 @@ Shader::Shader(const std::string& vertexPath, const std::string& fragmentPath)
     }
 }
 
+Shader::Shader(const std::string& vertexPath, const std::string& fragmentPath, const std::string& defines)
+{
+    std::string vertexSrc = ReadFile(vertexPath);
+    std::string fragmentSrc = ReadFile(fragmentPath);
+
+    if (vertexSrc.empty() || fragmentSrc.empty()) {
+        std::fprintf(stderr, "[Shader] Empty shader source. Vertex: %s, Fragment: %s\n",
+                     vertexPath.c_str(), fragmentPath.c_str());
+        m_RendererID = 0;
+        return;
+    }
+
+    m_RendererID = CreateShaderProgram(InjectDefines(vertexSrc, defines),
+                                       InjectDefines(fragmentSrc, defines));
+    if (m_RendererID == 0) {
+        std::fprintf(stderr, "[Shader] Failed to create shader program (%s + %s).\n",
+                     vertexPath.c_str(), fragmentPath.c_str());
+    }
+}
+
+Shader::Shader(const std::string& vertexPath, const std::string& geometryPath,
+               const std::string& fragmentPath, const std::string& defines)
+{
+    std::string vertexSrc = ReadFile(vertexPath);
+    std::string geometrySrc = ReadFile(geometryPath);
+    std::string fragmentSrc = ReadFile(fragmentPath);
+
+    if (vertexSrc.empty() || geometrySrc.empty() || fragmentSrc.empty()) {
+        std::fprintf(stderr, "[Shader] Empty shader source. Vertex: %s, Geometry: %s, Fragment: %s\n",
+                     vertexPath.c_str(), geometryPath.c_str(), fragmentPath.c_str());
+        m_RendererID = 0;
+        return;
+    }
+
+    m_RendererID = CreateShaderProgram(InjectDefines(vertexSrc, defines),
+                                       InjectDefines(fragmentSrc, defines),
+                                       InjectDefines(geometrySrc, defines));
+    if (m_RendererID == 0) {
+        std::fprintf(stderr, "[Shader] Failed to create shader program (%s + %s + %s).\n",
+                     vertexPath.c_str(), geometryPath.c_str(), fragmentPath.c_str());
+    }
+}
+
 Shader::~Shader()
 {
     if (m_RendererID)
@@ -150,27 +219,33 @@ Shader::~Shader()
 //渲染时切换当前程序
 void Shader::Bind() const
 {
+    DrawStats::UseProgram(m_RendererID);
     glUseProgram(m_RendererID);
 }
 
 void Shader::Unbind() const
 {
+    DrawStats::UseProgram(0);
     glUseProgram(0);
 }
 
 void Shader::setUniformMat4(const std::string& name, const glm::mat4& matrix)
 {
     int location = GetUniformLocation(name);
-    if (location != -1)
+    if (location != -1) {
+        DrawStats::Uniform();
         glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(matrix));
+    }
 }
 
 
 void Shader::setUniform4f(const std::string& name, float v0, float v1, float v2, float v3)
 {
     int location = GetUniformLocation(name);
-    if (location != -1)
+    if (location != -1) {
+        DrawStats::Uniform();
         glUniform4f(location,v0,v1,v2,v3);
+    }
 }
 
 void Shader::setUniform1i(const std::string& name, int v)
@@ -178,22 +253,55 @@ void Shader::setUniform1i(const std::string& name, int v)
     //把shader里的 u_Texture0（sampler2D）设置为 v
     //含义是  这个sampler 从 texture unit v 取纹理 （从 v 号坑的 (sampler2D → 找 unitv 的 GL_TEXTURE_2D) 取纹理）
     int location = GetUniformLocation(name);
-    if (location != -1)
+    if (location != -1) {
+        DrawStats::Uniform();
         glUniform1i(location, v);
+    }
+}
+
+void Shader::setUniform2f(const std::string& name, float v0, float v1)
+{
+    int location = GetUniformLocation(name);
+    if (location != -1) {
+        DrawStats::Uniform();
+        glUniform2f(location, v0, v1);
+    }
 }
 
 void Shader::setUniform3f(const std::string& name, float v0, float v1, float v2)
 {
     int location = GetUniformLocation(name);
-    if (location != -1)
+    if (location != -1) {
+        DrawStats::Uniform();
         glUniform3f(location,v0,v1,v2);
+    }
 }
 
 void Shader::setUniform1f(const std::string& name, float v)
 {
     int location = GetUniformLocation(name);
-    if (location != -1)
+    if (location != -1) {
+        DrawStats::Uniform();
         glUniform1f(location,v);
+    }
+}
+
+void Shader::setUniform3fv(const std::string& name, int count, const float* values)
+{
+    int location = GetUniformLocation(name);
+    if (location != -1) {
+        DrawStats::Uniform();
+        glUniform3fv(location, count, values);
+    }
+}
+
+void Shader::setUniform4fv(const std::string& name, int count, const float* values)
+{
+    int location = GetUniformLocation(name);
+    if (location != -1) {
+        DrawStats::Uniform();
+        glUniform4fv(location, count, values);
+    }
 }
 
 void Shader::SetMatrices(const glm::mat4& model, const glm::mat4& view, const glm::mat4& proj)
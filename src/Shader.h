@@ -12,6 +12,11 @@ class Shader
 {
 public:
     Shader(const std::string& vertexPath, const std::string& fragmentPath);
+    // defines：插到 #version 行之后的宏（例如 "#define USE_INSTANCING\n"），同一份 GLSL 编出不同变体
+    Shader(const std::string& vertexPath, const std::string& fragmentPath, const std::string& defines);
+    // 带几何着色器（例如一次 draw 用 gl_Layer 写立方体贴图的 6 个面）
+    Shader(const std::string& vertexPath, const std::string& geometryPath,
+           const std::string& fragmentPath, const std::string& defines);
     ~Shader();
 
     void Bind() const;
@@ -21,8 +26,13 @@ public:
     void setUniformMat4(const std::string& name, const glm::mat4& matrix);
     void setUniform4f(const std::string& name,float v0,float v1,float v2,float v3);
     void setUniform1i(const std::string& name,int v);
+    void setUniform2f(const std::string& name,float v0,float v1);
     void setUniform3f(const std::string& name,float v0,float v1,float v2);
     void setUniform1f(const std::string& name,float v);
+    // vec3 数组：values 连续存放 count 个 vec3
+    void setUniform3fv(const std::string& name,int count,const float* values);
+    // vec4 数组：values 连续存放 count 个 vec4
+    void setUniform4fv(const std::string& name,int count,const float* values);
     void SetMatrices(const glm::mat4& model, const glm::mat4& view, const glm::mat4& proj);
 
 private:
@@ -30,8 +40,10 @@ private:
     unsigned int m_RendererID = 0;
 
     static std::string ReadFile(const std::string& filepath);
+    static std::string InjectDefines(const std::string& source, const std::string& defines);
     //把GLSL文本->gpu能理解的shader object
     static unsigned int CompileShader(unsigned int type, const std::string& source);
-    static unsigned int CreateShaderProgram(const std::string& vertexSrc, const std::string& fragmentSrc);
+    static unsigned int CreateShaderProgram(const std::string& vertexSrc, const std::string& fragmentSrc,
+                                            const std::string& geometrySrc = std::string());
     int GetUniformLocation(const std::string& name) const;
 };
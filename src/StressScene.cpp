@@ -0,0 +1,469 @@
+#include "StressScene.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+
+#include "Model.h"
+
+namespace
+{
+    constexpr float kPi = 3.14159265358979f;
+
+    // (rows+1) x (cols+1) 个顶点的参数网格 -> 三角形，外侧是 CCW
+    void GridIndices(int rows, int cols, std::vector<unsigned int>& indices)
+    {
+        for (int r = 0; r < rows; ++r)
+        {
+            for (int c = 0; c < cols; ++c)
+            {
+                unsigned int a = (unsigned int)(r * (cols + 1) + c);
+                unsigned int b = a + (unsigned int)(cols + 1);
+                indices.insert(indices.end(), { a, a + 1, b, a + 1, b + 1, b });
+            }
+        }
+    }
+
+    // 半径 0.5，和 demo_cube 一样大
+    void BuildSphere(int stacks, int slices, std::vector<MeshVertex>& vertices, std::vector<unsigned int>& indices)
+    {
+        for (int st = 0; st <= stacks; ++st)
+        {
+            float phi = kPi * (float)st / (float)stacks;
+            for (int sl = 0; sl <= slices; ++sl)
+            {
+                float theta = 2.0f * kPi * (float)sl / (float)slices;
+                MeshVertex v;
+                v.normal = glm::vec3(std::sin(phi) * std::cos(theta), std::cos(phi), std::sin(phi) * std::sin(theta));
+                v.position = v.normal * 0.5f;
+                v.uv = glm::vec2((float)sl / (float)slices, 1.0f - (float)st / (float)stacks);
+                vertices.push_back(v);
+            }
+        }
+        GridIndices(stacks, slices, indices);
+    }
+
+    void BuildTorus(int rings, int sides, std::vector<MeshVertex>& vertices, std::vector<unsigned int>& indices)
+    {
+        const float major = 0.35f, minor = 0.15f;
+        for (int i = 0; i <= rings; ++i)
+        {
+            float u = 2.0f * kPi * (float)i / (float)rings;
+            glm::vec3 center(major * std::cos(u), 0.0f, major * std::sin(u));
+            for (int j = 0; j <= sides; ++j)
+            {
+                float v = 2.0f * kPi * (float)j / (float)sides;
+                MeshVertex vert;
+                vert.normal = glm::vec3(std::cos(v) * std::cos(u), std::sin(v), std::cos(v) * std::sin(u));
+                vert.position = center + vert.normal * minor;
+                vert.uv = glm::vec2((float)i / (float)rings, (float)j / (float)sides);
+                vertices.push_back(vert);
+            }
+        }
+        GridIndices(rings, sides, indices);
+    }
+
+    glm::vec3 HueToRgb(float h, float s, float v)
+    {
+        glm::vec3 rgb;
+        const float offsets[3] = { 0.0f, 4.0f, 2.0f };
+        for (int c = 0; c < 3; ++c)
+        {
+            float k = std::fmod(h * 6.0f + offsets[c], 6.0f);
+            rgb[c] = std::min(std::max(std::fabs(k - 3.0f) - 1.0f, 0.0f), 1.0f);
+        }
+        return v * (glm::vec3(1.0f - s) + s * rgb);
+    }
+
+    float Fract(float x)
+    {
+        return x - std::floor(x);
+    }
+
+    // 和 FrameTimingLog 一样的取法
+    double Percentile(std::vector<double> values, double p)
+    {
+        if (values.empty()) return 0.0;
+        std::sort(values.begin(), values.end());
+        std::size_t i = (std::size_t)(p * (double)(values.size() - 1) + 0.5);
+        return values[std::min(i, values.size() - 1)];
+    }
+}
+
+// ---------------------------------------------------------------------------
+// StressScene
+// ---------------------------------------------------------------------------
+
+StressScene::~StressScene() = default;
+
+void StressScene::SetResources(Shader* shader, Model* baseModel, Texture2D* albedo,
+                               std::uint32_t albedoArray, int albedoLayer)
+{
+    m_Shader = shader;
+    m_BaseModel = baseModel;
+    m_Albedo = albedo;
+    m_AlbedoArray = albedoArray;
+    m_AlbedoLayer = albedoLayer;
+}
+
+void StressScene::Generate(const StressSceneSettings& settings)
+{
+    m_Settings = settings;
+    m_Settings.objects = std::max(settings.objects, 0);
+    m_Settings.models = std::max(settings.models, 1);
+    m_Settings.materials = std::max(settings.materials, 1);
+    m_Settings.lights = std::max(settings.lights, 0);
+    m_Settings.clusters = std::max(settings.clusters, 1);
+    m_Settings.spacing = std::max(settings.spacing, 0.1f);
+
+    m_Store.Clear();
+    BuildModels(m_Settings.models);
+    BuildMaterials(m_Settings.materials);
+    // 物体和灯光各用一个随机流：改 L 不会把物体挪位置，反之亦然
+    BuildObjects(m_Settings.seed);
+    BuildLights(m_Settings.seed ^ 0x9e3779b9u);
+    m_UpdatedMatrices = m_Store.Update();
+
+    std::printf("[StressScene] %d objects (%s), %d models, %d materials, %d lights, %lld triangles\n",
+                m_Store.Count(), StressSceneSettings::LayoutName(m_Settings.layout), ModelCount(),
+                MaterialCount(), (int)m_Lights.size(), (long long)TriangleCount());
+}
+
+void StressScene::BuildModels(int count)
+{
+    // 模型 i（i >= 1）：奇数是球，偶数是圆环，细分随 i 增加，每个模型的三角形数都不同
+    int generated = std::max(count - 1, 0);
+    if ((int)m_Generated.size() > generated)
+        m_Generated.resize(generated);
+    while ((int)m_Generated.size() < generated)
+    {
+        int i = (int)m_Generated.size() + 1;
+        int detail = std::min(12 + 6 * ((i - 1) / 2), 96);
+        std::vector<MeshVertex> vertices;
+        std::vector<unsigned int> indices;
+        char name[64];
+        if (i % 2 == 1)
+        {
+            BuildSphere(detail / 2, detail, vertices, indices);
+            std::snprintf(name, sizeof(name), "Stress sphere %d", detail);
+        }
+        else
+        {
+            BuildTorus(detail, detail / 2, vertices, indices);
+            std::snprintf(name, sizeof(name), "Stress torus %d", detail);
+        }
+        auto model = std::make_unique<Model>();
+        model->LoadFromMesh(std::move(vertices), std::move(indices), name);
+        m_Generated.push_back(std::move(model));
+    }
+
+    m_Models.clear();
+    if (m_BaseModel) m_Models.push_back(m_BaseModel);
+    for (auto& model : m_Generated)
+        m_Models.push_back(model.get());
+}
+
+void StressScene::BuildMaterials(int count)
+{
+    // 前三种是原来网格的红 / 绿 / 蓝（蓝的是金属），之后按黄金分割取色相
+    static const glm::vec4 kPalette[3] = {
+        glm::vec4(1.0f, 0.3f, 0.2f, 1.0f),
+        glm::vec4(0.3f, 0.8f, 0.4f, 1.0f),
+        glm::vec4(0.3f, 0.5f, 1.0f, 1.0f),
+    };
+    for (int i = 0; i < count; ++i)
+    {
+        Material m;
+        m.shader = m_Shader;
+        m.albedo = m_Albedo;
+        m.albedoArray = m_AlbedoArray;
+        m.albedoLayer = m_AlbedoLayer;
+        if (i < 3)
+        {
+            m.color = kPalette[i];
+            m.metallic = (i == 2) ? 1.0f : 0.0f;
+            m.roughness = 0.25f + 0.3f * (float)i;
+        }
+        else
+        {
+            m.color = glm::vec4(HueToRgb(Fract((float)i * 0.618034f), 0.6f, 0.9f), 1.0f);
+            m.metallic = (i % 4 == 3) ? 1.0f : 0.0f;
+            m.roughness = 0.15f + 0.8f * Fract((float)i * 0.37f);
+        }
+        m_Store.AddMaterial(m);
+    }
+}
+
+void StressScene::BuildObjects(std::uint32_t seed)
+{
+    const StressSceneSettings& s = m_Settings;
+    const int n = s.objects;
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    m_Store.Reserve(n);
+    m_Handles.resize(n);
+    m_BasePositions.resize(n);
+    m_BaseYaw.resize(n);
+
+    // 随机 / 成团的区域取和网格一样的面积，三种布局的物体密度相同
+    const int side = std::max(1, (int)std::ceil(std::sqrt((float)n)));
+    const int rows = n > 0 ? (n + side - 1) / side : 1;
+    const int cols = (n + rows - 1) / rows;
+    const float half = 0.5f * (float)(side - 1) * s.spacing;
+
+    std::vector<glm::vec2> centers;
+    if (s.layout == StressSceneSettings::Layout::Clustered)
+    {
+        for (int c = 0; c < std::min(s.clusters, std::max(n, 1)); ++c)
+            centers.emplace_back((unit(rng) * 2.0f - 1.0f) * half, (unit(rng) * 2.0f - 1.0f) * half);
+    }
+    const float clusterSigma = half / std::sqrt((float)std::max((int)centers.size(), 1)) * 0.5f + s.spacing;
+    std::normal_distribution<float> gauss(0.0f, clusterSigma);
+
+    m_Radius = 0.0f;
+    for (int i = 0; i < n; ++i)
+    {
+        Transform t;
+        int material = 0;
+        int model = 0;
+        switch (s.layout)
+        {
+        case StressSceneSettings::Layout::Grid:
+        {
+            int ix = i / rows, iz = i % rows;
+            t.position = glm::vec3((float)ix * s.spacing - 0.5f * (float)(cols - 1) * s.spacing, 0.0f,
+                                               (float)iz * s.spacing - 0.5f * (float)(rows - 1) * s.spacing);
+            // 不超过三种时保持原来的棋盘式配色；更多时 (ix + iz) 只能取到 rows + cols - 1 种，改按序号轮流用满
+            material = s.materials <= 3 ? (ix + iz) % s.materials : i % s.materials;
+            model = i % (int)m_Models.size();
+            break;
+        }
+        case StressSceneSettings::Layout::Random:
+        case StressSceneSettings::Layout::Clustered:
+        {
+            glm::vec2 p;
+            if (centers.empty())
+                p = glm::vec2((unit(rng) * 2.0f - 1.0f) * half, (unit(rng) * 2.0f - 1.0f) * half);
+            else
+                p = centers[(std::size_t)i % centers.size()] + glm::vec2(gauss(rng), gauss(rng));
+            t.position = glm::vec3(p.x, (unit(rng) - 0.5f) * s.spacing, p.y);
+            t.rotationEulerDeg.y = unit(rng) * 360.0f;
+            t.scale = glm::vec3(0.6f + 0.6f * unit(rng));
+            material = std::min((int)(unit(rng) * (float)s.materials), s.materials - 1);
+            model = std::min((int)(unit(rng) * (float)m_Models.size()), (int)m_Models.size() - 1);
+            break;
+        }
+        }
+        m_Handles[i] = m_Store.Create(t, (std::uint32_t)material, (std::uint32_t)model);
+        m_BasePositions[i] = t.position;
+        m_BaseYaw[i] = t.rotationEulerDeg.y;
+        m_Radius = std::max(m_Radius, glm::length(glm::vec2(t.position.x, t.position.z)));
+    }
+    m_Radius += 0.5f * s.spacing;
+}
+
+void StressScene::BuildLights(std::uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    // 前两盏是原来场景的那两盏，之后的在场景上方随机撒
+    // 默认设置（3x3 网格）的半径算法和 BuildObjects 一致；场景不比它大时原样摆放，更大时按半径之比外推
+    const StressSceneSettings defaults;
+    const float defaultHalf = 0.5f * (float)((int)std::ceil(std::sqrt((float)defaults.objects)) - 1) * defaults.spacing;
+    const float defaultRadius = glm::length(glm::vec2(defaultHalf, defaultHalf)) + 0.5f * defaults.spacing;
+    const float scale = m_Radius > defaultRadius ? m_Radius / defaultRadius : 1.0f;
+    const float extent = std::max(m_Radius, 1.5f);
+    m_Lights.clear();
+    m_LightBase.clear();
+    for (int i = 0; i < m_Settings.lights; ++i)
+    {
+        PointLight light;
+        if (i == 0)
+            light = { glm::vec3(1.5f * scale, 4.0f, 2.0f * scale), glm::vec3(1.0f, 1.0f, 1.0f) };
+        else if (i == 1)
+            light = { glm::vec3(-1.5f * scale, 3.0f, -1.0f * scale), glm::vec3(1.0f, 0.5f, 0.2f) };
+        else
+        {
+            light.position = glm::vec3((unit(rng) * 2.0f - 1.0f) * extent, 1.5f + 2.5f * unit(rng),
+                                       (unit(rng) * 2.0f - 1.0f) * extent);
+            light.color = HueToRgb(Fract((float)i * 0.618034f + 0.3f), 0.5f, 1.0f);
+        }
+        m_Lights.push_back(light);
+        m_LightBase.push_back(light.position);
+    }
+}
+
+void StressScene::Update(float time)
+{
+    if (m_Settings.animate)
+    {
+        for (std::size_t i = 0; i < m_Handles.size(); ++i)
+        {
+            // 每个物体的转速和相位由下标决定
+            float speed = 30.0f + (float)((i * 37) % 60);
+            float phase = (float)((i * 131) % 628) * 0.01f;
+            m_Store.SetRotationEuler(m_Handles[i], glm::vec3(0.0f, m_BaseYaw[i] + speed * time, 0.0f));
+            m_Store.SetPosition(m_Handles[i],
+                                m_BasePositions[i] + glm::vec3(0.0f, 0.25f * std::sin(1.5f * time + phase), 0.0f));
+        }
+
+        for (std::size_t i = 0; i < m_Lights.size(); ++i)
+        {
+            float angle = time * (0.3f + 0.05f * (float)(i % 5));
+            float c = std::cos(angle), s = std::sin(angle);
+            const glm::vec3& p = m_LightBase[i];
+            m_Lights[i].position = glm::vec3(c * p.x - s * p.z, p.y, s * p.x + c * p.z);
+        }
+    }
+
+    m_UpdatedMatrices = m_Store.Update();
+}
+
+std::int64_t StressScene::TriangleCount() const
+{
+    std::vector<int> perModel;
+    for (Model* model : m_Models)
+        perModel.push_back(model->TriangleCount());
+    std::int64_t total = 0;
+    for (int i = 0; i < m_Store.Count(); ++i)
+        total += perModel[m_Store.ModelAt(i)];
+    return total;
+}
+
+// ---------------------------------------------------------------------------
+// StressSweep
+// ---------------------------------------------------------------------------
+
+const char* StressSweep::AxisName(Axis axis)
+{
+    switch (axis)
+    {
+        case Axis::Objects:   return "objects";
+        case Axis::Materials: return "materials";
+        case Axis::Lights:    return "lights";
+    }
+    return "?";
+}
+
+bool StressSweep::ParseAxis(const char* name, Axis& axis)
+{
+    for (Axis a : { Axis::Objects, Axis::Materials, Axis::Lights })
+    {
+        if (std::strcmp(name, AxisName(a)) == 0)
+        {
+            axis = a;
+            return true;
+        }
+    }
+    return false;
+}
+
+void StressSweep::Start(Axis axis, std::vector<int> values, int framesPerStep, int warmupFrames)
+{
+    m_Axis = axis;
+    m_Values = std::move(values);
+    m_FramesPerStep = std::max(framesPerStep, 1);
+    m_WarmupFrames = std::max(warmupFrames, 0);
+    m_Results.clear();
+    m_Step = 0;
+    m_Frame = 0;
+    m_Wall.clear();
+    m_Cpu.clear();
+    m_Gpu.clear();
+    m_DrawCalls = 0.0;
+    m_ProgramSwitches = 0.0;
+    m_Running = !m_Values.empty();
+}
+
+void StressSweep::Stop()
+{
+    m_Running = false;
+}
+
+void StressSweep::Configure(StressSceneSettings& settings) const
+{
+    if (m_Values.empty()) return;
+    int value = m_Values[std::min(m_Step, (int)m_Values.size() - 1)];
+    switch (m_Axis)
+    {
+        case Axis::Objects:   settings.objects = value; break;
+        case Axis::Materials: settings.materials = value; break;
+        case Axis::Lights:    settings.lights = value; break;
+    }
+}
+
+bool StressSweep::Record(double wallMs, double cpuMs, double gpuMs, long long drawCalls, long long programSwitches)
+{
+    if (!m_Running) return false;
+
+    // 换档后的头几帧有着色器预热、buffer 扩容、GPU 计时延迟读回，不进统计
+    if (m_Frame++ < m_WarmupFrames) return false;
+    m_Wall.push_back(wallMs);
+    m_Cpu.push_back(cpuMs);
+    m_Gpu.push_back(gpuMs);
+    m_DrawCalls += (double)drawCalls;
+    m_ProgramSwitches += (double)programSwitches;
+    if ((int)m_Wall.size() < m_FramesPerStep) return false;
+
+    FinishStep();
+    if (++m_Step >= (int)m_Values.size())
+    {
+        m_Running = false;
+        return false;
+    }
+    return true;
+}
+
+void StressSweep::FinishStep()
+{
+    Point p;
+    p.value = m_Values[m_Step];
+    double sum = 0.0;
+    for (double v : m_Wall) sum += v;
+    double n = (double)std::max<std::size_t>(m_Wall.size(), 1);
+    p.wallMean = sum / n;
+    p.wallP50 = Percentile(m_Wall, 0.50);
+    p.wallP95 = Percentile(m_Wall, 0.95);
+    p.cpuP50 = Percentile(m_Cpu, 0.50);
+    p.gpuP50 = Percentile(m_Gpu, 0.50);
+    p.drawCalls = m_DrawCalls / n;
+    p.programSwitches = m_ProgramSwitches / n;
+    m_Results.push_back(p);
+    std::printf("[StressSweep] %s = %d: wall p50 %.3f ms, p95 %.3f ms, gpu p50 %.3f ms, %.0f draws\n",
+                AxisName(m_Axis), p.value, p.wallP50, p.wallP95, p.gpuP50, p.drawCalls);
+
+    m_Frame = 0;
+    m_Wall.clear();
+    m_Cpu.clear();
+    m_Gpu.clear();
+    m_DrawCalls = 0.0;
+    m_ProgramSwitches = 0.0;
+}
+
+bool StressSweep::WriteJson(const std::string& path) const
+{
+    std::FILE* f = std::fopen(path.c_str(), "w");
+    if (!f)
+    {
+        std::fprintf(stderr, "[StressSweep] Failed to write %s\n", path.c_str());
+        return false;
+    }
+    std::fprintf(f, "{\n  \"axis\": \"%s\",\n  \"framesPerStep\": %d,\n  \"warmupFrames\": %d,\n  \"points\": [\n",
+                 AxisName(m_Axis), m_FramesPerStep, m_WarmupFrames);
+    for (std::size_t i = 0; i < m_Results.size(); ++i)
+    {
+        const Point& p = m_Results[i];
+        std::fprintf(f, "    { \"value\": %d, \"wallMean\": %.4f, \"wallP50\": %.4f, \"wallP95\": %.4f, "
+                        "\"cpuP50\": %.4f, \"gpuP50\": %.4f, \"drawCalls\": %.1f, \"programSwitches\": %.1f }%s\n",
+                     p.value, p.wallMean, p.wallP50, p.wallP95, p.cpuP50, p.gpuP50, p.drawCalls, p.programSwitches,
+                     i + 1 < m_Results.size() ? "," : "");
+    }
+    std::fprintf(f, "  ]\n}\n");
+    std::fclose(f);
+    std::printf("[StressSweep] Wrote %s\n", path.c_str());
+    return true;
+}
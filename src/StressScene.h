@@ -0,0 +1,193 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "Material.h"
+#include "SceneStore.h"
+#include "render/Light.h"
+
+class Model;
+class Shader;
+class Texture2D;
+
+// 压力场景的参数：N 个物体、M 种模型、K 种材质、L 个点光源
+// 默认值就是原来写死在 main 里的那个场景（3x3 网格、三种材质、两盏灯）
+struct StressSceneSettings
+{
+    enum class Layout
+    {
+        Grid,       // XZ 平面上的正方形网格
+        Random,     // 和网格同样密度的方形区域里均匀撒
+        Clustered,  // clusters 个团，团内正态分布
+    };
+
+    int objects = 9;
+    int models = 1;             // 模型 0 是 main 加载的立方体，其余是程序化的球 / 圆环（细分逐个增加）
+    int materials = 3;
+    int lights = 2;             // 超过 kMaxPointLights 的部分只生成不上传
+    Layout layout = Layout::Grid;
+    float spacing = 1.5f;       // 相邻物体的平均间距
+    int clusters = 8;
+    bool animate = false;       // 物体自转 + 上下浮动，灯光绕中心转
+    std::uint32_t seed = 1;
+
+    // 命令行和 JSON 里用的名字（Headless 解析参数时也用，所以放在头文件里）
+    static const char* LayoutName(Layout layout)
+    {
+        switch (layout)
+        {
+            case Layout::Grid:      return "grid";
+            case Layout::Random:    return "random";
+            case Layout::Clustered: return "clustered";
+        }
+        return "?";
+    }
+
+    static bool ParseLayout(const char* name, Layout& layout)
+    {
+        for (Layout l : { Layout::Grid, Layout::Random, Layout::Clustered })
+        {
+            if (std::strcmp(name, LayoutName(l)) == 0)
+            {
+                layout = l;
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+// StressScene：按 StressSceneSettings 生成物体、材质、灯光，给扩展性测试（剔除、instancing、灯光分桶）用
+// - 同一组参数和种子永远生成同一个场景，不同运行之间可比
+// - 所有材质共用同一张贴图（纹理数组的同一层），只有参数不同：K 影响的是材质切换，不是贴图数量
+// - 程序化模型按下标缓存，改 M 时只补上缺的、删掉多的
+// - 物体放在 SceneStore 里：材质归 store，物体只记材质 id / 模型 id，世界矩阵由 store 缓存
+// - Generate 会让之前拿到的句柄、材质引用失效
+class StressScene
+{
+public:
+    StressScene() = default;
+    ~StressScene();
+
+    StressScene(const StressScene&) = delete;
+    StressScene& operator=(const StressScene&) = delete;
+
+    // 所有材质用的 shader 和贴图，baseModel 是模型 0；都由调用方持有
+    void SetResources(Shader* shader, Model* baseModel, Texture2D* albedo, std::uint32_t albedoArray, int albedoLayer);
+
+    void Generate(const StressSceneSettings& settings);
+    // 动画（settings.animate）+ 更新 store 里的脏矩阵；time 是绝对时间（秒），同一时间得到同一姿态
+    // 没开动画时没有脏实体，几乎不花时间
+    void Update(float time);
+
+    const StressSceneSettings& Settings() const { return m_Settings; }
+    // 物体按 store 的稠密下标访问（0 .. Store().Count() - 1）
+    const SceneStore& Store() const { return m_Store; }
+    Model& ModelOf(int object) const { return *m_Models[m_Store.ModelAt(object)]; }
+    const Material& MaterialOf(int object) const { return m_Store.GetMaterial(m_Store.MaterialAt(object)); }
+    const std::vector<PointLight>& Lights() const { return m_Lights; }
+    int ModelCount() const { return (int)m_Models.size(); }
+    int MaterialCount() const { return m_Store.MaterialCount(); }
+    // 三角形总数（按每个物体的模型累加）
+    std::int64_t TriangleCount() const;
+    // 包住所有物体的半径（以原点为中心，XZ 平面），相机环绕路径用
+    float Radius() const { return m_Radius; }
+    // 上一次 Update 重算了多少个世界矩阵（静止场景是 0）
+    std::size_t UpdatedMatrices() const { return m_UpdatedMatrices; }
+
+private:
+    void BuildModels(int count);
+    void BuildMaterials(int count);
+    void BuildObjects(std::uint32_t seed);
+    void BuildLights(std::uint32_t seed);
+
+    Shader* m_Shader = nullptr;
+    Model* m_BaseModel = nullptr;
+    Texture2D* m_Albedo = nullptr;
+    std::uint32_t m_AlbedoArray = 0;
+    int m_AlbedoLayer = -1;
+
+    StressSceneSettings m_Settings;
+
+    std::vector<std::unique_ptr<Model>> m_Generated;    // 程序化模型，下标 i 对应模型 i + 1
+    std::vector<Model*> m_Models;
+    SceneStore m_Store;
+    std::vector<SceneHandle> m_Handles;                 // 第 i 个生成的物体
+    std::size_t m_UpdatedMatrices = 0;
+
+    // 动画的起点：Update 每次都从这里算，不累积误差
+    std::vector<glm::vec3> m_BasePositions;
+    std::vector<float> m_BaseYaw;
+
+    std::vector<PointLight> m_Lights;
+    std::vector<glm::vec3> m_LightBase;
+    float m_Radius = 0.0f;
+};
+
+// StressSweep：把某一个参数按一串取值逐档跑，每档先热身再测 framesPerStep 帧，得到"帧时间 - 参数"曲线
+// - 每帧由 main 调 Record；一档测完时把下一档写进场景参数，main 照着重建场景
+// - wallMs 是到提交完为止的墙钟时间（不含 swap / vsync 等待），cpuMs / gpuMs 来自渲染图
+class StressSweep
+{
+public:
+    enum class Axis
+    {
+        Objects,
+        Materials,
+        Lights,
+    };
+
+    struct Point
+    {
+        int value = 0;
+        double wallMean = 0.0;
+        double wallP50 = 0.0;
+        double wallP95 = 0.0;
+        double cpuP50 = 0.0;
+        double gpuP50 = 0.0;
+        double drawCalls = 0.0;     // 每帧平均
+        double programSwitches = 0.0;
+    };
+
+    static const char* AxisName(Axis axis);
+    static bool ParseAxis(const char* name, Axis& axis);
+
+    void Start(Axis axis, std::vector<int> values, int framesPerStep, int warmupFrames);
+    void Stop();
+    bool IsRunning() const { return m_Running; }
+
+    // 把当前档的取值写进 settings
+    void Configure(StressSceneSettings& settings) const;
+
+    // 记一帧；这一档测完、换到下一档时返回 true（调用方用 Configure 重建场景）
+    bool Record(double wallMs, double cpuMs, double gpuMs, long long drawCalls, long long programSwitches);
+
+    // 一共还要多少帧（headless 用它决定 --frames 的下限）
+    int TotalFrames() const { return (int)m_Values.size() * (m_FramesPerStep + m_WarmupFrames); }
+    int CurrentStep() const { return m_Step; }
+    int StepCount() const { return (int)m_Values.size(); }
+    Axis GetAxis() const { return m_Axis; }
+
+    const std::vector<Point>& Results() const { return m_Results; }
+    bool WriteJson(const std::string& path) const;
+
+private:
+    void FinishStep();
+
+    Axis m_Axis = Axis::Objects;
+    std::vector<int> m_Values;
+    int m_FramesPerStep = 120;
+    int m_WarmupFrames = 10;
+
+    bool m_Running = false;
+    int m_Step = 0;
+    int m_Frame = 0;
+    std::vector<double> m_Wall, m_Cpu, m_Gpu;
+    double m_DrawCalls = 0.0;
+    double m_ProgramSwitches = 0.0;
+    std::vector<Point> m_Results;
+};
@@ -1,6 +1,11 @@
 #include "Texture2D.h"
+#include "CpuProfiler.h"
+#include "render/DrawStats.h"
+#include "render/GpuMemory.h"
 #include <glad/glad.h>
+#include <algorithm>
 #include <cstdio>
+#include <vector>
 
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
@@ -17,8 +22,20 @@ static GLenum ChannelsToFormat(int channels)
     }
 }
 
+// 流送纹理的内部格式，规则和构造函数里一致
+static GLenum ChannelsToInternalFormat(int channels, bool srgb)
+{
+    GLenum format = ChannelsToFormat(channels);
+    if (srgb) {
+        if (format == GL_RGB)  return GL_SRGB;
+        if (format == GL_RGBA) return GL_SRGB_ALPHA;
+    }
+    return format;
+}
+
 Texture2D::Texture2D(const std::string& path, bool srgb, bool flipY)
 {
+    PROFILE_ZONE("Texture2D load");
     // 1) 设置 stb_image 是否翻转
     // OpenGL 的 UV 约定通常认为 v=0 在底部；很多图片数据第一行是“顶部”
     stbi_set_flip_vertically_on_load(flipY ? 1 : 0);
@@ -78,15 +95,45 @@ Texture2D::Texture2D(const std::string& path, bool srgb, bool flipY)
 
     // 8) 生成 mipmap（否则远处会闪烁/摩尔纹）
     glGenerateMipmap(GL_TEXTURE_2D);
+    m_Srgb = srgb;
+    m_MipCount = ComputeMipCount(m_Width, m_Height);
+    GpuMemory::TrackTexture(m_ID, GpuMemory::Category::Textures, path,
+                            GpuMemory::TextureBytes(internalFormat, m_Width, m_Height, 1, m_MipCount));
 
     // 9) 解绑 + 释放 CPU 数据
     glBindTexture(GL_TEXTURE_2D, 0);
     stbi_image_free(data);
 }
 
+Texture2D::Texture2D(int width, int height, int channels, bool srgb, const std::string& name)
+    : m_Width(width), m_Height(height), m_Channels(channels), m_Srgb(srgb), m_Streamed(true)
+{
+    m_MipCount = ComputeMipCount(width, height);
+
+    glGenTextures(1, &m_ID);
+    glBindTexture(GL_TEXTURE_2D, m_ID);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    // MAX_LEVEL 固定为最小 mip，BASE_LEVEL 随驻留情况变化
+    // 纹理完整性只检查 [BASE, MAX] 区间，所以更精细的级别可以一直不定义（不占显存）
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, m_MipCount - 1);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    // 先登记 0 字节，UploadMip / SetResidentBaseMip 按驻留的 mip 改
+    GpuMemory::TrackTexture(m_ID, GpuMemory::Category::Textures, name, 0);
+
+    // 占位：最低级 1x1 灰色，流送数据到之前先用它渲染
+    std::vector<unsigned char> grey((std::size_t)std::max(channels, 1), 128);
+    m_ResidentBase = m_MipCount - 1;
+    UploadMip(m_ResidentBase, grey.data());
+    SetResidentBaseMip(m_ResidentBase);
+}
+
 Texture2D::~Texture2D()
 {
     // RAII：对象销毁时释放 GPU 资源
+    GpuMemory::FreeTexture(m_ID);
     if (m_ID) glDeleteTextures(1, &m_ID);
 }
 
@@ -97,6 +144,10 @@ Texture2D::Texture2D(Texture2D&& other) noexcept
     m_Width = other.m_Width;
     m_Height = other.m_Height;
     m_Channels = other.m_Channels;
+    m_Srgb = other.m_Srgb;
+    m_Streamed = other.m_Streamed;
+    m_MipCount = other.m_MipCount;
+    m_ResidentBase = other.m_ResidentBase;
 
     // 对方置空，避免析构时重复 delete
     other.m_ID = 0;
@@ -108,6 +159,7 @@ Texture2D& Texture2D::operator=(Texture2D&& other) noexcept
     if (this == &other) return *this;
 
     // 先释放自己原来的资源，避免泄漏
+    GpuMemory::FreeTexture(m_ID);
     if (m_ID) glDeleteTextures(1, &m_ID);
 
     // 再接管对方资源
@@ -115,6 +167,10 @@ Texture2D& Texture2D::operator=(Texture2D&& other) noexcept
     m_Width = other.m_Width;
     m_Height = other.m_Height;
     m_Channels = other.m_Channels;
+    m_Srgb = other.m_Srgb;
+    m_Streamed = other.m_Streamed;
+    m_MipCount = other.m_MipCount;
+    m_ResidentBase = other.m_ResidentBase;
 
     other.m_ID = 0;
     other.m_Width = other.m_Height = other.m_Channels = 0;
@@ -133,11 +189,76 @@ void Texture2D::Bind(unsigned int slot) const
     // shader 里的 sampler2D uniform = slot 编号
     // glActiveTexture 选择“当前操作的纹理单元”
     glActiveTexture(GL_TEXTURE0 + slot);
+    DrawStats::BindTexture();
     // 把该纹理对象(其实是m_ID句柄  类似于qimage 和 qimage的指针  但是效果是绑定句柄代表的对象即纹理对象)绑定到当前纹理单元的 GL_TEXTURE_2D 绑定点
     glBindTexture(GL_TEXTURE_2D, m_ID);
 }
 
 void Texture2D::Unbind() const
 {
+    DrawStats::BindTexture();
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+int Texture2D::ComputeMipCount(int width, int height)
+{
+    int size = std::max(width, height);
+    int count = 1;
+    while (size > 1) {
+        size >>= 1;
+        ++count;
+    }
+    return count;
+}
+
+std::size_t Texture2D::BytesFromMip(int level) const
+{
+    std::size_t bytes = 0;
+    for (int i = std::max(level, 0); i < m_MipCount; ++i)
+    {
+        std::size_t w = (std::size_t)std::max(1, m_Width >> i);
+        std::size_t h = (std::size_t)std::max(1, m_Height >> i);
+        bytes += w * h * (std::size_t)m_Channels;
+    }
+    return bytes;
+}
+
+void Texture2D::UploadMip(int level, const unsigned char* pixels)
+{
+    if (!m_ID || level < 0 || level >= m_MipCount) return;
+
+    GLenum format = ChannelsToFormat(m_Channels);
+    GLenum internalFormat = ChannelsToInternalFormat(m_Channels, m_Srgb);
+
+    int w = std::max(1, m_Width >> level);
+    int h = std::max(1, m_Height >> level);
+
+    glBindTexture(GL_TEXTURE_2D, m_ID);
+    // 小 mip 的行宽经常不是 4 的倍数（比如 RGB 1x1 = 3 字节），上传时按 1 字节对齐
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, level, internalFormat, w, h, 0, format, GL_UNSIGNED_BYTE, pixels);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    // 流送从粗到细逐级上传，新传的级别到 BASE 之间都已定义
+    GpuMemory::Resize(GpuMemory::Kind::Texture, m_ID, BytesFromMip(std::min(level, m_ResidentBase)));
+}
+
+void Texture2D::SetResidentBaseMip(int base)
+{
+    if (!m_ID) return;
+    base = std::max(0, std::min(base, m_MipCount - 1));
+
+    glBindTexture(GL_TEXTURE_2D, m_ID);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, base);
+
+    // 淘汰：把 base 之前的级别重新定义成 0x0，驱动会回收这部分存储
+    GLenum format = ChannelsToFormat(m_Channels);
+    GLenum internalFormat = ChannelsToInternalFormat(m_Channels, m_Srgb);
+    for (int level = m_ResidentBase; level < base; ++level)
+        glTexImage2D(GL_TEXTURE_2D, level, internalFormat, 0, 0, 0, format, GL_UNSIGNED_BYTE, nullptr);
+
     glBindTexture(GL_TEXTURE_2D, 0);
+    m_ResidentBase = base;
+    GpuMemory::Resize(GpuMemory::Kind::Texture, m_ID, ResidentBytes());
 }
@@ -1,4 +1,5 @@
 #pragma once
+#include <cstddef>
 #include <string>
 
 // Texture2D: 封装 OpenGL 2D 纹理对象（GL_TEXTURE_2D）
@@ -13,6 +14,11 @@ public:
     // srgb: 是否以 sRGB 内部格式存储（颜色贴图通常 true；数据贴图必须 false）
     // flipY: 是否在加载时上下翻转（解决图片坐标原点与 UV 约定差异）
     explicit Texture2D(const std::string& path, bool srgb = false, bool flipY = true);
+
+    // 流送模式：只创建纹理对象，不上传像素
+    // 先放一个 1x1 的灰色最低级 mip 保证纹理完整，真正的 mip 由 TextureStreamer 按需上传
+    // name: 显存统计里的资源名（通常是图片路径）
+    Texture2D(int width, int height, int channels, bool srgb, const std::string& name = "streamed");
     ~Texture2D();
 
     // 禁用拷贝：避免两个对象持有同一个 OpenGL texture id 导致重复释放
@@ -35,9 +41,32 @@ public:
     int Height() const { return m_Height; }
     int Channels() const { return m_Channels; }
 
+    // ---------------- 流送相关 ----------------
+    // mip 级数 = floor(log2(max(w,h))) + 1
+    int MipCount() const { return m_MipCount; }
+    bool IsStreamed() const { return m_Streamed; }
+    // 当前驻留在显存里的最高精度 mip（GL_TEXTURE_BASE_LEVEL）
+    int ResidentBaseMip() const { return m_ResidentBase; }
+
+    // 上传某一级 mip（pixels 已经是该级尺寸，紧密排列）；调用方保证在主线程
+    void UploadMip(int level, const unsigned char* pixels);
+    // 把 BASE_LEVEL 设为 base；比 base 更精细的已驻留 mip 会被释放
+    void SetResidentBaseMip(int base);
+
+    // 从 level 到最小 mip 的总字节数（按 8bit/通道估算）
+    std::size_t BytesFromMip(int level) const;
+    std::size_t ResidentBytes() const { return BytesFromMip(m_ResidentBase); }
+
+    static int ComputeMipCount(int width, int height);
+
 private:
     unsigned int m_ID = 0; // OpenGL 纹理对象句柄（glGenTextures 得到）
     int m_Width = 0;
     int m_Height = 0;
     int m_Channels = 0;
+
+    bool m_Srgb = false;
+    bool m_Streamed = false;
+    int m_MipCount = 1;
+    int m_ResidentBase = 0;
 };
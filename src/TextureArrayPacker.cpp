@@ -0,0 +1,150 @@
+#include "TextureArrayPacker.h"
+
+#include "Texture2D.h"
+#include "ThreadPool.h"
+#include "render/GpuMemory.h"
+
+#include <glad/glad.h>
+#include <cstdio>
+
+#include <stb_image.h>
+
+TextureArrayPacker::~TextureArrayPacker()
+{
+    Destroy();
+}
+
+int TextureArrayPacker::Add(const std::string& path, bool srgb, bool flipY)
+{
+    // 同一张图重复登记时复用
+    for (std::size_t i = 0; i < m_Requests.size(); ++i)
+    {
+        const Request& r = m_Requests[i];
+        if (r.path == path && r.srgb == srgb && r.flipY == flipY) return (int)i;
+    }
+
+    Request r;
+    r.path = path;
+    r.srgb = srgb;
+    r.flipY = flipY;
+    m_Requests.push_back(r);
+    return (int)m_Requests.size() - 1;
+}
+
+TextureArrayPacker::Slot TextureArrayPacker::GetSlot(int index) const
+{
+    if (index < 0 || index >= (int)m_Requests.size()) return Slot{};
+    return m_Requests[index].slot;
+}
+
+bool TextureArrayPacker::Build(ThreadPool* pool)
+{
+    Destroy();
+
+    // 1) 并行解码（stb 的 flip 用线程局部版本）
+    struct Decoded
+    {
+        unsigned char* pixels = nullptr;
+        int width = 0;
+        int height = 0;
+    };
+    std::vector<Decoded> decoded(m_Requests.size());
+
+    auto decodeRange = [&](int begin, int end) {
+        for (int i = begin; i < end; ++i)
+        {
+            const Request& r = m_Requests[i];
+            stbi_set_flip_vertically_on_load_thread(r.flipY ? 1 : 0);
+            int comp = 0;
+            decoded[i].pixels = stbi_load(r.path.c_str(), &decoded[i].width, &decoded[i].height, &comp, 4);
+        }
+    };
+    if (pool)
+        pool->ParallelFor((int)m_Requests.size(), decodeRange);
+    else
+        decodeRange(0, (int)m_Requests.size());
+
+    // 2) 按 (宽, 高, 格式类) 分组，分配 layer
+    for (std::size_t i = 0; i < m_Requests.size(); ++i)
+    {
+        Request& r = m_Requests[i];
+        if (!decoded[i].pixels) {
+            std::fprintf(stderr, "[TextureArrayPacker] Failed to load: %s\n", r.path.c_str());
+            continue;
+        }
+
+        int group = -1;
+        for (std::size_t g = 0; g < m_Groups.size(); ++g)
+        {
+            const Group& gr = m_Groups[g];
+            if (gr.width == decoded[i].width && gr.height == decoded[i].height && gr.srgb == r.srgb) {
+                group = (int)g;
+                break;
+            }
+        }
+        if (group < 0) {
+            Group gr;
+            gr.width = decoded[i].width;
+            gr.height = decoded[i].height;
+            gr.srgb = r.srgb;
+            m_Groups.push_back(gr);
+            group = (int)m_Groups.size() - 1;
+        }
+
+        r.slot.group = group;
+        r.slot.layer = m_Groups[group].layers++;
+    }
+
+    // 3) 每组一个纹理数组：先分配所有 layer，再逐层上传，最后统一生成 mipmap
+    for (std::size_t g = 0; g < m_Groups.size(); ++g)
+    {
+        Group& gr = m_Groups[g];
+        glGenTextures(1, &gr.texture);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, gr.texture);
+        glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, gr.srgb ? GL_SRGB8_ALPHA8 : GL_RGBA8,
+                     gr.width, gr.height, gr.layers, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+
+        for (std::size_t i = 0; i < m_Requests.size(); ++i)
+        {
+            Request& r = m_Requests[i];
+            if (r.slot.group != (int)g) continue;
+            glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, r.slot.layer,
+                            gr.width, gr.height, 1, GL_RGBA, GL_UNSIGNED_BYTE, decoded[i].pixels);
+            r.slot.texture = gr.texture;
+        }
+
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        // 每层各自降采样，层与层之间不会串色（图集需要 padding 才能做到）
+        glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+        char name[64];
+        std::snprintf(name, sizeof(name), "Texture array %dx%d %s", gr.width, gr.height, gr.srgb ? "sRGB" : "linear");
+        GpuMemory::TrackTexture(gr.texture, GpuMemory::Category::Textures, name,
+                                GpuMemory::TextureBytes(gr.srgb ? GL_SRGB8_ALPHA8 : GL_RGBA8, gr.width, gr.height,
+                                                        gr.layers, Texture2D::ComputeMipCount(gr.width, gr.height)));
+
+        std::printf("[TextureArrayPacker] Group %zu: %dx%d %s, %d layers\n",
+                    g, gr.width, gr.height, gr.srgb ? "sRGB" : "linear", gr.layers);
+    }
+
+    for (Decoded& d : decoded)
+        if (d.pixels) stbi_image_free(d.pixels);
+
+    return !m_Groups.empty();
+}
+
+void TextureArrayPacker::Destroy()
+{
+    for (Group& g : m_Groups)
+        if (g.texture) {
+            GpuMemory::FreeTexture(g.texture);
+            glDeleteTextures(1, &g.texture);
+        }
+    m_Groups.clear();
+    for (Request& r : m_Requests)
+        r.slot = Slot{};
+}
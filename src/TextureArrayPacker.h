@@ -0,0 +1,60 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class ThreadPool;
+
+// TextureArrayPacker：加载时把同尺寸、同格式类的材质贴图打包进 GL_TEXTURE_2D_ARRAY
+// 目的：材质之间不再需要切换纹理绑定，不同材质的物体可以合并成一次 instanced draw，
+//       实例数据里带 layer 下标即可
+// 分组规则：(宽, 高, 格式类)；格式类只有 sRGB / 线性两种，所有贴图统一扩成 RGBA8
+class TextureArrayPacker
+{
+public:
+    // 打包后某张贴图的位置
+    struct Slot
+    {
+        std::uint32_t texture = 0;  // GL_TEXTURE_2D_ARRAY 对象
+        int layer = -1;
+        int group = -1;
+        bool IsValid() const { return texture != 0 && layer >= 0; }
+    };
+
+    struct Group
+    {
+        int width = 0;
+        int height = 0;
+        bool srgb = false;
+        int layers = 0;
+        std::uint32_t texture = 0;
+    };
+
+    TextureArrayPacker() = default;
+    ~TextureArrayPacker();
+
+    TextureArrayPacker(const TextureArrayPacker&) = delete;
+    TextureArrayPacker& operator=(const TextureArrayPacker&) = delete;
+
+    // 登记一张贴图，返回下标（Build 之后用 GetSlot 查结果）
+    int Add(const std::string& path, bool srgb = true, bool flipY = true);
+
+    // 并行解码所有登记的贴图，分组并创建纹理数组；只在主线程调用
+    bool Build(ThreadPool* pool = nullptr);
+    void Destroy();
+
+    Slot GetSlot(int index) const;
+    const std::vector<Group>& Groups() const { return m_Groups; }
+
+private:
+    struct Request
+    {
+        std::string path;
+        bool srgb = true;
+        bool flipY = true;
+        Slot slot;
+    };
+
+    std::vector<Request> m_Requests;
+    std::vector<Group> m_Groups;
+};
@@ -1,5 +1,10 @@
 #include "TextureHDR.h"
+#include "HalfFloat.h"
+#include "RadianceHDR.h"
+#include "ThreadPool.h"
+#include "render/GpuMemory.h"
 #include <glad/glad.h>
+#include <chrono>
 #include <cstdio>
 
 // stb_image 支持 HDR 加载
@@ -10,10 +15,99 @@ TextureHDR::~TextureHDR()
     Destroy();
 }
 
-bool TextureHDR::Load(const std::string& path)
+bool TextureHDR::Load(const std::string& path, Decode decode)
 {
     Destroy();
+    if (decode == Decode::StbFloat) return LoadStb(path);
 
+    auto t0 = std::chrono::high_resolution_clock::now();
+
+    RadianceHDR image;
+    RadianceHDR::Output output = (decode == Decode::RGBE) ? RadianceHDR::Output::RGBE
+                                                          : RadianceHDR::Output::Half;
+    if (!image.Load(path, output, true, &ThreadPool::Global())) {
+        // 不支持的朝向/格式交给 stb 兜底
+        std::fprintf(stderr, "[TextureHDR] Falling back to stb_image: %s\n", path.c_str());
+        return LoadStb(path);
+    }
+    auto t1 = std::chrono::high_resolution_clock::now();
+
+    int w = image.Width();
+    int h = image.Height();
+
+    glGenTextures(1, &m_TexID);
+    glBindTexture(GL_TEXTURE_2D, m_TexID);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    if (output == RadianceHDR::Output::Half) {
+        // 源数据已经是 half，驱动不用再在 CPU 上转换，上传字节数也是 GL_FLOAT 的一半
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB16F, w, h, 0, GL_RGB, GL_HALF_FLOAT, image.HalfData());
+    } else {
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, w, h, 0, GL_RGBA, GL_UNSIGNED_BYTE, image.RGBEData());
+    }
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    GpuMemory::TrackTexture(m_TexID, GpuMemory::Category::Environment, path,
+                            GpuMemory::TextureBytes(output == RadianceHDR::Output::Half ? GL_RGB16F : GL_RGBA8, w, h));
+
+    // RGBE 不能在编码空间里做线性插值（指数不同的像素混在一起会出错），只能 NEAREST
+    GLint filter = (output == RadianceHDR::Output::Half) ? GL_LINEAR : GL_NEAREST;
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    auto t2 = std::chrono::high_resolution_clock::now();
+
+    if (output == RadianceHDR::Output::Half) {
+        m_HalfPixels = image.ReleaseHalf();
+    } else {
+        m_HalfPixels.resize((std::size_t)w * h * 3);
+        const std::uint8_t* rgbe = image.RGBEData();
+        for (std::size_t i = 0; i < (std::size_t)w * h; ++i)
+        {
+            float rgb[3];
+            RadianceHDR::RGBEToFloat(rgbe + i * 4, rgb);
+            FloatToHalfArray(rgb, m_HalfPixels.data() + i * 3, 3);
+        }
+    }
+
+    m_Width = w;
+    m_Height = h;
+    m_IsRGBE = (output == RadianceHDR::Output::RGBE);
+    std::printf("[TextureHDR] Loaded: %s (%dx%d, %s) decode %.2f ms, upload %.2f ms\n",
+                path.c_str(), w, h, m_IsRGBE ? "RGBE8" : "RGB16F half",
+                std::chrono::duration<double, std::milli>(t1 - t0).count(),
+                std::chrono::duration<double, std::milli>(t2 - t1).count());
+    return true;
+}
+
+bool TextureHDR::LoadFromHalf(std::vector<std::uint16_t> pixels, int width, int height,
+                              const std::string& name)
+{
+    Destroy();
+    if (width <= 0 || height <= 0 || pixels.size() != (std::size_t)width * height * 3) return false;
+
+    glGenTextures(1, &m_TexID);
+    glBindTexture(GL_TEXTURE_2D, m_TexID);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB16F, width, height, 0, GL_RGB, GL_HALF_FLOAT, pixels.data());
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    GpuMemory::TrackTexture(m_TexID, GpuMemory::Category::Environment, name,
+                            GpuMemory::TextureBytes(GL_RGB16F, width, height));
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    m_Width = width;
+    m_Height = height;
+    return true;
+}
+
+bool TextureHDR::LoadStb(const std::string& path)
+{
     // stbi_loadf 返回 float* 数组（每像素 RGB 三个 float）
     stbi_set_flip_vertically_on_load(true);
     int w, h, channels;
@@ -28,6 +122,8 @@ bool TextureHDR::Load(const std::string& path)
 
     // 内部格式 GL_RGB16F（16bit 浮点），数据类型 GL_FLOAT
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB16F, w, h, 0, GL_RGB, GL_FLOAT, data);
+    GpuMemory::TrackTexture(m_TexID, GpuMemory::Category::Environment, path,
+                            GpuMemory::TextureBytes(GL_RGB16F, w, h));
 
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
@@ -35,6 +131,8 @@ bool TextureHDR::Load(const std::string& path)
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
     glBindTexture(GL_TEXTURE_2D, 0);
+    m_HalfPixels.resize((std::size_t)w * h * 3);
+    FloatToHalfArray(data, m_HalfPixels.data(), m_HalfPixels.size());
     stbi_image_free(data);
 
     m_Width = w;
@@ -46,9 +144,18 @@ bool TextureHDR::Load(const std::string& path)
 void TextureHDR::Destroy()
 {
     if (m_TexID) {
+        GpuMemory::FreeTexture(m_TexID);
         glDeleteTextures(1, &m_TexID);
         m_TexID = 0;
     }
     m_Width = 0;
     m_Height = 0;
+    m_IsRGBE = false;
+    ReleaseHalfPixels();
+}
+
+void TextureHDR::ReleaseHalfPixels()
+{
+    m_HalfPixels.clear();
+    m_HalfPixels.shrink_to_fit();
 }
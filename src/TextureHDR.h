@@ -4,23 +4,50 @@
 #pragma once
 #include <cstdint>
 #include <string>
+#include <vector>
 
 class TextureHDR
 {
 public:
+    // 解码路径
+    // Half：自带的 RadianceHDR 读取器，多线程解 RLE，直接转 half，GL_HALF_FLOAT 上传（默认）
+    // RGBE：保留 RGBE8 原始数据（显存/上传量再减 1/3），在 shader 里解码，只能 NEAREST 采样
+    // StbFloat：原来的 stbi_loadf + GL_FLOAT 路径，用来对比
+    enum class Decode
+    {
+        Half,
+        RGBE,
+        StbFloat,
+    };
+
     TextureHDR() = default;
     ~TextureHDR();
 
     //加载 .hdr 文件 (Equirectangular 格式)
-    bool Load(const std::string& path);
+    bool Load(const std::string& path, Decode decode = Decode::Half);
+    // 已经在别处（比如工作线程）解码好的 RGB half 像素，只做上传；pixels 上传完就随函数返回释放，
+    // 不保留 CPU 副本（GetHalfPixels 为空，需要的 CPU 计算应该在解码的地方做完）
+    // name: 显存统计里的资源名（通常是 .hdr 路径）
+    bool LoadFromHalf(std::vector<std::uint16_t> pixels, int width, int height,
+                      const std::string& name = "equirect");
     void Destroy();
 
     std::uint32_t GetID() const {return m_TexID;}
     int GetWidth() const {return m_Width;}
     int GetHeight() const {return m_Height;}
+    // 纹理里存的是 RGBE8，采样后需要 rgb * 2^(e*255-136)
+    bool IsRGBE() const {return m_IsRGBE;}
+    // Load 之后 CPU 端保留的一份 RGB half 像素（行顺序与纹理一致），给 CPU 端 IBL 计算（SH 辐照度等）用
+    const std::vector<std::uint16_t>& GetHalfPixels() const {return m_HalfPixels;}
+    // CPU 端计算用完后调用，释放上面那份像素（2k 全景图约 12 MB）；纹理本身不受影响
+    void ReleaseHalfPixels();
 
 private:
+    bool LoadStb(const std::string& path);
+
     std::uint32_t m_TexID = 0;
+    bool m_IsRGBE = false;
+    std::vector<std::uint16_t> m_HalfPixels;
     int m_Width = 0;
     int m_Height = 0;
 };
@@ -0,0 +1,319 @@
+#include "TextureStreamer.h"
+
+#include "CpuProfiler.h"
+#include "Texture2D.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+#include <stb_image.h>
+
+// 边长不超过这个值的 mip 算作"尾部"，加载后常驻，不参与淘汰
+static const int kTailSize = 64;
+
+TextureStreamer::TextureStreamer(std::size_t budgetBytes, ThreadPool* pool)
+    : m_Pool(pool ? pool : &ThreadPool::Global()),
+      m_BudgetBytes(budgetBytes)
+{
+}
+
+TextureStreamer::~TextureStreamer()
+{
+    // 等工作线程把手上的解码做完，它们会往 m_Completed 里写
+    std::unique_lock<std::mutex> lock(m_CompletedMutex);
+    m_IdleCv.wait(lock, [this] { return m_InFlight == 0; });
+}
+
+Texture2D* TextureStreamer::Load(const std::string& path, bool srgb, bool flipY)
+{
+    // 主线程只读文件头，真正的解码放到工作线程
+    int w = 0, h = 0, comp = 0;
+    if (!stbi_info(path.c_str(), &w, &h, &comp)) {
+        std::fprintf(stderr, "[TextureStreamer] Failed to load: %s\n", path.c_str());
+        return nullptr;
+    }
+
+    // 2 通道（灰度 + alpha）没有对应的 GL 源格式，统一扩成 RGBA
+    int channels = (comp == 1 || comp == 3) ? comp : 4;
+
+    Entry entry;
+    entry.texture = std::make_unique<Texture2D>(w, h, channels, srgb, path);
+    entry.path = path;
+    entry.flipY = flipY;
+
+    int mipCount = entry.texture->MipCount();
+    entry.tailMip = mipCount - 1;
+    while (entry.tailMip > 0 && std::max(w >> (entry.tailMip - 1), h >> (entry.tailMip - 1)) <= kTailSize)
+        --entry.tailMip;
+    entry.lastRequestedMip = entry.tailMip;
+
+    Texture2D* tex = entry.texture.get();
+    std::size_t index = m_Entries.size();
+    m_Entries.push_back(std::move(entry));
+    m_Lookup[tex] = index;
+
+    // 先把尾部小 mip 流送进来
+    Schedule(index, m_Entries[index].tailMip, mipCount - 1);
+
+    std::printf("[TextureStreamer] Registered: %s (%dx%d, %d mips, tail from mip %d)\n",
+                path.c_str(), w, h, mipCount, m_Entries[index].tailMip);
+    return tex;
+}
+
+void TextureStreamer::RequestMip(const Texture2D* tex, int mip)
+{
+    if (!tex || mip < 0) return;
+    auto it = m_Lookup.find(tex);
+    if (it == m_Lookup.end()) return;
+
+    Entry& e = m_Entries[it->second];
+    e.requestedMip = (e.requestedMip < 0) ? mip : std::min(e.requestedMip, mip);
+}
+
+void TextureStreamer::Schedule(std::size_t entryIndex, int firstMip, int lastMip)
+{
+    Entry& e = m_Entries[entryIndex];
+    e.loading = true;
+    e.loadingMip = firstMip;
+
+    {
+        std::lock_guard<std::mutex> lock(m_CompletedMutex);
+        ++m_InFlight;
+    }
+
+    std::string path = e.path;
+    bool flipY = e.flipY;
+    int channels = e.texture->Channels();
+
+    m_Pool->Submit([this, entryIndex, path, flipY, channels, firstMip, lastMip]() {
+        MipBatch batch;
+        batch.entryIndex = entryIndex;
+        batch.firstMip = firstMip;
+        if (!DecodeMips(path, flipY, channels, firstMip, lastMip, batch))
+            batch.levels.clear();
+
+        std::lock_guard<std::mutex> lock(m_CompletedMutex);
+        m_Completed.push_back(std::move(batch));
+        --m_InFlight;
+        if (m_InFlight == 0) m_IdleCv.notify_all();
+    });
+}
+
+bool TextureStreamer::DecodeMips(const std::string& path, bool flipY, int channels,
+                                 int firstMip, int lastMip, MipBatch& out)
+{
+    PROFILE_ZONE("Texture decode");
+    // flip 标志是全局的，工作线程用线程局部版本，避免和主线程的 Texture2D 加载互相干扰
+    stbi_set_flip_vertically_on_load_thread(flipY ? 1 : 0);
+
+    int w = 0, h = 0, comp = 0;
+    unsigned char* data = stbi_load(path.c_str(), &w, &h, &comp, channels);
+    if (!data) {
+        std::fprintf(stderr, "[TextureStreamer] Decode failed: %s\n", path.c_str());
+        return false;
+    }
+
+    // 从 mip0 开始逐级 2x2 box 降采样，只保留 [firstMip, lastMip]
+    std::vector<unsigned char> current(data, data + (std::size_t)w * h * channels);
+    stbi_image_free(data);
+
+    for (int level = 0; level <= lastMip; ++level)
+    {
+        if (level >= firstMip)
+            out.levels.push_back(current);
+        if (level == lastMip) break;
+
+        int nw = std::max(1, w >> 1);
+        int nh = std::max(1, h >> 1);
+        std::vector<unsigned char> next((std::size_t)nw * nh * channels);
+        for (int y = 0; y < nh; ++y)
+        {
+            int y0 = std::min(y * 2, h - 1), y1 = std::min(y * 2 + 1, h - 1);
+            for (int x = 0; x < nw; ++x)
+            {
+                int x0 = std::min(x * 2, w - 1), x1 = std::min(x * 2 + 1, w - 1);
+                for (int c = 0; c < channels; ++c)
+                {
+                    int sum = current[((std::size_t)y0 * w + x0) * channels + c]
+                            + current[((std::size_t)y0 * w + x1) * channels + c]
+                            + current[((std::size_t)y1 * w + x0) * channels + c]
+                            + current[((std::size_t)y1 * w + x1) * channels + c];
+                    next[((std::size_t)y * nw + x) * channels + c] = (unsigned char)((sum + 2) / 4);
+                }
+            }
+        }
+        current.swap(next);
+        w = nw;
+        h = nh;
+    }
+    return true;
+}
+
+void TextureStreamer::Update()
+{
+    // 1) 上传工作线程完成的 mip（GL 调用只能在主线程）
+    std::vector<MipBatch> completed;
+    {
+        std::lock_guard<std::mutex> lock(m_CompletedMutex);
+        completed.swap(m_Completed);
+    }
+
+    for (MipBatch& batch : completed)
+    {
+        Entry& e = m_Entries[batch.entryIndex];
+        e.loading = false;
+        e.loadingMip = -1;
+        if (batch.levels.empty()) continue;
+
+        // 从小到大上传，最后一次性移动 BASE_LEVEL，采样器不会看到不完整的区间
+        for (int i = (int)batch.levels.size() - 1; i >= 0; --i)
+            e.texture->UploadMip(batch.firstMip + i, batch.levels[i].data());
+        e.texture->SetResidentBaseMip(std::min(batch.firstMip, e.texture->ResidentBaseMip()));
+    }
+
+    // 2) 收集本帧请求，决定要流送的 mip
+    for (std::size_t i = 0; i < m_Entries.size(); ++i)
+    {
+        Entry& e = m_Entries[i];
+        if (e.requestedMip < 0) continue;
+
+        e.lastNeededFrame = m_Frame;
+        e.lastRequestedMip = std::min(e.requestedMip, e.tailMip);
+        if (e.loading) continue;
+
+        Texture2D& tex = *e.texture;
+        int target = e.lastRequestedMip;
+        if (target >= tex.ResidentBaseMip()) continue;
+
+        // 超预算时先淘汰别人，再不够就降低本次流送的精度
+        std::size_t extra = tex.BytesFromMip(target) - tex.ResidentBytes();
+        if (ResidentBytes() + extra > m_BudgetBytes) {
+            std::size_t limit = (m_BudgetBytes > extra) ? m_BudgetBytes - extra : 0;
+            EvictTo(limit);
+        }
+        while (target < tex.ResidentBaseMip() &&
+               ResidentBytes() + tex.BytesFromMip(target) - tex.ResidentBytes() > m_BudgetBytes)
+            ++target;
+
+        if (target < tex.ResidentBaseMip())
+            Schedule(i, target, tex.ResidentBaseMip() - 1);
+    }
+
+    // 3) 预算被调小时也要收缩
+    EvictTo(m_BudgetBytes);
+
+    for (Entry& e : m_Entries)
+        e.requestedMip = -1;
+    ++m_Frame;
+}
+
+void TextureStreamer::EvictTo(std::size_t targetBytes)
+{
+    std::size_t total = ResidentBytes();
+    if (total <= targetBytes) return;
+
+    // 最久没被需要的排前面
+    std::vector<std::size_t> order;
+    for (std::size_t i = 0; i < m_Entries.size(); ++i)
+        if (!m_Entries[i].loading) order.push_back(i);
+    std::sort(order.begin(), order.end(), [this](std::size_t a, std::size_t b) {
+        return m_Entries[a].lastNeededFrame < m_Entries[b].lastNeededFrame;
+    });
+
+    for (std::size_t index : order)
+    {
+        Entry& e = m_Entries[index];
+        Texture2D& tex = *e.texture;
+
+        // 本帧还在用的纹理只能丢掉比请求更精细的部分
+        int limit = (e.lastNeededFrame == m_Frame) ? e.lastRequestedMip : e.tailMip;
+        int base = tex.ResidentBaseMip();
+        std::size_t before = tex.ResidentBytes();
+        while (base < limit && total - (before - tex.BytesFromMip(base)) > targetBytes)
+            ++base;
+        if (base == tex.ResidentBaseMip()) continue;
+
+        tex.SetResidentBaseMip(base);
+        total -= before - tex.ResidentBytes();
+        if (total <= targetBytes) return;
+    }
+}
+
+std::size_t TextureStreamer::ResidentBytes() const
+{
+    std::size_t total = 0;
+    for (const Entry& e : m_Entries)
+    {
+        total += e.texture->ResidentBytes();
+        // 正在流送的部分提前记账，避免多张纹理同时流送时冲破预算
+        if (e.loading && e.loadingMip >= 0 && e.loadingMip < e.texture->ResidentBaseMip())
+            total += e.texture->BytesFromMip(e.loadingMip) - e.texture->ResidentBytes();
+    }
+    return total;
+}
+
+std::size_t TextureStreamer::RequestedBytes() const
+{
+    std::size_t total = 0;
+    for (const Entry& e : m_Entries)
+        total += e.texture->BytesFromMip(e.lastRequestedMip);
+    return total;
+}
+
+std::vector<TextureStreamer::TextureStats> TextureStreamer::GetStats() const
+{
+    std::vector<TextureStats> stats;
+    stats.reserve(m_Entries.size());
+    for (const Entry& e : m_Entries)
+    {
+        TextureStats s;
+        s.name = e.path;
+        s.width = e.texture->Width();
+        s.height = e.texture->Height();
+        s.residentMip = e.texture->ResidentBaseMip();
+        s.requestedMip = e.lastRequestedMip;
+        s.residentBytes = e.texture->ResidentBytes();
+        s.requestedBytes = e.texture->BytesFromMip(e.lastRequestedMip);
+        s.loading = e.loading;
+        stats.push_back(s);
+    }
+    return stats;
+}
+
+int TextureStreamer::EstimateMip(const glm::mat4& view, const glm::mat4& proj,
+                                 const glm::vec3& worldCenter, float worldRadius,
+                                 int viewportHeight, int texWidth, int texHeight)
+{
+    // 视锥剔除：从 VP 矩阵提取 6 个平面（Gribb-Hartmann），包围球完全在某个平面外就不可见
+    glm::mat4 vp = proj * view;
+    glm::vec4 rows[4];
+    for (int r = 0; r < 4; ++r)
+        rows[r] = glm::vec4(vp[0][r], vp[1][r], vp[2][r], vp[3][r]);
+
+    const glm::vec4 planes[6] = {
+        rows[3] + rows[0], rows[3] - rows[0],
+        rows[3] + rows[1], rows[3] - rows[1],
+        rows[3] + rows[2], rows[3] - rows[2],
+    };
+    for (const glm::vec4& p : planes)
+    {
+        glm::vec3 n(p.x, p.y, p.z);
+        float dist = glm::dot(n, worldCenter) + p.w;
+        if (dist < -worldRadius * glm::length(n)) return -1;
+    }
+
+    // 屏幕上的投影直径（像素）：2r * proj[1][1] * (H/2) / depth
+    glm::vec4 viewPos = view * glm::vec4(worldCenter, 1.0f);
+    float depth = -viewPos.z;
+    if (depth <= worldRadius) return 0;  // 相机在包围球里，直接要最高精度
+
+    float pixels = worldRadius * proj[1][1] * (float)viewportHeight / depth;
+    float texels = (float)std::max(texWidth, texHeight);
+    if (pixels < 1.0f) pixels = 1.0f;
+
+    int mip = (int)std::floor(std::log2(texels / pixels));
+    int maxMip = Texture2D::ComputeMipCount(texWidth, texHeight) - 1;
+    return std::max(0, std::min(mip, maxMip));
+}
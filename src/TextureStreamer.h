@@ -0,0 +1,103 @@
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+class Texture2D;
+class ThreadPool;
+
+// TextureStreamer：按需流送 Texture2D 的 mip
+// 流程：
+// 1) Load 只读图片头拿到尺寸，创建一个只有 1x1 占位 mip 的纹理，然后在工作线程里解码出尾部小 mip
+// 2) 每帧可见性/剔除阶段对每个物体调用 RequestMip（用 EstimateMip 估出屏幕上需要的精度）
+// 3) Update 在主线程上传工作线程算好的 mip，调整 GL_TEXTURE_BASE_LEVEL，
+//    超出显存预算时按"最久没被需要"的顺序淘汰高精度 mip
+class TextureStreamer
+{
+public:
+    // 每张纹理的统计，给 ImGui 面板用
+    struct TextureStats
+    {
+        std::string   name;
+        int           width = 0;
+        int           height = 0;
+        int           residentMip = 0;   // 当前 BASE_LEVEL
+        int           requestedMip = 0;  // 最近一次被需要的精度
+        std::size_t   residentBytes = 0;
+        std::size_t   requestedBytes = 0;
+        bool          loading = false;
+    };
+
+    explicit TextureStreamer(std::size_t budgetBytes = 64u * 1024u * 1024u, ThreadPool* pool = nullptr);
+    ~TextureStreamer();
+
+    TextureStreamer(const TextureStreamer&) = delete;
+    TextureStreamer& operator=(const TextureStreamer&) = delete;
+
+    // 返回的纹理由 streamer 持有，生命周期和 streamer 相同
+    Texture2D* Load(const std::string& path, bool srgb = false, bool flipY = true);
+
+    // 本帧需要 tex 至少精细到 mip 级（同一帧多次请求取最精细的）
+    void RequestMip(const Texture2D* tex, int mip);
+
+    // 主线程每帧调用一次（在绘制前）
+    void Update();
+
+    // 包围球在屏幕上的投影直径 -> 需要的 mip；不在视锥内返回 -1
+    // 假设 UV 在物体上铺满一次 [0,1]
+    static int EstimateMip(const glm::mat4& view, const glm::mat4& proj,
+                           const glm::vec3& worldCenter, float worldRadius,
+                           int viewportHeight, int texWidth, int texHeight);
+
+    void SetBudgetBytes(std::size_t bytes) { m_BudgetBytes = bytes; }
+    std::size_t BudgetBytes() const { return m_BudgetBytes; }
+    std::size_t ResidentBytes() const;
+    std::size_t RequestedBytes() const;
+    std::vector<TextureStats> GetStats() const;
+
+private:
+    struct Entry
+    {
+        std::unique_ptr<Texture2D> texture;
+        std::string path;
+        bool flipY = true;
+        int tailMip = 0;              // 小于等于这个尺寸的 mip 常驻，不参与淘汰
+        int requestedMip = -1;        // 本帧请求（-1 = 本帧没人要）
+        int lastRequestedMip = 0;
+        long long lastNeededFrame = -1;
+        bool loading = false;
+        int loadingMip = -1;          // 正在流送的最精细级别
+    };
+
+    // 工作线程产出的一批 mip，主线程 Update 里上传
+    struct MipBatch
+    {
+        std::size_t entryIndex = 0;
+        int firstMip = 0;
+        std::vector<std::vector<unsigned char>> levels;  // levels[i] 对应 mip firstMip + i
+    };
+
+    void Schedule(std::size_t entryIndex, int firstMip, int lastMip);
+    // 按最久没被需要的顺序淘汰高精度 mip，直到总驻留 <= targetBytes
+    void EvictTo(std::size_t targetBytes);
+    static bool DecodeMips(const std::string& path, bool flipY, int channels,
+                           int firstMip, int lastMip, MipBatch& out);
+
+    ThreadPool* m_Pool = nullptr;
+    std::size_t m_BudgetBytes = 0;
+    long long m_Frame = 0;
+
+    std::vector<Entry> m_Entries;
+    std::unordered_map<const Texture2D*, std::size_t> m_Lookup;
+
+    std::mutex m_CompletedMutex;
+    std::vector<MipBatch> m_Completed;
+    std::condition_variable m_IdleCv;
+    int m_InFlight = 0;  // 受 m_CompletedMutex 保护
+};
@@ -0,0 +1,131 @@
+#include "ThreadPool.h"
+#include "CpuProfiler.h"
+
+#include <algorithm>
+#include <memory>
+
+ThreadPool::ThreadPool(unsigned threadCount)
+{
+    if (threadCount == 0) {
+        unsigned hw = std::thread::hardware_concurrency();
+        threadCount = (hw > 1) ? hw - 1 : 1;
+    }
+
+    m_Workers.reserve(threadCount);
+    for (unsigned i = 0; i < threadCount; ++i)
+        m_Workers.emplace_back([this] { WorkerLoop(); });
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Stop = true;
+    }
+    m_JobCv.notify_all();
+    for (auto& t : m_Workers)
+        t.join();
+}
+
+void ThreadPool::Submit(std::function<void()> job)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Jobs.push_back(std::move(job));
+    }
+    m_JobCv.notify_one();
+}
+
+void ThreadPool::WorkerLoop()
+{
+    PROFILE_THREAD("Worker");
+    for (;;)
+    {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_JobCv.wait(lock, [this] { return m_Stop || !m_Jobs.empty(); });
+            if (m_Stop && m_Jobs.empty()) return;
+
+            job = std::move(m_Jobs.front());
+            m_Jobs.pop_front();
+            ++m_Running;
+        }
+
+        job();
+
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            --m_Running;
+            if (m_Running == 0 && m_Jobs.empty())
+                m_IdleCv.notify_all();
+        }
+    }
+}
+
+void ThreadPool::WaitIdle()
+{
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    m_IdleCv.wait(lock, [this] { return m_Running == 0 && m_Jobs.empty(); });
+}
+
+void ThreadPool::ParallelFor(int count, const std::function<void(int, int)>& fn, int grain)
+{
+    if (count <= 0) return;
+    grain = std::max(grain, 1);
+
+    // 块数：线程数的 4 倍左右，负载不均时能互相补位
+    int workers = (int)m_Workers.size() + 1;
+    int chunkSize = std::max(grain, (count + workers * 4 - 1) / (workers * 4));
+    int chunkCount = (count + chunkSize - 1) / chunkSize;
+
+    if (chunkCount == 1) {
+        fn(0, count);
+        return;
+    }
+
+    // 共享状态用 shared_ptr：辅助任务可能在调用者返回之后才被调度到，此时只会发现没活可干
+    struct State
+    {
+        std::atomic<int> next{0};
+        std::atomic<int> done{0};
+        std::mutex mutex;
+        std::condition_variable cv;
+    };
+    auto state = std::make_shared<State>();
+
+    auto runChunks = [state, &fn, count, chunkSize, chunkCount]() {
+        for (;;)
+        {
+            int chunk = state->next.fetch_add(1);
+            if (chunk >= chunkCount) return;
+
+            int begin = chunk * chunkSize;
+            int end = std::min(count, begin + chunkSize);
+            fn(begin, end);
+
+            if (state->done.fetch_add(1) + 1 == chunkCount) {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                state->cv.notify_all();
+            }
+        }
+    };
+
+    int helpers = std::min((int)m_Workers.size(), chunkCount - 1);
+    for (int i = 0; i < helpers; ++i)
+    {
+        // 辅助任务只在还有剩余块时才会碰 fn，而调用者会等所有块完成，所以引用 fn 是安全的
+        Submit(runChunks);
+    }
+
+    runChunks();
+
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->cv.wait(lock, [&] { return state->done.load() == chunkCount; });
+}
+
+ThreadPool& ThreadPool::Global()
+{
+    static ThreadPool s_Pool;
+    return s_Pool;
+}
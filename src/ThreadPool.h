@@ -0,0 +1,48 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// ThreadPool：固定数量的工作线程 + 一个任务队列
+// - Submit：丢一个任务进去，立刻返回（纹理流送、后台解码用）
+// - ParallelFor：把 [0, count) 切块并行执行，调用线程也参与干活，全部完成才返回
+// 注意：工作线程里不能调用任何 GL 函数（GL 上下文只在主线程）
+class ThreadPool
+{
+public:
+    // threadCount = 0 时按 CPU 核数 - 1 创建（至少 1 个）
+    explicit ThreadPool(unsigned threadCount = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void Submit(std::function<void()> job);
+
+    // fn(begin, end) 处理 [begin, end) 区间；grain 是每块最少的元素数
+    void ParallelFor(int count, const std::function<void(int begin, int end)>& fn, int grain = 1);
+
+    // 等待队列清空且没有任务在执行
+    void WaitIdle();
+
+    unsigned ThreadCount() const { return (unsigned)m_Workers.size(); }
+
+    // 全局共享的线程池（第一次调用时创建）
+    static ThreadPool& Global();
+
+private:
+    void WorkerLoop();
+
+    std::vector<std::thread> m_Workers;
+    std::deque<std::function<void()>> m_Jobs;
+    std::mutex m_Mutex;
+    std::condition_variable m_JobCv;
+    std::condition_variable m_IdleCv;
+    int m_Running = 0;
+    bool m_Stop = false;
+};
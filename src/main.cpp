@@ -1,4 +1,10 @@
-﻿#include <cstdio>
+﻿#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
     #include <vector>
 
 #include <glad/glad.h>
@@ -13,15 +19,32 @@
 
 #include "Shader.h"
 #include "Texture2D.h"
+#include "TextureStreamer.h"
+#include "TextureArrayPacker.h"
+#include "ThreadPool.h"
+#include "CpuProfiler.h"
 #include "Material.h"
-#include "Object.h"
+#include "SceneStore.h"
+#include "Headless.h"
+#include "CameraPath.h"
+#include "ImageWriter.h"
+#include "FrameTimingLog.h"
 
 #include "render/Renderer.h"
 #include "render/Light.h"
-#include "render/Framebuffer.h"
+#include "render/RenderGraph.h"
+#include "render/RenderTargetPool.h"
 #include "render/PostProcessPass.h"
+#include "render/BloomPass.h"
+#include "render/AutoExposure.h"
+#include "render/DrawStats.h"
+#include "render/DynamicResolution.h"
+#include "render/GpuProfiler.h"
+#include "render/GpuMemory.h"
+#include "render/Framebuffer.h"
+#include "render/FrameCapture.h"
+#include "StressScene.h"
 #include "Model.h"
-#include "TextureHDR.h"
 #include "IBLBaker.h"
 
 // ---------------------- 回调 ----------------------
@@ -38,23 +61,57 @@ static void scroll_callback(GLFWwindow* window, double xoffset, double yoffset)
 }
 
 // ---------------------- 主函数 ----------------------
-int main()
+int main(int argc, char** argv)
 {
-    glfwSetErrorCallback(glfw_error_callback);
-    if (!glfwInit()) return -1;
+    // --headless：EGL 离屏上下文，没有窗口和输入，按相机路径跑固定帧数后写计时
+    HeadlessOptions headless;
+    if (!ParseHeadlessOptions(argc, argv, headless)) return -1;
+
+    // 显存泄漏报告放在 atexit：main 里的局部对象（模型、纹理、Renderer……）都析构完才跑，
+    // 这时还登记着的对象就是没人释放的
+    std::atexit([] { GpuMemory::ReportLeaks(); });
+
+    // Trace：F9 或界面上开关，--trace 从启动就开始录（模型、shader、IBL 烘焙都在里面）
+    PROFILE_THREAD("Main");
+    const std::string tracePath = headless.tracePath.empty() ? "trace.json" : headless.tracePath;
+    auto startTrace = [&]() {
+        CpuProfiler::StartCapture();
+        GpuProfiler::Global().SetTraceCapture(true);
+    };
+    // GPU 区间要几帧后才读回，停止时最后几帧的 GPU 部分不在文件里
+    auto stopTrace = [&]() {
+        GpuProfiler::Global().SetTraceCapture(false);
+        CpuProfiler::WriteChromeTrace(tracePath, GpuProfiler::Global().TraceEvents());
+    };
+    if (!headless.tracePath.empty()) startTrace();
+    bool traceKeyDown = false;
+
+    GLFWwindow* window = nullptr;
+    HeadlessContext headlessContext;
+    if (headless.enabled)
+    {
+        if (!headlessContext.Create()) return -1;
+    }
+    else
+    {
+        glfwSetErrorCallback(glfw_error_callback);
+        if (!glfwInit()) return -1;
 
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+        glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
 
-    GLFWwindow* window = glfwCreateWindow(1280, 720, "RenderSandbox", nullptr, nullptr);
-    if (!window) { glfwTerminate(); return -1; }
+        window = glfwCreateWindow(1280, 720, "RenderSandbox", nullptr, nullptr);
+        if (!window) { glfwTerminate(); return -1; }
 
-    glfwMakeContextCurrent(window);
-    glfwSetScrollCallback(window, scroll_callback);
-    glfwSwapInterval(1);
+        glfwMakeContextCurrent(window);
+        glfwSetScrollCallback(window, scroll_callback);
+        glfwSwapInterval(1);
+    }
 
-    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
+    GLADloadproc loader = headless.enabled ? (GLADloadproc)HeadlessContext::GetProcAddress
+                                           : (GLADloadproc)glfwGetProcAddress;
+    if (!gladLoadGLLoader(loader)) {
         std::fprintf(stderr, "Failed to initialize GLAD\n");
         return -1;
     }
@@ -80,25 +137,33 @@ int main()
     ImGui::CreateContext();
     ImGui::StyleColorsDark();
     const char* glsl_version = "#version 330";
-    ImGui_ImplGlfw_InitForOpenGL(window, true);
+    // headless 也照样构建界面（CPU 开销和窗口模式一致），只是不画出来
+    if (window) ImGui_ImplGlfw_InitForOpenGL(window, true);
     ImGui_ImplOpenGL3_Init(glsl_version);
 
     // ---------------------- 资源：纹理/着色器 ----------------------
-    Texture2D albedo("assets/textures/container.jpg", true);
+    // 纹理走流送：先只有尾部小 mip，按屏幕上需要的精度再把高精度 mip 流进来
+    TextureStreamer textureStreamer(64u * 1024u * 1024u);
+    Texture2D* albedo = textureStreamer.Load("assets/textures/container.jpg", true);
     Shader shader("assets/shaders/basic.vert", "assets/shaders/pbr.frag");
-    Shader postShader("assets/shaders/post.vert", "assets/shaders/post.frag");
     Shader skyboxShader("assets/shaders/skybox.vert", "assets/shaders/skybox.frag");
+    // 批处理版本：材质参数逐实例传入，albedo 从纹理数组按 layer 采样
+    Shader instancedShader("assets/shaders/basic.vert", "assets/shaders/pbr.frag",
+                           "#define USE_INSTANCING\n#define USE_TEXTURE_ARRAY\n");
 
-    TextureHDR hdrTexture;
-    if (!hdrTexture.Load("assets/textures/suburban_garden_2k.hdr"))
+    // 材质贴图按 (尺寸, 格式类) 打包进纹理数组，给 instanced 批处理用
+    TextureArrayPacker texturePacker;
+    int containerSlot = texturePacker.Add("assets/textures/container.jpg", true);
+    texturePacker.Build(&ThreadPool::Global());
+
+    // 程序启动时预计算一次（漫反射辐照度在 CPU 上投影成 SH9）；HDR 和烘焙参数没变时直接读缓存
+    IBLBaker iblBaker;
+    if (!iblBaker.Bake("assets/textures/suburban_garden_2k.hdr", "cache/suburban_garden_2k.iblcache"))
     {
         std::fprintf(stderr, "Failed to load HDR!\n");
         return -1;
     }
 
-    IBLBaker iblBaker;
-    iblBaker.Bake(hdrTexture.GetID());  // 程序启动时预计算一次
-
     Model model;
     if (!model.Load("assets/models/demo_cube.obj"))
     {
@@ -126,14 +191,14 @@ int main()
 
     float fovDeg = 60.0f;
     float moveSpeed = 2.5f;
-    float lastTime = (float)glfwGetTime();
+    float lastTime = window ? (float)glfwGetTime() : 0.0f;
 
     // ---------------------- ImGui 参数（材质参数） ----------------------
     float tintColor[4] = { 1.0f, 0.3f, 0.2f, 1.0f };
     float shininess = 32.0f;
     float ambientStrength = 0.08f;
-    int postMode = 0;
-    float vignetteStrength = 0.35f;
+    // 后处理效果栈：按顺序融合成一个全屏 pass，可以开关、调参数、调顺序
+    std::vector<PostEffect> postStack = PostProcessPass::DefaultStack();
     bool drawModel = true;
     float modelYaw = 0.0f;
     float modelScaleMul = 1.0f;
@@ -142,134 +207,257 @@ int main()
     float roughness = 0.5f;
     float ao        = 1.0f;
     float lightIntensity = 30.0f;  // PBR 距离平方衰减，需要更高的光源强度
+    bool drawGrid = headless.stressScene;
+    bool batchGrid = true;
+    int textureBudgetMB = 64;
+    // 环境选择：assets/textures 下的所有 .hdr，切换走后台解码 + 分帧烘焙
+    std::vector<std::string> environments;
+    {
+        std::error_code ec;
+        for (const auto& entry : std::filesystem::directory_iterator("assets/textures", ec))
+            if (entry.path().extension() == ".hdr")
+                environments.push_back(entry.path().generic_string());
+        std::sort(environments.begin(), environments.end());
+    }
+    int swapStepsPerFrame = 4;
+    // 烘焙参数：改完点 Rebake 生效（参数参与缓存 key，换回原参数会重新命中旧缓存）
+    IBLBakeSettings bakeSettings = iblBaker.GetSettings();
+    const int bakeEnvSizes[] = { 256, 512, 1024, 2048 };
+    const int bakePrefilterSizes[] = { 64, 128, 256, 512 };
+    const uint32_t bakeFormats[] = { IBLCache::kFormatRGB16F, IBLCache::kFormatR11G11B10F };
+
+    bool useIrradianceSH = iblBaker.HasIrradianceSH();
+    bool hasSHDiff = false;
+    IBLBaker::IrradianceDiff shDiff;
+    bool useSpecularIBL = iblBaker.GetPrefilterMap() != 0 && iblBaker.GetBRDFLUT() != 0;
+    bool hasBrdfDiff = false;
+    IBLBaker::BRDFLUTDiff brdfDiff;
 
     // ---------------------- Material（共享） ----------------------
     Material litMat;
     litMat.shader = &shader;
-    litMat.albedo = &albedo;
+    litMat.albedo = albedo;
     litMat.color = glm::vec4(tintColor[0], tintColor[1], tintColor[2], tintColor[3]);
     litMat.shininess = shininess;
     litMat.ambientStrength = ambientStrength;
 
-    // ---------------------- Object 列表（每个物体一个 model） ----------------------
-    std::vector<Object> objects;
-    objects.reserve(9);
-
-    for (int x = -1; x <= 1; ++x)
+    // ---------------------- 物体 + 灯光（StressScene 生成；默认参数就是 3x3 网格、三种材质、两盏灯） ----------------------
+    // 网格物体的材质参数不同，贴图都在同一个纹理数组里，可以合成一次 instanced draw
+    TextureArrayPacker::Slot containerArray = texturePacker.GetSlot(containerSlot);
+    StressScene stressScene;
+    stressScene.SetResources(&shader, &model, albedo, containerArray.texture, containerArray.layer);
+    StressSceneSettings stressSettings = headless.stress;   // 界面改这一份，点 Generate 才重建
+    StressSweep stressSweep;
+    int sweepAxis = 0;
+    char sweepValues[128] = "100,1000,10000,50000";
+    int sweepFrames = headless.sweepFrames;
+    if (!headless.sweepAxis.empty())
     {
-        for (int z = -1; z <= 1; ++z)
+        StressSweep::Axis axis;
+        if (!StressSweep::ParseAxis(headless.sweepAxis.c_str(), axis))
         {
-            Object obj;
-            obj.transform.position = glm::vec3((float)x * 1.5f, 0.0f, (float)z * 1.5f);
-            obj.material = &litMat;
-            objects.push_back(obj);
+            std::fprintf(stderr, "Unknown sweep axis '%s' (objects | materials | lights)\n", headless.sweepAxis.c_str());
+            return -1;
         }
+        sweepAxis = (int)axis;
+        stressSweep.Start(axis, headless.sweepValues, headless.sweepFrames, headless.warmup);
+        stressSweep.Configure(stressSettings);
+        if (headless.enabled)
+            headless.frames = std::max(headless.frames, stressSweep.TotalFrames());
     }
+    stressScene.Generate(stressSettings);
+    // Generate 只改内容，引用一直有效
+    const SceneStore& sceneStore = stressScene.Store();
+    const std::vector<PointLight>& lights = stressScene.Lights();
 
     // ---------------------- Renderer + Lights（A：Renderer 持有 lights） ----------------------
     Renderer renderer;
 
-    std::vector<PointLight> lights;
-    lights.push_back({ glm::vec3( 1.5f, 4.0f,  2.0f), glm::vec3(1.0f, 1.0f, 1.0f) });
-    lights.push_back({ glm::vec3(-1.5f, 3.0f, -1.0f), glm::vec3(1.0f, 0.5f, 0.2f) });
-
     renderer.SetPointLights(lights);
-
-    int fbw = 0, fbh = 0;
-    glfwGetFramebufferSize(window, &fbw, &fbh);
-    
-    Framebuffer sceneFbo;
-    sceneFbo.Create(fbw, fbh);
+    renderer.SetInstancedShader(&instancedShader);
+    int gridDrawCalls = 0;
+    bool showDrawStatsOverlay = false;
+    int gpuBudgetMB = 0;
+
+    // 场景命令流录制（给 FrameReplay）：资源按路径登记，路径要和上面创建时一致
+    FrameCapture frameCapture;
+    frameCapture.RegisterShader(&shader, "assets/shaders/basic.vert", "assets/shaders/pbr.frag");
+    frameCapture.RegisterShader(&skyboxShader, "assets/shaders/skybox.vert", "assets/shaders/skybox.frag");
+    frameCapture.RegisterShader(&instancedShader, "assets/shaders/basic.vert", "assets/shaders/pbr.frag",
+                                "#define USE_INSTANCING\n#define USE_TEXTURE_ARRAY\n");
+    frameCapture.RegisterModel(&model, "assets/models/demo_cube.obj");
+    frameCapture.RegisterTexture(albedo, "assets/textures/container.jpg", true);
+    frameCapture.RegisterTextureLayer(containerArray.texture, containerArray.layer, "assets/textures/container.jpg", true);
+    bool recordNextFrame = false;
+
+    // 离屏目标每帧从池里借，用完归还；窗口尺寸变化时旧尺寸的纹理过几帧才删
+    RenderTargetPool targetPool;
+    // 每帧声明 pass 和读写关系，由图排序、剔除、分配临时目标
+    RenderGraph frameGraph;
     PostProcessPass postPass;
-    postPass.Init(&postShader);
-    // ---------------------- 主循环 ----------------------
-    while (!glfwWindowShouldClose(window))
+    postPass.Init("assets/shaders/post.vert", "assets/shaders/post.frag");
+    BloomPass bloomPass;
+    bloomPass.Init("assets/shaders/post.vert", "assets/shaders/bloom_down.frag", "assets/shaders/bloom_up.frag");
+    DynamicResolution dynamicRes;
+    AutoExposure autoExposure;
+    autoExposure.Init("assets/shaders/post.vert", "assets/shaders/exposure_luminance.frag",
+                      "assets/shaders/exposure_adapt.frag");
+
+    // ---------------------- Headless：离屏目标 + 相机路径 + 计时 ----------------------
+    Framebuffer headlessTarget;
+    CameraPath cameraPath;
+    FrameTimingLog timingLog;
+    int headlessFrame = 0;
+    const float headlessDt = 1.0f / headless.fps;
+    if (headless.enabled)
     {
-        glfwPollEvents();
+        if (!headlessTarget.Create(headless.width, headless.height))
+            return -1;
+        if (!headless.cameraPath.empty() && !cameraPath.Load(headless.cameraPath))
+            return -1;
+        if (cameraPath.Empty())
+        {
+            // 压力场景按场景大小拉远；默认场景保持原来的机位，计时和以前的运行可比
+            float orbitRadius = headless.stressScene ? std::max(4.0f, stressScene.Radius() * 1.5f) : 4.0f;
+            float orbitHeight = headless.stressScene ? std::max(1.5f, orbitRadius * 0.4f) : 1.5f;
+            cameraPath = CameraPath::Orbit(glm::vec3(0.0f), orbitRadius, orbitHeight, headless.frames * headlessDt);
+        }
+        // 自动调比例依赖计时，结果不可重复；要测它时用 --dynamic-res
+        dynamicRes.Settings().enabled = headless.dynamicResolution;
+    }
 
-        // delta time
-        float now = (float)glfwGetTime();
-        float dt = now - lastTime;
-        lastTime = now;
+    // ---------------------- 主循环 ----------------------
+    while (headless.enabled ? headlessFrame < headless.frames : !glfwWindowShouldClose(window))
+    {
+        PROFILE_ZONE("Frame");
+        auto frameStart = std::chrono::high_resolution_clock::now();
+        if (window) glfwPollEvents();
+        targetPool.BeginFrame();
+        frameGraph.BeginFrame();
+        GpuProfiler::Global().BeginFrame();
+        DrawStats::BeginFrame();
+        if (recordNextFrame || (headless.recordFrame >= 0 && headlessFrame == headless.recordFrame))
+        {
+            frameCapture.Begin();
+            recordNextFrame = false;
+        }
 
-        // 键盘移动
-        float velocity = moveSpeed * dt;
-        if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS) cameraPos += cameraFront * velocity;
-        if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS) cameraPos -= cameraFront * velocity;
-        if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS) cameraPos += cameraRight * velocity;
-        if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS) cameraPos -= cameraRight * velocity;
-        if (glfwGetKey(window, GLFW_KEY_E) == GLFW_PRESS) cameraPos += worldUp * velocity;
-        if (glfwGetKey(window, GLFW_KEY_Q) == GLFW_PRESS) cameraPos -= worldUp * velocity;
+        int w, h;
+        if (window) {
+            glfwGetFramebufferSize(window, &w, &h);
+        } else {
+            w = headless.width;
+            h = headless.height;
+        }
 
-        // 鼠标右键旋转视角
-        int rmb = glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_RIGHT);
-        if (rmb == GLFW_PRESS)
+        // delta time（headless 用固定步长，整次运行可重复）
+        float dt = headlessDt;
+        if (window)
         {
-            glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+            float now = (float)glfwGetTime();
+            dt = now - lastTime;
+            lastTime = now;
+        }
 
-            double xpos, ypos;
-            glfwGetCursorPos(window, &xpos, &ypos);
+        if (window)
+        {
+            PROFILE_ZONE("Input");
+            const bool traceKey = glfwGetKey(window, GLFW_KEY_F9) == GLFW_PRESS;
+            if (traceKey && !traceKeyDown)
+            {
+                if (GpuProfiler::Global().IsTraceCapturing()) stopTrace();
+                else startTrace();
+            }
+            traceKeyDown = traceKey;
+
+            // 键盘移动
+            float velocity = moveSpeed * dt;
+            if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS) cameraPos += cameraFront * velocity;
+            if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS) cameraPos -= cameraFront * velocity;
+            if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS) cameraPos += cameraRight * velocity;
+            if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS) cameraPos -= cameraRight * velocity;
+            if (glfwGetKey(window, GLFW_KEY_E) == GLFW_PRESS) cameraPos += worldUp * velocity;
+            if (glfwGetKey(window, GLFW_KEY_Q) == GLFW_PRESS) cameraPos -= worldUp * velocity;
+
+            // 鼠标右键旋转视角
+            int rmb = glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_RIGHT);
+            if (rmb == GLFW_PRESS)
+            {
+                glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+
+                double xpos, ypos;
+                glfwGetCursorPos(window, &xpos, &ypos);
+
+                if (firstMouse) {
+                    lastX = xpos;
+                    lastY = ypos;
+                    firstMouse = false;
+                }
+
+                double xoffset = xpos - lastX;
+                double yoffset = lastY - ypos;
 
-            if (firstMouse) {
                 lastX = xpos;
                 lastY = ypos;
-                firstMouse = false;
-            }
-
-            double xoffset = xpos - lastX;
-            double yoffset = lastY - ypos;
 
-            lastX = xpos;
-            lastY = ypos;
+                xoffset *= mouseSensitivity;
+                yoffset *= mouseSensitivity;
 
-            xoffset *= mouseSensitivity;
-            yoffset *= mouseSensitivity;
+                yaw   += (float)xoffset;
+                pitch += (float)yoffset;
 
-            yaw   += (float)xoffset;
-            pitch += (float)yoffset;
-
-            if (pitch > 89.0f) pitch = 89.0f;
-            if (pitch < -89.0f) pitch = -89.0f;
-        }
-        else
-        {
-            glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_NORMAL);
-            firstMouse = true;
-        }
-
-        // 鼠标中键平移
-        int mmb = glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_MIDDLE);
-        double mx, my;
-        glfwGetCursorPos(window, &mx, &my);
+                if (pitch > 89.0f) pitch = 89.0f;
+                if (pitch < -89.0f) pitch = -89.0f;
+            }
+            else
+            {
+                glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_NORMAL);
+                firstMouse = true;
+            }
 
-        if (mmb == GLFW_PRESS)
-        {
-            if (!panning) {
-                panning = true;
+            // 鼠标中键平移
+            int mmb = glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_MIDDLE);
+            double mx, my;
+            glfwGetCursorPos(window, &mx, &my);
+
+            if (mmb == GLFW_PRESS)
+            {
+                if (!panning) {
+                    panning = true;
+                    panLastX = mx;
+                    panLastY = my;
+                }
+
+                double dx = mx - panLastX;
+                double dy = my - panLastY;
                 panLastX = mx;
                 panLastY = my;
-            }
 
-            double dx = mx - panLastX;
-            double dy = my - panLastY;
-            panLastX = mx;
-            panLastY = my;
+                cameraPos += cameraRight * (float)(dx * panSpeed);
+                cameraPos -= cameraUp    * (float)(dy * panSpeed);
+            }
+            else
+            {
+                panning = false;
+            }
 
-            cameraPos += cameraRight * (float)(dx * panSpeed);
-            cameraPos -= cameraUp    * (float)(dy * panSpeed);
+            // 滚轮缩放 FOV
+            if (g_ScrollY != 0.0f)
+            {
+                fovDeg -= g_ScrollY * 2.0f;
+                if (fovDeg < 20.0f) fovDeg = 20.0f;
+                if (fovDeg > 90.0f) fovDeg = 90.0f;
+                g_ScrollY = 0.0f;
+            }
         }
         else
         {
-            panning = false;
-        }
-
-        // 滚轮缩放 FOV
-        if (g_ScrollY != 0.0f)
-        {
-            fovDeg -= g_ScrollY * 2.0f;
-            if (fovDeg < 20.0f) fovDeg = 20.0f;
-            if (fovDeg > 90.0f) fovDeg = 90.0f;
-            g_ScrollY = 0.0f;
+            // 相机路径只看时间：第 n 帧永远是同一个机位
+            CameraPath::Key key = cameraPath.Evaluate(headlessFrame * headlessDt);
+            cameraPos = key.position;
+            yaw = key.yaw;
+            pitch = key.pitch;
+            fovDeg = key.fov;
         }
 
         // 由 yaw/pitch 重建相机基向量
@@ -284,7 +472,13 @@ int main()
 
         // ---------------------- ImGui ----------------------
         ImGui_ImplOpenGL3_NewFrame();
-        ImGui_ImplGlfw_NewFrame();
+        if (window) {
+            ImGui_ImplGlfw_NewFrame();
+        } else {
+            ImGuiIO& io = ImGui::GetIO();
+            io.DisplaySize = ImVec2((float)w, (float)h);
+            io.DeltaTime = dt;
+        }
         ImGui::NewFrame();
 
         ImGui::Begin("RenderSandbox");
@@ -309,8 +503,145 @@ int main()
         ImGui::SliderFloat("Light Intensity", &lightIntensity, 1.0f, 300.0f);
         ImGui::Separator();
         ImGui::Text("PostProcess");
-        ImGui::Combo("Mode", &postMode, "None\0Invert\0Grayscale\0");
-        ImGui::SliderFloat("Vignette", &vignetteStrength, 0.0f, 1.0f);
+        for (int i = 0; i < (int)postStack.size(); ++i)
+        {
+            PostEffect& fx = postStack[i];
+            ImGui::PushID(i);
+            ImGui::Checkbox("##on", &fx.enabled);
+            ImGui::SameLine();
+            if (ImGui::ArrowButton("##up", ImGuiDir_Up) && i > 0)
+                std::swap(postStack[i], postStack[i - 1]);
+            ImGui::SameLine();
+            if (ImGui::ArrowButton("##down", ImGuiDir_Down) && i + 1 < (int)postStack.size())
+                std::swap(postStack[i], postStack[i + 1]);
+            ImGui::SameLine();
+            // 交换之后 fx 指向的已经是换过来的那一项，下面的控件照样对得上
+            if (ImGui::TreeNode("##fx", "%s", PostProcessPass::EffectName(fx.type)))
+            {
+                switch (fx.type)
+                {
+                case PostEffectType::Bloom:
+                    ImGui::SliderFloat("Intensity", &fx.bloomIntensity, 0.0f, 0.5f);
+                    break;
+                case PostEffectType::Exposure:
+                    ImGui::Checkbox("Auto", &fx.autoExposure);
+                    if (fx.autoExposure)
+                        ImGui::SliderFloat("Key", &fx.exposureKey, 0.05f, 0.5f);
+                    ImGui::SliderFloat(fx.autoExposure ? "Compensation EV" : "EV", &fx.exposureEV, -5.0f, 5.0f);
+                    break;
+                case PostEffectType::Tonemap:
+                {
+                    int op = (int)fx.tonemap;
+                    if (ImGui::Combo("Operator", &op, "Reinhard\0ACES\0Filmic\0"))
+                        fx.tonemap = (TonemapOperator)op;
+                    ImGui::SliderFloat("Gamma", &fx.gamma, 1.0f, 3.0f);
+                    break;
+                }
+                case PostEffectType::ColorGrade:
+                    ImGui::SliderFloat("Contrast", &fx.contrast, 0.5f, 2.0f);
+                    ImGui::SliderFloat("Saturation", &fx.saturation, 0.0f, 2.0f);
+                    ImGui::ColorEdit3("Filter", &fx.colorFilter.x);
+                    break;
+                case PostEffectType::Vignette:
+                    ImGui::SliderFloat("Strength", &fx.vignetteStrength, 0.0f, 1.0f);
+                    break;
+                case PostEffectType::Dither:
+                    ImGui::SliderFloat("Amplitude (1/255)", &fx.ditherAmplitude, 0.0f, 4.0f);
+                    break;
+                default:
+                    ImGui::TextDisabled("No parameters");
+                    break;
+                }
+                ImGui::TreePop();
+            }
+            ImGui::PopID();
+        }
+        ImGui::Text("Fused shader variants: %d", postPass.VariantCount());
+        if (ImGui::TreeNode("Bloom pyramid"))
+        {
+            BloomSettings& bloom = bloomPass.Settings();
+            ImGui::SliderInt("Iterations", &bloom.iterations, 1, BloomPass::kMaxIterations);
+            ImGui::SliderFloat("Threshold", &bloom.threshold, 0.0f, 5.0f);
+            ImGui::SliderFloat("Knee", &bloom.knee, 0.0f, 1.0f);
+            // 每级是图里的一个 pass，直接取图的 GPU 计时（被剔除时为 0）
+            double bloomGpuMs = 0.0;
+            for (const RenderGraph::PassInfo& pi : frameGraph.GetPassInfos())
+            {
+                if (pi.name.compare(0, 5, "Bloom") != 0) continue;
+                ImGui::Text("%-14s %s%.3f ms", pi.name.c_str(), pi.culled ? "(culled) " : "", pi.gpuMs);
+                bloomGpuMs += pi.gpuMs;
+            }
+            ImGui::Text("Bloom total: %.3f ms GPU, %d levels", bloomGpuMs, bloomPass.LevelCount());
+            ImGui::TreePop();
+        }
+        if (ImGui::TreeNode("Auto exposure"))
+        {
+            AutoExposureSettings& ae = autoExposure.Settings();
+            ImGui::SliderFloat("Speed up", &ae.speedUp, 0.1f, 10.0f);
+            ImGui::SliderFloat("Speed down", &ae.speedDown, 0.1f, 10.0f);
+            ImGui::DragFloatRange2("Log2 luminance", &ae.minLogLum, &ae.maxLogLum, 0.1f, -16.0f, 16.0f);
+            // 读回的值只用来显示，曝光本身在 post.frag 里直接读 GPU 上的结果
+            float logLum = 0.0f;
+            int latency = 0;
+            if (autoExposure.GetReadback(logLum, latency))
+                ImGui::Text("Adapted log2 lum: %.2f (EV %.2f), %d frames old", logLum, -logLum, latency);
+            else
+                ImGui::TextDisabled("No readback yet");
+            double exposureGpuMs = 0.0;
+            for (const RenderGraph::PassInfo& pi : frameGraph.GetPassInfos())
+            {
+                if (pi.name.compare(0, 9, "Luminance") != 0 && pi.name != "Exposure Adapt") continue;
+                ImGui::Text("%-20s %s%.3f ms", pi.name.c_str(), pi.culled ? "(culled) " : "", pi.gpuMs);
+                exposureGpuMs += pi.gpuMs;
+            }
+            ImGui::Text("Reduction total: %.3f ms GPU, %d levels", exposureGpuMs, autoExposure.ReductionLevels());
+            ImGui::TreePop();
+        }
+        {
+            // tonemap/调色/反色/灰度这一段烘成 3D LUT，shader 里只剩一次采样
+            bool useLut = postPass.IsLutEnabled();
+            if (ImGui::Checkbox("Bake color chain into 3D LUT", &useLut))
+                postPass.SetLutEnabled(useLut);
+            int lutSizeIndex = postPass.GetLutSize() >= 64 ? 1 : 0;
+            if (ImGui::Combo("LUT size", &lutSizeIndex, "32^3\0" "64^3\0"))
+                postPass.SetLutSize(lutSizeIndex == 1 ? 64 : 32);
+            const ColorLut& lut = postPass.GetLut();
+            ImGui::Text("LUT %s: %d^3 (%.1f KB), %d bakes, last bake %.2f ms + upload %.2f ms%s",
+                        postPass.IsLutActive() ? "in use" : "not used", lut.Size(), lut.Bytes() / 1024.0,
+                        lut.BakeCount(), lut.LastBakeMs(), lut.LastUploadMs(), lut.IsBaking() ? " (baking)" : "");
+            // 单像素开销：Post pass 的 GPU 时间摊到每个像素
+            for (const RenderGraph::PassInfo& pi : frameGraph.GetPassInfos())
+                if (pi.name == "Post" && w > 0 && h > 0)
+                    ImGui::Text("Post pass: %.3f ms GPU, %.2f ns/pixel", pi.gpuMs, pi.gpuMs * 1e6 / ((double)w * h));
+        }
+        if (ImGui::TreeNode("Dynamic resolution"))
+        {
+            DynamicResolutionSettings& dr = dynamicRes.Settings();
+            ImGui::Checkbox("Auto scale", &dr.enabled);
+            if (dr.enabled)
+            {
+                ImGui::SliderFloat("Target GPU ms", &dr.targetMs, 4.0f, 50.0f);
+                ImGui::DragFloatRange2("Scale range", &dr.minScale, &dr.maxScale, 0.01f, 0.25f, 1.0f);
+            }
+            else
+            {
+                ImGui::SliderFloat("Scale", &dr.manualScale, 0.25f, 1.0f);
+            }
+            int filter = (int)postPass.GetUpscaleFilter();
+            if (ImGui::Combo("Upscale", &filter, "Bilinear\0Edge-aware\0"))
+                postPass.SetUpscaleFilter((PostProcessPass::UpscaleFilter)filter);
+            if (postPass.GetUpscaleFilter() == PostProcessPass::UpscaleFilter::EdgeAware)
+            {
+                float sharpness = postPass.GetUpscaleSharpness();
+                if (ImGui::SliderFloat("Sharpness", &sharpness, 0.0f, 1.0f))
+                    postPass.SetUpscaleSharpness(sharpness);
+            }
+            ImGui::Text("Scale %.0f%%: %d x %d", dynamicRes.Scale() * 100.0f,
+                        dynamicRes.RenderWidth(), dynamicRes.RenderHeight());
+            ImGui::Text("GPU %.2f ms, headroom %+.2f ms, %d changes",
+                        dynamicRes.GpuMs(), dynamicRes.HeadroomMs(), dynamicRes.ChangeCount());
+            ImGui::TreePop();
+        }
         ImGui::Separator();
         ImGui::Text("Model");
         ImGui::Checkbox("Draw Model", &drawModel);
@@ -318,24 +649,453 @@ int main()
         ImGui::SliderFloat("Model Scale Mul", &modelScaleMul, 0.1f, 5.0f);
         ImGui::Text("Model Radius: %.3f", model.GetRadius());
         ImGui::Separator();
+        ImGui::Text("Object Grid");
+        ImGui::Checkbox("Draw Grid", &drawGrid);
+        ImGui::Checkbox("Batch (texture array + instancing)", &batchGrid);
+        {
+            const Renderer::BatchStats& bs = renderer.GetBatchStats();
+            if (batchGrid)
+                ImGui::Text("Objects %d, draws %d, batches saved %d",
+                            bs.objects, bs.drawCalls, bs.BatchesSaved());
+            else
+                ImGui::Text("Objects %d, draws %d", sceneStore.Count(), gridDrawCalls);
+        }
+        if (ImGui::TreeNode("Stress scene"))
+        {
+            // 扫描进行中不能手动重建（扫描每档自己重建）
+            const bool sweeping = stressSweep.IsRunning();
+            ImGui::InputInt("Objects (N)", &stressSettings.objects, 100, 1000);
+            ImGui::SliderInt("Models (M)", &stressSettings.models, 1, 16);
+            ImGui::SliderInt("Materials (K)", &stressSettings.materials, 1, 256);
+            ImGui::SliderInt("Lights (L)", &stressSettings.lights, 0, 64);
+            int layout = (int)stressSettings.layout;
+            if (ImGui::Combo("Layout", &layout, "grid\0random\0clustered\0"))
+                stressSettings.layout = (StressSceneSettings::Layout)layout;
+            ImGui::SliderFloat("Spacing", &stressSettings.spacing, 0.5f, 5.0f);
+            if (stressSettings.layout == StressSceneSettings::Layout::Clustered)
+                ImGui::SliderInt("Clusters", &stressSettings.clusters, 1, 64);
+            int seed = (int)stressSettings.seed;
+            if (ImGui::InputInt("Seed", &seed)) stressSettings.seed = (std::uint32_t)std::max(seed, 0);
+            ImGui::Checkbox("Animate", &stressSettings.animate);
+            if (!sweeping && ImGui::Button("Generate"))
+            {
+                stressScene.Generate(stressSettings);
+                drawGrid = true;
+            }
+            ImGui::Text("%d objects, %d models, %d materials, %d lights (%d shaded), %lld triangles",
+                        sceneStore.Count(), stressScene.ModelCount(), stressScene.MaterialCount(), (int)lights.size(),
+                        std::min((int)lights.size(), kMaxPointLights), (long long)stressScene.TriangleCount());
+            ImGui::Text("Matrices updated last frame: %d%s", (int)stressScene.UpdatedMatrices(),
+                        sceneStore.HasHierarchy() ? " (hierarchy)" : "");
+
+            // 扫描：某一个参数逐档跑，画出帧时间随它变化的曲线
+            ImGui::Separator();
+            ImGui::Text("Sweep");
+            ImGui::Combo("Axis", &sweepAxis, "objects\0materials\0lights\0");
+            ImGui::InputText("Values", sweepValues, sizeof(sweepValues));
+            ImGui::SliderInt("Frames per step", &sweepFrames, 10, 600);
+            if (!sweeping && ImGui::Button("Run sweep"))
+            {
+                std::vector<int> values;
+                for (const char* p = sweepValues; *p;)
+                {
+                    char* end = nullptr;
+                    long v = std::strtol(p, &end, 10);
+                    if (end == p) break;
+                    values.push_back((int)v);
+                    p = (*end == ',') ? end + 1 : end;
+                }
+                stressSweep.Start((StressSweep::Axis)sweepAxis, values, sweepFrames, 10);
+                stressSweep.Configure(stressSettings);
+                stressScene.Generate(stressSettings);
+                drawGrid = true;
+            }
+            if (sweeping)
+            {
+                if (ImGui::Button("Stop")) stressSweep.Stop();
+                ImGui::SameLine();
+                ImGui::Text("Step %d / %d", stressSweep.CurrentStep() + 1, stressSweep.StepCount());
+            }
+            const auto& points = stressSweep.Results();
+            if (!points.empty())
+            {
+                std::vector<float> wall, gpu;
+                for (const auto& p : points)
+                {
+                    wall.push_back((float)p.wallP50);
+                    gpu.push_back((float)p.gpuP50);
+                }
+                ImGui::PlotLines("Wall p50 (ms)", wall.data(), (int)wall.size(), 0, nullptr, 0.0f, FLT_MAX, ImVec2(0, 60));
+                ImGui::PlotLines("GPU p50 (ms)", gpu.data(), (int)gpu.size(), 0, nullptr, 0.0f, FLT_MAX, ImVec2(0, 60));
+                if (ImGui::BeginTable("##sweep", 5, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg))
+                {
+                    ImGui::TableSetupColumn(StressSweep::AxisName(stressSweep.GetAxis()));
+                    ImGui::TableSetupColumn("Wall p50");
+                    ImGui::TableSetupColumn("Wall p95");
+                    ImGui::TableSetupColumn("GPU p50");
+                    ImGui::TableSetupColumn("Draws");
+                    ImGui::TableHeadersRow();
+                    for (const auto& p : points)
+                    {
+                        ImGui::TableNextRow();
+                        ImGui::TableNextColumn(); ImGui::Text("%d", p.value);
+                        ImGui::TableNextColumn(); ImGui::Text("%.2f", p.wallP50);
+                        ImGui::TableNextColumn(); ImGui::Text("%.2f", p.wallP95);
+                        ImGui::TableNextColumn(); ImGui::Text("%.2f", p.gpuP50);
+                        ImGui::TableNextColumn(); ImGui::Text("%.0f", p.drawCalls);
+                    }
+                    ImGui::EndTable();
+                }
+                if (!stressSweep.IsRunning() && ImGui::Button("Save sweep"))
+                    stressSweep.WriteJson(headless.sweepPath);
+            }
+            ImGui::TreePop();
+        }
+        ImGui::Separator();
+        ImGui::Text("Texture Streaming");
+        ImGui::SliderInt("Budget (MB)", &textureBudgetMB, 1, 1024);
+        textureStreamer.SetBudgetBytes((std::size_t)textureBudgetMB * 1024u * 1024u);
+        ImGui::Text("Resident %.2f MB / Requested %.2f MB",
+                    textureStreamer.ResidentBytes() / (1024.0 * 1024.0),
+                    textureStreamer.RequestedBytes() / (1024.0 * 1024.0));
+        if (ImGui::BeginTable("##streaming", 4, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg))
+        {
+            ImGui::TableSetupColumn("Texture");
+            ImGui::TableSetupColumn("Mip (res/req)");
+            ImGui::TableSetupColumn("Resident KB");
+            ImGui::TableSetupColumn("Requested KB");
+            ImGui::TableHeadersRow();
+            for (const auto& ts : textureStreamer.GetStats())
+            {
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn(); ImGui::Text("%s%s", ts.name.c_str(), ts.loading ? " *" : "");
+                ImGui::TableNextColumn(); ImGui::Text("%d / %d", ts.residentMip, ts.requestedMip);
+                ImGui::TableNextColumn(); ImGui::Text("%.1f", ts.residentBytes / 1024.0);
+                ImGui::TableNextColumn(); ImGui::Text("%.1f", ts.requestedBytes / 1024.0);
+            }
+            ImGui::EndTable();
+        }
+        ImGui::Separator();
+        ImGui::Text("Environment");
+        if (ImGui::BeginCombo("HDRI", iblBaker.GetEnvironmentPath().c_str()))
+        {
+            for (const std::string& env : environments)
+            {
+                bool selected = (env == iblBaker.GetEnvironmentPath());
+                if (ImGui::Selectable(env.c_str(), selected) && !selected)
+                    iblBaker.BeginSwap(env);
+            }
+            ImGui::EndCombo();
+        }
+        ImGui::SliderInt("Bake steps / frame", &swapStepsPerFrame, 1, iblBaker.SwapStepCount());
+        if (ImGui::TreeNode("Bake settings"))
+        {
+            auto sizeCombo = [](const char* label, int& value, const int* options, int count) {
+                if (ImGui::BeginCombo(label, std::to_string(value).c_str()))
+                {
+                    for (int i = 0; i < count; ++i)
+                        if (ImGui::Selectable(std::to_string(options[i]).c_str(), options[i] == value))
+                            value = options[i];
+                    ImGui::EndCombo();
+                }
+            };
+            sizeCombo("Env size", bakeSettings.envSize, bakeEnvSizes, 4);
+            sizeCombo("Prefilter size", bakeSettings.prefilterSize, bakePrefilterSizes, 4);
+            if (ImGui::BeginCombo("Cubemap format", IBLCache::FormatName(bakeSettings.envFormat)))
+            {
+                for (uint32_t format : bakeFormats)
+                {
+                    if (ImGui::Selectable(IBLCache::FormatName(format), format == bakeSettings.envFormat))
+                        bakeSettings.envFormat = bakeSettings.irradianceFormat = bakeSettings.prefilterFormat = format;
+                }
+                ImGui::EndCombo();
+            }
+            if (ImGui::Button("Rebake"))
+            {
+                const std::string env = iblBaker.GetEnvironmentPath();
+                iblBaker.SetSettings(bakeSettings);
+                iblBaker.Bake(env, "cache/" + std::filesystem::path(env).stem().string() + ".iblcache");
+                hasSHDiff = hasBrdfDiff = false;
+            }
+            ImGui::TreePop();
+        }
+        if (iblBaker.IsSwapping())
+            ImGui::ProgressBar(iblBaker.GetSwapProgress(), ImVec2(-1.0f, 0.0f),
+                               iblBaker.GetSwapProgress() > 0.0f ? "Baking" : "Decoding");
+        ImGui::Text("Diffuse IBL");
+        ImGui::Text("IBL %s in %.2f ms", iblBaker.WasLoadedFromCache() ? "loaded from cache" : "rebuilt",
+                    iblBaker.GetLastBakeMs());
+        if (iblBaker.HasIrradianceSH())
+        {
+            ImGui::Checkbox("SH9 irradiance (CPU)", &useIrradianceSH);
+            ImGui::Text("SH bake: %.2f ms", iblBaker.GetSHBakeMs());
+            if (ImGui::Button("Compare SH vs convolution"))
+            {
+                shDiff = iblBaker.CompareSHWithConvolution();
+                hasSHDiff = true;
+            }
+            if (hasSHDiff)
+            {
+                ImGui::Text("Convolution bake: %.2f ms", shDiff.gpuBakeMs);
+                ImGui::Text("RMS %.4f, max %.4f", shDiff.rmsError, shDiff.maxError);
+                ImGui::Text("Rel RMS %.2f%%, max rel %.2f%%",
+                            shDiff.relRmsError * 100.0f, shDiff.maxRelError * 100.0f);
+            }
+        }
+        else
+        {
+            ImGui::Text("Convolution irradiance map (no CPU pixels)");
+        }
+        // 关掉 SH 时需要卷积结果；没烘过就现在补一次
+        if (!useIrradianceSH && iblBaker.HasIrradianceSH() && !iblBaker.GetIrradianceMap())
+        {
+            shDiff = iblBaker.CompareSHWithConvolution();
+            hasSHDiff = true;
+        }
+        ImGui::Text("Specular IBL");
+        ImGui::Checkbox("Prefiltered env + BRDF LUT", &useSpecularIBL);
+        if (ImGui::Button("Validate BRDF LUT (CPU reference)"))
+        {
+            brdfDiff = iblBaker.CompareBRDFLUT();
+            hasBrdfDiff = true;
+        }
+        if (hasBrdfDiff)
+            ImGui::Text("%d texels: RMS %.5f, max %.5f (CPU %.1f ms)",
+                        brdfDiff.texels, brdfDiff.rmsError, brdfDiff.maxError, brdfDiff.cpuMs);
+        ImGui::Separator();
+        {
+            const RenderTargetPool::Stats& rt = targetPool.GetStats();
+            ImGui::Text("Render targets: %d (%d in use, peak %d), %d FBOs",
+                        rt.textures, rt.inUse, rt.peakInUse, rt.framebuffers);
+            ImGui::Text("%.1f MB (%.1f MB idle), last frame: +%d new, %d reused, -%d deleted",
+                        rt.bytes / (1024.0 * 1024.0), rt.freeBytes / (1024.0 * 1024.0),
+                        rt.created, rt.reused, rt.deleted);
+        }
+        if (ImGui::TreeNode("Render graph"))
+        {
+            const RenderGraph::FrameStats& gs = frameGraph.GetFrameStats();
+            ImGui::Text("%d passes (%d culled), %d FBO binds, CPU %.2f ms, GPU %.2f ms",
+                        gs.passes, gs.culledPasses, gs.groups, gs.cpuMs, gs.gpuMs);
+            if (ImGui::BeginTable("graph_passes", 4))
+            {
+                ImGui::TableSetupColumn("Pass");
+                ImGui::TableSetupColumn("Group");
+                ImGui::TableSetupColumn("CPU ms");
+                ImGui::TableSetupColumn("GPU ms");
+                ImGui::TableHeadersRow();
+                for (const RenderGraph::PassInfo& pi : frameGraph.GetPassInfos())
+                {
+                    ImGui::TableNextRow();
+                    ImGui::TableNextColumn(); ImGui::Text("%s%s", pi.name.c_str(), pi.culled ? " (culled)" : "");
+                    ImGui::TableNextColumn(); ImGui::Text("%d", pi.group);
+                    ImGui::TableNextColumn(); ImGui::Text("%.3f", pi.cpuMs);
+                    ImGui::TableNextColumn(); ImGui::Text("%.3f", pi.gpuMs);
+                }
+                ImGui::EndTable();
+            }
+            if (ImGui::Button("Dump frame to render_graph.json"))
+                frameGraph.RequestDump("render_graph.json");
+            ImGui::TreePop();
+        }
+        if (ImGui::TreeNode("Draw stats"))
+        {
+            ImGui::Checkbox("Overlay", &showDrawStatsOverlay);
+            const DrawStats::Counters& last = DrawStats::LastFrame();
+            const std::array<double, DrawStats::kCounterCount> avg = DrawStats::Average();
+            if (ImGui::BeginTable("draw_stats", 3))
+            {
+                ImGui::TableSetupColumn("Counter");
+                ImGui::TableSetupColumn("Last frame");
+                ImGui::TableSetupColumn("Avg");
+                ImGui::TableHeadersRow();
+                for (int c = 0; c < DrawStats::kCounterCount; ++c)
+                {
+                    ImGui::TableNextRow();
+                    ImGui::TableNextColumn(); ImGui::Text("%s", DrawStats::Name((DrawStats::Counter)c));
+                    ImGui::TableNextColumn(); ImGui::Text("%lld", (long long)last[c]);
+                    ImGui::TableNextColumn(); ImGui::Text("%.1f", avg[c]);
+                }
+                ImGui::EndTable();
+            }
+            ImGui::TreePop();
+        }
+        if (ImGui::TreeNode("GPU memory"))
+        {
+            const double mb = 1024.0 * 1024.0;
+            const std::size_t total = GpuMemory::TotalBytes();
+            ImGui::Text("%.1f MB in %d objects (peak %.1f MB)", total / mb, GpuMemory::ObjectCount(),
+                        GpuMemory::PeakBytes() / mb);
+            if (ImGui::SliderInt("Budget (MB, 0 = off)", &gpuBudgetMB, 0, 2048))
+                GpuMemory::SetBudgetBytes((std::size_t)gpuBudgetMB * 1024 * 1024);
+            if (gpuBudgetMB > 0)
+            {
+                char overlay[64];
+                std::snprintf(overlay, sizeof(overlay), "%.1f / %d MB", total / mb, gpuBudgetMB);
+                ImGui::ProgressBar((float)(total / mb / gpuBudgetMB), ImVec2(-1.0f, 0.0f), overlay);
+            }
+            if (ImGui::BeginTable("gpu_memory", 4))
+            {
+                ImGui::TableSetupColumn("Category");
+                ImGui::TableSetupColumn("MB");
+                ImGui::TableSetupColumn("Peak MB");
+                ImGui::TableSetupColumn("Share");
+                ImGui::TableHeadersRow();
+                for (int c = 0; c < (int)GpuMemory::Category::kCount; ++c)
+                {
+                    const GpuMemory::CategoryStats cs = GpuMemory::GetCategory((GpuMemory::Category)c);
+                    ImGui::TableNextRow();
+                    ImGui::TableNextColumn(); ImGui::Text("%s (%d)", GpuMemory::CategoryName((GpuMemory::Category)c), cs.objects);
+                    ImGui::TableNextColumn(); ImGui::Text("%.2f", cs.bytes / mb);
+                    ImGui::TableNextColumn(); ImGui::Text("%.2f", cs.peakBytes / mb);
+                    ImGui::TableNextColumn();
+                    ImGui::ProgressBar(total ? (float)((double)cs.bytes / total) : 0.0f, ImVec2(-1.0f, 0.0f));
+                }
+                ImGui::EndTable();
+            }
+            if (ImGui::TreeNode("Assets"))
+            {
+                if (ImGui::BeginTable("gpu_memory_assets", 4))
+                {
+                    ImGui::TableSetupColumn("Asset");
+                    ImGui::TableSetupColumn("Category");
+                    ImGui::TableSetupColumn("Objects");
+                    ImGui::TableSetupColumn("MB");
+                    ImGui::TableHeadersRow();
+                    for (const GpuMemory::AssetStats& a : GpuMemory::Assets())
+                    {
+                        ImGui::TableNextRow();
+                        ImGui::TableNextColumn(); ImGui::Text("%s", a.name.c_str());
+                        ImGui::TableNextColumn(); ImGui::Text("%s", GpuMemory::CategoryName(a.category));
+                        ImGui::TableNextColumn(); ImGui::Text("%d", a.objects);
+                        ImGui::TableNextColumn(); ImGui::Text("%.2f", a.bytes / mb);
+                    }
+                    ImGui::EndTable();
+                }
+                ImGui::TreePop();
+            }
+            if (ImGui::Button("Report live objects"))
+                GpuMemory::ReportLeaks();
+            ImGui::TreePop();
+        }
+        if (ImGui::TreeNode("GPU profiler"))
+        {
+            GpuProfiler& profiler = GpuProfiler::Global();
+            bool profilerOn = profiler.IsEnabled();
+            if (ImGui::Checkbox("Enabled", &profilerOn))
+                profiler.SetEnabled(profilerOn);
+            ImGui::SameLine();
+            if (ImGui::Button("Reset"))
+                profiler.Reset();
+            ImGui::Text("%d frames resolved, %d dropped (results %d frames late at most)",
+                        profiler.ResolvedFrames(), profiler.DroppedFrames(), GpuProfiler::kFrameLatency);
+            if (ImGui::BeginTable("gpu_scopes", 6))
+            {
+                ImGui::TableSetupColumn("Scope");
+                ImGui::TableSetupColumn("Last");
+                ImGui::TableSetupColumn("Avg");
+                ImGui::TableSetupColumn("p50");
+                ImGui::TableSetupColumn("p95");
+                ImGui::TableSetupColumn("p99");
+                ImGui::TableHeadersRow();
+                for (const GpuProfiler::ScopeStats& st : profiler.GetStats())
+                {
+                    // 最近一帧没跑的区间（比如环境切换完之后的 IBL 步骤）灰掉，历史还在
+                    ImGui::TableNextRow();
+                    ImGui::TableNextColumn();
+                    if (st.active) ImGui::Text("%*s%s", st.depth * 2, "", st.name.c_str());
+                    else ImGui::TextDisabled("%*s%s", st.depth * 2, "", st.name.c_str());
+                    ImGui::TableNextColumn(); ImGui::Text("%.3f", st.lastMs);
+                    ImGui::TableNextColumn(); ImGui::Text("%.3f", st.avgMs);
+                    ImGui::TableNextColumn(); ImGui::Text("%.3f", st.p50Ms);
+                    ImGui::TableNextColumn(); ImGui::Text("%.3f", st.p95Ms);
+                    ImGui::TableNextColumn(); ImGui::Text("%.3f", st.p99Ms);
+                }
+                ImGui::EndTable();
+            }
+            if (ImGui::Button("Export gpu_profile.csv"))
+                profiler.ExportCsv("gpu_profile.csv");
+            ImGui::SameLine();
+            if (ImGui::Button("Export gpu_profile.json"))
+                profiler.ExportJson("gpu_profile.json");
+            ImGui::TreePop();
+        }
+        if (ImGui::TreeNode("Command capture"))
+        {
+            if (ImGui::Button("Record next frame"))
+                recordNextFrame = true;
+            ImGui::SameLine();
+            ImGui::Text("-> %s (replay with FrameReplay)", headless.recordPath.c_str());
+            ImGui::TreePop();
+        }
+        if (ImGui::TreeNode("Trace capture"))
+        {
+#ifndef RENDERSANDBOX_PROFILE
+            ImGui::TextDisabled("Built without RENDERSANDBOX_PROFILE: GPU zones only");
+#endif
+            const bool tracing = GpuProfiler::Global().IsTraceCapturing();
+            if (ImGui::Button(tracing ? "Stop and write trace (F9)" : "Start capture (F9)"))
+            {
+                if (tracing) stopTrace();
+                else startTrace();
+            }
+            ImGui::Text("%s, %d GPU zones so far", tracePath.c_str(), (int)GpuProfiler::Global().TraceEvents().size());
+            ImGui::TreePop();
+        }
         ImGui::End();
 
+        // 左上角常驻的紧凑版本，不抢鼠标
+        if (showDrawStatsOverlay)
+        {
+            const DrawStats::Counters& last = DrawStats::LastFrame();
+            ImGui::SetNextWindowPos(ImVec2(10.0f, 10.0f), ImGuiCond_Always);
+            ImGui::SetNextWindowBgAlpha(0.6f);
+            ImGui::Begin("##draw_stats_overlay", nullptr,
+                         ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_AlwaysAutoResize |
+                         ImGuiWindowFlags_NoInputs | ImGuiWindowFlags_NoSavedSettings |
+                         ImGuiWindowFlags_NoFocusOnAppearing | ImGuiWindowFlags_NoNav);
+            ImGui::Text("Draws %lld, tris %lld, verts %lld", (long long)last[DrawStats::DrawCalls],
+                        (long long)last[DrawStats::Triangles], (long long)last[DrawStats::Vertices]);
+            ImGui::Text("Programs %lld (+%lld redundant), FBOs %lld (+%lld redundant)",
+                        (long long)last[DrawStats::ProgramSwitches], (long long)last[DrawStats::RedundantProgramBinds],
+                        (long long)last[DrawStats::FboSwitches], (long long)last[DrawStats::RedundantFboBinds]);
+            ImGui::Text("Textures %lld, VAOs %lld, uniforms %lld", (long long)last[DrawStats::TextureBinds],
+                        (long long)last[DrawStats::VaoBinds], (long long)last[DrawStats::UniformCalls]);
+            ImGui::Text("Uploads %lld, %.1f KB", (long long)last[DrawStats::BufferUploads],
+                        last[DrawStats::BufferBytes] / 1024.0);
+            ImGui::End();
+        }
+
         ImGui::Render();
 
+        // 环境切换：每帧推进几步，完成前继续用旧贴图
+        {
+            PROFILE_ZONE("IBL swap");
+            if (iblBaker.UpdateSwap(swapStepsPerFrame))
+                hasSHDiff = false;
+        }
+
         // ---------------------- GL 状态开关 ----------------------
         if (enableDepth) glEnable(GL_DEPTH_TEST); else glDisable(GL_DEPTH_TEST);
         if (enableCull)  glEnable(GL_CULL_FACE);  else glDisable(GL_CULL_FACE);
 
-        // ---------------------- 清屏 + Offscreen(FBO) ----------------------
-        int w, h;
-        glfwGetFramebufferSize(window, &w, &h);
-        sceneFbo.Resize(w, h);
-
-        sceneFbo.Bind();
-        glViewport(0, 0, w, h);
+        // ---------------------- 帧图资源：离屏颜色/深度 + 默认帧缓冲 ----------------------
+        RenderGraph::ResourceId sceneColor = frameGraph.CreateTexture("SceneColor", { w, h, GL_RGB16F, 0 });
+        RenderGraph::ResourceId sceneDepth = frameGraph.CreateTexture("SceneDepth", { w, h, GL_DEPTH24_STENCIL8, 0 });
+        // headless 没有默认帧缓冲：画进 headlessTarget 的颜色纹理
+        RenderGraph::ResourceId backbuffer = RenderGraph::kInvalidResource;
+        if (window) {
+            backbuffer = frameGraph.ImportBackbuffer("Backbuffer", w, h);
+        } else {
+            backbuffer = frameGraph.ImportTexture("Backbuffer", headlessTarget.ColorTex(), { w, h, GL_RGB16F, 0 });
+            frameGraph.MarkOutput(backbuffer);
+        }
 
-        glClearColor(0.1f, 0.12f, 0.15f, 1.0f);
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        // ---------------------- 动态分辨率 ----------------------
+        // 场景目标按窗口大小分配（池子里一直复用同一份），场景只画进左下角 rw x rh 的视口
+        dynamicRes.Update(frameGraph.GetFrameStats().gpuMs, w, h);
+        const int rw = dynamicRes.RenderWidth();
+        const int rh = dynamicRes.RenderHeight();
+        const glm::vec2 sceneUvScale = dynamicRes.UvScale();
 
 
         // ---------------------- 计算 view/proj ----------------------
@@ -343,83 +1103,332 @@ int main()
         float aspect = (h == 0) ? 1.0f : (float)w / (float)h;
         glm::mat4 proj = glm::perspective(glm::radians(fovDeg), aspect, 0.1f, 100.0f);
 
-        // ---------------------- 每帧把 ImGui 参数写回材质 ----------------------
-        litMat.color = glm::vec4(tintColor[0], tintColor[1], tintColor[2], tintColor[3]);
-        litMat.shininess = shininess;
-        litMat.ambientStrength = ambientStrength;
-        litMat.metallic  = metallic;
-        litMat.roughness = roughness;
-        litMat.ao        = ao;
+        // ---------------------- 可见性：按屏幕占比请求纹理精度 ----------------------
+        glm::mat4 modelMat(1.0f);
+        modelMat = glm::rotate(modelMat, glm::radians(modelYaw), glm::vec3(0.0f, 1.0f, 0.0f));
 
-        // 用 lightIntensity 缩放光源颜色传入 shader
-        // PBR 距离平方衰减需要更强的光源才能看到效果
-        litMat.Bind(cameraPos);   // 激活 shader + 传材质 uniform
-        shader.setUniform1i("u_PointLightCount", (int)lights.size());
-        // 绑定 IrradianceMap 到纹理单元 2
-        shader.setUniform1i("u_IrradianceMap", 2);
-        glActiveTexture(GL_TEXTURE2);
-        glBindTexture(GL_TEXTURE_CUBE_MAP, iblBaker.GetIrradianceMap());
-        for (int li = 0; li < (int)lights.size(); li++)
+        float radius = model.GetRadius();
+        float fitScale = (radius > 0.0001f) ? (1.2f / radius) : 1.0f;
+        if (fitScale > 100.0f) fitScale = 100.0f;
+        modelMat = glm::scale(modelMat, glm::vec3(fitScale * modelScaleMul));
+        modelMat = glm::translate(modelMat, -model.GetCenter());
+
+        if (drawModel && albedo)
         {
-            shader.setUniform3f(("u_PointLights[" + std::to_string(li) + "].position").c_str(),
-                lights[li].position.x, lights[li].position.y, lights[li].position.z);
-            glm::vec3 scaledColor = lights[li].color * lightIntensity;
-            shader.setUniform3f(("u_PointLights[" + std::to_string(li) + "].color").c_str(),
-                scaledColor.x, scaledColor.y, scaledColor.z);
+            // GetRadius 是最大半轴长，包围球半径取对角线（×√3），中心平移后在原点
+            float worldRadius = radius * 1.7320508f * fitScale * modelScaleMul;
+            int mip = TextureStreamer::EstimateMip(view, proj, glm::vec3(0.0f), worldRadius,
+                                                   rh, albedo->Width(), albedo->Height());
+            textureStreamer.RequestMip(albedo, mip);
         }
-
-        if (drawModel)
+        // 压力场景动画：只看时间，headless 下每次运行相同
+        stressScene.Update(window ? (float)glfwGetTime() : (float)headlessFrame * headlessDt);
+        if (drawGrid && albedo)
         {
-            glm::mat4 modelMat(1.0f);
-            modelMat = glm::rotate(modelMat, glm::radians(modelYaw), glm::vec3(0.0f, 1.0f, 0.0f));
-
-            float radius = model.GetRadius();
-            float fitScale = (radius > 0.0001f) ? (1.2f / radius) : 1.0f;
-            if (fitScale > 100.0f) fitScale = 100.0f;
-            modelMat = glm::scale(modelMat, glm::vec3(fitScale * modelScaleMul));
-            modelMat = glm::translate(modelMat, -model.GetCenter());
-
-            shader.SetMatrices(modelMat, view, proj);
-            model.Draw();
+            for (int i = 0; i < sceneStore.Count(); ++i)
+            {
+                // 缩放取世界矩阵三列的长度，父节点的缩放也算进去
+                const glm::mat4& world = sceneStore.WorldMatrix(i);
+                float objRadius = 0.5f * 1.7320508f * std::max(glm::length(glm::vec3(world[0])),
+                                  std::max(glm::length(glm::vec3(world[1])), glm::length(glm::vec3(world[2]))));
+                int mip = TextureStreamer::EstimateMip(view, proj, glm::vec3(world[3]), objRadius,
+                                                       rh, albedo->Width(), albedo->Height());
+                textureStreamer.RequestMip(albedo, mip);
+            }
+        }
+        // 上传工作线程解好的 mip + 按预算淘汰（要在绑定材质之前，上传会改纹理绑定）
+        {
+            PROFILE_ZONE("Texture streaming");
+            textureStreamer.Update();
         }
 
-        // ---- 渲染天空盒 ----
-        glDepthFunc(GL_LEQUAL);  // 天空盒深度值 = 1.0，LEQUAL 才能通过测试
+        // ---------------------- Scene：模型 + 物体网格 ----------------------
+        frameGraph.AddPass("Scene", [&](const RenderGraph::PassContext&) {
+            glViewport(0, 0, rw, rh);
+            frameCapture.BeginPass("Scene", rw, rh, true, glm::vec4(0.1f, 0.12f, 0.15f, 1.0f), enableDepth, enableCull);
+            frameCapture.SetCamera(view, proj, cameraPos);
+            // ---------------------- 每帧把 ImGui 参数写回材质 ----------------------
+            litMat.color = glm::vec4(tintColor[0], tintColor[1], tintColor[2], tintColor[3]);
+            litMat.shininess = shininess;
+            litMat.ambientStrength = ambientStrength;
+            litMat.metallic  = metallic;
+            litMat.roughness = roughness;
+            litMat.ao        = ao;
+
+            // 用 lightIntensity 缩放光源颜色传入 shader
+            // PBR 距离平方衰减需要更强的光源才能看到效果
+            std::vector<PointLight> scaledLights = lights;
+            for (auto& L : scaledLights) L.color *= lightIntensity;
+
+            litMat.Bind(cameraPos);   // 激活 shader + 传材质 uniform
+            frameCapture.BindMaterial(&litMat);
+            // IrradianceMap / PrefilterMap / BRDF LUT 绑到 2 / 3 / 4 号纹理单元
+            iblBaker.ApplyToShader(shader, useIrradianceSH, useSpecularIBL, true);
+            frameCapture.SetEnvironment(iblBaker.GetEnvironmentPath(), useIrradianceSH, useSpecularIBL, true);
+            const int lightCount = std::min((int)scaledLights.size(), kMaxPointLights);
+            shader.setUniform1i("u_PointLightCount", lightCount);
+            for (int li = 0; li < lightCount; li++)
+            {
+                shader.setUniform3f(("u_PointLights[" + std::to_string(li) + "].position").c_str(),
+                    scaledLights[li].position.x, scaledLights[li].position.y, scaledLights[li].position.z);
+                shader.setUniform3f(("u_PointLights[" + std::to_string(li) + "].color").c_str(),
+                    scaledLights[li].color.x, scaledLights[li].color.y, scaledLights[li].color.z);
+            }
+            frameCapture.SetLights(scaledLights);
 
-        skyboxShader.Bind();
-        // 去掉 view 的平移，相机永远在盒子中心
-        glm::mat4 skyView = glm::mat4(glm::mat3(view));
-        skyboxShader.setUniformMat4("u_Projection", proj);
-        skyboxShader.setUniformMat4("u_View", skyView);
-        skyboxShader.setUniform1i("u_Skybox", 0);
+            if (drawModel)
+            {
+                shader.SetMatrices(modelMat, view, proj);
+                model.Draw();
+                frameCapture.DrawModel(&model, modelMat);
+            }
 
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_CUBE_MAP, iblBaker.GetEnvCubemap());
-        //glBindTexture(GL_TEXTURE_CUBE_MAP, iblBaker.GetIrradianceMap());
+            // ---- 物体网格：纹理数组 + instancing 一次画完，或者逐物体绑定材质 ----
+            gridDrawCalls = 0;
+            if (drawGrid)
+            {
+                if (batchGrid)
+                {
+                    renderer.SetPointLights(scaledLights);
+                    renderer.BeginFrame(view, proj, cameraPos);
+
+                    // IBL 贴图上面已经绑过，这里只设 uniform
+                    instancedShader.Bind();
+                    frameCapture.BindShader(&instancedShader);
+                    iblBaker.ApplyToShader(instancedShader, useIrradianceSH, useSpecularIBL, false);
+                    frameCapture.SetEnvironment(iblBaker.GetEnvironmentPath(), useIrradianceSH, useSpecularIBL, false);
+                    bool submitted = true;
+                    for (int i = 0; i < sceneStore.Count(); ++i)
+                    {
+                        const glm::mat4& world = sceneStore.WorldMatrix(i);
+                        const Material& material = stressScene.MaterialOf(i);
+                        Model& objModel = stressScene.ModelOf(i);
+                        submitted = renderer.SubmitInstanced(world, material, objModel) && submitted;
+                        frameCapture.SubmitInstanced(&objModel, &material, world);
+                    }
+                    renderer.FlushInstanced();
+                    frameCapture.FlushInstanced(&instancedShader);
+                    // 贴图没能打包（比如加载失败）时退回逐物体绘制
+                    if (!submitted) batchGrid = false;
+                }
+                else
+                {
+                    // 每个物体都要重新绑定材质（shader 的灯光 uniform 上面已经设置过）
+                    for (int i = 0; i < sceneStore.Count(); ++i)
+                    {
+                        const glm::mat4& world = sceneStore.WorldMatrix(i);
+                        const Material& material = stressScene.MaterialOf(i);
+                        Model& objModel = stressScene.ModelOf(i);
+                        material.Bind(cameraPos);
+                        frameCapture.BindMaterial(&material);
+                        shader.SetMatrices(world, view, proj);
+                        objModel.Draw();
+                        frameCapture.DrawModel(&objModel, world);
+                        ++gridDrawCalls;
+                    }
+                }
+            }
+            frameCapture.EndPass();
+        })
+            .WriteColor(sceneColor, RenderGraph::LoadOp::Clear)
+            .WriteDepth(sceneDepth, RenderGraph::LoadOp::Clear)
+            .SetClearColor(glm::vec4(0.1f, 0.12f, 0.15f, 1.0f));
+
+        // 附件和 Scene 相同，图会把两者合并成一次 FBO 绑定
+        frameGraph.AddPass("Skybox", [&](const RenderGraph::PassContext&) {
+            glViewport(0, 0, rw, rh);
+            frameCapture.BeginPass("Skybox", rw, rh, false, glm::vec4(0.0f), enableDepth, enableCull);
+            frameCapture.DrawSkybox(&skyboxShader);
+            // ---- 渲染天空盒 ----
+            glDepthFunc(GL_LEQUAL);  // 天空盒深度值 = 1.0，LEQUAL 才能通过测试
+
+            skyboxShader.Bind();
+            // 去掉 view 的平移，相机永远在盒子中心
+            glm::mat4 skyView = glm::mat4(glm::mat3(view));
+            skyboxShader.setUniformMat4("u_Projection", proj);
+            skyboxShader.setUniformMat4("u_View", skyView);
+            skyboxShader.setUniform1i("u_Skybox", 0);
+
+            glActiveTexture(GL_TEXTURE0);
+            DrawStats::BindTexture();
+            glBindTexture(GL_TEXTURE_CUBE_MAP, iblBaker.GetEnvCubemap());
+            //glBindTexture(GL_TEXTURE_CUBE_MAP, iblBaker.GetIrradianceMap());
+
+
+            iblBaker.RenderCube();  // 复用已有的 RenderCube
+
+            glDepthFunc(GL_LESS);   // 恢复默认深度测试
+            // ---- 天空盒结束 ----
+            frameCapture.EndPass();
+        })
+            .WriteColor(sceneColor)
+            .WriteDepth(sceneDepth);
+
+        // ---------------------- Bloom：dual-Kawase 金字塔 ----------------------
+        // 每帧都声明；栈里关掉 Bloom 时 Post 不读它，整条金字塔被图剔除
+        RenderGraph::ResourceId bloomTex = bloomPass.AddToGraph(frameGraph, sceneColor, w, h, sceneUvScale);
+        bool useBloom = bloomTex != RenderGraph::kInvalidResource &&
+                        std::any_of(postStack.begin(), postStack.end(), [](const PostEffect& e) {
+                            return e.enabled && e.type == PostEffectType::Bloom;
+                        });
+
+        // ---------------------- 自动曝光：亮度归约 + 时间适应 ----------------------
+        // 同样每帧声明；手动曝光时没人读结果，整条链被剔除，切回自动时直接从当前亮度开始
+        RenderGraph::ResourceId exposureTex = autoExposure.AddToGraph(frameGraph, sceneColor, w, h, dt, sceneUvScale);
+        bool useAutoExposure = exposureTex != RenderGraph::kInvalidResource &&
+                               std::any_of(postStack.begin(), postStack.end(), [](const PostEffect& e) {
+                                   return e.enabled && e.type == PostEffectType::Exposure && e.autoExposure;
+                               });
 
+        // ---------------------- Present: FBO -> Default ----------------------
+        RenderGraph::PassBuilder post = frameGraph.AddPass("Post", [&](const RenderGraph::PassContext& ctx) {
+            postPass.Execute(ctx.Texture(sceneColor), ctx.width, ctx.height, postStack,
+                             useBloom ? ctx.Texture(bloomTex) : 0,
+                             useAutoExposure ? ctx.Texture(exposureTex) : 0, sceneUvScale);
+        });
+        post.Read(sceneColor).WriteColor(backbuffer, RenderGraph::LoadOp::DontCare);
+        if (useBloom) post.Read(bloomTex);
+        if (useAutoExposure) post.Read(exposureTex);
 
-        iblBaker.RenderCube();  // 复用已有的 RenderCube
+        // ---------------------- ImGui 渲染 ----------------------
+        if (window)
+        {
+            frameGraph.AddPass("ImGui", [&](const RenderGraph::PassContext&) {
+                ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+            })
+                .WriteColor(backbuffer);
+        }
 
-        glDepthFunc(GL_LESS);   // 恢复默认深度测试
-        // ---- 天空盒结束 ----
+        // ---------------------- Headless 截图：HDR 场景颜色（后处理之前） ----------------------
+        const bool captureThisFrame = headless.enabled &&
+            std::find(headless.captureFrames.begin(), headless.captureFrames.end(), headlessFrame) != headless.captureFrames.end();
+        if (captureThisFrame && headless.captureExr)
+        {
+            frameGraph.AddPass("Capture HDR", [&](const RenderGraph::PassContext& ctx) {
+                // 场景只画在左下角 rw x rh，整张读回后裁掉
+                std::vector<float> pixels((std::size_t)w * h * 3);
+                glPixelStorei(GL_PACK_ALIGNMENT, 1);
+                glBindTexture(GL_TEXTURE_2D, ctx.Texture(sceneColor));
+                glGetTexImage(GL_TEXTURE_2D, 0, GL_RGB, GL_FLOAT, pixels.data());
+                glBindTexture(GL_TEXTURE_2D, 0);
+                glPixelStorei(GL_PACK_ALIGNMENT, 4);
+                std::vector<float> cropped((std::size_t)rw * rh * 3);
+                for (int y = 0; y < rh; ++y)
+                    std::copy_n(&pixels[(std::size_t)y * w * 3], (std::size_t)rw * 3, &cropped[(std::size_t)y * rw * 3]);
+                char path[512];
+                std::snprintf(path, sizeof(path), "%s_%04d.exr", headless.capturePrefix.c_str(), headlessFrame);
+                if (ImageWriter::WriteExr(path, rw, rh, cropped.data()))
+                    std::printf("[Headless] Wrote %s\n", path);
+            })
+                .Read(sceneColor)
+                .SetSideEffect();
+        }
 
+        // 临时目标在最后一次使用后马上还给池子（SceneDepth 在 Skybox 之后、SceneColor 在 Post 之后）
+        {
+            PROFILE_ZONE("Graph compile");
+            frameGraph.Compile();
+        }
+        {
+            PROFILE_ZONE("Graph execute");
+            frameGraph.Execute(targetPool);
+        }
+        if (frameCapture.IsRecording())
+            frameCapture.End(headless.recordPath);
+        // 扫描：这一帧进当前档；一档测完按下一档重建场景，全部测完写结果
+        if (stressSweep.IsRunning())
+        {
+            double wallMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - frameStart).count();
+            const DrawStats::Counters& draws = DrawStats::CurrentFrame();
+            if (stressSweep.Record(wallMs, frameGraph.GetFrameStats().cpuMs, frameGraph.GetFrameStats().gpuMs,
+                                   (long long)draws[DrawStats::DrawCalls], (long long)draws[DrawStats::ProgramSwitches]))
+            {
+                stressSweep.Configure(stressSettings);
+                stressScene.Generate(stressSettings);
+            }
+            else if (!stressSweep.IsRunning())
+            {
+                stressSweep.WriteJson(headless.sweepPath);
+            }
+        }
+        if (window)
+        {
+            PROFILE_ZONE("Swap");
+            glfwSwapBuffers(window);
+            continue;
+        }
 
-        // ---------------------- Present: FBO -> Default ----------------------
-        postPass.Execute(sceneFbo.ColorTex(), w, h, postMode, vignetteStrength);
+        // ---------------------- Headless：计时 + 截图 ----------------------
+        if (headless.finishEachFrame)
+        {
+            PROFILE_ZONE("glFinish");
+            glFinish();
+        }
+        if (captureThisFrame && headless.capturePng)
+        {
+            std::vector<unsigned char> pixels((std::size_t)w * h * 4);
+            headlessTarget.Bind();
+            glReadPixels(0, 0, w, h, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+            Framebuffer::BindDefault();
+            char path[512];
+            std::snprintf(path, sizeof(path), "%s_%04d.png", headless.capturePrefix.c_str(), headlessFrame);
+            if (ImageWriter::WritePng(path, w, h, pixels.data()))
+                std::printf("[Headless] Wrote %s\n", path);
+        }
 
+        FrameTimingLog::Frame timing;
+        timing.index = headlessFrame;
+        timing.wallMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - frameStart).count();
+        timing.graphCpuMs = frameGraph.GetFrameStats().cpuMs;
+        timing.gpuMs = frameGraph.GetFrameStats().gpuMs;
+        timing.renderScale = dynamicRes.Scale();
+        timing.draws = DrawStats::CurrentFrame();
+        // 截图帧多了读回和写盘，不进统计
+        timingLog.Record(timing, frameGraph.GetPassInfos(), headlessFrame >= headless.warmup && !captureThisFrame);
+        ++headlessFrame;
+    }
 
+    if (headless.enabled)
+    {
+        if (timingLog.WriteJson(headless.timingsPath, headless.width, headless.height, headlessDt, headless.warmup))
+            std::printf("[Headless] %d frames, timings written to %s\n", timingLog.FrameCount(), headless.timingsPath.c_str());
+        const std::string& profilePath = headless.gpuProfilePath;
+        if (!profilePath.empty())
+        {
+            if (profilePath.size() > 4 && profilePath.compare(profilePath.size() - 4, 4, ".csv") == 0)
+                GpuProfiler::Global().ExportCsv(profilePath);
+            else
+                GpuProfiler::Global().ExportJson(profilePath);
+        }
+    }
 
-        // ---------------------- ImGui 渲染 ----------------------
-        ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
-        glfwSwapBuffers(window);
+    // 退出时还在录：等 GPU 做完，把最后几帧的 GPU 区间也读回来再写
+    if (GpuProfiler::Global().IsTraceCapturing())
+    {
+        glFinish();
+        GpuProfiler::Global().BeginFrame();
+        stopTrace();
     }
 
     // ---------------------- 清理 ----------------------
+    iblBaker.Destroy();
+    postPass.Shutdown();
+    bloomPass.Shutdown();
+    autoExposure.Shutdown();
+    frameGraph.Destroy();
+    targetPool.Destroy();
+    GpuProfiler::Global().Destroy();
+
     ImGui_ImplOpenGL3_Shutdown();
-    ImGui_ImplGlfw_Shutdown();
+    if (window) ImGui_ImplGlfw_Shutdown();
     ImGui::DestroyContext();
 
-    glfwDestroyWindow(window);
-    glfwTerminate();
+    if (window)
+    {
+        glfwDestroyWindow(window);
+        glfwTerminate();
+    }
+    headlessTarget.Destroy();
+    headlessContext.Destroy();
     return 0;
 }
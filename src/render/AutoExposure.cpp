@@ -0,0 +1,221 @@
+#include "AutoExposure.h"
+
+#include "../Shader.h"
+#include "DrawStats.h"
+#include "GpuMemory.h"
+
+#include <glad/glad.h>
+
+#include <cstdio>
+
+// Shader 在头文件里只有前置声明，构造/析构放这里
+AutoExposure::AutoExposure() = default;
+AutoExposure::~AutoExposure() = default;
+
+bool AutoExposure::Init(const std::string& vertexPath, const std::string& luminancePath,
+                        const std::string& adaptPath)
+{
+    m_Luminance.reset(new Shader(vertexPath, luminancePath, "#define LUMINANCE_FIRST\n"));
+    m_Reduce.reset(new Shader(vertexPath, luminancePath));
+    m_Adapt.reset(new Shader(vertexPath, adaptPath));
+    if (!m_Vao) {
+        glGenVertexArrays(1, &m_Vao);
+    }
+
+    // 适应结果跨帧保留，自己持有；初值 0（亮度 1），第一次执行时会直接重置成当前亮度
+    const float zero = 0.0f;
+    glGenTextures(2, m_Adapted);
+    for (int i = 0; i < 2; ++i)
+    {
+        glBindTexture(GL_TEXTURE_2D, m_Adapted[i]);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_R32F, 1, 1, 0, GL_RED, GL_FLOAT, &zero);
+        GpuMemory::TrackTexture(m_Adapted[i], GpuMemory::Category::PostProcess, "Auto exposure",
+                                GpuMemory::TextureBytes(GL_R32F, 1, 1));
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    glGenBuffers(kReadbackRing, m_Pbos);
+    for (int i = 0; i < kReadbackRing; ++i)
+    {
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, m_Pbos[i]);
+        glBufferData(GL_PIXEL_PACK_BUFFER, sizeof(float), nullptr, GL_STREAM_READ);
+        GpuMemory::TrackBuffer(m_Pbos[i], GpuMemory::Category::PostProcess, "Auto exposure", sizeof(float));
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    if (!m_Luminance->GetRendererID() || !m_Reduce->GetRendererID() || !m_Adapt->GetRendererID())
+    {
+        std::printf("[AutoExposure] Failed to compile exposure shaders\n");
+        return false;
+    }
+    return true;
+}
+
+void AutoExposure::Shutdown()
+{
+    if (m_Vao) {
+        glDeleteVertexArrays(1, &m_Vao);
+        m_Vao = 0;
+    }
+    if (m_Adapted[0]) {
+        GpuMemory::FreeTexture(m_Adapted[0]);
+        GpuMemory::FreeTexture(m_Adapted[1]);
+        glDeleteTextures(2, m_Adapted);
+        m_Adapted[0] = m_Adapted[1] = 0;
+    }
+    for (int i = 0; i < kReadbackRing; ++i)
+    {
+        if (m_Fences[i]) glDeleteSync((GLsync)m_Fences[i]);
+        m_Fences[i] = nullptr;
+    }
+    if (m_Pbos[0]) {
+        for (int i = 0; i < kReadbackRing; ++i) GpuMemory::FreeBuffer(m_Pbos[i]);
+        glDeleteBuffers(kReadbackRing, m_Pbos);
+        for (int i = 0; i < kReadbackRing; ++i) m_Pbos[i] = 0;
+    }
+    m_Luminance.reset();
+    m_Reduce.reset();
+    m_Adapt.reset();
+    m_HasReadback = false;
+}
+
+void AutoExposure::Draw()
+{
+    DrawStats::BindVertexArray();
+    glBindVertexArray(m_Vao);
+    DrawStats::DrawArrays(GL_TRIANGLES, 0, 3);
+    glBindVertexArray(0);
+}
+
+RenderGraph::ResourceId AutoExposure::AddToGraph(RenderGraph& graph, RenderGraph::ResourceId source,
+                                                 int width, int height, float dt,
+                                                 const glm::vec2& sourceUvScale)
+{
+    m_Levels = 0;
+    if (!m_Adapt || !m_Adapt->GetRendererID() || width <= 0 || height <= 0)
+        return RenderGraph::kInvalidResource;
+
+    const std::uint64_t frame = ++m_Frame;
+    const int prev = m_Current;
+    m_Current = 1 - m_Current;
+    RenderGraph::ResourceId previous = graph.ImportTexture("Exposure (prev)", m_Adapted[prev], { 1, 1, GL_R32F, 0 });
+    RenderGraph::ResourceId adapted = graph.ImportTexture("Exposure", m_Adapted[m_Current], { 1, 1, GL_R32F, 0 });
+
+    // ---- 归约：源 -> 1/4 -> 1/16 -> ... -> 1x1 ----
+    RenderGraph::ResourceId src = source;
+    int srcW = width, srcH = height;
+    while (true)
+    {
+        const int w = (srcW + 3) / 4;
+        const int h = (srcH + 3) / 4;
+        char name[32];
+        std::snprintf(name, sizeof(name), "Luminance %d", m_Levels);
+        RenderGraph::ResourceId dst = graph.CreateTexture(name, { w, h, GL_R16F, 0 });
+
+        Shader* shader = (m_Levels == 0) ? m_Luminance.get() : m_Reduce.get();
+        if (m_Levels == 0)
+            std::snprintf(name, sizeof(name), "Luminance");
+        else
+            std::snprintf(name, sizeof(name), "Luminance Reduce %d", m_Levels);
+        graph.AddPass(name, [this, shader, src, srcW, srcH, sourceUvScale](const RenderGraph::PassContext& ctx) {
+            glDisable(GL_DEPTH_TEST);
+            glDisable(GL_BLEND);
+            shader->Bind();
+            glActiveTexture(GL_TEXTURE0);
+            DrawStats::BindTexture();
+            glBindTexture(GL_TEXTURE_2D, ctx.Texture(src));
+            shader->setUniform1i("u_Source", 0);
+            shader->setUniform2f("u_SourceTexel", 1.0f / (float)srcW, 1.0f / (float)srcH);
+            if (shader == m_Luminance.get())
+            {
+                shader->setUniform2f("u_LogLumRange", m_Settings.minLogLum, m_Settings.maxLogLum);
+                shader->setUniform2f("u_SourceUvScale", sourceUvScale.x, sourceUvScale.y);
+            }
+            Draw();
+        })
+            .Read(src)
+            .WriteColor(dst, RenderGraph::LoadOp::DontCare);
+
+        ++m_Levels;
+        src = dst;
+        srcW = w;
+        srcH = h;
+        if (w == 1 && h == 1) break;
+    }
+
+    // ---- 时间适应 ----
+    graph.AddPass("Exposure Adapt", [this, src, previous, frame, dt](const RenderGraph::PassContext& ctx) {
+        // 上一帧没执行（被剔除或第一次）：上一帧的纹理是旧的，直接取当前亮度
+        const bool reset = m_LastAdaptFrame == 0 || m_LastAdaptFrame + 1 != frame;
+        m_LastAdaptFrame = frame;
+
+        glDisable(GL_DEPTH_TEST);
+        glDisable(GL_BLEND);
+        m_Adapt->Bind();
+        glActiveTexture(GL_TEXTURE0);
+        DrawStats::BindTexture();
+        glBindTexture(GL_TEXTURE_2D, ctx.Texture(src));
+        m_Adapt->setUniform1i("u_AverageLum", 0);
+        glActiveTexture(GL_TEXTURE1);
+        DrawStats::BindTexture();
+        glBindTexture(GL_TEXTURE_2D, ctx.Texture(previous));
+        m_Adapt->setUniform1i("u_Previous", 1);
+        glActiveTexture(GL_TEXTURE0);
+        m_Adapt->setUniform4f("u_Adapt", m_Settings.speedUp, m_Settings.speedDown, dt, reset ? 1.0f : 0.0f);
+        Draw();
+
+        IssueReadback();
+    })
+        .Read(src)
+        .Read(previous)
+        .WriteColor(adapted, RenderGraph::LoadOp::DontCare);
+
+    return adapted;
+}
+
+void AutoExposure::IssueReadback()
+{
+    // 先收已经完成的（超时 0，不等待），取最新的一个
+    std::uint64_t newest = 0;
+    for (int i = 0; i < kReadbackRing; ++i)
+    {
+        if (!m_Fences[i]) continue;
+        GLenum status = glClientWaitSync((GLsync)m_Fences[i], 0, 0);
+        if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) continue;
+
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, m_Pbos[i]);
+        const float* value = (const float*)glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, sizeof(float), GL_MAP_READ_BIT);
+        if (value && m_IssuedFrame[i] > newest)
+        {
+            newest = m_IssuedFrame[i];
+            m_ReadbackValue = *value;
+            m_ReadbackLatency = (int)(m_LastAdaptFrame - m_IssuedFrame[i]);
+            m_HasReadback = true;
+        }
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        glDeleteSync((GLsync)m_Fences[i]);
+        m_Fences[i] = nullptr;
+    }
+
+    // 当前槽位还没读回就跳过这一帧的读回，绝不阻塞
+    const int slot = (int)(m_LastAdaptFrame % kReadbackRing);
+    if (!m_Fences[slot])
+    {
+        // 当前绑定的是 Adapt 的 FBO，COLOR_ATTACHMENT0 就是刚写的 1x1 结果
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, m_Pbos[slot]);
+        glReadPixels(0, 0, 1, 1, GL_RED, GL_FLOAT, nullptr);
+        m_Fences[slot] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        m_IssuedFrame[slot] = m_LastAdaptFrame;
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+}
+
+bool AutoExposure::GetReadback(float& logLuminance, int& latencyFrames) const
+{
+    if (!m_HasReadback) return false;
+    logLuminance = m_ReadbackValue;
+    latencyFrames = m_ReadbackLatency;
+    return true;
+}
@@ -0,0 +1,75 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "RenderGraph.h"
+
+class Shader;
+
+struct AutoExposureSettings
+{
+    float minLogLum = -10.0f;   // 参与平均的 log2 亮度范围
+    float maxLogLum = 10.0f;
+    float speedUp = 3.0f;       // 场景变亮时的适应速度（1/秒）
+    float speedDown = 1.0f;     // 场景变暗时
+};
+
+// AutoExposure：log 亮度归约 + 时间适应，全程留在 GPU
+// - "Luminance"：场景颜色 -> 1/4 分辨率的 log2 亮度（R16F）
+// - "Luminance Reduce n"：每级再缩小 4 倍，直到 1x1，得到平均 log2 亮度
+// - "Exposure Adapt"：和上一帧的结果按指数衰减混合，写进 1x1 R32F（两张纹理乒乓）
+// post.frag 直接 texelFetch 这张 1x1 纹理算曝光，CPU 不需要知道结果。
+// 界面要显示的数值走 PBO 环：每帧 glReadPixels 进一个 PBO 加 fence，几帧后 fence 到了才 map，从不等待
+class AutoExposure
+{
+public:
+    static constexpr int kReadbackRing = 3;
+
+    AutoExposure();
+    ~AutoExposure();
+
+    AutoExposure(const AutoExposure&) = delete;
+    AutoExposure& operator=(const AutoExposure&) = delete;
+
+    bool Init(const std::string& vertexPath, const std::string& luminancePath, const std::string& adaptPath);
+    void Shutdown();
+
+    // 声明归约和适应的 pass，返回 1x1 的适应后 log2 亮度；没有 pass 读它时整条链被剔除，
+    // 之后再用到时直接跳到当前亮度（不从很久以前的值慢慢适应过来）
+    // sourceUvScale：source 里有效内容的比例（动态分辨率），归约链的尺寸始终按 width/height 算
+    RenderGraph::ResourceId AddToGraph(RenderGraph& graph, RenderGraph::ResourceId source,
+                                       int width, int height, float dt,
+                                       const glm::vec2& sourceUvScale = glm::vec2(1.0f));
+
+    AutoExposureSettings& Settings() { return m_Settings; }
+    const AutoExposureSettings& Settings() const { return m_Settings; }
+
+    // PBO 读回的适应后 log2 亮度（几帧前的值，只给界面用）；还没有读回时返回 false
+    bool GetReadback(float& logLuminance, int& latencyFrames) const;
+    int ReductionLevels() const { return m_Levels; }
+
+private:
+    void Draw();
+    void IssueReadback();
+
+    AutoExposureSettings m_Settings;
+    std::unique_ptr<Shader> m_Luminance;    // 第一级（LUMINANCE_FIRST）
+    std::unique_ptr<Shader> m_Reduce;
+    std::unique_ptr<Shader> m_Adapt;
+    std::uint32_t m_Vao = 0;
+
+    std::uint32_t m_Adapted[2] = {};        // 1x1 R32F，乒乓
+    int m_Current = 0;
+    std::uint64_t m_Frame = 0;              // AddToGraph 次数
+    std::uint64_t m_LastAdaptFrame = 0;     // 上一次真正执行 Adapt 的帧
+    int m_Levels = 0;
+
+    // 读回环：m_Fences 存的是 GLsync（头文件里不引 glad）
+    std::uint32_t m_Pbos[kReadbackRing] = {};
+    void* m_Fences[kReadbackRing] = {};
+    std::uint64_t m_IssuedFrame[kReadbackRing] = {};
+    bool m_HasReadback = false;
+    float m_ReadbackValue = 0.0f;
+    int m_ReadbackLatency = 0;
+};
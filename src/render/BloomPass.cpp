@@ -0,0 +1,135 @@
+#include "BloomPass.h"
+
+#include "../Shader.h"
+#include "DrawStats.h"
+
+#include <glad/glad.h>
+
+#include <cstdio>
+
+// Shader 在头文件里只有前置声明，构造/析构放这里
+BloomPass::BloomPass() = default;
+BloomPass::~BloomPass() = default;
+
+bool BloomPass::Init(const std::string& vertexPath, const std::string& downPath, const std::string& upPath)
+{
+    m_Prefilter.reset(new Shader(vertexPath, downPath, "#define BLOOM_PREFILTER\n"));
+    m_Down.reset(new Shader(vertexPath, downPath));
+    m_Up.reset(new Shader(vertexPath, upPath));
+    if (!m_Vao) {
+        glGenVertexArrays(1, &m_Vao);
+    }
+
+    if (!m_Prefilter->GetRendererID() || !m_Down->GetRendererID() || !m_Up->GetRendererID())
+    {
+        std::printf("[BloomPass] Failed to compile bloom shaders\n");
+        return false;
+    }
+    return true;
+}
+
+void BloomPass::Shutdown()
+{
+    if (m_Vao) {
+        glDeleteVertexArrays(1, &m_Vao);
+        m_Vao = 0;
+    }
+    m_Prefilter.reset();
+    m_Down.reset();
+    m_Up.reset();
+}
+
+void BloomPass::Draw()
+{
+    DrawStats::BindVertexArray();
+    glBindVertexArray(m_Vao);
+    DrawStats::DrawArrays(GL_TRIANGLES, 0, 3);
+    glBindVertexArray(0);
+}
+
+RenderGraph::ResourceId BloomPass::AddToGraph(RenderGraph& graph, RenderGraph::ResourceId source,
+                                              int width, int height, const glm::vec2& sourceUvScale)
+{
+    m_Levels = 0;
+    if (!m_Down || !m_Down->GetRendererID()) return RenderGraph::kInvalidResource;
+
+    // 级数受设置和分辨率限制：最小一级至少 2x2
+    int iterations = m_Settings.iterations;
+    if (iterations < 1) iterations = 1;
+    if (iterations > kMaxIterations) iterations = kMaxIterations;
+
+    RenderGraph::ResourceId levels[kMaxIterations];
+    int sizes[kMaxIterations][2];
+    int w = width, h = height;
+    for (int i = 0; i < iterations; ++i)
+    {
+        w /= 2;
+        h /= 2;
+        if (w < 2 || h < 2) break;
+        sizes[i][0] = w;
+        sizes[i][1] = h;
+        char name[32];
+        std::snprintf(name, sizeof(name), "Bloom %d", i);
+        levels[i] = graph.CreateTexture(name, { w, h, kFormat, 0 });
+        ++m_Levels;
+    }
+    if (m_Levels == 0) return RenderGraph::kInvalidResource;
+
+    // ---- 降采样：source -> 0 -> 1 -> ... ----
+    for (int i = 0; i < m_Levels; ++i)
+    {
+        RenderGraph::ResourceId src = (i == 0) ? source : levels[i - 1];
+        int srcW = (i == 0) ? width : sizes[i - 1][0];
+        int srcH = (i == 0) ? height : sizes[i - 1][1];
+        Shader* shader = (i == 0) ? m_Prefilter.get() : m_Down.get();
+
+        char name[32];
+        std::snprintf(name, sizeof(name), "Bloom Down %d", i);
+        graph.AddPass(name, [this, shader, src, srcW, srcH, sourceUvScale](const RenderGraph::PassContext& ctx) {
+            glDisable(GL_DEPTH_TEST);
+            glDisable(GL_BLEND);
+            shader->Bind();
+            glActiveTexture(GL_TEXTURE0);
+            DrawStats::BindTexture();
+            glBindTexture(GL_TEXTURE_2D, ctx.Texture(src));
+            shader->setUniform1i("u_Source", 0);
+            shader->setUniform2f("u_SourceTexel", 1.0f / (float)srcW, 1.0f / (float)srcH);
+            if (shader == m_Prefilter.get())
+            {
+                shader->setUniform4f("u_Threshold", m_Settings.threshold, m_Settings.knee, 0.0f, 0.0f);
+                shader->setUniform2f("u_SourceUvScale", sourceUvScale.x, sourceUvScale.y);
+            }
+            Draw();
+        })
+            .Read(src)
+            .WriteColor(levels[i], RenderGraph::LoadOp::DontCare);
+    }
+
+    // ---- 升采样：最小一级往上，加法混合叠到上一级的降采样结果上 ----
+    for (int i = m_Levels - 2; i >= 0; --i)
+    {
+        RenderGraph::ResourceId src = levels[i + 1];
+        int srcW = sizes[i + 1][0];
+        int srcH = sizes[i + 1][1];
+
+        char name[32];
+        std::snprintf(name, sizeof(name), "Bloom Up %d", i);
+        graph.AddPass(name, [this, src, srcW, srcH](const RenderGraph::PassContext& ctx) {
+            glDisable(GL_DEPTH_TEST);
+            glEnable(GL_BLEND);
+            glBlendFunc(GL_ONE, GL_ONE);
+            m_Up->Bind();
+            glActiveTexture(GL_TEXTURE0);
+            DrawStats::BindTexture();
+            glBindTexture(GL_TEXTURE_2D, ctx.Texture(src));
+            m_Up->setUniform1i("u_Source", 0);
+            m_Up->setUniform2f("u_SourceTexel", 1.0f / (float)srcW, 1.0f / (float)srcH);
+            Draw();
+            glDisable(GL_BLEND);
+        })
+            .Read(src)
+            .WriteColor(levels[i], RenderGraph::LoadOp::Load);
+    }
+
+    return levels[0];
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "RenderGraph.h"
+
+class Shader;
+
+struct BloomSettings
+{
+    int iterations = 5;         // 降采样级数：1 = 1/2 分辨率 ... 6 = 1/64
+    float threshold = 1.0f;     // 亮度（max(r,g,b)）超过它才进 bloom
+    float knee = 0.5f;          // 阈值附近的软过渡宽度
+};
+
+// BloomPass：dual-Kawase 金字塔
+// - 降采样每级 5 次 fetch，升采样每级 8 次 fetch，第一级降采样顺带做阈值
+// - 升采样用加法混合叠回上一级，不额外分配纹理；金字塔用 R11G11B10F，带宽是 RGB16F 的 2/3
+// - 每级是渲染图里的一个 pass（"Bloom Down n" / "Bloom Up n"），每级的 GPU 时间直接看图的计时
+// - 结果在 1/2 分辨率那一级；没有 pass 读它时整条金字塔都会被图剔除
+class BloomPass
+{
+public:
+    static constexpr int kMaxIterations = 6;
+    static constexpr std::uint32_t kFormat = 0x8C3A;    // GL_R11F_G11F_B10F
+
+    BloomPass();
+    ~BloomPass();
+
+    BloomPass(const BloomPass&) = delete;
+    BloomPass& operator=(const BloomPass&) = delete;
+
+    bool Init(const std::string& vertexPath, const std::string& downPath, const std::string& upPath);
+    void Shutdown();
+
+    // 在 graph 里声明整条金字塔，返回 bloom 结果（source 的 1/2 分辨率）；尺寸太小时返回 kInvalidResource
+    // sourceUvScale：source 里有效内容的比例（动态分辨率）；金字塔尺寸始终按 width/height 算，比例变了不重新分配
+    RenderGraph::ResourceId AddToGraph(RenderGraph& graph, RenderGraph::ResourceId source, int width, int height,
+                                       const glm::vec2& sourceUvScale = glm::vec2(1.0f));
+
+    BloomSettings& Settings() { return m_Settings; }
+    const BloomSettings& Settings() const { return m_Settings; }
+    // 上一次 AddToGraph 实际用的级数（受分辨率限制可能比设置的少）
+    int LevelCount() const { return m_Levels; }
+
+private:
+    void Draw();
+
+    BloomSettings m_Settings;
+    std::unique_ptr<Shader> m_Prefilter;    // 第一级：降采样 + 阈值
+    std::unique_ptr<Shader> m_Down;
+    std::unique_ptr<Shader> m_Up;
+    std::uint32_t m_Vao = 0;
+    int m_Levels = 0;
+};
@@ -0,0 +1,250 @@
+#include "ColorLut.h"
+
+#include "../HalfFloat.h"
+#include "../ThreadPool.h"
+#include "GpuMemory.h"
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+
+namespace
+{
+    // ---- 以下和 post.frag 的同名函数一一对应 ----
+    glm::vec3 Pow3(const glm::vec3& c, float e)
+    {
+        return glm::vec3(std::pow(c.r, e), std::pow(c.g, e), std::pow(c.b, e));
+    }
+
+    glm::vec3 HableCurve(const glm::vec3& x)
+    {
+        const float A = 0.15f, B = 0.50f, C = 0.10f, D = 0.20f, E = 0.02f, F = 0.30f;
+        return ((x * (A * x + C * B) + D * E) / (x * (A * x + B) + D * F)) - E / F;
+    }
+
+    glm::vec3 Tonemap(const PostEffect& e, glm::vec3 c)
+    {
+        const float invGamma = 1.0f / (e.gamma > 0.01f ? e.gamma : 0.01f);
+        switch (e.tonemap)
+        {
+        case TonemapOperator::ACES:
+            c = glm::clamp((c * (2.51f * c + 0.03f)) / (c * (2.43f * c + 0.59f) + 0.14f), 0.0f, 1.0f);
+            break;
+        case TonemapOperator::Filmic:
+            c = glm::clamp(HableCurve(2.0f * c) / HableCurve(glm::vec3(11.2f)), 0.0f, 1.0f);
+            break;
+        default:
+            c = c / (c + glm::vec3(1.0f));
+            break;
+        }
+        return Pow3(c, invGamma);
+    }
+
+    float Luma(const glm::vec3& c)
+    {
+        return glm::dot(c, glm::vec3(0.2126f, 0.7152f, 0.0722f));
+    }
+}
+
+ColorLut::~ColorLut()
+{
+    Destroy();
+}
+
+bool ColorLut::CanBake(PostEffectType type)
+{
+    // 曝光故意留在 shader 里：只是一次乘法，而且自动曝光每帧都在变，烘进去就得每帧重烘
+    return type == PostEffectType::Tonemap || type == PostEffectType::ColorGrade ||
+           type == PostEffectType::Invert || type == PostEffectType::Grayscale;
+}
+
+glm::vec3 ColorLut::Evaluate(const std::vector<PostEffect>& effects, glm::vec3 c)
+{
+    for (const PostEffect& e : effects)
+    {
+        switch (e.type)
+        {
+        case PostEffectType::Exposure:
+            c *= std::exp2(e.exposureEV);
+            break;
+        case PostEffectType::Tonemap:
+            c = Tonemap(e, c);
+            break;
+        case PostEffectType::ColorGrade:
+        {
+            c = (c - glm::vec3(0.5f)) * e.contrast + glm::vec3(0.5f);
+            float g = Luma(c);
+            c = glm::mix(glm::vec3(g), c, e.saturation);
+            c = glm::max(c * e.colorFilter, glm::vec3(0.0f));
+            break;
+        }
+        case PostEffectType::Invert:
+            c = glm::vec3(1.0f) - c;
+            break;
+        case PostEffectType::Grayscale:
+            c = glm::vec3(Luma(c));
+            break;
+        default:
+            // bloom、暗角、抖动和像素位置有关，不在 LUT 里
+            break;
+        }
+    }
+    return c;
+}
+
+float ColorLut::ShaperEncode(float x)
+{
+    const float bias = std::exp2(kShaperMinEV);
+    float u = (std::log2(std::max(x, 0.0f) + bias) - kShaperMinEV) / (kShaperMaxEV - kShaperMinEV);
+    return std::min(std::max(u, 0.0f), 1.0f);
+}
+
+float ColorLut::ShaperDecode(float u)
+{
+    return std::exp2(kShaperMinEV + u * (kShaperMaxEV - kShaperMinEV)) - std::exp2(kShaperMinEV);
+}
+
+std::string ColorLut::MakeKey(const std::vector<PostEffect>& effects, bool hdrInput, int size)
+{
+    std::string key;
+    char buf[160];
+    std::snprintf(buf, sizeof(buf), "%d %d;", size, hdrInput ? 1 : 0);
+    key += buf;
+    for (const PostEffect& e : effects)
+    {
+        switch (e.type)
+        {
+        case PostEffectType::Tonemap:
+            std::snprintf(buf, sizeof(buf), "T%d %.9g;", (int)e.tonemap, e.gamma);
+            break;
+        case PostEffectType::ColorGrade:
+            std::snprintf(buf, sizeof(buf), "G%.9g %.9g %.9g %.9g %.9g;", e.contrast, e.saturation,
+                     e.colorFilter.r, e.colorFilter.g, e.colorFilter.b);
+            break;
+        default:
+            std::snprintf(buf, sizeof(buf), "%d;", (int)e.type);
+            break;
+        }
+        key += buf;
+    }
+    return key;
+}
+
+void ColorLut::Request(const std::vector<PostEffect>& effects, bool hdrInput, int size)
+{
+    size = std::min(std::max(size, 2), 128);
+    std::string key = MakeKey(effects, hdrInput, size);
+    if (key == m_RequestedKey) return;
+
+    m_RequestedKey = key;
+    m_RequestedEffects = effects;
+    m_RequestedHdr = hdrInput;
+    m_RequestedSize = size;
+
+    // 已经在烘的不打断，烘完后 Update 发现 key 不一致会再起一个
+    if (!m_Job && m_UploadedKey != m_RequestedKey)
+        StartJob();
+}
+
+void ColorLut::StartJob()
+{
+    m_Job = std::make_shared<Job>();
+    m_Job->key = m_RequestedKey;
+    m_Job->effects = m_RequestedEffects;
+    m_Job->hdrInput = m_RequestedHdr;
+    m_Job->size = m_RequestedSize;
+
+    std::shared_ptr<Job> job = m_Job;
+    ThreadPool::Global().Submit([job]() {
+        auto t0 = std::chrono::high_resolution_clock::now();
+        const int n = job->size;
+        job->texels.resize((std::size_t)n * n * n * 3);
+
+        // 每个轴上的输入值只算一次：texel 中心对应 u = i / (n - 1)
+        std::vector<float> axis(n);
+        for (int i = 0; i < n; ++i)
+        {
+            float u = (float)i / (float)(n - 1);
+            axis[i] = job->hdrInput ? ShaperDecode(u) : u;
+        }
+
+        ThreadPool::Global().ParallelFor(n, [&](int begin, int end) {
+            for (int z = begin; z < end; ++z)
+                for (int y = 0; y < n; ++y)
+                {
+                    std::uint16_t* dst = &job->texels[(((std::size_t)z * n + y) * n) * 3];
+                    for (int x = 0; x < n; ++x)
+                    {
+                        glm::vec3 c = Evaluate(job->effects, glm::vec3(axis[x], axis[y], axis[z]));
+                        dst[x * 3 + 0] = FloatToHalf(c.r);
+                        dst[x * 3 + 1] = FloatToHalf(c.g);
+                        dst[x * 3 + 2] = FloatToHalf(c.b);
+                    }
+                }
+        }, 1);
+
+        job->bakeMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - t0).count();
+        job->done.store(true, std::memory_order_release);
+    });
+}
+
+void ColorLut::Update()
+{
+    if (!m_Job || !m_Job->done.load(std::memory_order_acquire)) return;
+
+    std::shared_ptr<Job> job = std::move(m_Job);
+    m_Job.reset();
+
+    auto t0 = std::chrono::high_resolution_clock::now();
+    const int n = job->size;
+    if (!m_Texture || m_Size != n)
+    {
+        GpuMemory::FreeTexture(m_Texture);
+        if (m_Texture) glDeleteTextures(1, &m_Texture);
+        glGenTextures(1, &m_Texture);
+        glBindTexture(GL_TEXTURE_3D, m_Texture);
+        glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+        glTexImage3D(GL_TEXTURE_3D, 0, GL_RGB16F, n, n, n, 0, GL_RGB, GL_HALF_FLOAT, job->texels.data());
+        GpuMemory::TrackTexture(m_Texture, GpuMemory::Category::PostProcess, "Color LUT",
+                                GpuMemory::TextureBytes(GL_RGB16F, n, n, n));
+    }
+    else
+    {
+        glBindTexture(GL_TEXTURE_3D, m_Texture);
+        glTexSubImage3D(GL_TEXTURE_3D, 0, 0, 0, 0, n, n, n, GL_RGB, GL_HALF_FLOAT, job->texels.data());
+    }
+    glBindTexture(GL_TEXTURE_3D, 0);
+
+    m_UploadedKey = job->key;
+    m_Size = n;
+    m_HdrInput = job->hdrInput;
+    m_LastBakeMs = job->bakeMs;
+    m_LastUploadMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - t0).count();
+    ++m_BakeCount;
+
+    // 烘焙期间参数又变了：按最新的再烘一次
+    if (m_UploadedKey != m_RequestedKey)
+        StartJob();
+}
+
+void ColorLut::Destroy()
+{
+    // 在烘的任务只持有自己的 shared_ptr，直接丢掉即可
+    m_Job.reset();
+    if (m_Texture)
+    {
+        GpuMemory::FreeTexture(m_Texture);
+        glDeleteTextures(1, &m_Texture);
+        m_Texture = 0;
+    }
+    m_UploadedKey.clear();
+    m_RequestedKey.clear();
+    m_Size = 0;
+}
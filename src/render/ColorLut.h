@@ -0,0 +1,87 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "PostEffect.h"
+
+// ColorLut：把后处理里一段“只和输入颜色有关”的效果（tonemap、调色、反色、灰度）烘成 3D LUT
+// - 烘焙在工作线程（ThreadPool::Global 的 ParallelFor 按 z 切片），主线程只负责上传
+// - 参数不变不重烘；烘焙中参数又变了，等这次烘完再按最新参数烘一次
+// - 输入是 HDR 时先过 log shaper（覆盖 2^kShaperMinEV..2^kShaperMaxEV），LDR 输入直接用 [0,1]
+// - CPU 版本的效果函数和 post.frag 里的一一对应，改一边要同步改另一边
+// GL 调用只在主线程
+class ColorLut
+{
+public:
+    static constexpr float kShaperMinEV = -12.0f;
+    static constexpr float kShaperMaxEV = 8.0f;
+
+    ColorLut() = default;
+    ~ColorLut();
+
+    ColorLut(const ColorLut&) = delete;
+    ColorLut& operator=(const ColorLut&) = delete;
+
+    // 请求烘焙 effects（已经是启用的一段纯颜色效果）；和当前/在烘的一样就什么都不做
+    void Request(const std::vector<PostEffect>& effects, bool hdrInput, int size);
+    // 每帧在主线程调用：工作线程烘好了就上传
+    void Update();
+
+    // 上传的 LUT 是否就是最近一次 Request 的内容
+    bool IsCurrent() const { return m_Texture != 0 && m_UploadedKey == m_RequestedKey; }
+    bool IsBaking() const { return m_Job != nullptr; }
+
+    std::uint32_t GetTexture() const { return m_Texture; }
+    int Size() const { return m_Size; }
+    bool HdrInput() const { return m_HdrInput; }
+
+    // 最近一次烘焙（工作线程墙钟时间）和上传耗时
+    double LastBakeMs() const { return m_LastBakeMs; }
+    double LastUploadMs() const { return m_LastUploadMs; }
+    int BakeCount() const { return m_BakeCount; }
+    std::size_t Bytes() const { return (std::size_t)m_Size * m_Size * m_Size * 3 * sizeof(std::uint16_t); }
+
+    void Destroy();
+
+    static bool CanBake(PostEffectType type);
+    // CPU 上按顺序执行 effects，结果和 post.frag 的 ALU 路径一致
+    static glm::vec3 Evaluate(const std::vector<PostEffect>& effects, glm::vec3 c);
+    static float ShaperEncode(float x);     // HDR 值 -> [0,1]
+    static float ShaperDecode(float u);     // [0,1] -> HDR 值，ShaperDecode(0) == 0
+
+private:
+    struct Job
+    {
+        std::string key;
+        std::vector<PostEffect> effects;
+        bool hdrInput = false;
+        int size = 0;
+        std::vector<std::uint16_t> texels;  // RGB half，x 变化最快
+        double bakeMs = 0.0;
+        std::atomic<bool> done{false};
+    };
+
+    static std::string MakeKey(const std::vector<PostEffect>& effects, bool hdrInput, int size);
+    void StartJob();
+
+    std::string m_RequestedKey;
+    std::vector<PostEffect> m_RequestedEffects;
+    bool m_RequestedHdr = false;
+    int m_RequestedSize = 0;
+
+    std::shared_ptr<Job> m_Job;             // 在烘的（工作线程只持有 shared_ptr，丢弃也安全）
+
+    std::uint32_t m_Texture = 0;
+    std::string m_UploadedKey;
+    int m_Size = 0;
+    bool m_HdrInput = false;
+
+    double m_LastBakeMs = 0.0;
+    double m_LastUploadMs = 0.0;
+    int m_BakeCount = 0;
+};
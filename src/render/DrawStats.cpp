@@ -0,0 +1,86 @@
+#include "DrawStats.h"
+
+#include <glad/glad.h>
+
+namespace
+{
+    // 历史环：第 i 帧写在 i % kHistory
+    DrawStats::Counters s_History[DrawStats::kHistory] = {};
+    int s_HistoryCount = 0;
+    int s_HistoryNext = 0;
+    bool s_FirstFrame = true;
+
+    std::int64_t TriangleCount(std::uint32_t mode, std::int64_t vertices)
+    {
+        switch (mode)
+        {
+        case GL_TRIANGLES:      return vertices / 3;
+        case GL_TRIANGLE_STRIP:
+        case GL_TRIANGLE_FAN:   return vertices > 2 ? vertices - 2 : 0;
+        default:                return 0;
+        }
+    }
+}
+
+void DrawStats::DrawArrays(std::uint32_t mode, int first, int count)
+{
+    Draw(count, TriangleCount(mode, count));
+    glDrawArrays(mode, first, count);
+}
+
+void DrawStats::DrawElements(std::uint32_t mode, int indexCount, int instanceCount)
+{
+    Draw((std::int64_t)indexCount * instanceCount, TriangleCount(mode, indexCount) * instanceCount);
+    if (instanceCount > 1)
+        glDrawElementsInstanced(mode, indexCount, GL_UNSIGNED_INT, nullptr, instanceCount);
+    else
+        glDrawElements(mode, indexCount, GL_UNSIGNED_INT, nullptr);
+}
+
+void DrawStats::BeginFrame()
+{
+    // 第一次调用之前没有完整的一帧（只有启动时的加载和烘焙），不进历史
+    if (!s_FirstFrame)
+    {
+        s_Last = s_Current;
+        s_History[s_HistoryNext] = s_Current;
+        s_HistoryNext = (s_HistoryNext + 1) % kHistory;
+        if (s_HistoryCount < kHistory) ++s_HistoryCount;
+    }
+    s_FirstFrame = false;
+
+    s_Current.fill(0);
+    s_ProgramKnown = false;
+    s_FramebufferKnown = false;
+}
+
+std::array<double, DrawStats::kCounterCount> DrawStats::Average()
+{
+    std::array<double, kCounterCount> avg{};
+    if (s_HistoryCount == 0) return avg;
+    for (int i = 0; i < s_HistoryCount; ++i)
+        for (int c = 0; c < kCounterCount; ++c)
+            avg[c] += (double)s_History[i][c];
+    for (double& v : avg) v /= (double)s_HistoryCount;
+    return avg;
+}
+
+const char* DrawStats::Name(Counter counter)
+{
+    switch (counter)
+    {
+    case DrawCalls:             return "drawCalls";
+    case Vertices:              return "vertices";
+    case Triangles:             return "triangles";
+    case ProgramSwitches:       return "programSwitches";
+    case RedundantProgramBinds: return "redundantProgramBinds";
+    case TextureBinds:          return "textureBinds";
+    case VaoBinds:              return "vaoBinds";
+    case FboSwitches:           return "fboSwitches";
+    case RedundantFboBinds:     return "redundantFboBinds";
+    case UniformCalls:          return "uniformCalls";
+    case BufferUploads:         return "bufferUploads";
+    case BufferBytes:           return "bufferBytes";
+    default:                    return "unknown";
+    }
+}
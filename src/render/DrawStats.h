@@ -0,0 +1,98 @@
+#pragma once
+#include <array>
+#include <cstdint>
+
+// DrawStats：每帧的 draw / 状态切换计数，用来看 CPU 一侧的驱动开销花在哪
+// - 计数点放在包 GL 调用的地方（Mesh、Shader、Texture2D、Framebuffer、Renderer、渲染图和全屏 pass），
+//   直接调 GL 又没有计数的地方（ImGui 后端、一次性的资源创建）不算
+// - program / FBO 记住当前绑定，真正切换和重复绑定分开计；BeginFrame 时忘掉记住的绑定，
+//   因为 ImGui 后端会在我们看不到的地方改掉它们
+// - draw 统一走 DrawArrays / DrawElements：发 draw 的同时计数；VAO 的绑定 / 解绑仍由调用点自己做，
+//   统计层不额外增加 GL 调用
+// - 其余计数函数都是内联的几次加法，一直开着；只在 GL 线程（主线程）调用，不加锁
+class DrawStats
+{
+public:
+    enum Counter
+    {
+        DrawCalls,
+        Vertices,               // 提交的顶点（有索引时是索引数），instancing 乘实例数
+        Triangles,
+        ProgramSwitches,
+        RedundantProgramBinds,  // 绑定的就是当前 program
+        TextureBinds,
+        VaoBinds,               // 不含解绑（绑 0）
+        FboSwitches,
+        RedundantFboBinds,
+        UniformCalls,           // 真正发出去的 glUniform*（找不到位置的不算）
+        BufferUploads,
+        BufferBytes,
+        kCounterCount
+    };
+    using Counters = std::array<std::int64_t, kCounterCount>;
+
+    static constexpr int kHistory = 120;
+
+    // 每帧开头：当前帧的计数成为 LastFrame，进历史
+    static void BeginFrame();
+
+    // 上一帧的完整计数；CurrentFrame 是这一帧到目前为止的
+    static const Counters& LastFrame() { return s_Last; }
+    static const Counters& CurrentFrame() { return s_Current; }
+    // 最近 kHistory 帧（不足时按已有的帧）的平均
+    static std::array<double, kCounterCount> Average();
+
+    // JSON 里用的名字（camelCase）
+    static const char* Name(Counter counter);
+
+    // vertices / triangles 是这次 draw 的总数（instancing 已经乘上实例数）
+    static void Draw(std::int64_t vertices, std::int64_t triangles)
+    {
+        ++s_Current[DrawCalls];
+        s_Current[Vertices] += vertices;
+        s_Current[Triangles] += triangles;
+    }
+    static void UseProgram(std::uint32_t program)
+    {
+        if (program == s_Program && s_ProgramKnown)
+        {
+            ++s_Current[RedundantProgramBinds];
+            return;
+        }
+        ++s_Current[ProgramSwitches];
+        s_Program = program;
+        s_ProgramKnown = true;
+    }
+    static void BindFramebuffer(std::uint32_t fbo)
+    {
+        if (fbo == s_Framebuffer && s_FramebufferKnown)
+        {
+            ++s_Current[RedundantFboBinds];
+            return;
+        }
+        ++s_Current[FboSwitches];
+        s_Framebuffer = fbo;
+        s_FramebufferKnown = true;
+    }
+    // 在当前绑定的 VAO 上画，计一次 draw；三角形数按 mode 从顶点数算
+    static void DrawArrays(std::uint32_t mode, int first, int count);
+    // 索引是 GL_UNSIGNED_INT，instanceCount > 1 时走 glDrawElementsInstanced
+    static void DrawElements(std::uint32_t mode, int indexCount, int instanceCount = 1);
+
+    static void BindTexture() { ++s_Current[TextureBinds]; }
+    static void BindVertexArray() { ++s_Current[VaoBinds]; }
+    static void Uniform() { ++s_Current[UniformCalls]; }
+    static void Upload(std::int64_t bytes)
+    {
+        ++s_Current[BufferUploads];
+        s_Current[BufferBytes] += bytes;
+    }
+
+private:
+    inline static Counters s_Current{};
+    inline static Counters s_Last{};
+    inline static std::uint32_t s_Program = 0;
+    inline static std::uint32_t s_Framebuffer = 0;
+    inline static bool s_ProgramKnown = false;
+    inline static bool s_FramebufferKnown = false;
+};
@@ -0,0 +1,52 @@
+#include "DynamicResolution.h"
+
+#include <algorithm>
+#include <cmath>
+
+void DynamicResolution::Update(double gpuFrameMs, int maxWidth, int maxHeight)
+{
+    const float minScale = std::min(std::max(m_Settings.minScale, 0.1f), 1.0f);
+    const float maxScale = std::min(std::max(m_Settings.maxScale, minScale), 1.0f);
+
+    if (!m_Settings.enabled)
+    {
+        m_Scale = std::min(std::max(m_Settings.manualScale, 0.1f), 1.0f);
+        m_Cooldown = kSettleFrames;
+        m_Samples = 0;
+    }
+    else if (m_Cooldown > 0)
+    {
+        // 读回来的还是旧比例的时间，不用
+        --m_Cooldown;
+        m_Samples = 0;
+    }
+    else if (gpuFrameMs > 0.0)
+    {
+        m_SmoothedMs = (m_Samples == 0) ? gpuFrameMs : m_SmoothedMs + (gpuFrameMs - m_SmoothedMs) * 0.25;
+        ++m_Samples;
+
+        // 攒几帧再判断，单帧的尖峰不触发
+        if (m_Samples >= 3 && m_Settings.targetMs > 0.0f)
+        {
+            float desired = m_Scale * (float)std::sqrt(m_Settings.targetMs / std::max(m_SmoothedMs, 0.01));
+            desired = std::min(std::max(desired, m_Scale - kMaxStep), m_Scale + kMaxStep);
+            desired = std::min(std::max(desired, minScale), maxScale);
+            if (std::fabs(desired - m_Scale) > kDeadband)
+            {
+                m_Scale = desired;
+                m_Cooldown = kSettleFrames;
+                m_Samples = 0;
+                ++m_Changes;
+            }
+        }
+    }
+    if (m_Settings.enabled)
+        m_Scale = std::min(std::max(m_Scale, minScale), maxScale);
+
+    m_RenderWidth = std::max(1, (int)std::lround(maxWidth * m_Scale));
+    m_RenderHeight = std::max(1, (int)std::lround(maxHeight * m_Scale));
+    m_RenderWidth = std::min(m_RenderWidth, std::max(maxWidth, 1));
+    m_RenderHeight = std::min(m_RenderHeight, std::max(maxHeight, 1));
+    m_UvScale = glm::vec2(maxWidth > 0 ? (float)m_RenderWidth / (float)maxWidth : 1.0f,
+                          maxHeight > 0 ? (float)m_RenderHeight / (float)maxHeight : 1.0f);
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include <glm/glm.hpp>
+
+struct DynamicResolutionSettings
+{
+    bool enabled = true;
+    float targetMs = 16.6f;     // 想要守住的 GPU 帧时间
+    float minScale = 0.5f;      // 每个轴的缩放范围
+    float maxScale = 1.0f;
+    float manualScale = 1.0f;   // 关掉自动时用的固定比例
+};
+
+// DynamicResolution：按 GPU 帧时间选场景的渲染比例
+// - 场景目标始终按窗口大小分配，场景只画在左下角 (RenderWidth x RenderHeight) 的视口里，改比例不重新分配
+// - 读场景的 pass 用 UvScale() 把 [0,1] 映射到有效区域，PostProcessPass 负责放大回窗口
+// - GPU 时间来自渲染图的计时查询（几帧前的结果）：改一次比例后等 kSettleFrames 帧，
+//   新比例的时间读回来了再决定下一步，避免按旧比例的时间来回振荡
+// - 模型：GPU 时间近似和像素数（比例的平方）成正比；全分辨率的部分（后处理、UI）不缩放，
+//   按这个模型会稍微调过头，多调几次就收敛
+class DynamicResolution
+{
+public:
+    static constexpr int kSettleFrames = 6;
+    static constexpr float kMaxStep = 0.1f;     // 每次最多改这么多
+    static constexpr float kDeadband = 0.02f;   // 比这小的调整忽略（时间本身有抖动）
+
+    // 每帧开头调用：gpuFrameMs 是最近读回的整帧 GPU 时间（还没有时传 0）
+    void Update(double gpuFrameMs, int maxWidth, int maxHeight);
+
+    float Scale() const { return m_Scale; }
+    int RenderWidth() const { return m_RenderWidth; }
+    int RenderHeight() const { return m_RenderHeight; }
+    // 有效区域占目标纹理的比例（取整之后的实际值）
+    glm::vec2 UvScale() const { return m_UvScale; }
+
+    // 平滑后的 GPU 帧时间和离目标还剩多少（负数表示超了）
+    double GpuMs() const { return m_SmoothedMs; }
+    double HeadroomMs() const { return m_Settings.targetMs - m_SmoothedMs; }
+    int ChangeCount() const { return m_Changes; }
+
+    DynamicResolutionSettings& Settings() { return m_Settings; }
+    const DynamicResolutionSettings& Settings() const { return m_Settings; }
+
+private:
+    DynamicResolutionSettings m_Settings;
+    float m_Scale = 1.0f;
+    int m_RenderWidth = 0;
+    int m_RenderHeight = 0;
+    glm::vec2 m_UvScale{1.0f, 1.0f};
+    double m_SmoothedMs = 0.0;
+    int m_Samples = 0;          // 当前比例下攒了几个样本
+    int m_Cooldown = 0;
+    int m_Changes = 0;
+};
@@ -0,0 +1,555 @@
+#include "FrameCapture.h"
+
+#include "../Material.h"
+#include "../MappedFile.h"
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <type_traits>
+
+static const char          kMagic[8] = { 'R', 'S', 'F', 'R', 'A', 'M', 'E', 'C' };
+// 格式有任何变化都要改这个版本号（旧文件直接拒绝）
+static const std::uint32_t kFormatVersion = 2;
+
+// 文件布局：FileHeader，之后各表依次是 u32 个数 + 元素
+// 字符串是 u32 长度 + 字节；结构按字段逐个写，不依赖编译器的填充
+struct FileHeader
+{
+    char          magic[8];
+    std::uint32_t version;
+    std::uint32_t reserved;
+};
+
+namespace
+{
+    class Writer
+    {
+    public:
+        template <class T>
+        void Put(const T& value)
+        {
+            static_assert(std::is_trivially_copyable<T>::value, "POD only");
+            const std::uint8_t* p = reinterpret_cast<const std::uint8_t*>(&value);
+            m_Bytes.insert(m_Bytes.end(), p, p + sizeof(T));
+        }
+        void PutString(const std::string& s)
+        {
+            Put((std::uint32_t)s.size());
+            m_Bytes.insert(m_Bytes.end(), s.begin(), s.end());
+        }
+        void PutBool(bool b) { Put((std::uint8_t)(b ? 1 : 0)); }
+        void PutCount(std::size_t n) { Put((std::uint32_t)n); }
+
+        const std::vector<std::uint8_t>& Bytes() const { return m_Bytes; }
+
+    private:
+        std::vector<std::uint8_t> m_Bytes;
+    };
+
+    // 越界后 ok 变成 false，之后读到的都是默认值，最后统一检查
+    class Reader
+    {
+    public:
+        Reader(const std::uint8_t* data, std::size_t size) : m_P(data), m_End(data + size) {}
+
+        template <class T>
+        void Get(T& value)
+        {
+            static_assert(std::is_trivially_copyable<T>::value, "POD only");
+            if (!m_Ok || (std::size_t)(m_End - m_P) < sizeof(T)) { m_Ok = false; value = T{}; return; }
+            std::memcpy(&value, m_P, sizeof(T));
+            m_P += sizeof(T);
+        }
+        void GetString(std::string& s)
+        {
+            std::uint32_t n = 0;
+            Get(n);
+            if (!m_Ok || (std::size_t)(m_End - m_P) < n) { m_Ok = false; s.clear(); return; }
+            s.assign(reinterpret_cast<const char*>(m_P), n);
+            m_P += n;
+        }
+        void GetBool(bool& b)
+        {
+            std::uint8_t v = 0;
+            Get(v);
+            b = v != 0;
+        }
+        // 每个元素至少 minBytes 字节：个数大过剩余字节的文件直接判坏，不会先 resize 出一个巨大的数组
+        std::size_t GetCount(std::size_t minBytes)
+        {
+            std::uint32_t n = 0;
+            Get(n);
+            if (m_Ok && (std::size_t)n * minBytes > (std::size_t)(m_End - m_P)) m_Ok = false;
+            return m_Ok ? n : 0;
+        }
+
+        bool Ok() const { return m_Ok; }
+        bool AtEnd() const { return m_P == m_End; }
+
+    private:
+        const std::uint8_t* m_P;
+        const std::uint8_t* m_End;
+        bool m_Ok = true;
+    };
+
+    bool InRange(std::int32_t index, std::size_t size)
+    {
+        return index >= -1 && index < (std::int32_t)size;
+    }
+}
+
+// ---------------- 资源登记 ----------------
+
+void FrameCapture::RegisterShader(const Shader* shader, const std::string& vertexPath,
+                                  const std::string& fragmentPath, const std::string& defines)
+{
+    if (!shader || m_ShaderIndex.count(shader)) return;
+    m_ShaderIndex[shader] = (std::int32_t)m_Shaders.size();
+    m_Shaders.push_back(ShaderDesc{ vertexPath, fragmentPath, defines });
+}
+
+void FrameCapture::RegisterModel(const Model* model, const std::string& path)
+{
+    if (!model || m_ModelIndex.count(model)) return;
+    m_ModelIndex[model] = (std::int32_t)m_Models.size();
+    m_Models.push_back(path);
+}
+
+void FrameCapture::RegisterTexture(const Texture2D* texture, const std::string& path, bool srgb)
+{
+    if (!texture || m_TextureIndex.count(texture)) return;
+    m_TextureIndex[texture] = (std::int32_t)m_Textures.size();
+    m_Textures.push_back(TextureDesc{ path, srgb, false });
+}
+
+void FrameCapture::RegisterTextureLayer(std::uint32_t texture, int layer, const std::string& path, bool srgb)
+{
+    if (!texture || layer < 0) return;
+    std::uint64_t key = ((std::uint64_t)texture << 32) | (std::uint32_t)layer;
+    if (m_LayerIndex.count(key)) return;
+    m_LayerIndex[key] = (std::int32_t)m_Textures.size();
+    m_Textures.push_back(TextureDesc{ path, srgb, true });
+}
+
+// ---------------- 录制 ----------------
+
+void FrameCapture::ClearFrame()
+{
+    m_Commands.clear();
+    m_Materials.clear();
+    m_MaterialIndex.clear();
+    m_Passes.clear();
+    m_Cameras.clear();
+    m_LightSets.clear();
+    m_Environments.clear();
+    m_Draws.clear();
+    m_Instances.clear();
+}
+
+void FrameCapture::Begin()
+{
+    ClearFrame();
+    m_Recording = true;
+}
+
+void FrameCapture::Push(Op op, std::size_t index)
+{
+    m_Commands.push_back(Command{ op, (std::uint32_t)index });
+}
+
+std::int32_t FrameCapture::MaterialIndex(const Material* material)
+{
+    if (!material) return -1;
+    auto it = m_MaterialIndex.find(material);
+    if (it != m_MaterialIndex.end()) return it->second;
+
+    MaterialDesc desc;
+    auto shader = m_ShaderIndex.find(material->shader);
+    desc.shader = shader != m_ShaderIndex.end() ? shader->second : -1;
+    auto albedo = m_TextureIndex.find(material->albedo);
+    desc.albedo = albedo != m_TextureIndex.end() ? albedo->second : -1;
+    if (material->albedoArray && material->albedoLayer >= 0)
+    {
+        auto layer = m_LayerIndex.find(((std::uint64_t)material->albedoArray << 32) | (std::uint32_t)material->albedoLayer);
+        desc.albedoLayer = layer != m_LayerIndex.end() ? layer->second : -1;
+    }
+    desc.color = material->color;
+    desc.shininess = material->shininess;
+    desc.ambientStrength = material->ambientStrength;
+    desc.metallic = material->metallic;
+    desc.roughness = material->roughness;
+    desc.ao = material->ao;
+
+    std::int32_t index = (std::int32_t)m_Materials.size();
+    m_Materials.push_back(desc);
+    m_MaterialIndex[material] = index;
+    return index;
+}
+
+void FrameCapture::BeginPass(const std::string& name, int width, int height, bool clear,
+                             const glm::vec4& clearColor, bool depthTest, bool cullFace)
+{
+    if (!m_Recording) return;
+    Push(Op::BeginPass, m_Passes.size());
+    m_Passes.push_back(PassDesc{ name, width, height, clear, clearColor, depthTest, cullFace });
+}
+
+void FrameCapture::EndPass()
+{
+    if (!m_Recording) return;
+    Push(Op::EndPass, 0);
+}
+
+void FrameCapture::SetCamera(const glm::mat4& view, const glm::mat4& proj, const glm::vec3& viewPos)
+{
+    if (!m_Recording) return;
+    Push(Op::SetCamera, m_Cameras.size());
+    m_Cameras.push_back(CameraDesc{ view, proj, viewPos });
+}
+
+void FrameCapture::BindShader(const Shader* shader)
+{
+    if (!m_Recording) return;
+    auto it = m_ShaderIndex.find(shader);
+    if (it == m_ShaderIndex.end()) return;
+    Push(Op::BindShader, (std::size_t)it->second);
+}
+
+void FrameCapture::BindMaterial(const Material* material)
+{
+    if (!m_Recording || !material) return;
+    Push(Op::BindMaterial, (std::size_t)MaterialIndex(material));
+}
+
+void FrameCapture::SetLights(const std::vector<PointLight>& lights)
+{
+    if (!m_Recording) return;
+    Push(Op::SetLights, m_LightSets.size());
+    m_LightSets.push_back(lights);
+}
+
+void FrameCapture::SetEnvironment(const std::string& hdrPath, bool useSH, bool useSpecular, bool bindTextures)
+{
+    if (!m_Recording) return;
+    Push(Op::SetEnvironment, m_Environments.size());
+    m_Environments.push_back(EnvironmentDesc{ hdrPath, useSH, useSpecular, bindTextures });
+}
+
+void FrameCapture::DrawModel(const Model* model, const glm::mat4& matrix)
+{
+    if (!m_Recording) return;
+    auto it = m_ModelIndex.find(model);
+    Push(Op::DrawModel, m_Draws.size());
+    m_Draws.push_back(DrawDesc{ it != m_ModelIndex.end() ? it->second : -1, matrix });
+}
+
+void FrameCapture::SubmitInstanced(const Model* model, const Material* material, const glm::mat4& matrix)
+{
+    if (!m_Recording) return;
+    auto it = m_ModelIndex.find(model);
+    Push(Op::SubmitInstanced, m_Instances.size());
+    m_Instances.push_back(InstanceDesc{ it != m_ModelIndex.end() ? it->second : -1, MaterialIndex(material), matrix });
+}
+
+void FrameCapture::FlushInstanced(const Shader* instancedShader)
+{
+    if (!m_Recording) return;
+    auto it = m_ShaderIndex.find(instancedShader);
+    if (it == m_ShaderIndex.end()) return;
+    Push(Op::FlushInstanced, (std::size_t)it->second);
+}
+
+void FrameCapture::DrawSkybox(const Shader* skyboxShader)
+{
+    if (!m_Recording) return;
+    auto it = m_ShaderIndex.find(skyboxShader);
+    if (it == m_ShaderIndex.end()) return;
+    Push(Op::DrawSkybox, (std::size_t)it->second);
+}
+
+// ---------------- 文件 ----------------
+
+bool FrameCapture::End(const std::string& path)
+{
+    if (!m_Recording) return false;
+    m_Recording = false;
+
+    Writer w;
+    FileHeader header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kFormatVersion;
+    w.Put(header);
+
+    w.PutCount(m_Shaders.size());
+    for (const ShaderDesc& s : m_Shaders)
+    {
+        w.PutString(s.vertexPath);
+        w.PutString(s.fragmentPath);
+        w.PutString(s.defines);
+    }
+    w.PutCount(m_Models.size());
+    for (const std::string& m : m_Models)
+        w.PutString(m);
+    w.PutCount(m_Textures.size());
+    for (const TextureDesc& t : m_Textures)
+    {
+        w.PutString(t.path);
+        w.PutBool(t.srgb);
+        w.PutBool(t.layer);
+    }
+    w.PutCount(m_Materials.size());
+    for (const MaterialDesc& m : m_Materials)
+    {
+        w.Put(m.shader);
+        w.Put(m.albedo);
+        w.Put(m.albedoLayer);
+        w.Put(m.color);
+        w.Put(m.shininess);
+        w.Put(m.ambientStrength);
+        w.Put(m.metallic);
+        w.Put(m.roughness);
+        w.Put(m.ao);
+    }
+    w.PutCount(m_Passes.size());
+    for (const PassDesc& p : m_Passes)
+    {
+        w.PutString(p.name);
+        w.Put((std::int32_t)p.width);
+        w.Put((std::int32_t)p.height);
+        w.PutBool(p.clear);
+        w.Put(p.clearColor);
+        w.PutBool(p.depthTest);
+        w.PutBool(p.cullFace);
+    }
+    w.PutCount(m_Cameras.size());
+    for (const CameraDesc& c : m_Cameras)
+    {
+        w.Put(c.view);
+        w.Put(c.proj);
+        w.Put(c.viewPos);
+    }
+    w.PutCount(m_LightSets.size());
+    for (const std::vector<PointLight>& set : m_LightSets)
+    {
+        w.PutCount(set.size());
+        for (const PointLight& l : set)
+        {
+            w.Put(l.position);
+            w.Put(l.color);
+        }
+    }
+    w.PutCount(m_Environments.size());
+    for (const EnvironmentDesc& e : m_Environments)
+    {
+        w.PutString(e.hdrPath);
+        w.PutBool(e.useSH);
+        w.PutBool(e.useSpecular);
+        w.PutBool(e.bindTextures);
+    }
+    w.PutCount(m_Draws.size());
+    for (const DrawDesc& d : m_Draws)
+    {
+        w.Put(d.model);
+        w.Put(d.matrix);
+    }
+    w.PutCount(m_Instances.size());
+    for (const InstanceDesc& i : m_Instances)
+    {
+        w.Put(i.model);
+        w.Put(i.material);
+        w.Put(i.matrix);
+    }
+    w.PutCount(m_Commands.size());
+    for (const Command& c : m_Commands)
+    {
+        w.Put((std::uint32_t)c.op);
+        w.Put(c.index);
+    }
+
+    std::error_code ec;
+    std::filesystem::path target(path);
+    if (target.has_parent_path())
+        std::filesystem::create_directories(target.parent_path(), ec);
+
+    std::FILE* f = std::fopen(path.c_str(), "wb");
+    if (!f)
+    {
+        std::fprintf(stderr, "[FrameCapture] Cannot write %s\n", path.c_str());
+        return false;
+    }
+    const std::vector<std::uint8_t>& bytes = w.Bytes();
+    bool ok = std::fwrite(bytes.data(), 1, bytes.size(), f) == bytes.size();
+    ok = (std::fclose(f) == 0) && ok;
+    if (!ok)
+    {
+        std::fprintf(stderr, "[FrameCapture] Failed to write %s\n", path.c_str());
+        return false;
+    }
+    std::printf("[FrameCapture] Wrote %s: %zu commands, %zu draws, %zu instances, %zu materials (%zu bytes)\n",
+                path.c_str(), m_Commands.size(), m_Draws.size(), m_Instances.size(), m_Materials.size(),
+                bytes.size());
+    return true;
+}
+
+bool FrameCapture::Load(const std::string& path)
+{
+    m_Recording = false;
+    ClearFrame();
+    m_Shaders.clear();
+    m_Models.clear();
+    m_Textures.clear();
+    m_ShaderIndex.clear();
+    m_ModelIndex.clear();
+    m_TextureIndex.clear();
+    m_LayerIndex.clear();
+
+    MappedFile file;
+    if (!file.Open(path))
+    {
+        std::fprintf(stderr, "[FrameCapture] Cannot read %s\n", path.c_str());
+        return false;
+    }
+
+    Reader r(file.Data(), file.Size());
+    FileHeader header{};
+    r.Get(header);
+    if (!r.Ok() || std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kFormatVersion)
+    {
+        std::fprintf(stderr, "[FrameCapture] Not a frame capture (or wrong version): %s\n", path.c_str());
+        return false;
+    }
+
+    m_Shaders.resize(r.GetCount(12));
+    for (ShaderDesc& s : m_Shaders)
+    {
+        r.GetString(s.vertexPath);
+        r.GetString(s.fragmentPath);
+        r.GetString(s.defines);
+    }
+    m_Models.resize(r.GetCount(4));
+    for (std::string& m : m_Models)
+        r.GetString(m);
+    m_Textures.resize(r.GetCount(6));
+    for (TextureDesc& t : m_Textures)
+    {
+        r.GetString(t.path);
+        r.GetBool(t.srgb);
+        r.GetBool(t.layer);
+    }
+    m_Materials.resize(r.GetCount(48));
+    for (MaterialDesc& m : m_Materials)
+    {
+        r.Get(m.shader);
+        r.Get(m.albedo);
+        r.Get(m.albedoLayer);
+        r.Get(m.color);
+        r.Get(m.shininess);
+        r.Get(m.ambientStrength);
+        r.Get(m.metallic);
+        r.Get(m.roughness);
+        r.Get(m.ao);
+    }
+    m_Passes.resize(r.GetCount(31));
+    for (PassDesc& p : m_Passes)
+    {
+        std::int32_t width = 0, height = 0;
+        r.GetString(p.name);
+        r.Get(width);
+        r.Get(height);
+        r.GetBool(p.clear);
+        r.Get(p.clearColor);
+        r.GetBool(p.depthTest);
+        r.GetBool(p.cullFace);
+        p.width = width;
+        p.height = height;
+    }
+    m_Cameras.resize(r.GetCount(140));
+    for (CameraDesc& c : m_Cameras)
+    {
+        r.Get(c.view);
+        r.Get(c.proj);
+        r.Get(c.viewPos);
+    }
+    m_LightSets.resize(r.GetCount(4));
+    for (std::vector<PointLight>& set : m_LightSets)
+    {
+        set.resize(r.GetCount(24));
+        for (PointLight& l : set)
+        {
+            r.Get(l.position);
+            r.Get(l.color);
+        }
+    }
+    m_Environments.resize(r.GetCount(7));
+    for (EnvironmentDesc& e : m_Environments)
+    {
+        r.GetString(e.hdrPath);
+        r.GetBool(e.useSH);
+        r.GetBool(e.useSpecular);
+        r.GetBool(e.bindTextures);
+    }
+    m_Draws.resize(r.GetCount(68));
+    for (DrawDesc& d : m_Draws)
+    {
+        r.Get(d.model);
+        r.Get(d.matrix);
+    }
+    m_Instances.resize(r.GetCount(72));
+    for (InstanceDesc& i : m_Instances)
+    {
+        r.Get(i.model);
+        r.Get(i.material);
+        r.Get(i.matrix);
+    }
+    m_Commands.resize(r.GetCount(8));
+    for (Command& c : m_Commands)
+    {
+        std::uint32_t op = 0;
+        r.Get(op);
+        r.Get(c.index);
+        c.op = (Op)op;
+    }
+
+    // 下标全部校验一遍，重放时就不用再查
+    bool ok = r.Ok() && r.AtEnd();
+    for (const MaterialDesc& m : m_Materials)
+        ok = ok && InRange(m.shader, m_Shaders.size()) && InRange(m.albedo, m_Textures.size()) &&
+             InRange(m.albedoLayer, m_Textures.size());
+    for (const DrawDesc& d : m_Draws)
+        ok = ok && InRange(d.model, m_Models.size());
+    for (const InstanceDesc& i : m_Instances)
+        ok = ok && InRange(i.model, m_Models.size()) && InRange(i.material, m_Materials.size());
+    for (const Command& c : m_Commands)
+    {
+        std::size_t limit = 0;
+        switch (c.op)
+        {
+            case Op::BeginPass:       limit = m_Passes.size(); break;
+            case Op::EndPass:         limit = 1; break;
+            case Op::SetCamera:       limit = m_Cameras.size(); break;
+            case Op::BindShader:
+            case Op::FlushInstanced:
+            case Op::DrawSkybox:      limit = m_Shaders.size(); break;
+            case Op::BindMaterial:    limit = m_Materials.size(); break;
+            case Op::SetLights:       limit = m_LightSets.size(); break;
+            case Op::SetEnvironment:  limit = m_Environments.size(); break;
+            case Op::DrawModel:       limit = m_Draws.size(); break;
+            case Op::SubmitInstanced: limit = m_Instances.size(); break;
+        }
+        ok = ok && c.index < limit;
+    }
+    if (!ok)
+    {
+        std::fprintf(stderr, "[FrameCapture] Corrupt capture: %s\n", path.c_str());
+        ClearFrame();
+        m_Shaders.clear();
+        m_Models.clear();
+        m_Textures.clear();
+        return false;
+    }
+
+    std::printf("[FrameCapture] Loaded %s: %zu commands, %zu draws, %zu instances, %zu materials\n",
+                path.c_str(), m_Commands.size(), m_Draws.size(), m_Instances.size(), m_Materials.size());
+    return true;
+}
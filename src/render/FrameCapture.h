@@ -0,0 +1,183 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "Light.h"
+
+class Model;
+class Shader;
+class Texture2D;
+struct Material;
+
+// FrameCapture：把一帧场景的高层命令流录成紧凑的二进制文件，给 FrameReplay 反复重放
+// - 命令和 main 里真正的调用一一对应（绑材质、设灯光、画模型、提交 instanced……），重放时原样调
+//   Material / Shader / Model / Renderer，测的就是这套后端的提交开销
+// - 模型、shader、贴图、HDR 按路径引用：录之前由调用方 Register；没登记的资源照录，重放时跳过
+// - 材质在第一次被引用时拍快照，同一帧里后来再改参数不会反映
+// - 只录场景几何（Scene / Skybox），后处理和场景无关，不在里面
+// - 录制接口在没开始录的时候直接返回，调用点不用再判断
+class FrameCapture
+{
+public:
+    enum class Op : std::uint32_t
+    {
+        BeginPass = 1,      // index -> passes
+        EndPass,
+        SetCamera,          // index -> cameras：Renderer::BeginFrame
+        BindShader,         // index -> shaders
+        BindMaterial,       // index -> materials：Material::Bind
+        SetLights,          // index -> lightSets：当前 shader 的灯光 uniform + Renderer::SetPointLights
+        SetEnvironment,     // index -> environments：IBLBaker::ApplyToShader
+        DrawModel,          // index -> draws：当前 shader 的矩阵 + Model::Draw
+        SubmitInstanced,    // index -> instances：Renderer::SubmitInstanced
+        FlushInstanced,     // index -> shaders（Renderer 的 instanced shader）
+        DrawSkybox,         // index -> shaders
+    };
+
+    struct Command
+    {
+        Op op = Op::EndPass;
+        std::uint32_t index = 0;
+    };
+
+    struct ShaderDesc
+    {
+        std::string vertexPath;
+        std::string fragmentPath;
+        std::string defines;
+    };
+
+    // layer = true：打包进纹理数组的图层（重放时用 TextureArrayPacker 重新打包）
+    struct TextureDesc
+    {
+        std::string path;
+        bool srgb = false;
+        bool layer = false;
+    };
+
+    struct MaterialDesc
+    {
+        std::int32_t shader = -1;
+        std::int32_t albedo = -1;       // textures 下标
+        std::int32_t albedoLayer = -1;  // textures 下标（layer = true）
+        glm::vec4 color{1.0f};
+        float shininess = 32.0f;
+        float ambientStrength = 0.08f;
+        float metallic = 0.0f;
+        float roughness = 0.5f;
+        float ao = 1.0f;
+    };
+
+    struct PassDesc
+    {
+        std::string name;
+        int width = 0;
+        int height = 0;
+        bool clear = false;
+        glm::vec4 clearColor{0.0f};
+        bool depthTest = true;
+        bool cullFace = false;
+    };
+
+    struct CameraDesc
+    {
+        glm::mat4 view{1.0f};
+        glm::mat4 proj{1.0f};
+        glm::vec3 viewPos{0.0f};
+    };
+
+    // bindTextures = false：只设 uniform（这一帧里已经有别的 shader 绑过 IBL 贴图）
+    struct EnvironmentDesc
+    {
+        std::string hdrPath;
+        bool useSH = true;
+        bool useSpecular = true;
+        bool bindTextures = true;
+    };
+
+    struct DrawDesc
+    {
+        std::int32_t model = -1;
+        glm::mat4 matrix{1.0f};
+    };
+
+    struct InstanceDesc
+    {
+        std::int32_t model = -1;
+        std::int32_t material = -1;
+        glm::mat4 matrix{1.0f};
+    };
+
+    // ---------------- 资源登记（启动时一次） ----------------
+    void RegisterShader(const Shader* shader, const std::string& vertexPath, const std::string& fragmentPath,
+                        const std::string& defines = std::string());
+    void RegisterModel(const Model* model, const std::string& path);
+    void RegisterTexture(const Texture2D* texture, const std::string& path, bool srgb);
+    // 纹理数组里的一层：texture 是数组的 GL 名字（Material::albedoArray）
+    void RegisterTextureLayer(std::uint32_t texture, int layer, const std::string& path, bool srgb);
+
+    // ---------------- 录制 ----------------
+    // Begin 清空上一次的命令；End 写文件并停止录制
+    void Begin();
+    bool End(const std::string& path);
+    bool IsRecording() const { return m_Recording; }
+
+    void BeginPass(const std::string& name, int width, int height, bool clear, const glm::vec4& clearColor,
+                   bool depthTest, bool cullFace);
+    void EndPass();
+    void SetCamera(const glm::mat4& view, const glm::mat4& proj, const glm::vec3& viewPos);
+    void BindShader(const Shader* shader);
+    void BindMaterial(const Material* material);
+    void SetLights(const std::vector<PointLight>& lights);
+    void SetEnvironment(const std::string& hdrPath, bool useSH, bool useSpecular, bool bindTextures);
+    void DrawModel(const Model* model, const glm::mat4& matrix);
+    void SubmitInstanced(const Model* model, const Material* material, const glm::mat4& matrix);
+    void FlushInstanced(const Shader* instancedShader);
+    void DrawSkybox(const Shader* skyboxShader);
+
+    // ---------------- 读回（FrameReplay） ----------------
+    bool Load(const std::string& path);
+
+    const std::vector<Command>& Commands() const { return m_Commands; }
+    const std::vector<ShaderDesc>& Shaders() const { return m_Shaders; }
+    const std::vector<std::string>& Models() const { return m_Models; }
+    const std::vector<TextureDesc>& Textures() const { return m_Textures; }
+    const std::vector<MaterialDesc>& Materials() const { return m_Materials; }
+    const std::vector<PassDesc>& Passes() const { return m_Passes; }
+    const std::vector<CameraDesc>& Cameras() const { return m_Cameras; }
+    const std::vector<std::vector<PointLight>>& LightSets() const { return m_LightSets; }
+    const std::vector<EnvironmentDesc>& Environments() const { return m_Environments; }
+    const std::vector<DrawDesc>& Draws() const { return m_Draws; }
+    const std::vector<InstanceDesc>& Instances() const { return m_Instances; }
+
+private:
+    void Push(Op op, std::size_t index);
+    std::int32_t MaterialIndex(const Material* material);
+    void ClearFrame();
+
+    bool m_Recording = false;
+
+    // 登记表：指针（纹理数组是 GL 名字 + 层）-> 下标
+    std::unordered_map<const void*, std::int32_t> m_ShaderIndex;
+    std::unordered_map<const void*, std::int32_t> m_ModelIndex;
+    std::unordered_map<const void*, std::int32_t> m_TextureIndex;
+    std::unordered_map<std::uint64_t, std::int32_t> m_LayerIndex;
+    std::unordered_map<const void*, std::int32_t> m_MaterialIndex;
+
+    std::vector<ShaderDesc> m_Shaders;
+    std::vector<std::string> m_Models;
+    std::vector<TextureDesc> m_Textures;
+
+    // 一帧的内容
+    std::vector<Command> m_Commands;
+    std::vector<MaterialDesc> m_Materials;
+    std::vector<PassDesc> m_Passes;
+    std::vector<CameraDesc> m_Cameras;
+    std::vector<std::vector<PointLight>> m_LightSets;
+    std::vector<EnvironmentDesc> m_Environments;
+    std::vector<DrawDesc> m_Draws;
+    std::vector<InstanceDesc> m_Instances;
+};
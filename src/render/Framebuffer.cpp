@@ -1,4 +1,6 @@
 #include "Framebuffer.h"
+#include "DrawStats.h"
+#include "GpuMemory.h"
 
 #include <glad/glad.h>
 #include <cstdio>
@@ -66,6 +68,8 @@ bool Framebuffer::CreateAttachments(int width, int height)
     glGenTextures(1, &m_ColorTex);
     glBindTexture(GL_TEXTURE_2D, m_ColorTex);
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB16F, width, height, 0, GL_RGB, GL_FLOAT, nullptr);
+    GpuMemory::TrackTexture(m_ColorTex, GpuMemory::Category::RenderTargets, "Framebuffer color",
+                            GpuMemory::TextureBytes(GL_RGB16F, width, height));
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
@@ -77,6 +81,8 @@ bool Framebuffer::CreateAttachments(int width, int height)
     glGenRenderbuffers(1, &m_DepthStencilRbo);
     glBindRenderbuffer(GL_RENDERBUFFER, m_DepthStencilRbo);
     glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+    GpuMemory::TrackRenderbuffer(m_DepthStencilRbo, GpuMemory::Category::RenderTargets, "Framebuffer depth",
+                                 GpuMemory::TextureBytes(GL_DEPTH24_STENCIL8, width, height));
     glBindRenderbuffer(GL_RENDERBUFFER, 0);
 
     glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, m_DepthStencilRbo);
@@ -89,10 +95,12 @@ bool Framebuffer::CreateAttachments(int width, int height)
 void Framebuffer::Destroy()
 {
     if (m_DepthStencilRbo) {
+        GpuMemory::FreeRenderbuffer(m_DepthStencilRbo);
         glDeleteRenderbuffers(1, &m_DepthStencilRbo);
         m_DepthStencilRbo = 0;
     }
     if (m_ColorTex) {
+        GpuMemory::FreeTexture(m_ColorTex);
         glDeleteTextures(1, &m_ColorTex);
         m_ColorTex = 0;
     }
@@ -112,6 +120,8 @@ bool Framebuffer::Resize(int width, int height)
 
     glBindFramebuffer(GL_FRAMEBUFFER, m_Fbo);
 
+    GpuMemory::FreeTexture(m_ColorTex);
+    GpuMemory::FreeRenderbuffer(m_DepthStencilRbo);
     if (m_ColorTex) glDeleteTextures(1, &m_ColorTex);
     if (m_DepthStencilRbo) glDeleteRenderbuffers(1, &m_DepthStencilRbo);
     m_ColorTex = 0;
@@ -136,11 +146,13 @@ bool Framebuffer::Resize(int width, int height)
 
 void Framebuffer::Bind() const
 {
+    DrawStats::BindFramebuffer(m_Fbo);
     glBindFramebuffer(GL_FRAMEBUFFER, m_Fbo);
 }
 
 void Framebuffer::BindDefault()
 {
+    DrawStats::BindFramebuffer(0);
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
 }
 
@@ -0,0 +1,240 @@
+#include "GpuMemory.h"
+
+#include <glad/glad.h>
+#include <algorithm>
+#include <cstdio>
+#include <unordered_map>
+
+namespace
+{
+    constexpr int kCategoryCount = (int)GpuMemory::Category::kCount;
+
+    // 命名空间级对象：main 里用 atexit 注册的 ReportLeaks 跑完之后才析构
+    std::unordered_map<std::uint64_t, GpuMemory::Allocation> s_Allocations;
+    GpuMemory::CategoryStats s_Categories[kCategoryCount];
+    std::size_t s_Total = 0;
+    std::size_t s_Peak = 0;
+    std::size_t s_Budget = 0;
+    bool s_OverBudget = false;
+
+    std::uint64_t Key(GpuMemory::Kind kind, std::uint32_t id)
+    {
+        return ((std::uint64_t)kind << 32) | id;
+    }
+
+    const char* KindName(GpuMemory::Kind kind)
+    {
+        switch (kind)
+        {
+            case GpuMemory::Kind::Texture:      return "texture";
+            case GpuMemory::Kind::Buffer:       return "buffer";
+            case GpuMemory::Kind::Renderbuffer: return "renderbuffer";
+        }
+        return "?";
+    }
+
+    void Add(GpuMemory::Category category, std::size_t bytes, int objects)
+    {
+        GpuMemory::CategoryStats& c = s_Categories[(int)category];
+        c.bytes += bytes;
+        c.objects += objects;
+        c.peakBytes = std::max(c.peakBytes, c.bytes);
+        s_Total += bytes;
+        s_Peak = std::max(s_Peak, s_Total);
+
+        // 跨过预算时提示一次，回到预算以内再重新计
+        if (s_Budget > 0 && s_Total > s_Budget && !s_OverBudget)
+            std::printf("[GpuMemory] Over budget: %.1f MB / %.1f MB\n",
+                        s_Total / (1024.0 * 1024.0), s_Budget / (1024.0 * 1024.0));
+        s_OverBudget = s_Budget > 0 && s_Total > s_Budget;
+    }
+
+    void Remove(GpuMemory::Category category, std::size_t bytes, int objects)
+    {
+        GpuMemory::CategoryStats& c = s_Categories[(int)category];
+        c.bytes -= std::min(c.bytes, bytes);
+        c.objects -= objects;
+        s_Total -= std::min(s_Total, bytes);
+        s_OverBudget = s_Budget > 0 && s_Total > s_Budget;
+    }
+}
+
+std::size_t GpuMemory::BytesPerTexel(std::uint32_t internalFormat)
+{
+    switch (internalFormat)
+    {
+        case GL_R8:
+        case GL_RED:                return 1;
+        case GL_RG8:
+        case GL_RG:
+        case GL_R16F:
+        case GL_DEPTH_COMPONENT16:  return 2;
+        case GL_RGB8:
+        case GL_SRGB8:
+        case GL_RGB:
+        case GL_SRGB:               return 3;
+        case GL_RGBA8:
+        case GL_SRGB8_ALPHA8:
+        case GL_RGBA:
+        case GL_SRGB_ALPHA:
+        case GL_RG16F:
+        case GL_R32F:
+        case GL_R11F_G11F_B10F:
+        case GL_RGB9_E5:
+        case GL_RGB10_A2:
+        case GL_DEPTH_COMPONENT24:
+        case GL_DEPTH_COMPONENT32F:
+        case GL_DEPTH24_STENCIL8:   return 4;
+        case GL_RGB16F:             return 6;
+        case GL_RGBA16F:
+        case GL_RG32F:
+        case GL_DEPTH32F_STENCIL8:  return 8;
+        case GL_RGB32F:             return 12;
+        case GL_RGBA32F:            return 16;
+    }
+    return 4;
+}
+
+std::size_t GpuMemory::TextureBytes(std::uint32_t internalFormat, int width, int height,
+                                    int layers, int mips, int samples)
+{
+    std::size_t texels = 0;
+    for (int level = 0; level < std::max(mips, 1); ++level)
+        texels += (std::size_t)std::max(1, width >> level) * (std::size_t)std::max(1, height >> level);
+    return texels * (std::size_t)std::max(layers, 1) * (std::size_t)std::max(samples, 1)
+         * BytesPerTexel(internalFormat);
+}
+
+void GpuMemory::Track(Kind kind, std::uint32_t id, Category category, const std::string& name, std::size_t bytes)
+{
+    if (!id) return;
+    auto it = s_Allocations.find(Key(kind, id));
+    if (it != s_Allocations.end())
+    {
+        Remove(it->second.category, it->second.bytes, 1);
+        s_Allocations.erase(it);
+    }
+    Allocation a;
+    a.kind = kind;
+    a.id = id;
+    a.category = category;
+    a.name = name;
+    a.bytes = bytes;
+    s_Allocations.emplace(Key(kind, id), std::move(a));
+    Add(category, bytes, 1);
+}
+
+void GpuMemory::Free(Kind kind, std::uint32_t id)
+{
+    if (!id) return;
+    auto it = s_Allocations.find(Key(kind, id));
+    if (it == s_Allocations.end()) return;
+    Remove(it->second.category, it->second.bytes, 1);
+    s_Allocations.erase(it);
+}
+
+void GpuMemory::Resize(Kind kind, std::uint32_t id, std::size_t bytes)
+{
+    auto it = s_Allocations.find(Key(kind, id));
+    if (it == s_Allocations.end()) return;
+    Remove(it->second.category, it->second.bytes, 0);
+    it->second.bytes = bytes;
+    Add(it->second.category, bytes, 0);
+}
+
+std::size_t GpuMemory::TotalBytes()
+{
+    return s_Total;
+}
+
+std::size_t GpuMemory::PeakBytes()
+{
+    return s_Peak;
+}
+
+int GpuMemory::ObjectCount()
+{
+    return (int)s_Allocations.size();
+}
+
+GpuMemory::CategoryStats GpuMemory::GetCategory(Category category)
+{
+    return s_Categories[(int)category];
+}
+
+std::vector<GpuMemory::AssetStats> GpuMemory::Assets()
+{
+    std::vector<AssetStats> assets;
+    std::unordered_map<std::string, std::size_t> index[kCategoryCount];
+    for (const auto& entry : s_Allocations)
+    {
+        const Allocation& a = entry.second;
+        auto& names = index[(int)a.category];
+        auto it = names.find(a.name);
+        if (it == names.end())
+        {
+            it = names.emplace(a.name, assets.size()).first;
+            AssetStats s;
+            s.category = a.category;
+            s.name = a.name;
+            assets.push_back(s);
+        }
+        assets[it->second].bytes += a.bytes;
+        assets[it->second].objects++;
+    }
+    std::sort(assets.begin(), assets.end(), [](const AssetStats& a, const AssetStats& b) {
+        return a.bytes != b.bytes ? a.bytes > b.bytes : a.name < b.name;
+    });
+    return assets;
+}
+
+const char* GpuMemory::CategoryName(Category category)
+{
+    switch (category)
+    {
+        case Category::Textures:      return "Textures";
+        case Category::Environment:   return "Environment";
+        case Category::Meshes:        return "Meshes";
+        case Category::RenderTargets: return "Render targets";
+        case Category::IBL:           return "IBL";
+        case Category::PostProcess:   return "Post process";
+        case Category::Buffers:       return "Buffers";
+        default:                      return "?";
+    }
+}
+
+void GpuMemory::SetBudgetBytes(std::size_t bytes)
+{
+    s_Budget = bytes;
+    s_OverBudget = s_Budget > 0 && s_Total > s_Budget;
+}
+
+std::size_t GpuMemory::BudgetBytes()
+{
+    return s_Budget;
+}
+
+int GpuMemory::ReportLeaks()
+{
+    if (s_Allocations.empty())
+    {
+        std::printf("[GpuMemory] No leaks (peak %.1f MB)\n", s_Peak / (1024.0 * 1024.0));
+        return 0;
+    }
+
+    std::vector<const Allocation*> live;
+    live.reserve(s_Allocations.size());
+    for (const auto& entry : s_Allocations)
+        live.push_back(&entry.second);
+    std::sort(live.begin(), live.end(), [](const Allocation* a, const Allocation* b) {
+        if (a->category != b->category) return a->category < b->category;
+        return a->bytes > b->bytes;
+    });
+
+    std::fprintf(stderr, "[GpuMemory] %d objects (%.2f MB) still allocated:\n",
+                 (int)live.size(), s_Total / (1024.0 * 1024.0));
+    for (const Allocation* a : live)
+        std::fprintf(stderr, "[GpuMemory]   %-14s %-12s %6u %10.1f KB  %s\n", CategoryName(a->category),
+                     KindName(a->kind), a->id, a->bytes / 1024.0, a->name.c_str());
+    return (int)live.size();
+}
@@ -0,0 +1,103 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// GpuMemory：显存账本，记下每个纹理 / buffer / renderbuffer 分配和释放时的字节数
+// - 字节数按内部格式、尺寸、层数、mip 级数算（BytesPerTexel 和 RenderTargetPool 共用一张表），
+//   是我们要求的量，驱动的对齐和填充（比如 RGB16F 按 4 通道存）不算在内
+// - 同一个对象再次 Track（重新分配、流送改了驻留的 mip）覆盖原来的记录
+// - 按类别和资源名汇总给界面；程序退出时还没 Free 的就是泄漏，ReportLeaks 逐个打印
+// - 只在 GL 线程（主线程）调用，不加锁
+class GpuMemory
+{
+public:
+    enum class Category
+    {
+        Textures,       // Texture2D / 纹理数组
+        Environment,    // TextureHDR 全景图
+        Meshes,         // 顶点 / 索引 buffer
+        RenderTargets,  // RenderTargetPool、Framebuffer
+        IBL,            // 环境立方体、辐照度、预过滤、BRDF LUT
+        PostProcess,    // 颜色 LUT、曝光纹理和 PBO
+        Buffers,        // 其他 buffer（实例数据等）
+        kCount
+    };
+
+    enum class Kind
+    {
+        Texture,
+        Buffer,
+        Renderbuffer,
+    };
+
+    struct Allocation
+    {
+        Kind kind = Kind::Texture;
+        std::uint32_t id = 0;
+        Category category = Category::Textures;
+        std::string name;
+        std::size_t bytes = 0;
+    };
+
+    struct CategoryStats
+    {
+        std::size_t bytes = 0;
+        std::size_t peakBytes = 0;
+        int objects = 0;
+    };
+
+    // 同一类别下同名资源的合计（一张立方体的所有 mip、一个模型的所有 mesh……）
+    struct AssetStats
+    {
+        Category category = Category::Textures;
+        std::string name;
+        std::size_t bytes = 0;
+        int objects = 0;
+    };
+
+    // 每个 texel 的字节数；不认识的格式按 4 字节算
+    static std::size_t BytesPerTexel(std::uint32_t internalFormat);
+    // layers 是数组层数 / 立方体的 6 个面，不随 mip 减半；3D 纹理只有一级时把深度当 layers 传
+    static std::size_t TextureBytes(std::uint32_t internalFormat, int width, int height,
+                                    int layers = 1, int mips = 1, int samples = 1);
+
+    static void TrackTexture(std::uint32_t id, Category category, const std::string& name, std::size_t bytes)
+    {
+        Track(Kind::Texture, id, category, name, bytes);
+    }
+    static void TrackBuffer(std::uint32_t id, Category category, const std::string& name, std::size_t bytes)
+    {
+        Track(Kind::Buffer, id, category, name, bytes);
+    }
+    static void TrackRenderbuffer(std::uint32_t id, Category category, const std::string& name, std::size_t bytes)
+    {
+        Track(Kind::Renderbuffer, id, category, name, bytes);
+    }
+    static void FreeTexture(std::uint32_t id) { Free(Kind::Texture, id); }
+    static void FreeBuffer(std::uint32_t id) { Free(Kind::Buffer, id); }
+    static void FreeRenderbuffer(std::uint32_t id) { Free(Kind::Renderbuffer, id); }
+
+    // 只改字节数，类别和名字保留（流送纹理换驻留 mip）；没登记过的对象忽略
+    static void Resize(Kind kind, std::uint32_t id, std::size_t bytes);
+
+    static std::size_t TotalBytes();
+    static std::size_t PeakBytes();
+    static int ObjectCount();
+    static CategoryStats GetCategory(Category category);
+    // 按字节数从大到小
+    static std::vector<AssetStats> Assets();
+    static const char* CategoryName(Category category);
+
+    // 0 = 不设预算
+    static void SetBudgetBytes(std::size_t bytes);
+    static std::size_t BudgetBytes();
+
+    // 打印还登记着的对象（按类别、字节数排序），返回个数
+    static int ReportLeaks();
+
+private:
+    static void Track(Kind kind, std::uint32_t id, Category category, const std::string& name, std::size_t bytes);
+    static void Free(Kind kind, std::uint32_t id);
+};
@@ -0,0 +1,301 @@
+#include "GpuProfiler.h"
+
+#include <glad/glad.h>
+#include <algorithm>
+#include <cstdio>
+
+namespace
+{
+    constexpr int kQueryBatch = 64;
+
+    double Percentile(const std::vector<double>& sorted, double p)
+    {
+        std::size_t i = (std::size_t)(p * (double)(sorted.size() - 1) + 0.5);
+        return sorted[std::min(i, sorted.size() - 1)];
+    }
+}
+
+GpuProfiler& GpuProfiler::Global()
+{
+    static GpuProfiler s_Profiler;
+    return s_Profiler;
+}
+
+std::uint32_t GpuProfiler::AcquireQuery()
+{
+    if (m_FreeQueries.empty())
+    {
+        GLuint ids[kQueryBatch];
+        glGenQueries(kQueryBatch, ids);
+        for (int i = kQueryBatch - 1; i >= 0; --i)
+        {
+            m_FreeQueries.push_back(ids[i]);
+            m_AllQueries.push_back(ids[i]);
+        }
+    }
+    std::uint32_t q = m_FreeQueries.back();
+    m_FreeQueries.pop_back();
+    return q;
+}
+
+void GpuProfiler::Recycle(FrameSlot& slot)
+{
+    for (const Record& r : slot.records)
+    {
+        m_FreeQueries.push_back(r.begin);
+        if (r.end) m_FreeQueries.push_back(r.end);
+    }
+    slot.records.clear();
+    slot.pending = false;
+}
+
+int GpuProfiler::FindOrAddSeries(const std::string& path, const char* name, int depth)
+{
+    auto it = m_SeriesIndex.find(path);
+    if (it != m_SeriesIndex.end()) return it->second;
+
+    Series s;
+    s.name = name;
+    s.path = path;
+    s.depth = depth;
+    s.history.assign(kHistory, 0.0);
+    m_Series.push_back(std::move(s));
+    int index = (int)m_Series.size() - 1;
+    m_SeriesIndex.emplace(path, index);
+    return index;
+}
+
+int GpuProfiler::Begin(const char* name)
+{
+    if (!m_Enabled) return -1;
+
+    FrameSlot& slot = m_Slots[m_Current];
+    const int depth = (int)m_Open.size();
+    std::string path = m_Open.empty() ? std::string(name)
+                                      : m_Series[slot.records[m_Open.back()].series].path + "/" + name;
+
+    Record r;
+    r.series = FindOrAddSeries(path, name, depth);
+    r.begin = AcquireQuery();
+    glQueryCounter(r.begin, GL_TIMESTAMP);
+    slot.records.push_back(r);
+
+    const int index = (int)slot.records.size() - 1;
+    m_Open.push_back(index);
+    return index;
+}
+
+void GpuProfiler::End(int scope)
+{
+    if (scope < 0) return;
+    if (m_Open.empty() || m_Open.back() != scope)
+    {
+        // 区间没有按栈的顺序关（或者跨了 BeginFrame）：丢掉这个结束标记，不然时间戳对不上
+        std::fprintf(stderr, "[GpuProfiler] Unbalanced End(%d)\n", scope);
+        return;
+    }
+    m_Open.pop_back();
+
+    Record& r = m_Slots[m_Current].records[scope];
+    r.end = AcquireQuery();
+    glQueryCounter(r.end, GL_TIMESTAMP);
+}
+
+bool GpuProfiler::Resolve(FrameSlot& slot)
+{
+    // 全部可用才读，GL_QUERY_RESULT 在结果没好时会阻塞
+    for (const Record& r : slot.records)
+    {
+        if (!r.end) continue;
+        GLint available = 0;
+        glGetQueryObjectiv(r.end, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) return false;
+    }
+
+    for (const Record& r : slot.records)
+    {
+        if (!r.end) continue;
+        GLuint64 t0 = 0, t1 = 0;
+        glGetQueryObjectui64v(r.begin, GL_QUERY_RESULT, &t0);
+        glGetQueryObjectui64v(r.end, GL_QUERY_RESULT, &t1);
+        const double ms = t1 > t0 ? (double)(t1 - t0) / 1.0e6 : 0.0;
+
+        Series& s = m_Series[r.series];
+        if (m_TraceCapture && slot.calibrated && (int)m_Trace.size() < kMaxTraceEvents)
+            m_Trace.push_back(CpuProfiler::ExternalEvent{ s.name,
+                                                          (std::uint64_t)((std::int64_t)t0 + slot.cpuOffsetNs),
+                                                          (std::uint64_t)((std::int64_t)t1 + slot.cpuOffsetNs) });
+        s.history[s.next] = ms;
+        s.next = (s.next + 1) % kHistory;
+        s.count = std::min(s.count + 1, kHistory);
+        s.lastMs = ms;
+    }
+    return true;
+}
+
+void GpuProfiler::RebuildStats(const FrameSlot& latest)
+{
+    std::vector<int> order;
+    std::vector<bool> seen(m_Series.size(), false);
+    for (const Record& r : latest.records)
+        if (!seen[r.series]) { seen[r.series] = true; order.push_back(r.series); }
+    const std::size_t activeCount = order.size();
+    for (int i = 0; i < (int)m_Series.size(); ++i)
+        if (!seen[i] && m_Series[i].count > 0) order.push_back(i);
+
+    m_Stats.clear();
+    std::vector<double> sorted;
+    for (std::size_t k = 0; k < order.size(); ++k)
+    {
+        const Series& s = m_Series[order[k]];
+        ScopeStats st;
+        st.name = s.name;
+        st.path = s.path;
+        st.depth = s.depth;
+        st.active = k < activeCount;
+        st.samples = s.count;
+        st.lastMs = s.lastMs;
+        if (s.count > 0)
+        {
+            sorted.assign(s.history.begin(), s.history.begin() + s.count);
+            std::sort(sorted.begin(), sorted.end());
+            double sum = 0.0;
+            for (double v : sorted) sum += v;
+            st.avgMs = sum / (double)sorted.size();
+            st.p50Ms = Percentile(sorted, 0.50);
+            st.p95Ms = Percentile(sorted, 0.95);
+            st.p99Ms = Percentile(sorted, 0.99);
+            st.maxMs = sorted.back();
+        }
+        m_Stats.push_back(std::move(st));
+    }
+}
+
+void GpuProfiler::BeginFrame()
+{
+    if (!m_Open.empty())
+    {
+        std::fprintf(stderr, "[GpuProfiler] %d scope(s) still open at frame end\n", (int)m_Open.size());
+        // 没关的区间没有结束时间戳，整帧作废
+        Recycle(m_Slots[m_Current]);
+        m_Open.clear();
+    }
+    m_Slots[m_Current].pending = !m_Slots[m_Current].records.empty();
+
+    // 从最老的槽开始读回；后面的读不回来前面的也不会好，遇到没好的就停
+    const FrameSlot* latest = nullptr;
+    for (int i = 1; i <= kFrameLatency; ++i)
+    {
+        FrameSlot& slot = m_Slots[(m_Current + i) % kFrameLatency];
+        if (!slot.pending) continue;
+        if (!Resolve(slot)) break;
+        ++m_ResolvedFrames;
+        latest = &slot;
+        // 先只标记，查询对象等统计重建完再还
+        slot.pending = false;
+    }
+    if (latest) RebuildStats(*latest);
+    for (FrameSlot& slot : m_Slots)
+        if (!slot.pending && !slot.records.empty()) Recycle(slot);
+
+    // 下一个槽还在等 GPU：丢掉那一帧，绝不等
+    m_Current = (m_Current + 1) % kFrameLatency;
+    FrameSlot& next = m_Slots[m_Current];
+    if (next.pending)
+    {
+        ++m_DroppedFrames;
+        Recycle(next);
+    }
+
+    // GL_TIMESTAMP 的 get 不等 GPU 做完，只是取当前 GPU 时钟；只在录 trace 时取
+    next.calibrated = m_TraceCapture;
+    if (m_TraceCapture)
+    {
+        GLint64 gpuNowNs = 0;
+        glGetInteger64v(GL_TIMESTAMP, &gpuNowNs);
+        next.cpuOffsetNs = (std::int64_t)CpuProfiler::NowNs() - (std::int64_t)gpuNowNs;
+    }
+}
+
+void GpuProfiler::SetTraceCapture(bool capture)
+{
+    if (capture && !m_TraceCapture) m_Trace.clear();
+    m_TraceCapture = capture;
+}
+
+void GpuProfiler::Reset()
+{
+    for (Series& s : m_Series)
+    {
+        s.next = 0;
+        s.count = 0;
+        s.lastMs = 0.0;
+    }
+    m_Stats.clear();
+    m_ResolvedFrames = 0;
+    m_DroppedFrames = 0;
+}
+
+void GpuProfiler::Destroy()
+{
+    if (!m_AllQueries.empty())
+        glDeleteQueries((GLsizei)m_AllQueries.size(), m_AllQueries.data());
+    m_AllQueries.clear();
+    m_FreeQueries.clear();
+    for (FrameSlot& slot : m_Slots)
+    {
+        slot.records.clear();
+        slot.pending = false;
+    }
+    m_Open.clear();
+}
+
+bool GpuProfiler::ExportCsv(const std::string& path) const
+{
+    std::FILE* f = std::fopen(path.c_str(), "w");
+    if (!f)
+    {
+        std::fprintf(stderr, "[GpuProfiler] Cannot write %s\n", path.c_str());
+        return false;
+    }
+    std::fprintf(f, "scope,depth,samples,last_ms,avg_ms,p50_ms,p95_ms,p99_ms,max_ms\n");
+    for (const ScopeStats& s : m_Stats)
+        std::fprintf(f, "\"%s\",%d,%d,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f\n",
+                     s.path.c_str(), s.depth, s.samples, s.lastMs, s.avgMs, s.p50Ms, s.p95Ms, s.p99Ms, s.maxMs);
+    std::fclose(f);
+    std::printf("[GpuProfiler] Wrote %s (%d scopes)\n", path.c_str(), (int)m_Stats.size());
+    return true;
+}
+
+bool GpuProfiler::ExportJson(const std::string& path) const
+{
+    std::FILE* f = std::fopen(path.c_str(), "w");
+    if (!f)
+    {
+        std::fprintf(stderr, "[GpuProfiler] Cannot write %s\n", path.c_str());
+        return false;
+    }
+    std::fprintf(f, "{\n  \"resolvedFrames\": %d, \"droppedFrames\": %d, \"history\": %d,\n",
+                 m_ResolvedFrames, m_DroppedFrames, kHistory);
+    std::fprintf(f, "  \"scopes\": [\n");
+    for (std::size_t i = 0; i < m_Stats.size(); ++i)
+    {
+        const ScopeStats& s = m_Stats[i];
+        std::fprintf(f, "    { \"name\": \"%s\", \"path\": \"%s\", \"depth\": %d, \"samples\": %d, "
+                        "\"lastMs\": %.4f, \"avgMs\": %.4f, \"p50Ms\": %.4f, \"p95Ms\": %.4f, \"p99Ms\": %.4f, \"maxMs\": %.4f,\n",
+                     s.name.c_str(), s.path.c_str(), s.depth, s.samples,
+                     s.lastMs, s.avgMs, s.p50Ms, s.p95Ms, s.p99Ms, s.maxMs);
+
+        // 原始样本，从最老的开始
+        std::fprintf(f, "      \"historyMs\": [");
+        const Series& series = m_Series[m_SeriesIndex.at(s.path)];
+        const int start = series.count < kHistory ? 0 : series.next;
+        for (int k = 0; k < series.count; ++k)
+            std::fprintf(f, "%s%.4f", k ? ", " : "", series.history[(start + k) % kHistory]);
+        std::fprintf(f, "] }%s\n", i + 1 < m_Stats.size() ? "," : "");
+    }
+    std::fprintf(f, "  ]\n}\n");
+    std::fclose(f);
+    std::printf("[GpuProfiler] Wrote %s (%d scopes)\n", path.c_str(), (int)m_Stats.size());
+    return true;
+}
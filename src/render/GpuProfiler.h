@@ -0,0 +1,134 @@
+#pragma once
+#include "../CpuProfiler.h"
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// GpuProfiler：可嵌套的 GPU 计时区间，用 glQueryCounter(GL_TIMESTAMP) 打时间戳
+// - 渲染图的每个 pass 自动是一个顶层区间；pass 内部（PostProcessPass）和 pass 之外（IBLBaker）再用 GpuScope 细分
+// - 一帧的区间记在一个帧槽里，kFrameLatency 个槽轮流用，BeginFrame 时只读回已经完成的槽；
+//   槽轮回来时结果还没好就丢掉那一帧（计数），从不等 GPU
+// - 每个区间（按父区间路径区分）保留最近 kHistory 个样本，给界面算平均和分位数，也可以导出 CSV/JSON
+// - 录 trace 时每帧开头用 glGetInteger64v(GL_TIMESTAMP) 对一次时钟，读回的区间换算成 CpuProfiler 的时间轴
+// GL 调用只在主线程
+class GpuProfiler
+{
+public:
+    static constexpr int kFrameLatency = 4;
+    static constexpr int kHistory = 240;
+    static constexpr int kMaxTraceEvents = 1 << 20;
+
+    struct ScopeStats
+    {
+        std::string name;       // 区间名
+        std::string path;       // 父区间/.../区间名
+        int depth = 0;
+        bool active = false;    // 最近读回的那一帧里有没有它
+        int samples = 0;
+        double lastMs = 0.0;
+        double avgMs = 0.0;
+        double p50Ms = 0.0;
+        double p95Ms = 0.0;
+        double p99Ms = 0.0;
+        double maxMs = 0.0;
+    };
+
+    static GpuProfiler& Global();
+
+    GpuProfiler() = default;
+    ~GpuProfiler() = default;
+
+    GpuProfiler(const GpuProfiler&) = delete;
+    GpuProfiler& operator=(const GpuProfiler&) = delete;
+
+    // 每帧开头：读回已完成的帧，换下一个帧槽
+    void BeginFrame();
+    // 返回区间句柄；关掉时返回 -1，End(-1) 什么都不做
+    int Begin(const char* name);
+    void End(int scope);
+
+    void SetEnabled(bool enabled) { m_Enabled = enabled; }
+    bool IsEnabled() const { return m_Enabled; }
+
+    // 先序（父在子前）；最近一帧没出现的区间排在最后，active = false
+    const std::vector<ScopeStats>& GetStats() const { return m_Stats; }
+    int ResolvedFrames() const { return m_ResolvedFrames; }
+    int DroppedFrames() const { return m_DroppedFrames; }
+
+    // CSV：每个区间一行汇总；JSON：汇总 + 每个区间的原始样本（按时间顺序）
+    bool ExportCsv(const std::string& path) const;
+    bool ExportJson(const std::string& path) const;
+
+    // 打开时清空上一次的 trace；关掉时还没读回的几帧不会再进 trace
+    void SetTraceCapture(bool capture);
+    bool IsTraceCapturing() const { return m_TraceCapture; }
+    const std::vector<CpuProfiler::ExternalEvent>& TraceEvents() const { return m_Trace; }
+
+    // 清空历史（查询对象保留）
+    void Reset();
+    // 删除所有查询对象；要在 GL 上下文销毁之前调用
+    void Destroy();
+
+private:
+    struct Record
+    {
+        int series = 0;
+        std::uint32_t begin = 0;
+        std::uint32_t end = 0;
+    };
+    struct FrameSlot
+    {
+        std::vector<Record> records;
+        bool pending = false;
+        bool calibrated = false;
+        std::int64_t cpuOffsetNs = 0;   // CPU 时间 - GPU 时间，这一帧开头量的
+    };
+    struct Series
+    {
+        std::string name;
+        std::string path;
+        int depth = 0;
+        std::vector<double> history;    // 环形
+        int next = 0;
+        int count = 0;
+        double lastMs = 0.0;
+    };
+
+    std::uint32_t AcquireQuery();
+    void Recycle(FrameSlot& slot);
+    bool Resolve(FrameSlot& slot);
+    void RebuildStats(const FrameSlot& latest);
+    int FindOrAddSeries(const std::string& path, const char* name, int depth);
+
+    bool m_Enabled = true;
+    FrameSlot m_Slots[kFrameLatency];
+    int m_Current = 0;
+    std::vector<int> m_Open;            // 当前打开的区间（m_Slots[m_Current].records 下标）
+    std::vector<std::uint32_t> m_FreeQueries;
+    std::vector<std::uint32_t> m_AllQueries;
+
+    std::vector<Series> m_Series;
+    std::unordered_map<std::string, int> m_SeriesIndex;
+    std::vector<ScopeStats> m_Stats;
+    int m_ResolvedFrames = 0;
+    int m_DroppedFrames = 0;
+
+    bool m_TraceCapture = false;
+    std::vector<CpuProfiler::ExternalEvent> m_Trace;
+};
+
+// RAII 区间：{ GpuScope scope("Bloom prefilter"); ... }
+class GpuScope
+{
+public:
+    explicit GpuScope(const char* name) : m_Scope(GpuProfiler::Global().Begin(name)) {}
+    ~GpuScope() { GpuProfiler::Global().End(m_Scope); }
+
+    GpuScope(const GpuScope&) = delete;
+    GpuScope& operator=(const GpuScope&) = delete;
+
+private:
+    int m_Scope;
+};
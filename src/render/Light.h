@@ -1,6 +1,9 @@
 #pragma once
 #include <glm/glm.hpp>
 
+// 和 pbr.frag / basic.frag 的 MAX_POINT_LIGHTS 一致；超出的灯光不上传
+constexpr int kMaxPointLights = 32;
+
 struct PointLight
 {
     glm::vec3 position{0.0f};
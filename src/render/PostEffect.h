@@ -0,0 +1,43 @@
+#pragma once
+#include <glm/glm.hpp>
+
+// 效果栈里的一个逐像素效果（按栈里的顺序依次作用）
+enum class PostEffectType
+{
+    Bloom,          // 叠加 BloomPass 的结果（要在 tonemap 之前才是 HDR 叠加）
+    Exposure,
+    Tonemap,        // HDR -> LDR + gamma 编码，之后的效果在显示空间
+    ColorGrade,
+    Invert,
+    Grayscale,
+    Vignette,
+    Dither,         // 一般放最后
+};
+
+enum class TonemapOperator
+{
+    Reinhard,
+    ACES,
+    Filmic,
+};
+
+struct PostEffect
+{
+    PostEffectType type = PostEffectType::Exposure;
+    bool enabled = true;
+
+    float bloomIntensity = 0.05f;                           // Bloom
+    float exposureEV = 0.0f;                                // Exposure（自动曝光时是补偿量）
+    bool autoExposure = true;                               // 用 AutoExposure 的平均亮度
+    float exposureKey = 0.18f;                              // 自动曝光把平均亮度映射到的中灰
+    TonemapOperator tonemap = TonemapOperator::Reinhard;    // Tonemap（换算子会换变体）
+    float gamma = 2.2f;
+    float contrast = 1.0f;                                  // ColorGrade
+    float saturation = 1.0f;
+    glm::vec3 colorFilter{1.0f, 1.0f, 1.0f};
+    float vignetteStrength = 0.35f;                         // Vignette 0..1
+    float ditherAmplitude = 1.0f;                           // Dither，单位 1/255
+
+    PostEffect() = default;
+    explicit PostEffect(PostEffectType t, bool on = true) : type(t), enabled(on) {}
+};
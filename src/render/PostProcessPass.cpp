@@ -1,15 +1,43 @@
 #include "PostProcessPass.h"
 
 #include "../Shader.h"
+#include "DrawStats.h"
+#include "GpuProfiler.h"
 
 #include <glad/glad.h>
 
-void PostProcessPass::Init(Shader* shader)
+#include <cmath>
+#include <cstdio>
+
+// Shader 在头文件里只有前置声明，构造/析构放这里
+PostProcessPass::PostProcessPass() = default;
+PostProcessPass::~PostProcessPass() = default;
+
+bool PostProcessPass::Init(const std::string& vertexPath, const std::string& fragmentPath)
 {
-    m_Shader = shader;
+    m_VertexPath = vertexPath;
+    m_FragmentPath = fragmentPath;
     if (!m_Vao) {
         glGenVertexArrays(1, &m_Vao);
     }
+
+    m_Enabled.clear();
+    for (const PostEffect& e : DefaultStack())
+        if (e.enabled) m_Enabled.push_back(e);
+
+    // 先把默认栈（带 bloom 和自动曝光）的变体编出来，第一帧不卡；失败说明 post.frag 本身有问题
+    std::string defines;
+    std::vector<glm::vec4> params;
+    int dropped = BuildVariant(m_Enabled, -1, -1, false, 0, defines, params);
+    Shader* shader = GetVariant(defines, dropped);
+
+    // 默认栈的 LUT 也先开始烘
+    if (m_UseLut)
+    {
+        int lutBegin, lutEnd;
+        PrepareLut(m_Enabled, lutBegin, lutEnd);
+    }
+    return shader && shader->GetRendererID();
 }
 
 void PostProcessPass::Shutdown()
@@ -18,32 +46,254 @@ void PostProcessPass::Shutdown()
         glDeleteVertexArrays(1, &m_Vao);
         m_Vao = 0;
     }
-    m_Shader = nullptr;
+    m_Variants.clear();
+    m_CurrentKey.clear();
+    m_Lut.Destroy();
+    m_LutActive = false;
+}
+
+std::vector<PostEffect> PostProcessPass::DefaultStack()
+{
+    std::vector<PostEffect> stack;
+    stack.emplace_back(PostEffectType::Bloom);
+    stack.emplace_back(PostEffectType::Exposure);
+    stack.emplace_back(PostEffectType::Tonemap);
+    stack.emplace_back(PostEffectType::ColorGrade, false);
+    stack.emplace_back(PostEffectType::Invert, false);
+    stack.emplace_back(PostEffectType::Grayscale, false);
+    stack.emplace_back(PostEffectType::Vignette);
+    stack.emplace_back(PostEffectType::Dither);
+    return stack;
+}
+
+const char* PostProcessPass::EffectName(PostEffectType type)
+{
+    switch (type)
+    {
+    case PostEffectType::Bloom:      return "Bloom";
+    case PostEffectType::Exposure:   return "Exposure";
+    case PostEffectType::Tonemap:    return "Tonemap";
+    case PostEffectType::ColorGrade: return "Color Grade";
+    case PostEffectType::Invert:     return "Invert";
+    case PostEffectType::Grayscale:  return "Grayscale";
+    case PostEffectType::Vignette:   return "Vignette";
+    case PostEffectType::Dither:     return "Dither";
+    }
+    return "Unknown";
+}
+
+bool PostProcessPass::FindLutRun(const std::vector<PostEffect>& enabled, int& begin, int& end)
+{
+    begin = end = -1;
+    for (int i = 0; i < (int)enabled.size(); ++i)
+    {
+        if (ColorLut::CanBake(enabled[i].type))
+        {
+            begin = i;
+            end = i + 1;
+            while (end < (int)enabled.size() && ColorLut::CanBake(enabled[end].type))
+                ++end;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool PostProcessPass::PrepareLut(const std::vector<PostEffect>& enabled, int& lutBegin, int& lutEnd)
+{
+    if (!FindLutRun(enabled, lutBegin, lutEnd))
+        return false;
+
+    // tonemap 本身可烘焙，第一段之前不可能已经 tonemap 过，输入总是 HDR
+    m_LutEffects.assign(enabled.begin() + lutBegin, enabled.begin() + lutEnd);
+    m_Lut.Request(m_LutEffects, true, m_LutSize);
+    m_Lut.Update();
+    return m_Lut.IsCurrent();
+}
+
+int PostProcessPass::BuildVariant(const std::vector<PostEffect>& enabled, int lutBegin, int lutEnd,
+                                  bool lutHdr, int lutSize, std::string& defines, std::vector<glm::vec4>& params)
+{
+    defines.clear();
+    params.clear();
+
+    int step = 0;
+    int dropped = 0;
+    char line[160];
+    for (int i = 0; i < (int)enabled.size(); ++i)
+    {
+        const PostEffect& e = enabled[i];
+        if (step >= kMaxEffects)
+        {
+            ++dropped;
+            continue;
+        }
+
+        const int p = (int)params.size();
+        if (i == lutBegin)
+        {
+            // 整段效果换成一次 LUT 采样
+            std::snprintf(line, sizeof(line), "#define POST_STEP%d(c) %s(c, u_EffectParams[%d])\n",
+                     step, lutHdr ? "applyColorLutLog" : "applyColorLut", p);
+            params.emplace_back(ColorLut::kShaperMinEV, ColorLut::kShaperMaxEV - ColorLut::kShaperMinEV,
+                                (float)lutSize, 0.0f);
+            defines += line;
+            ++step;
+            i = lutEnd - 1;
+            continue;
+        }
+
+        switch (e.type)
+        {
+        case PostEffectType::Bloom:
+            std::snprintf(line, sizeof(line), "#define POST_STEP%d(c) applyBloom(c, u_EffectParams[%d])\n", step, p);
+            params.emplace_back(e.bloomIntensity, 0.0f, 0.0f, 0.0f);
+            break;
+        case PostEffectType::Exposure:
+            std::snprintf(line, sizeof(line), "#define POST_STEP%d(c) %s(c, u_EffectParams[%d])\n", step,
+                     e.autoExposure ? "applyAutoExposure" : "applyExposure", p);
+            params.emplace_back(std::exp2(e.exposureEV), e.exposureKey, 0.0f, 0.0f);
+            break;
+        case PostEffectType::Tonemap:
+        {
+            const char* fn = e.tonemap == TonemapOperator::ACES   ? "tonemapACES"
+                           : e.tonemap == TonemapOperator::Filmic ? "tonemapFilmic"
+                                                                  : "tonemapReinhard";
+            std::snprintf(line, sizeof(line), "#define POST_STEP%d(c) %s(c, u_EffectParams[%d])\n", step, fn, p);
+            params.emplace_back(1.0f / (e.gamma > 0.01f ? e.gamma : 0.01f), 0.0f, 0.0f, 0.0f);
+            break;
+        }
+        case PostEffectType::ColorGrade:
+            std::snprintf(line, sizeof(line),
+                     "#define POST_STEP%d(c) applyColorGrade(c, u_EffectParams[%d], u_EffectParams[%d])\n",
+                     step, p, p + 1);
+            params.emplace_back(e.contrast, e.saturation, 0.0f, 0.0f);
+            params.emplace_back(e.colorFilter, 0.0f);
+            break;
+        case PostEffectType::Invert:
+            std::snprintf(line, sizeof(line), "#define POST_STEP%d(c) applyInvert(c)\n", step);
+            break;
+        case PostEffectType::Grayscale:
+            std::snprintf(line, sizeof(line), "#define POST_STEP%d(c) applyGrayscale(c)\n", step);
+            break;
+        case PostEffectType::Vignette:
+            std::snprintf(line, sizeof(line), "#define POST_STEP%d(c) applyVignette(c, u_EffectParams[%d])\n", step, p);
+            params.emplace_back(e.vignetteStrength, 0.0f, 0.0f, 0.0f);
+            break;
+        case PostEffectType::Dither:
+            std::snprintf(line, sizeof(line), "#define POST_STEP%d(c) applyDither(c, u_EffectParams[%d])\n", step, p);
+            params.emplace_back(e.ditherAmplitude, 0.0f, 0.0f, 0.0f);
+            break;
+        }
+        defines += line;
+        ++step;
+    }
+
+    // GLSL 不允许长度为 0 的数组
+    const int count = params.empty() ? 1 : (int)params.size();
+    std::snprintf(line, sizeof(line), "#define POST_PARAM_COUNT %d\n", count);
+    defines += line;
+    return dropped;
+}
+
+Shader* PostProcessPass::GetVariant(const std::string& defines, int dropped)
+{
+    auto it = m_Variants.find(defines);
+    if (it != m_Variants.end())
+        return it->second.get();
+
+    if (dropped > 0)
+        std::printf("[PostProcessPass] More than %d effects enabled, ignoring the last %d\n", kMaxEffects, dropped);
+    // 编译失败也缓存下来，免得每帧重编
+    std::unique_ptr<Shader> shader(new Shader(m_VertexPath, m_FragmentPath, defines));
+    if (!shader->GetRendererID())
+        std::printf("[PostProcessPass] Failed to compile variant:\n%s", defines.c_str());
+    else
+        std::printf("[PostProcessPass] Compiled variant #%d\n", (int)m_Variants.size() + 1);
+
+    Shader* result = shader.get();
+    m_Variants.emplace(defines, std::move(shader));
+    return result;
 }
 
 void PostProcessPass::Execute(std::uint32_t sceneColorTex,
                               int width,
                               int height,
-                              int mode,
-                              float vignetteStrength)
+                              const std::vector<PostEffect>& stack,
+                              std::uint32_t bloomTex,
+                              std::uint32_t exposureTex,
+                              const glm::vec2& sceneUvScale)
 {
-    if (!m_Shader || !m_Shader->GetRendererID()) return;
     if (width <= 0 || height <= 0) return;
 
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
-    glViewport(0, 0, width, height);
+    m_Enabled.clear();
+    for (const PostEffect& e : stack)
+    {
+        if (!e.enabled || (e.type == PostEffectType::Bloom && !bloomTex)) continue;
+        m_Enabled.push_back(e);
+        if (!exposureTex) m_Enabled.back().autoExposure = false;
+    }
+
+    int lutBegin = -1, lutEnd = -1;
+    {
+        // 烘好的 LUT 在这里上传成 3D 纹理
+        GpuScope scope("LUT upload");
+        m_LutActive = m_UseLut && PrepareLut(m_Enabled, lutBegin, lutEnd);
+    }
+    if (!m_LutActive) lutBegin = lutEnd = -1;
+
+    int dropped = BuildVariant(m_Enabled, lutBegin, lutEnd, m_Lut.HdrInput(), m_Lut.Size(),
+                               m_CurrentKey, m_Params);
+    // 全分辨率时不放大，锐化也不需要
+    const bool upscaling = sceneUvScale.x < 1.0f || sceneUvScale.y < 1.0f;
+    if (upscaling && m_UpscaleFilter == UpscaleFilter::EdgeAware)
+        m_CurrentKey += "#define POST_UPSCALE_SHARPEN\n";
+    Shader* shader = GetVariant(m_CurrentKey, dropped);
+    if (!shader || !shader->GetRendererID()) return;
+
     glDisable(GL_DEPTH_TEST);
 
-    m_Shader->Bind();
+    shader->Bind();
 
     glActiveTexture(GL_TEXTURE0);
+    DrawStats::BindTexture();
     glBindTexture(GL_TEXTURE_2D, sceneColorTex);
-    m_Shader->setUniform1i("u_SceneTex", 0);
-    m_Shader->setUniform1i("u_Mode", mode);
-    m_Shader->setUniform1f("u_VignetteStrength", vignetteStrength);
+    shader->setUniform1i("u_SceneTex", 0);
+    // 场景纹理按输出尺寸分配，有效区域是左下角的 sceneUvScale
+    shader->setUniform2f("u_SceneUvScale", sceneUvScale.x, sceneUvScale.y);
+    shader->setUniform2f("u_SceneTexel", 1.0f / (float)width, 1.0f / (float)height);
+    if (upscaling && m_UpscaleFilter == UpscaleFilter::EdgeAware)
+        shader->setUniform1f("u_UpscaleSharpness", m_UpscaleSharpness);
+    if (m_LutActive)
+    {
+        glActiveTexture(GL_TEXTURE1);
+        DrawStats::BindTexture();
+        glBindTexture(GL_TEXTURE_3D, m_Lut.GetTexture());
+        shader->setUniform1i("u_ColorLut", 1);
+        glActiveTexture(GL_TEXTURE0);
+    }
+    if (bloomTex)
+    {
+        glActiveTexture(GL_TEXTURE2);
+        DrawStats::BindTexture();
+        glBindTexture(GL_TEXTURE_2D, bloomTex);
+        shader->setUniform1i("u_BloomTex", 2);
+        glActiveTexture(GL_TEXTURE0);
+    }
+    if (exposureTex)
+    {
+        glActiveTexture(GL_TEXTURE3);
+        DrawStats::BindTexture();
+        glBindTexture(GL_TEXTURE_2D, exposureTex);
+        shader->setUniform1i("u_ExposureTex", 3);
+        glActiveTexture(GL_TEXTURE0);
+    }
+    if (!m_Params.empty())
+        shader->setUniform4fv("u_EffectParams", (int)m_Params.size(), &m_Params[0].x);
 
+    GpuScope scope("Fused draw");
+    DrawStats::BindVertexArray();
     glBindVertexArray(m_Vao);
-    glDrawArrays(GL_TRIANGLES, 0, 3);
+    DrawStats::DrawArrays(GL_TRIANGLES, 0, 3);
     glBindVertexArray(0);
 }
-
@@ -1,22 +1,102 @@
 #pragma once
 #include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "ColorLut.h"
+#include "PostEffect.h"
 
 class Shader;
 
+// PostProcessPass：把效果栈融合成一个全屏 pass
+// - 每种“启用的效果序列”（含 tonemap 算子）生成一组 POST_STEPn 宏，编出一个 post.frag 变体并缓存
+// - 不管开了几个效果，每帧都只读一次场景纹理、写一次目标
+// - 参数每帧用一次 glUniform4fv 上传，调参数不会触发重新编译
+// - 开启 LUT 时，第一段连续的纯颜色效果（tonemap/调色/反色/灰度）由 ColorLut 在工作线程烘成 3D LUT，
+//   shader 里换成一次三线性采样；LUT 没烘好（或参数刚变）的几帧先走 ALU 路径，结果一样
+// 目标 FBO 和视口由调用方设置（RenderGraph 的 pass）
 class PostProcessPass
 {
 public:
-    void Init(Shader* shader);
+    static constexpr int kMaxEffects = 8;   // post.frag 里展开的 POST_STEP 个数
+
+    PostProcessPass();
+    ~PostProcessPass();
+
+    PostProcessPass(const PostProcessPass&) = delete;
+    PostProcessPass& operator=(const PostProcessPass&) = delete;
+
+    bool Init(const std::string& vertexPath, const std::string& fragmentPath);
     void Shutdown();
 
+    // 动态分辨率时场景只占 sceneColorTex 的一部分，放大用的滤波
+    enum class UpscaleFilter
+    {
+        Bilinear,
+        EdgeAware,      // 双线性 + 按局部对比度锐化（多 4 次采样）
+    };
+
+    // bloomTex 为 0 时跳过栈里的 Bloom 效果；exposureTex 为 0 时自动曝光退回手动 EV
+    // sceneUvScale：场景有效区域占 sceneColorTex 的比例，小于 1 时按 UpscaleFilter 放大到 width x height
     void Execute(std::uint32_t sceneColorTex,
                  int width,
                  int height,
-                 int mode,
-                 float vignetteStrength);
+                 const std::vector<PostEffect>& stack,
+                 std::uint32_t bloomTex = 0,
+                 std::uint32_t exposureTex = 0,
+                 const glm::vec2& sceneUvScale = glm::vec2(1.0f));
+
+    // 默认栈：Bloom + 自动曝光 + Reinhard + gamma 2.2 + 暗角 + 抖动，调色 / 反相 / 灰度默认关闭
+    // 只有色调映射、gamma 和暗角沿用旧版 post.frag；关掉 Bloom 和 Dither、曝光改回手动 0 EV 才和它的结果一样
+    static std::vector<PostEffect> DefaultStack();
+    static const char* EffectName(PostEffectType type);
+
+    // LUT 边长 32 或 64（其它值会被 ColorLut 夹住）
+    void SetLutEnabled(bool enabled) { m_UseLut = enabled; }
+    void SetLutSize(int size) { m_LutSize = size; }
+    bool IsLutEnabled() const { return m_UseLut; }
+    int GetLutSize() const { return m_LutSize; }
+    // 上一次 Execute 是否真的用了 LUT
+    bool IsLutActive() const { return m_LutActive; }
+    const ColorLut& GetLut() const { return m_Lut; }
+
+    void SetUpscaleFilter(UpscaleFilter filter) { m_UpscaleFilter = filter; }
+    UpscaleFilter GetUpscaleFilter() const { return m_UpscaleFilter; }
+    void SetUpscaleSharpness(float sharpness) { m_UpscaleSharpness = sharpness; }
+    float GetUpscaleSharpness() const { return m_UpscaleSharpness; }
+
+    int VariantCount() const { return (int)m_Variants.size(); }
+    // 上一次 Execute 用的变体（宏定义文本）
+    const std::string& CurrentVariant() const { return m_CurrentKey; }
 
 private:
-    Shader* m_Shader = nullptr;
+    // 启用的效果里第一段连续的可烘焙效果 [begin, end)
+    static bool FindLutRun(const std::vector<PostEffect>& enabled, int& begin, int& end);
+    // 找到可烘焙的一段就请求 LUT 并上传烘好的结果，返回 LUT 是否可用
+    bool PrepareLut(const std::vector<PostEffect>& enabled, int& lutBegin, int& lutEnd);
+    // 启用的效果 -> 宏定义 + 参数；[lutBegin, lutEnd) 换成一次 LUT 采样（lutBegin < 0 表示不用）
+    // 返回超出 kMaxEffects 被丢掉的效果数
+    static int BuildVariant(const std::vector<PostEffect>& enabled, int lutBegin, int lutEnd,
+                            bool lutHdr, int lutSize, std::string& defines, std::vector<glm::vec4>& params);
+    // 没编过的变体现编，编译结果（包括失败）按宏定义文本缓存
+    Shader* GetVariant(const std::string& defines, int dropped);
+
+    std::string m_VertexPath;
+    std::string m_FragmentPath;
+    std::unordered_map<std::string, std::unique_ptr<Shader>> m_Variants;
+    std::string m_CurrentKey;
+    std::vector<glm::vec4> m_Params;
+    std::vector<PostEffect> m_Enabled;      // 每帧复用
+    std::vector<PostEffect> m_LutEffects;
+
+    ColorLut m_Lut;
+    bool m_UseLut = true;
+    int m_LutSize = 32;
+    bool m_LutActive = false;
+    UpscaleFilter m_UpscaleFilter = UpscaleFilter::EdgeAware;
+    float m_UpscaleSharpness = 0.5f;
     std::uint32_t m_Vao = 0;
 };
-
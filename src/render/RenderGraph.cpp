@@ -0,0 +1,556 @@
+#include "RenderGraph.h"
+#include "DrawStats.h"
+#include "GpuProfiler.h"
+#include "../CpuProfiler.h"
+
+#include <glad/glad.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+std::uint32_t RenderGraph::PassContext::Texture(ResourceId id) const
+{
+    return graph ? graph->TargetOf(id).texture : 0;
+}
+
+// ---------------- PassBuilder ----------------
+
+RenderGraph::PassBuilder& RenderGraph::PassBuilder::Read(ResourceId id)
+{
+    if (m_Graph->ValidResource(id)) m_Graph->m_Passes[m_Pass].reads.push_back(id);
+    return *this;
+}
+
+RenderGraph::PassBuilder& RenderGraph::PassBuilder::WriteColor(ResourceId id, LoadOp op)
+{
+    if (m_Graph->ValidResource(id)) m_Graph->m_Passes[m_Pass].colors.push_back({ id, op });
+    return *this;
+}
+
+RenderGraph::PassBuilder& RenderGraph::PassBuilder::WriteDepth(ResourceId id, LoadOp op)
+{
+    if (m_Graph->ValidResource(id)) m_Graph->m_Passes[m_Pass].depth = { id, op };
+    return *this;
+}
+
+RenderGraph::PassBuilder& RenderGraph::PassBuilder::SetClearColor(const glm::vec4& color)
+{
+    m_Graph->m_Passes[m_Pass].clearColor = color;
+    return *this;
+}
+
+RenderGraph::PassBuilder& RenderGraph::PassBuilder::SetClearDepth(float depth)
+{
+    m_Graph->m_Passes[m_Pass].clearDepth = depth;
+    return *this;
+}
+
+RenderGraph::PassBuilder& RenderGraph::PassBuilder::SetSideEffect()
+{
+    m_Graph->m_Passes[m_Pass].sideEffect = true;
+    return *this;
+}
+
+// ---------------- 声明 ----------------
+
+RenderGraph::~RenderGraph()
+{
+    Destroy();
+}
+
+void RenderGraph::BeginFrame()
+{
+    m_Passes.clear();
+    m_Resources.clear();
+    m_Order.clear();
+    m_Compiled = false;
+    m_Frame++;
+}
+
+RenderGraph::ResourceId RenderGraph::CreateTexture(const std::string& name, const RenderTargetDesc& desc)
+{
+    Resource r;
+    r.name = name;
+    r.desc = desc;
+    m_Resources.push_back(r);
+    return (ResourceId)m_Resources.size() - 1;
+}
+
+RenderGraph::ResourceId RenderGraph::ImportTexture(const std::string& name, std::uint32_t texture,
+                                                   const RenderTargetDesc& desc)
+{
+    Resource r;
+    r.name = name;
+    r.desc = desc;
+    r.imported = true;
+    r.importedTexture = texture;
+    m_Resources.push_back(r);
+    return (ResourceId)m_Resources.size() - 1;
+}
+
+RenderGraph::ResourceId RenderGraph::ImportBackbuffer(const std::string& name, int width, int height)
+{
+    Resource r;
+    r.name = name;
+    r.desc = { width, height, GL_RGBA8, 0 };
+    r.imported = true;
+    r.backbuffer = true;
+    r.output = true;
+    m_Resources.push_back(r);
+    return (ResourceId)m_Resources.size() - 1;
+}
+
+void RenderGraph::MarkOutput(ResourceId id)
+{
+    if (ValidResource(id)) m_Resources[id].output = true;
+}
+
+RenderGraph::PassBuilder RenderGraph::AddPass(const std::string& name, ExecuteFn execute)
+{
+    Pass p;
+    p.name = name;
+    p.execute = std::move(execute);
+    m_Passes.push_back(std::move(p));
+    m_Compiled = false;
+    return PassBuilder(this, (int)m_Passes.size() - 1);
+}
+
+bool RenderGraph::Writes(const Pass& pass, ResourceId id) const
+{
+    if (pass.depth.id == id) return true;
+    for (const Attachment& a : pass.colors)
+        if (a.id == id) return true;
+    return false;
+}
+
+bool RenderGraph::Reads(const Pass& pass, ResourceId id) const
+{
+    if (std::find(pass.reads.begin(), pass.reads.end(), id) != pass.reads.end()) return true;
+    if (pass.depth.id == id && pass.depth.op == LoadOp::Load) return true;
+    for (const Attachment& a : pass.colors)
+        if (a.id == id && a.op == LoadOp::Load) return true;
+    return false;
+}
+
+RenderTarget RenderGraph::TargetOf(ResourceId id) const
+{
+    RenderTarget t;
+    if (!ValidResource(id)) return t;
+    const Resource& r = m_Resources[id];
+    if (r.imported) {
+        t.texture = r.importedTexture;
+        t.desc = r.desc;
+        return t;
+    }
+    return r.target;
+}
+
+// ---------------- Compile ----------------
+
+bool RenderGraph::Compile()
+{
+    const int n = (int)m_Passes.size();
+    m_Order.clear();
+
+    // 1) 依赖：orderDeps 决定先后，liveDeps 决定"要用到谁的结果"
+    std::vector<std::vector<int>> orderDeps(n), liveDeps(n);
+    auto addDep = [](std::vector<int>& deps, int p) {
+        if (std::find(deps.begin(), deps.end(), p) == deps.end()) deps.push_back(p);
+    };
+
+    for (int p = 0; p < n; ++p)
+    {
+        const Pass& pass = m_Passes[p];
+        for (ResourceId r = 0; r < (ResourceId)m_Resources.size(); ++r)
+        {
+            bool reads = Reads(pass, r);
+            bool writes = Writes(pass, r);
+            if (!reads && !writes) continue;
+
+            // 之前最近的写入者；没有的话（消费者先声明）依赖所有写入者
+            int lastWriter = -1;
+            for (int q = 0; q < p; ++q)
+                if (Writes(m_Passes[q], r)) lastWriter = q;
+
+            if (reads)
+            {
+                if (lastWriter >= 0) {
+                    addDep(orderDeps[p], lastWriter);
+                    addDep(liveDeps[p], lastWriter);
+                } else {
+                    for (int q = p + 1; q < n; ++q)
+                        if (Writes(m_Passes[q], r)) {
+                            addDep(orderDeps[p], q);
+                            addDep(liveDeps[p], q);
+                        }
+                }
+            }
+            if (writes)
+            {
+                // 写后写：按声明顺序；读后写：之前读旧内容的 pass 要先执行
+                // （读的是之后才声明的写入者的，不算，否则先声明消费者会成环）
+                if (lastWriter >= 0) addDep(orderDeps[p], lastWriter);
+                for (int q = 0; q < p; ++q)
+                {
+                    if (!Reads(m_Passes[q], r)) continue;
+                    for (int w = 0; w < q; ++w)
+                        if (Writes(m_Passes[w], r)) { addDep(orderDeps[p], q); break; }
+                }
+            }
+        }
+    }
+
+    // 2) 剔除：从输出往回标记
+    std::vector<int> stack;
+    for (int p = 0; p < n; ++p)
+    {
+        Pass& pass = m_Passes[p];
+        pass.live = pass.sideEffect;
+        for (ResourceId r = 0; r < (ResourceId)m_Resources.size() && !pass.live; ++r)
+            if (m_Resources[r].output && Writes(pass, r)) pass.live = true;
+        if (pass.live) stack.push_back(p);
+    }
+    while (!stack.empty())
+    {
+        int p = stack.back();
+        stack.pop_back();
+        for (int d : liveDeps[p])
+        {
+            if (m_Passes[d].live) continue;
+            m_Passes[d].live = true;
+            stack.push_back(d);
+        }
+    }
+
+    // 3) 拓扑排序（只排存活的），同时可执行时按声明顺序
+    std::vector<int> remaining(n, 0);
+    for (int p = 0; p < n; ++p)
+    {
+        if (!m_Passes[p].live) continue;
+        for (int d : orderDeps[p])
+            if (m_Passes[d].live) remaining[p]++;
+    }
+    std::vector<bool> done(n, false);
+    for (;;)
+    {
+        int next = -1;
+        for (int p = 0; p < n; ++p)
+            if (m_Passes[p].live && !done[p] && remaining[p] == 0) { next = p; break; }
+        if (next < 0) break;
+
+        done[next] = true;
+        m_Order.push_back(next);
+        for (int p = 0; p < n; ++p)
+            if (m_Passes[p].live && !done[p] &&
+                std::find(orderDeps[p].begin(), orderDeps[p].end(), next) != orderDeps[p].end())
+                remaining[p]--;
+    }
+
+    bool ok = true;
+    int liveCount = 0;
+    for (const Pass& pass : m_Passes) liveCount += pass.live ? 1 : 0;
+    if ((int)m_Order.size() != liveCount)
+    {
+        // 环：只会出现在"先声明消费者"互相引用时；退回声明顺序
+        std::fprintf(stderr, "[RenderGraph] Dependency cycle, falling back to declaration order\n");
+        m_Order.clear();
+        for (int p = 0; p < n; ++p)
+            if (m_Passes[p].live) m_Order.push_back(p);
+        ok = false;
+    }
+
+    // 4) 生命周期（执行顺序下标）
+    for (Resource& r : m_Resources) r.firstPass = r.lastPass = -1;
+    for (int k = 0; k < (int)m_Order.size(); ++k)
+    {
+        Pass& pass = m_Passes[m_Order[k]];
+        pass.order = k;
+        auto touch = [&](ResourceId id) {
+            if (!ValidResource(id)) return;
+            Resource& r = m_Resources[id];
+            if (r.firstPass < 0) r.firstPass = k;
+            r.lastPass = k;
+        };
+        for (ResourceId id : pass.reads) touch(id);
+        for (const Attachment& a : pass.colors) touch(a.id);
+        touch(pass.depth.id);
+    }
+
+    // 5) 合并：和上一个 pass 附件完全相同、且不采样自己的附件
+    int group = -1;
+    for (int k = 0; k < (int)m_Order.size(); ++k)
+    {
+        Pass& pass = m_Passes[m_Order[k]];
+        pass.mergedWithPrevious = false;
+        bool hasAttachments = !pass.colors.empty() || pass.depth.id != kInvalidResource;
+        if (k > 0 && hasAttachments)
+        {
+            const Pass& prev = m_Passes[m_Order[k - 1]];
+            bool same = prev.depth.id == pass.depth.id && prev.colors.size() == pass.colors.size();
+            for (std::size_t i = 0; i < pass.colors.size() && same; ++i)
+                same = prev.colors[i].id == pass.colors[i].id;
+            for (ResourceId id : pass.reads)
+                if (Writes(pass, id)) same = false;
+            pass.mergedWithPrevious = same;
+        }
+        if (!pass.mergedWithPrevious) group++;
+        pass.group = group;
+    }
+    for (Pass& pass : m_Passes)
+        if (!pass.live) { pass.order = -1; pass.group = -1; pass.mergedWithPrevious = false; }
+
+    m_Compiled = true;
+    return ok;
+}
+
+// ---------------- Execute ----------------
+
+void RenderGraph::PollTimers()
+{
+    for (auto& kv : m_Timers)
+    {
+        PassTimer& t = kv.second;
+        // 从最老的开始，最新读回的结果留在 gpuMs 里
+        for (int i = 0; i < kQueryRing; ++i)
+        {
+            int slot = (t.next + i) % kQueryRing;
+            if (!t.pending[slot]) continue;
+            GLint available = 0;
+            glGetQueryObjectiv(t.queries[slot], GL_QUERY_RESULT_AVAILABLE, &available);
+            if (!available) continue;
+            GLuint64 ns = 0;
+            glGetQueryObjectui64v(t.queries[slot], GL_QUERY_RESULT, &ns);
+            t.gpuMs = (double)ns / 1.0e6;
+            t.pending[slot] = false;
+        }
+    }
+}
+
+void RenderGraph::Execute(RenderTargetPool& pool)
+{
+    if (!m_Compiled) Compile();
+    PollTimers();
+
+    m_FrameStats = FrameStats{};
+    std::vector<double> cpuMs(m_Passes.size(), 0.0);
+
+    for (int k = 0; k < (int)m_Order.size(); ++k)
+    {
+        const int p = m_Order[k];
+        Pass& pass = m_Passes[p];
+
+        // 1) 这个 pass 第一次用到的临时纹理
+        for (Resource& r : m_Resources)
+        {
+            if (r.imported || r.firstPass != k) continue;
+            r.target = pool.Acquire(r.desc);
+            m_FrameStats.transientTextures++;
+        }
+
+        // 2) 绑定附件（合并组里只有第一个 pass 绑）
+        PassContext ctx;
+        ctx.graph = this;
+        ResourceId first = !pass.colors.empty() ? pass.colors[0].id : pass.depth.id;
+        if (ValidResource(first)) {
+            ctx.width = m_Resources[first].desc.width;
+            ctx.height = m_Resources[first].desc.height;
+        }
+
+        if (ValidResource(first) && !pass.mergedWithPrevious)
+        {
+            GLuint fbo = 0;
+            if (!m_Resources[first].backbuffer)
+            {
+                RenderTarget colors[4];
+                int colorCount = std::min((int)pass.colors.size(), 4);
+                for (int i = 0; i < colorCount; ++i)
+                    colors[i] = TargetOf(pass.colors[i].id);
+                RenderTarget depth = TargetOf(pass.depth.id);
+                fbo = pool.GetFramebuffer(colors, colorCount, depth.Valid() ? &depth : nullptr);
+            }
+            DrawStats::BindFramebuffer(fbo);
+            glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+            glViewport(0, 0, ctx.width, ctx.height);
+            m_FrameStats.groups++;
+        }
+
+        // 3) Clear
+        for (int i = 0; i < (int)pass.colors.size(); ++i)
+            if (pass.colors[i].op == LoadOp::Clear)
+                glClearBufferfv(GL_COLOR, i, &pass.clearColor.x);
+        if (pass.depth.id != kInvalidResource && pass.depth.op == LoadOp::Clear)
+        {
+            glDepthMask(GL_TRUE);
+            std::uint32_t format = m_Resources[pass.depth.id].desc.format;
+            if (format == GL_DEPTH24_STENCIL8 || format == GL_DEPTH32F_STENCIL8)
+                glClearBufferfi(GL_DEPTH_STENCIL, 0, pass.clearDepth, 0);
+            else
+                glClearBufferfv(GL_DEPTH, 0, &pass.clearDepth);
+        }
+
+        // 4) 执行 + 计时（上一轮的查询还没读回就跳过这一帧的 GPU 计时）
+        // 图自己的 TIME_ELAPSED 给 GetFrameStats 用；GpuProfiler 的区间让 pass 内部可以再嵌套
+        const int profilerScope = GpuProfiler::Global().Begin(pass.name.c_str());
+        PassTimer& timer = m_Timers[pass.name];
+        int slot = timer.next;
+        bool timed = !timer.pending[slot];
+        if (timed) {
+            if (!timer.queries[slot]) glGenQueries(1, &timer.queries[slot]);
+            glBeginQuery(GL_TIME_ELAPSED, timer.queries[slot]);
+        }
+
+        auto t0 = std::chrono::high_resolution_clock::now();
+        {
+            PROFILE_ZONE_STRING(pass.name);
+            if (pass.execute) pass.execute(ctx);
+        }
+        auto t1 = std::chrono::high_resolution_clock::now();
+        cpuMs[p] = std::chrono::duration<double, std::milli>(t1 - t0).count();
+
+        if (timed) {
+            glEndQuery(GL_TIME_ELAPSED);
+            timer.pending[slot] = true;
+            timer.next = (slot + 1) % kQueryRing;
+        }
+        GpuProfiler::Global().End(profilerScope);
+
+        // 5) 最后一次使用之后马上还给池子，后面的 pass 可以复用这块显存
+        for (Resource& r : m_Resources)
+            if (!r.imported && r.lastPass == k) pool.Release(r.target);
+    }
+
+    // 没被任何存活 pass 用到的临时纹理不会分配
+    BuildInfos();
+    for (std::size_t p = 0; p < m_Passes.size(); ++p)
+    {
+        m_PassInfos[p].cpuMs = cpuMs[p];
+        m_FrameStats.cpuMs += cpuMs[p];
+        m_FrameStats.gpuMs += m_PassInfos[p].gpuMs;
+    }
+
+    if (!m_DumpPath.empty())
+    {
+        if (WriteJson(m_DumpPath))
+            std::printf("[RenderGraph] Frame %llu dumped to %s\n", (unsigned long long)m_Frame, m_DumpPath.c_str());
+        m_DumpPath.clear();
+    }
+}
+
+void RenderGraph::BuildInfos()
+{
+    m_PassInfos.clear();
+    m_ResourceInfos.clear();
+
+    for (const Pass& pass : m_Passes)
+    {
+        PassInfo info;
+        info.name = pass.name;
+        info.culled = !pass.live;
+        info.order = pass.order;
+        info.group = pass.group;
+        for (ResourceId id : pass.reads) info.reads.push_back(m_Resources[id].name);
+        for (const Attachment& a : pass.colors) info.writes.push_back(m_Resources[a.id].name);
+        if (pass.depth.id != kInvalidResource) info.writes.push_back(m_Resources[pass.depth.id].name);
+        auto it = m_Timers.find(pass.name);
+        if (pass.live && it != m_Timers.end()) info.gpuMs = it->second.gpuMs;
+
+        m_FrameStats.passes++;
+        if (!pass.live) m_FrameStats.culledPasses++;
+        m_PassInfos.push_back(std::move(info));
+    }
+
+    for (const Resource& r : m_Resources)
+    {
+        ResourceInfo info;
+        info.name = r.name;
+        info.desc = r.desc;
+        info.imported = r.imported;
+        info.backbuffer = r.backbuffer;
+        info.used = r.firstPass >= 0;
+        info.firstPass = r.firstPass;
+        info.lastPass = r.lastPass;
+        info.texture = r.imported ? r.importedTexture : 0;
+        m_ResourceInfos.push_back(info);
+    }
+}
+
+// 名字都来自代码里的字面量，只需要转义引号和反斜杠
+static void WriteJsonString(std::FILE* f, const std::string& s)
+{
+    std::fputc('"', f);
+    for (char c : s)
+    {
+        if (c == '"' || c == '\\') std::fputc('\\', f);
+        std::fputc(c, f);
+    }
+    std::fputc('"', f);
+}
+
+static void WriteJsonStringArray(std::FILE* f, const std::vector<std::string>& items)
+{
+    std::fputc('[', f);
+    for (std::size_t i = 0; i < items.size(); ++i)
+    {
+        if (i) std::fputs(", ", f);
+        WriteJsonString(f, items[i]);
+    }
+    std::fputc(']', f);
+}
+
+bool RenderGraph::WriteJson(const std::string& path) const
+{
+    std::FILE* f = std::fopen(path.c_str(), "wb");
+    if (!f) {
+        std::fprintf(stderr, "[RenderGraph] Cannot write %s\n", path.c_str());
+        return false;
+    }
+
+    std::fprintf(f, "{\n  \"frame\": %llu,\n", (unsigned long long)m_Frame);
+    std::fprintf(f, "  \"stats\": { \"passes\": %d, \"culled\": %d, \"fboBinds\": %d, \"transientTextures\": %d, "
+                    "\"cpuMs\": %.4f, \"gpuMs\": %.4f },\n",
+                 m_FrameStats.passes, m_FrameStats.culledPasses, m_FrameStats.groups,
+                 m_FrameStats.transientTextures, m_FrameStats.cpuMs, m_FrameStats.gpuMs);
+
+    std::fprintf(f, "  \"passes\": [\n");
+    for (std::size_t i = 0; i < m_PassInfos.size(); ++i)
+    {
+        const PassInfo& p = m_PassInfos[i];
+        std::fprintf(f, "    { \"name\": ");
+        WriteJsonString(f, p.name);
+        std::fprintf(f, ", \"culled\": %s, \"order\": %d, \"group\": %d, \"reads\": ",
+                     p.culled ? "true" : "false", p.order, p.group);
+        WriteJsonStringArray(f, p.reads);
+        std::fprintf(f, ", \"writes\": ");
+        WriteJsonStringArray(f, p.writes);
+        std::fprintf(f, ", \"cpuMs\": %.4f, \"gpuMs\": %.4f }%s\n",
+                     p.cpuMs, p.gpuMs, i + 1 < m_PassInfos.size() ? "," : "");
+    }
+    std::fprintf(f, "  ],\n");
+
+    std::fprintf(f, "  \"resources\": [\n");
+    for (std::size_t i = 0; i < m_ResourceInfos.size(); ++i)
+    {
+        const ResourceInfo& r = m_ResourceInfos[i];
+        std::fprintf(f, "    { \"name\": ");
+        WriteJsonString(f, r.name);
+        std::fprintf(f, ", \"width\": %d, \"height\": %d, \"format\": \"0x%X\", \"samples\": %d, "
+                        "\"kind\": \"%s\", \"used\": %s, \"firstPass\": %d, \"lastPass\": %d }%s\n",
+                     r.desc.width, r.desc.height, r.desc.format, r.desc.samples,
+                     r.backbuffer ? "backbuffer" : (r.imported ? "imported" : "transient"),
+                     r.used ? "true" : "false", r.firstPass, r.lastPass,
+                     i + 1 < m_ResourceInfos.size() ? "," : "");
+    }
+    std::fprintf(f, "  ]\n}\n");
+
+    bool ok = std::ferror(f) == 0;
+    std::fclose(f);
+    return ok;
+}
+
+void RenderGraph::Destroy()
+{
+    for (auto& kv : m_Timers)
+        for (std::uint32_t& q : kv.second.queries)
+            if (q) { glDeleteQueries(1, &q); q = 0; }
+    m_Timers.clear();
+}
@@ -0,0 +1,206 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "RenderTargetPool.h"
+
+// RenderGraph：每帧重新声明的 pass 图
+// 用法（每帧）：
+//   graph.BeginFrame();
+//   auto color = graph.CreateTexture("SceneColor", { w, h, GL_RGB16F, 0 });
+//   auto back  = graph.ImportBackbuffer("Backbuffer", w, h);
+//   graph.AddPass("Scene", [&](const RenderGraph::PassContext&) { ... })
+//        .WriteColor(color, RenderGraph::LoadOp::Clear);
+//   graph.AddPass("Post", ...).Read(color).WriteColor(back, RenderGraph::LoadOp::DontCare);
+//   graph.Compile();
+//   graph.Execute(pool);
+// Compile：
+// - 按读写关系排序（写在读之前、同一资源的写按声明顺序）
+// - 从输出（backbuffer、MarkOutput 的导入资源、SetSideEffect 的 pass）往回找，没人用到结果的 pass 直接剔除
+// - 临时纹理按排序后的首次/末次使用从 RenderTargetPool 借还，生命周期不重叠的共用显存
+// - 相邻、附件完全相同、且不读自己附件的 pass 合并成一组，只绑一次 FBO
+// Execute：每个 pass 记 CPU 时间和 GPU 时间（GL_TIME_ELAPSED，环形查询，几帧后非阻塞读回）
+class RenderGraph
+{
+public:
+    using ResourceId = int;
+    static constexpr ResourceId kInvalidResource = -1;
+
+    // 附件在 pass 开始时怎么处理
+    enum class LoadOp
+    {
+        Load,       // 保留之前的内容（依赖之前的写入者）
+        Clear,      // 清成 pass 的 clear 值
+        DontCare,   // 会被整个覆盖（比如全屏 pass）
+    };
+
+    struct PassContext
+    {
+        int width = 0;          // 附件尺寸（没有附件时为 0）
+        int height = 0;
+        const RenderGraph* graph = nullptr;
+
+        // 资源当前对应的 GL 纹理（backbuffer 为 0）
+        std::uint32_t Texture(ResourceId id) const;
+    };
+    using ExecuteFn = std::function<void(const PassContext&)>;
+
+    // AddPass 返回的声明接口，链式调用
+    class PassBuilder
+    {
+    public:
+        PassBuilder& Read(ResourceId id);
+        PassBuilder& WriteColor(ResourceId id, LoadOp op = LoadOp::Load);
+        PassBuilder& WriteDepth(ResourceId id, LoadOp op = LoadOp::Load);
+        PassBuilder& SetClearColor(const glm::vec4& color);
+        PassBuilder& SetClearDepth(float depth);
+        // 结果不经过图里的资源（比如只读回 CPU），永远不剔除
+        PassBuilder& SetSideEffect();
+
+    private:
+        friend class RenderGraph;
+        PassBuilder(RenderGraph* graph, int pass) : m_Graph(graph), m_Pass(pass) {}
+        RenderGraph* m_Graph;
+        int m_Pass;
+    };
+
+    // 上一次 Execute 的每个 pass（给界面和导出用）
+    struct PassInfo
+    {
+        std::string name;
+        bool culled = false;
+        int order = -1;         // 执行顺序，剔除的为 -1
+        int group = -1;         // 合并组（同组只绑一次 FBO）
+        std::vector<std::string> reads;
+        std::vector<std::string> writes;
+        double cpuMs = 0.0;     // 本帧 execute 回调的 CPU 时间
+        double gpuMs = 0.0;     // 最近一次读回的 GPU 时间（几帧前）
+    };
+
+    struct ResourceInfo
+    {
+        std::string name;
+        RenderTargetDesc desc;
+        bool imported = false;
+        bool backbuffer = false;
+        bool used = false;      // 剔除后还有 pass 用到
+        int firstPass = -1;     // 执行顺序下标
+        int lastPass = -1;
+        std::uint32_t texture = 0;
+    };
+
+    struct FrameStats
+    {
+        int passes = 0;
+        int culledPasses = 0;
+        int groups = 0;         // 实际 FBO 绑定次数
+        int transientTextures = 0;
+        double cpuMs = 0.0;
+        double gpuMs = 0.0;
+    };
+
+    RenderGraph() = default;
+    ~RenderGraph();
+
+    RenderGraph(const RenderGraph&) = delete;
+    RenderGraph& operator=(const RenderGraph&) = delete;
+
+    // 清掉上一帧的 pass 和资源（计时查询保留）
+    void BeginFrame();
+
+    ResourceId CreateTexture(const std::string& name, const RenderTargetDesc& desc);
+    ResourceId ImportTexture(const std::string& name, std::uint32_t texture, const RenderTargetDesc& desc);
+    // 默认帧缓冲：写它的 pass 是图的输出
+    ResourceId ImportBackbuffer(const std::string& name, int width, int height);
+    // 导入的资源在帧结束后还要用（写它的 pass 不剔除）
+    void MarkOutput(ResourceId id);
+
+    PassBuilder AddPass(const std::string& name, ExecuteFn execute);
+
+    bool Compile();
+    void Execute(RenderTargetPool& pool);
+
+    // 下一次 Execute 之后把整张图（含计时）写成 JSON
+    void RequestDump(const std::string& path) { m_DumpPath = path; }
+    bool WriteJson(const std::string& path) const;
+
+    const std::vector<PassInfo>& GetPassInfos() const { return m_PassInfos; }
+    const std::vector<ResourceInfo>& GetResourceInfos() const { return m_ResourceInfos; }
+    const FrameStats& GetFrameStats() const { return m_FrameStats; }
+    std::uint64_t FrameIndex() const { return m_Frame; }
+
+    // 释放计时查询；需要在 GL 上下文销毁前调用
+    void Destroy();
+
+private:
+    struct Attachment
+    {
+        ResourceId id = kInvalidResource;
+        LoadOp op = LoadOp::Load;
+    };
+
+    struct Pass
+    {
+        std::string name;
+        ExecuteFn execute;
+        std::vector<ResourceId> reads;
+        std::vector<Attachment> colors;
+        Attachment depth;
+        glm::vec4 clearColor{0.0f, 0.0f, 0.0f, 1.0f};
+        float clearDepth = 1.0f;
+        bool sideEffect = false;
+
+        // Compile 结果
+        bool live = false;
+        bool mergedWithPrevious = false;
+        int order = -1;
+        int group = -1;
+    };
+
+    struct Resource
+    {
+        std::string name;
+        RenderTargetDesc desc;
+        bool imported = false;
+        bool backbuffer = false;
+        bool output = false;
+        std::uint32_t importedTexture = 0;
+
+        // Compile / Execute
+        int firstPass = -1;
+        int lastPass = -1;
+        RenderTarget target;
+    };
+
+    static constexpr int kQueryRing = 4;
+    struct PassTimer
+    {
+        std::uint32_t queries[kQueryRing] = {};
+        bool pending[kQueryRing] = {};
+        int next = 0;
+        double gpuMs = 0.0;
+    };
+
+    bool ValidResource(ResourceId id) const { return id >= 0 && id < (int)m_Resources.size(); }
+    bool Writes(const Pass& pass, ResourceId id) const;
+    bool Reads(const Pass& pass, ResourceId id) const;   // 包括 LoadOp::Load 的附件
+    RenderTarget TargetOf(ResourceId id) const;
+    void PollTimers();
+    void BuildInfos();
+
+    std::vector<Pass> m_Passes;
+    std::vector<Resource> m_Resources;
+    std::vector<int> m_Order;           // 存活 pass 的执行顺序
+    bool m_Compiled = false;
+
+    std::unordered_map<std::string, PassTimer> m_Timers;
+    std::vector<PassInfo> m_PassInfos;
+    std::vector<ResourceInfo> m_ResourceInfos;
+    FrameStats m_FrameStats;
+    std::string m_DumpPath;
+    std::uint64_t m_Frame = 0;
+};
@@ -0,0 +1,329 @@
+#include "RenderTargetPool.h"
+#include "GpuMemory.h"
+
+#include <glad/glad.h>
+#include <algorithm>
+#include <cstdio>
+
+RenderTargetPool::~RenderTargetPool()
+{
+    Destroy();
+}
+
+bool RenderTargetPool::IsDepthFormat(std::uint32_t format)
+{
+    switch (format)
+    {
+        case GL_DEPTH_COMPONENT16:
+        case GL_DEPTH_COMPONENT24:
+        case GL_DEPTH_COMPONENT32F:
+        case GL_DEPTH24_STENCIL8:
+        case GL_DEPTH32F_STENCIL8:
+            return true;
+    }
+    return false;
+}
+
+static bool HasStencil(std::uint32_t format)
+{
+    return format == GL_DEPTH24_STENCIL8 || format == GL_DEPTH32F_STENCIL8;
+}
+
+std::size_t RenderTargetPool::BytesPerPixel(std::uint32_t format)
+{
+    return GpuMemory::BytesPerTexel(format);
+}
+
+std::size_t RenderTargetPool::EntryBytes(const RenderTargetDesc& desc)
+{
+    return (std::size_t)desc.width * (std::size_t)desc.height * BytesPerPixel(desc.format)
+         * (std::size_t)std::max(desc.samples, 1);
+}
+
+std::uint32_t RenderTargetPool::CreateTexture(const RenderTargetDesc& desc)
+{
+    const bool depth = IsDepthFormat(desc.format);
+    std::uint32_t tex = 0;
+    glGenTextures(1, &tex);
+    // 池里的纹理轮流给不同 pass 用，没有固定的名字，按尺寸归到一起
+    char name[48];
+    std::snprintf(name, sizeof(name), "Pool %dx%d", desc.width, desc.height);
+    GpuMemory::TrackTexture(tex, GpuMemory::Category::RenderTargets, name, EntryBytes(desc));
+
+    if (desc.samples > 0)
+    {
+        glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, tex);
+        glTexImage2DMultisample(GL_TEXTURE_2D_MULTISAMPLE, desc.samples, desc.format,
+                                desc.width, desc.height, GL_TRUE);
+        glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, 0);
+        return tex;
+    }
+
+    // 不上传数据，format/type 只要和内部格式兼容就行
+    GLenum format = GL_RGBA, type = GL_FLOAT;
+    if (depth) {
+        format = HasStencil(desc.format) ? GL_DEPTH_STENCIL : GL_DEPTH_COMPONENT;
+        type = desc.format == GL_DEPTH24_STENCIL8 ? GL_UNSIGNED_INT_24_8
+             : desc.format == GL_DEPTH32F_STENCIL8 ? GL_FLOAT_32_UNSIGNED_INT_24_8_REV
+             : GL_FLOAT;
+    }
+
+    glBindTexture(GL_TEXTURE_2D, tex);
+    glTexImage2D(GL_TEXTURE_2D, 0, desc.format, desc.width, desc.height, 0, format, type, nullptr);
+    // 同一张纹理会被不同 pass 轮流使用：采样参数固定成线性 + clamp（深度用最近点），使用者改了要自己恢复
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, depth ? GL_NEAREST : GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, depth ? GL_NEAREST : GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    return tex;
+}
+
+void RenderTargetPool::BeginFrame()
+{
+    m_Frame++;
+    m_Stats.created = m_Counters.created;
+    m_Stats.reused = m_Counters.reused;
+    m_Stats.deleted = m_Counters.deleted;
+    m_Stats.peakInUse = m_Counters.peakInUse;
+    m_Counters = Stats{};
+
+    // 1) 空闲太久的删掉
+    for (int slot = 0; slot < (int)m_Entries.size(); ++slot)
+    {
+        const Entry& e = m_Entries[slot];
+        if (e.texture && !e.inUse && m_Frame - e.lastUsedFrame > (std::uint64_t)m_RetireFrames)
+            DeleteEntry(slot);
+    }
+
+    // 2) 空闲总量超预算：从最久没用的开始删
+    std::size_t freeBytes = 0;
+    std::vector<int> idle;
+    for (int slot = 0; slot < (int)m_Entries.size(); ++slot)
+    {
+        const Entry& e = m_Entries[slot];
+        if (!e.texture || e.inUse) continue;
+        freeBytes += EntryBytes(e.desc);
+        idle.push_back(slot);
+    }
+    if (freeBytes > m_FreeBudget)
+    {
+        std::sort(idle.begin(), idle.end(), [this](int a, int b) {
+            return m_Entries[a].lastUsedFrame < m_Entries[b].lastUsedFrame;
+        });
+        for (int slot : idle)
+        {
+            if (freeBytes <= m_FreeBudget) break;
+            freeBytes -= EntryBytes(m_Entries[slot].desc);
+            DeleteEntry(slot);
+        }
+    }
+
+    // 3) 很久没用的 FBO（附件还在，但组合不再出现）
+    for (std::size_t i = 0; i < m_Framebuffers.size();)
+    {
+        if (m_Frame - m_Framebuffers[i].lastUsedFrame > (std::uint64_t)m_RetireFrames) {
+            glDeleteFramebuffers(1, &m_Framebuffers[i].fbo);
+            m_Framebuffers[i] = m_Framebuffers.back();
+            m_Framebuffers.pop_back();
+        } else {
+            ++i;
+        }
+    }
+
+    UpdateCounts();
+}
+
+RenderTarget RenderTargetPool::Acquire(const RenderTargetDesc& desc)
+{
+    RenderTarget target;
+    if (desc.width <= 0 || desc.height <= 0 || desc.format == 0) return target;
+
+    // 同描述的空闲纹理里挑最近用过的（旧的留给回收）
+    int best = -1;
+    for (int slot = 0; slot < (int)m_Entries.size(); ++slot)
+    {
+        const Entry& e = m_Entries[slot];
+        if (!e.texture || e.inUse || e.desc != desc) continue;
+        if (best < 0 || e.lastUsedFrame > m_Entries[best].lastUsedFrame) best = slot;
+    }
+
+    if (best >= 0) {
+        m_Counters.reused++;
+    } else {
+        std::uint32_t tex = CreateTexture(desc);
+        if (!tex) return target;
+        if (!m_FreeSlots.empty()) {
+            best = m_FreeSlots.back();
+            m_FreeSlots.pop_back();
+        } else {
+            best = (int)m_Entries.size();
+            m_Entries.emplace_back();
+        }
+        m_Entries[best].texture = tex;
+        m_Entries[best].desc = desc;
+        m_Counters.created++;
+    }
+
+    Entry& e = m_Entries[best];
+    e.inUse = true;
+    e.lastUsedFrame = m_Frame;
+
+    target.texture = e.texture;
+    target.desc = desc;
+    target.slot = best;
+
+    UpdateCounts();
+    m_Counters.peakInUse = std::max(m_Counters.peakInUse, m_Stats.inUse);
+    return target;
+}
+
+void RenderTargetPool::Release(RenderTarget& target)
+{
+    if (!target.Valid()) return;
+    if (target.slot < 0 || target.slot >= (int)m_Entries.size() ||
+        m_Entries[target.slot].texture != target.texture || !m_Entries[target.slot].inUse)
+    {
+        std::fprintf(stderr, "[RenderTargetPool] Release of unknown target (texture %u)\n", target.texture);
+        target = RenderTarget{};
+        return;
+    }
+
+    Entry& e = m_Entries[target.slot];
+    e.inUse = false;
+    e.lastUsedFrame = m_Frame;
+    target = RenderTarget{};
+    UpdateCounts();
+}
+
+std::uint32_t RenderTargetPool::GetFramebuffer(const RenderTarget* colors, int colorCount, const RenderTarget* depth)
+{
+    colorCount = std::clamp(colorCount, 0, FramebufferEntry::kMaxColors);
+    std::uint32_t depthTex = (depth && depth->Valid()) ? depth->texture : 0;
+    // 借失败（比如窗口最小化时尺寸为 0）的目标：返回 0，调用方画到默认帧缓冲上
+    for (int i = 0; i < colorCount; ++i)
+        if (!colors[i].Valid()) return 0;
+
+    for (FramebufferEntry& fb : m_Framebuffers)
+    {
+        if (fb.colorCount != colorCount || fb.depth != depthTex) continue;
+        bool same = true;
+        for (int i = 0; i < colorCount && same; ++i)
+            same = fb.colors[i] == colors[i].texture;
+        if (!same) continue;
+        fb.lastUsedFrame = m_Frame;
+        return fb.fbo;
+    }
+
+    FramebufferEntry fb;
+    fb.colorCount = colorCount;
+    fb.depth = depthTex;
+    fb.lastUsedFrame = m_Frame;
+
+    glGenFramebuffers(1, &fb.fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, fb.fbo);
+
+    GLenum drawBuffers[FramebufferEntry::kMaxColors];
+    for (int i = 0; i < colorCount; ++i)
+    {
+        fb.colors[i] = colors[i].texture;
+        GLenum target = colors[i].desc.samples > 0 ? GL_TEXTURE_2D_MULTISAMPLE : GL_TEXTURE_2D;
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + i, target, colors[i].texture, 0);
+        drawBuffers[i] = GL_COLOR_ATTACHMENT0 + i;
+    }
+    if (colorCount > 0) {
+        glDrawBuffers(colorCount, drawBuffers);
+    } else {
+        glDrawBuffer(GL_NONE);
+        glReadBuffer(GL_NONE);
+    }
+
+    if (depthTex)
+    {
+        GLenum attachment = HasStencil(depth->desc.format) ? GL_DEPTH_STENCIL_ATTACHMENT : GL_DEPTH_ATTACHMENT;
+        GLenum target = depth->desc.samples > 0 ? GL_TEXTURE_2D_MULTISAMPLE : GL_TEXTURE_2D;
+        glFramebufferTexture2D(GL_FRAMEBUFFER, attachment, target, depthTex, 0);
+    }
+
+    GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    if (status != GL_FRAMEBUFFER_COMPLETE) {
+        std::fprintf(stderr, "[RenderTargetPool] Incomplete FBO: 0x%x\n", (unsigned)status);
+        glDeleteFramebuffers(1, &fb.fbo);
+        return 0;
+    }
+
+    m_Framebuffers.push_back(fb);
+    UpdateCounts();
+    return fb.fbo;
+}
+
+void RenderTargetPool::Trim()
+{
+    for (int slot = 0; slot < (int)m_Entries.size(); ++slot)
+        if (m_Entries[slot].texture && !m_Entries[slot].inUse)
+            DeleteEntry(slot);
+    UpdateCounts();
+}
+
+void RenderTargetPool::Destroy()
+{
+    for (FramebufferEntry& fb : m_Framebuffers)
+        glDeleteFramebuffers(1, &fb.fbo);
+    m_Framebuffers.clear();
+
+    for (Entry& e : m_Entries)
+        if (e.texture) {
+            GpuMemory::FreeTexture(e.texture);
+            glDeleteTextures(1, &e.texture);
+        }
+    m_Entries.clear();
+    m_FreeSlots.clear();
+    m_Stats = Stats{};
+    m_Counters = Stats{};
+}
+
+void RenderTargetPool::DeleteEntry(int slot)
+{
+    Entry& e = m_Entries[slot];
+    DeleteFramebuffersUsing(e.texture);
+    GpuMemory::FreeTexture(e.texture);
+    glDeleteTextures(1, &e.texture);
+    e = Entry{};
+    m_FreeSlots.push_back(slot);
+    m_Counters.deleted++;
+}
+
+void RenderTargetPool::DeleteFramebuffersUsing(std::uint32_t texture)
+{
+    for (std::size_t i = 0; i < m_Framebuffers.size();)
+    {
+        FramebufferEntry& fb = m_Framebuffers[i];
+        bool uses = fb.depth == texture;
+        for (int c = 0; c < fb.colorCount && !uses; ++c)
+            uses = fb.colors[c] == texture;
+        if (uses) {
+            glDeleteFramebuffers(1, &fb.fbo);
+            m_Framebuffers[i] = m_Framebuffers.back();
+            m_Framebuffers.pop_back();
+        } else {
+            ++i;
+        }
+    }
+}
+
+void RenderTargetPool::UpdateCounts()
+{
+    m_Stats.textures = m_Stats.inUse = 0;
+    m_Stats.bytes = m_Stats.freeBytes = 0;
+    for (const Entry& e : m_Entries)
+    {
+        if (!e.texture) continue;
+        std::size_t bytes = EntryBytes(e.desc);
+        m_Stats.textures++;
+        m_Stats.bytes += bytes;
+        if (e.inUse) m_Stats.inUse++;
+        else m_Stats.freeBytes += bytes;
+    }
+    m_Stats.framebuffers = (int)m_Framebuffers.size();
+}
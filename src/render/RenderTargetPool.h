@@ -0,0 +1,122 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 渲染目标的描述：同一描述的纹理可以互相替换
+struct RenderTargetDesc
+{
+    int width = 0;
+    int height = 0;
+    std::uint32_t format = 0;   // GL 内部格式，如 GL_RGBA16F、GL_DEPTH24_STENCIL8
+    int samples = 0;            // 0 = 普通 2D 纹理，>0 = GL_TEXTURE_2D_MULTISAMPLE
+
+    bool operator==(const RenderTargetDesc& o) const
+    {
+        return width == o.width && height == o.height && format == o.format && samples == o.samples;
+    }
+    bool operator!=(const RenderTargetDesc& o) const { return !(*this == o); }
+};
+
+// 池里借出的一个目标；texture 在 Release 之前有效
+struct RenderTarget
+{
+    std::uint32_t texture = 0;
+    RenderTargetDesc desc;
+    int slot = -1;              // 池内部下标
+
+    bool Valid() const { return texture != 0; }
+};
+
+// RenderTargetPool：帧内临时渲染目标的池
+// - Acquire 按描述借一张纹理，Release 之后同一帧里后面的 pass 就能拿去用
+//   （GL 按提交顺序执行，生命周期不重叠的 pass 天然可以共用同一块显存）
+// - 释放的纹理不马上删：空闲超过 retireFrames 帧才删，窗口拖动时尺寸来回变也不会每帧删了又建
+// - 空闲纹理总量超过预算时从最久没用的开始删
+// - FBO 按附件组合缓存，纹理删除时一起删
+// 只在 GL 线程使用
+class RenderTargetPool
+{
+public:
+    struct Stats
+    {
+        int textures = 0;           // 池里的纹理总数（借出 + 空闲）
+        int inUse = 0;
+        int framebuffers = 0;
+        std::size_t bytes = 0;      // 估算显存（借出 + 空闲）
+        std::size_t freeBytes = 0;
+        // 上一帧（BeginFrame 时结算，界面在帧中间读也是完整的一帧）
+        int created = 0;
+        int reused = 0;
+        int deleted = 0;
+        int peakInUse = 0;
+    };
+
+    RenderTargetPool() = default;
+    ~RenderTargetPool();
+
+    RenderTargetPool(const RenderTargetPool&) = delete;
+    RenderTargetPool& operator=(const RenderTargetPool&) = delete;
+
+    // 每帧开始调用：推进帧号，回收空闲太久的纹理
+    void BeginFrame();
+
+    RenderTarget Acquire(const RenderTargetDesc& desc);
+    // 释放后 target 被清空；同一帧里之后的 Acquire 可以拿到同一张纹理
+    void Release(RenderTarget& target);
+
+    // 附件组合对应的 FBO（缓存）；depth 可以为空。颜色附件依次挂到 COLOR_ATTACHMENT0..
+    std::uint32_t GetFramebuffer(const RenderTarget* colors, int colorCount, const RenderTarget* depth);
+
+    // 空闲多少帧之后删除（默认 4）
+    void SetRetireFrames(int frames) { m_RetireFrames = frames < 1 ? 1 : frames; }
+    // 空闲纹理的显存上限（默认 256 MB），超出时从最久没用的开始删
+    void SetFreeBudget(std::size_t bytes) { m_FreeBudget = bytes; }
+
+    // 删掉所有空闲纹理（借出中的不动）
+    void Trim();
+    // 释放全部 GL 对象；需要在 GL 上下文销毁前调用
+    void Destroy();
+
+    const Stats& GetStats() const { return m_Stats; }
+    std::uint64_t FrameIndex() const { return m_Frame; }
+
+    static bool IsDepthFormat(std::uint32_t format);
+    // 估算每像素字节数（多重采样再乘 samples），用的是 GpuMemory::BytesPerTexel 那张表
+    static std::size_t BytesPerPixel(std::uint32_t format);
+
+private:
+    struct Entry
+    {
+        std::uint32_t texture = 0;
+        RenderTargetDesc desc;
+        bool inUse = false;
+        std::uint64_t lastUsedFrame = 0;
+    };
+
+    struct FramebufferEntry
+    {
+        static constexpr int kMaxColors = 4;
+        std::uint32_t fbo = 0;
+        std::uint32_t colors[kMaxColors] = {};
+        int colorCount = 0;
+        std::uint32_t depth = 0;
+        std::uint64_t lastUsedFrame = 0;
+    };
+
+    static std::uint32_t CreateTexture(const RenderTargetDesc& desc);
+    static std::size_t EntryBytes(const RenderTargetDesc& desc);
+    void DeleteEntry(int slot);
+    void DeleteFramebuffersUsing(std::uint32_t texture);
+    void UpdateCounts();
+
+    std::vector<Entry> m_Entries;       // texture == 0 的是空槽
+    std::vector<int> m_FreeSlots;
+    std::vector<FramebufferEntry> m_Framebuffers;
+
+    std::uint64_t m_Frame = 0;
+    int m_RetireFrames = 4;
+    std::size_t m_FreeBudget = std::size_t(256) * 1024 * 1024;
+    Stats m_Stats;
+    Stats m_Counters;   // 本帧正在累计的 created / reused / deleted / peakInUse
+};
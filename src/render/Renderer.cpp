@@ -1,10 +1,20 @@
 #include "Renderer.h"
+#include "DrawStats.h"
+#include "GpuMemory.h"
 
 #include "../Material.h"
+#include "../Model.h"
 #include "../Shader.h"
 
 #include <glad/glad.h>
 #include <algorithm>
+#include <string>
+
+Renderer::~Renderer()
+{
+    GpuMemory::FreeBuffer(m_InstanceVbo);
+    if (m_InstanceVbo) glDeleteBuffers(1, &m_InstanceVbo);
+}
 
 void Renderer::SetPointLights(const std::vector<PointLight>& lights)
 {
@@ -33,9 +43,19 @@ void Renderer::DrawObject(const Object& obj, unsigned int vao, int vertexCount)
     glm::mat4 modelMat = obj.transform.ToMatrix();
     shader->SetMatrices(modelMat, m_View, m_Proj);
 
-    // 3) 灯光（先按你现有 shader 的写法：PointLights 数组）
-    const int MAX_POINT_LIGHTS = 8;
-    int count = (int)std::min<size_t>(m_PointLights.size(), MAX_POINT_LIGHTS);
+    // 3) 灯光
+    ApplyLights(shader);
+
+    // 4) draw
+    DrawStats::BindVertexArray();
+    glBindVertexArray(vao);
+    DrawStats::DrawArrays(GL_TRIANGLES, 0, vertexCount);
+}
+
+void Renderer::ApplyLights(Shader* shader)
+{
+    // 先按你现有 shader 的写法：PointLights 数组
+    int count = (int)std::min<size_t>(m_PointLights.size(), kMaxPointLights);
 
     shader->setUniform1i("u_PointLightCount", count);
 
@@ -51,8 +71,88 @@ void Renderer::DrawObject(const Object& obj, unsigned int vao, int vertexCount)
         shader->setUniform3f(("u_PointLights[" + std::to_string(i) + "].color").c_str(),
                              L.color.x, L.color.y, L.color.z);
     }
+}
 
-    // 4) draw
-    glBindVertexArray(vao);
-    glDrawArrays(GL_TRIANGLES, 0, vertexCount);
+bool Renderer::SubmitInstanced(const Object& obj, Model& model)
+{
+    if (!obj.material) return false;
+    return SubmitInstanced(obj.transform.ToMatrix(), *obj.material, model);
+}
+
+bool Renderer::SubmitInstanced(const glm::mat4& world, const Material& material, Model& model)
+{
+    const Material* mat = &material;
+    if (!mat->albedoArray || !m_InstancedShader) return false;
+
+    Batch* batch = nullptr;
+    for (Batch& b : m_Batches)
+    {
+        if (b.textureArray == mat->albedoArray && b.model == &model) {
+            batch = &b;
+            break;
+        }
+    }
+    if (!batch) {
+        m_Batches.push_back(Batch{});
+        batch = &m_Batches.back();
+        batch->textureArray = mat->albedoArray;
+        batch->model = &model;
+    }
+
+    InstanceData inst;
+    inst.model = world;
+    inst.color = mat->color;
+    inst.params = glm::vec4(mat->metallic, mat->roughness, mat->ao, (float)mat->albedoLayer);
+    batch->instances.push_back(inst);
+
+    if (std::find(batch->materials.begin(), batch->materials.end(), mat) == batch->materials.end())
+        batch->materials.push_back(mat);
+    return true;
+}
+
+void Renderer::FlushInstanced()
+{
+    m_Stats = BatchStats{};
+    if (m_Batches.empty() || !m_InstancedShader) return;
+
+    if (!m_InstanceVbo) {
+        glGenBuffers(1, &m_InstanceVbo);
+        GpuMemory::TrackBuffer(m_InstanceVbo, GpuMemory::Category::Buffers, "Instance data", 0);
+    }
+
+    Shader* shader = m_InstancedShader;
+    shader->Bind();
+    shader->setUniformMat4("u_View", m_View);
+    shader->setUniformMat4("u_Proj", m_Proj);
+    shader->setUniform3f("u_ViewPos", m_ViewPos.x, m_ViewPos.y, m_ViewPos.z);
+    shader->setUniform1i("u_TextureArray", 0);
+    ApplyLights(shader);
+
+    glActiveTexture(GL_TEXTURE0);
+    for (Batch& b : m_Batches)
+    {
+        if (b.instances.empty()) continue;
+
+        DrawStats::BindTexture();
+        glBindTexture(GL_TEXTURE_2D_ARRAY, b.textureArray);
+
+        // 每批重新填 buffer（orphan 一下，避免等 GPU 用完上一批）
+        glBindBuffer(GL_ARRAY_BUFFER, m_InstanceVbo);
+        GLsizeiptr bytes = (GLsizeiptr)(b.instances.size() * sizeof(InstanceData));
+        glBufferData(GL_ARRAY_BUFFER, bytes, nullptr, GL_STREAM_DRAW);
+        GpuMemory::Resize(GpuMemory::Kind::Buffer, m_InstanceVbo, (std::size_t)bytes);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, bytes, b.instances.data());
+        DrawStats::Upload(bytes);
+
+        b.model->BindInstanceBuffer(m_InstanceVbo);
+        b.model->DrawInstanced((int)b.instances.size());
+
+        m_Stats.objects += (int)b.instances.size();
+        m_Stats.naiveBatches += (int)b.materials.size();
+        m_Stats.drawCalls += 1;
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+    m_Batches.clear();
 }
@@ -1,13 +1,41 @@
 #pragma once
+#include <cstdint>
 #include <vector>
 #include <glm/glm.hpp>
 
 #include "Light.h"
 #include "../Object.h"
 
+class Model;
+class Shader;
+
 class Renderer
 {
 public:
+    // 每实例数据，布局和 Mesh::BindInstanceBuffer / basic.vert(USE_INSTANCING) 对应
+    struct InstanceData
+    {
+        glm::mat4 model{1.0f};
+        glm::vec4 color{1.0f};
+        glm::vec4 params{0.0f};  // metallic, roughness, ao, layer
+    };
+
+    // 批处理统计：naiveBatches = 按 (材质, 模型) 分组时需要的 draw 数
+    struct BatchStats
+    {
+        int objects = 0;
+        int naiveBatches = 0;
+        int drawCalls = 0;
+        int BatchesSaved() const { return naiveBatches - drawCalls; }
+    };
+
+    Renderer() = default;
+    ~Renderer();
+
+    // 持有 m_InstanceVbo，拷贝会重复删除
+    Renderer(const Renderer&) = delete;
+    Renderer& operator=(const Renderer&) = delete;
+
     void SetPointLights(const std::vector<PointLight>& lights);
 
     void BeginFrame(const glm::mat4& view,
@@ -16,11 +44,39 @@ public:
 
     void DrawObject(const Object& obj, unsigned int vao, int vertexCount);
 
+    // ---------------- 纹理数组 + instancing ----------------
+    // shader 需要用 USE_INSTANCING / USE_TEXTURE_ARRAY 编译
+    void SetInstancedShader(Shader* shader) { m_InstancedShader = shader; }
+
+    // 材质贴图已打包进纹理数组（material->albedoArray != 0）的物体才能走这里
+    // 按 (纹理数组, 模型) 分组，材质差异放进实例数据
+    bool SubmitInstanced(const Object& obj, Model& model);
+    // 世界矩阵已经算好的（SceneStore）直接走这个，不再每帧 ToMatrix
+    bool SubmitInstanced(const glm::mat4& world, const Material& material, Model& model);
+    void FlushInstanced();
+
+    const BatchStats& GetBatchStats() const { return m_Stats; }
+
 private:
+    void ApplyLights(Shader* shader);
+
     std::vector<PointLight> m_PointLights;
 
     // per-frame cache
     glm::mat4 m_View{1.0f};
     glm::mat4 m_Proj{1.0f};
     glm::vec3 m_ViewPos{0.0f};
+
+    struct Batch
+    {
+        std::uint32_t textureArray = 0;
+        Model* model = nullptr;
+        std::vector<InstanceData> instances;
+        std::vector<const void*> materials;  // 只用来统计 naiveBatches
+    };
+
+    Shader* m_InstancedShader = nullptr;
+    std::vector<Batch> m_Batches;
+    std::uint32_t m_InstanceVbo = 0;
+    BatchStats m_Stats;
 };
@@ -0,0 +1,481 @@
+// FrameReplay：把 FrameCapture 录下的一帧场景命令流在 headless 上下文里反复重放，
+// 单独测 Material / Shader / Model / Renderer 这套提交路径的 CPU 开销和 GPU 时间
+// 用法（在仓库根目录运行，资源按录制时的相对路径加载）：
+//   FrameReplay <frame.rsframe> [--iterations 200] [--warmup 10] [--out replay.json]
+//               [--baseline old.json] [--threshold 0.1]
+//       每次迭代：CPU 提交时间（chrono，不含 glFinish）+ GPU 时间（GL_TIME_ELAPSED）
+//       --baseline：和之前某次的输出比较 p50，任何一项变慢超过 threshold 时返回 2（和 RenderSandboxBench 一致）；
+//                   baseline 读不了、或者缺 cpuSubmitMs / gpuMs 任何一项时返回 3（在重放之前就检查）
+//       参数错误、加载 / 初始化 / 写文件失败返回 1
+// 和 RenderSandbox 的区别：没有后处理、没有纹理流送（贴图直接全分辨率加载），相机和物体都是录下来的那一帧
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include "Headless.h"
+#include "IBLBaker.h"
+#include "Material.h"
+#include "Model.h"
+#include "Shader.h"
+#include "Texture2D.h"
+#include "TextureArrayPacker.h"
+#include "render/DrawStats.h"
+#include "render/FrameCapture.h"
+#include "render/Framebuffer.h"
+#include "render/Renderer.h"
+
+using Clock = std::chrono::high_resolution_clock;
+
+namespace
+{
+    struct Summary
+    {
+        double mean = 0.0, p50 = 0.0, p95 = 0.0, p99 = 0.0, max = 0.0;
+    };
+
+    // 和 FrameTimingLog 一样的汇总口径
+    Summary Summarize(std::vector<double> values)
+    {
+        Summary s;
+        if (values.empty()) return s;
+        std::sort(values.begin(), values.end());
+        double sum = 0.0;
+        for (double v : values) sum += v;
+        auto percentile = [&](double p) {
+            std::size_t i = (std::size_t)(p * (double)(values.size() - 1) + 0.5);
+            return values[std::min(i, values.size() - 1)];
+        };
+        s.mean = sum / (double)values.size();
+        s.p50 = percentile(0.50);
+        s.p95 = percentile(0.95);
+        s.p99 = percentile(0.99);
+        s.max = values.back();
+        return s;
+    }
+
+    void WriteSummary(std::FILE* f, const char* name, const Summary& s, bool last)
+    {
+        std::fprintf(f, "    \"%s\": { \"mean\": %.4f, \"p50\": %.4f, \"p95\": %.4f, \"p99\": %.4f, \"max\": %.4f }%s\n",
+                     name, s.mean, s.p50, s.p95, s.p99, s.max, last ? "" : ",");
+    }
+
+    // 只认 WriteJson 写出来的格式："name": { ... "p50": x
+    bool ReadBaselineP50(const std::string& text, const char* name, double& p50)
+    {
+        std::string key = std::string("\"") + name + "\"";
+        const char* p = std::strstr(text.c_str(), key.c_str());
+        if (!p) return false;
+        p = std::strstr(p, "\"p50\":");
+        if (!p) return false;
+        p50 = std::strtod(p + 6, nullptr);
+        return true;
+    }
+
+    // 两项都要有；拼错路径或者文件不对时要让 CI 失败，而不是悄悄跳过对比
+    bool LoadBaseline(const std::string& path, double& cpuP50, double& gpuP50)
+    {
+        std::FILE* f = std::fopen(path.c_str(), "rb");
+        if (!f)
+        {
+            std::fprintf(stderr, "[FrameReplay] Cannot read baseline %s\n", path.c_str());
+            return false;
+        }
+        std::string text;
+        char buf[4096];
+        std::size_t n;
+        while ((n = std::fread(buf, 1, sizeof(buf), f)) > 0) text.append(buf, n);
+        std::fclose(f);
+
+        bool ok = true;
+        for (auto m : { std::make_pair("cpuSubmitMs", &cpuP50), std::make_pair("gpuMs", &gpuP50) })
+        {
+            if (!ReadBaselineP50(text, m.first, *m.second) || *m.second <= 0.0)
+            {
+                std::fprintf(stderr, "[FrameReplay] Baseline %s has no %s\n", path.c_str(), m.first);
+                ok = false;
+            }
+        }
+        return ok;
+    }
+
+    void PrintUsage()
+    {
+        std::fprintf(stderr,
+            "Usage: FrameReplay <frame.rsframe> [--iterations N] [--warmup N] [--out replay.json]\n"
+            "                   [--baseline old.json] [--threshold 0.1]\n");
+    }
+
+    // 重放需要的 GL 资源，按 FrameCapture 的下标一一对应；加载失败的项留空，引用它的命令跳过
+    class Replayer
+    {
+    public:
+        explicit Replayer(const FrameCapture& capture) : m_Capture(capture) {}
+
+        bool Setup();
+        void Execute();
+
+        int Width() const { return m_Width; }
+        int Height() const { return m_Height; }
+
+    private:
+        void ApplyLights(const std::vector<PointLight>& lights);
+        void DrawSkybox(Shader& shader);
+
+        const FrameCapture& m_Capture;
+
+        std::vector<std::unique_ptr<Shader>> m_Shaders;
+        std::vector<std::unique_ptr<Model>> m_Models;
+        std::vector<std::unique_ptr<Texture2D>> m_Textures;
+        std::vector<TextureArrayPacker::Slot> m_Layers;     // textures 下标 -> 打包位置（layer = true 的项）
+        std::vector<Material> m_Materials;
+        TextureArrayPacker m_Packer;
+        IBLBaker m_IBL;
+        Framebuffer m_Target;
+        Renderer m_Renderer;
+
+        int m_Width = 0;
+        int m_Height = 0;
+
+        // 重放时的状态
+        Shader* m_Current = nullptr;
+        FrameCapture::CameraDesc m_Camera;
+    };
+
+    bool Replayer::Setup()
+    {
+        for (const FrameCapture::ShaderDesc& d : m_Capture.Shaders())
+        {
+            m_Shaders.push_back(d.defines.empty()
+                ? std::make_unique<Shader>(d.vertexPath, d.fragmentPath)
+                : std::make_unique<Shader>(d.vertexPath, d.fragmentPath, d.defines));
+        }
+
+        for (const std::string& path : m_Capture.Models())
+        {
+            auto model = std::make_unique<Model>();
+            if (!model->Load(path))
+            {
+                std::fprintf(stderr, "[FrameReplay] Failed to load model: %s\n", path.c_str());
+                model.reset();
+            }
+            m_Models.push_back(std::move(model));
+        }
+
+        // 普通贴图直接全分辨率加载；纹理数组的图层重新打包（同尺寸的会和录制时一样分到同一组）
+        const auto& textures = m_Capture.Textures();
+        std::vector<int> packIndex(textures.size(), -1);
+        for (std::size_t i = 0; i < textures.size(); ++i)
+        {
+            if (textures[i].layer)
+            {
+                packIndex[i] = m_Packer.Add(textures[i].path, textures[i].srgb);
+                m_Textures.emplace_back();
+            }
+            else
+            {
+                m_Textures.push_back(std::make_unique<Texture2D>(textures[i].path, textures[i].srgb));
+            }
+        }
+        m_Packer.Build();
+        m_Layers.resize(textures.size());
+        for (std::size_t i = 0; i < textures.size(); ++i)
+            if (packIndex[i] >= 0) m_Layers[i] = m_Packer.GetSlot(packIndex[i]);
+
+        for (const FrameCapture::MaterialDesc& d : m_Capture.Materials())
+        {
+            Material m;
+            m.shader = d.shader >= 0 ? m_Shaders[d.shader].get() : nullptr;
+            m.albedo = d.albedo >= 0 ? m_Textures[d.albedo].get() : nullptr;
+            if (d.albedoLayer >= 0 && m_Layers[d.albedoLayer].IsValid())
+            {
+                m.albedoArray = m_Layers[d.albedoLayer].texture;
+                m.albedoLayer = m_Layers[d.albedoLayer].layer;
+            }
+            m.color = d.color;
+            m.shininess = d.shininess;
+            m.ambientStrength = d.ambientStrength;
+            m.metallic = d.metallic;
+            m.roughness = d.roughness;
+            m.ao = d.ao;
+            m_Materials.push_back(m);
+        }
+
+        // 一帧里只会有一张环境图（切换 HDRI 在帧之间），取第一个；缓存路径和 RenderSandbox 一致，通常直接命中
+        const auto& envs = m_Capture.Environments();
+        if (!envs.empty())
+        {
+            const std::string& hdr = envs.front().hdrPath;
+            std::string cache = "cache/" + std::filesystem::path(hdr).stem().string() + ".iblcache";
+            if (!m_IBL.Bake(hdr, cache))
+            {
+                std::fprintf(stderr, "[FrameReplay] Failed to load environment: %s\n", hdr.c_str());
+                return false;
+            }
+        }
+
+        for (const FrameCapture::PassDesc& p : m_Capture.Passes())
+        {
+            m_Width = std::max(m_Width, p.width);
+            m_Height = std::max(m_Height, p.height);
+        }
+        if (m_Width <= 0 || m_Height <= 0)
+        {
+            std::fprintf(stderr, "[FrameReplay] Capture has no passes\n");
+            return false;
+        }
+        if (!m_Target.Create(m_Width, m_Height)) return false;
+
+        // Renderer 的 instanced shader 就是 FlushInstanced 记下的那个
+        for (const FrameCapture::Command& c : m_Capture.Commands())
+        {
+            if (c.op == FrameCapture::Op::FlushInstanced)
+            {
+                m_Renderer.SetInstancedShader(m_Shaders[c.index].get());
+                break;
+            }
+        }
+        return true;
+    }
+
+    void Replayer::ApplyLights(const std::vector<PointLight>& lights)
+    {
+        m_Renderer.SetPointLights(lights);
+        if (!m_Current) return;
+        const int lightCount = std::min((int)lights.size(), kMaxPointLights);
+        m_Current->setUniform1i("u_PointLightCount", lightCount);
+        for (int li = 0; li < lightCount; li++)
+        {
+            m_Current->setUniform3f(("u_PointLights[" + std::to_string(li) + "].position").c_str(),
+                lights[li].position.x, lights[li].position.y, lights[li].position.z);
+            m_Current->setUniform3f(("u_PointLights[" + std::to_string(li) + "].color").c_str(),
+                lights[li].color.x, lights[li].color.y, lights[li].color.z);
+        }
+    }
+
+    // 和 RenderSandbox 的 Skybox pass 相同
+    void Replayer::DrawSkybox(Shader& shader)
+    {
+        glDepthFunc(GL_LEQUAL);
+        shader.Bind();
+        shader.setUniformMat4("u_Projection", m_Camera.proj);
+        shader.setUniformMat4("u_View", glm::mat4(glm::mat3(m_Camera.view)));
+        shader.setUniform1i("u_Skybox", 0);
+        glActiveTexture(GL_TEXTURE0);
+        DrawStats::BindTexture();
+        glBindTexture(GL_TEXTURE_CUBE_MAP, m_IBL.GetEnvCubemap());
+        m_IBL.RenderCube();
+        glDepthFunc(GL_LESS);
+        m_Current = &shader;
+    }
+
+    void Replayer::Execute()
+    {
+        using Op = FrameCapture::Op;
+        m_Current = nullptr;
+        for (const FrameCapture::Command& c : m_Capture.Commands())
+        {
+            switch (c.op)
+            {
+            case Op::BeginPass:
+            {
+                const FrameCapture::PassDesc& p = m_Capture.Passes()[c.index];
+                m_Target.Bind();
+                glViewport(0, 0, p.width, p.height);
+                if (p.depthTest) glEnable(GL_DEPTH_TEST); else glDisable(GL_DEPTH_TEST);
+                if (p.cullFace) glEnable(GL_CULL_FACE); else glDisable(GL_CULL_FACE);
+                if (p.clear)
+                {
+                    glClearColor(p.clearColor.r, p.clearColor.g, p.clearColor.b, p.clearColor.a);
+                    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+                }
+                break;
+            }
+            case Op::EndPass:
+                break;
+            case Op::SetCamera:
+                m_Camera = m_Capture.Cameras()[c.index];
+                m_Renderer.BeginFrame(m_Camera.view, m_Camera.proj, m_Camera.viewPos);
+                break;
+            case Op::BindShader:
+                m_Current = m_Shaders[c.index].get();
+                m_Current->Bind();
+                break;
+            case Op::BindMaterial:
+            {
+                const Material& m = m_Materials[c.index];
+                if (!m.shader) break;
+                m.Bind(m_Camera.viewPos);
+                m_Current = m.shader;
+                break;
+            }
+            case Op::SetLights:
+                ApplyLights(m_Capture.LightSets()[c.index]);
+                break;
+            case Op::SetEnvironment:
+            {
+                const FrameCapture::EnvironmentDesc& e = m_Capture.Environments()[c.index];
+                if (m_Current) m_IBL.ApplyToShader(*m_Current, e.useSH, e.useSpecular, e.bindTextures);
+                break;
+            }
+            case Op::DrawModel:
+            {
+                const FrameCapture::DrawDesc& d = m_Capture.Draws()[c.index];
+                if (d.model < 0 || !m_Models[d.model] || !m_Current) break;
+                m_Current->SetMatrices(d.matrix, m_Camera.view, m_Camera.proj);
+                m_Models[d.model]->Draw();
+                break;
+            }
+            case Op::SubmitInstanced:
+            {
+                const FrameCapture::InstanceDesc& d = m_Capture.Instances()[c.index];
+                if (d.model < 0 || !m_Models[d.model] || d.material < 0) break;
+                m_Renderer.SubmitInstanced(d.matrix, m_Materials[d.material], *m_Models[d.model]);
+                break;
+            }
+            case Op::FlushInstanced:
+                m_Renderer.FlushInstanced();
+                break;
+            case Op::DrawSkybox:
+                DrawSkybox(*m_Shaders[c.index]);
+                break;
+            }
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    std::string capturePath;
+    std::string outPath = "replay.json";
+    std::string baselinePath;
+    int iterations = 200;
+    int warmup = 10;
+    double threshold = 0.1;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        auto next = [&]() -> const char* { return i + 1 < argc ? argv[++i] : nullptr; };
+        const char* value = nullptr;
+        if (arg == "--iterations" && (value = next())) iterations = std::max(1, std::atoi(value));
+        else if (arg == "--warmup" && (value = next())) warmup = std::max(0, std::atoi(value));
+        else if (arg == "--out" && (value = next())) outPath = value;
+        else if (arg == "--baseline" && (value = next())) baselinePath = value;
+        else if (arg == "--threshold" && (value = next())) threshold = std::atof(value);
+        else if (!arg.empty() && arg[0] != '-' && capturePath.empty()) capturePath = arg;
+        else { PrintUsage(); return 1; }
+    }
+    if (capturePath.empty()) { PrintUsage(); return 1; }
+
+    double baseCpu = 0.0, baseGpu = 0.0;
+    if (!baselinePath.empty() && !LoadBaseline(baselinePath, baseCpu, baseGpu)) return 3;
+
+    FrameCapture capture;
+    if (!capture.Load(capturePath)) return 1;
+
+    HeadlessContext context;
+    if (!context.Create()) return 1;
+    if (!gladLoadGLLoader((GLADloadproc)HeadlessContext::GetProcAddress))
+    {
+        std::fprintf(stderr, "[FrameReplay] Failed to initialize GLAD\n");
+        return 1;
+    }
+    glEnable(GL_DEPTH_TEST);
+    glEnable(GL_TEXTURE_CUBE_MAP_SEAMLESS);
+    glDepthFunc(GL_LESS);
+
+    int rc = 0;
+    {
+        Replayer replayer(capture);
+        if (!replayer.Setup()) return 1;
+
+        GLuint query = 0;
+        glGenQueries(1, &query);
+
+        std::vector<double> cpuMs, gpuMs, wallMs;
+        DrawStats::Counters draws{};
+        for (int it = 0; it < warmup + iterations; ++it)
+        {
+            DrawStats::BeginFrame();
+            glBeginQuery(GL_TIME_ELAPSED, query);
+            auto t0 = Clock::now();
+            replayer.Execute();
+            auto t1 = Clock::now();
+            glEndQuery(GL_TIME_ELAPSED);
+            glFinish();
+            auto t2 = Clock::now();
+            GLuint64 ns = 0;
+            glGetQueryObjectui64v(query, GL_QUERY_RESULT, &ns);
+            if (it < warmup) continue;
+            cpuMs.push_back(std::chrono::duration<double, std::milli>(t1 - t0).count());
+            wallMs.push_back(std::chrono::duration<double, std::milli>(t2 - t0).count());
+            gpuMs.push_back((double)ns / 1.0e6);
+        }
+        // 每次迭代的命令完全一样，计数取最后一次
+        DrawStats::BeginFrame();
+        draws = DrawStats::LastFrame();
+        glDeleteQueries(1, &query);
+
+        Summary cpu = Summarize(cpuMs), gpu = Summarize(gpuMs), wall = Summarize(wallMs);
+        std::printf("[FrameReplay] %s: %d commands, %dx%d, %d iterations\n", capturePath.c_str(),
+                    (int)capture.Commands().size(), replayer.Width(), replayer.Height(), iterations);
+        std::printf("[FrameReplay]   cpu submit  p50 %.3f ms  p95 %.3f ms\n", cpu.p50, cpu.p95);
+        std::printf("[FrameReplay]   gpu         p50 %.3f ms  p95 %.3f ms\n", gpu.p50, gpu.p95);
+        std::printf("[FrameReplay]   draw calls %lld, program switches %lld, texture binds %lld\n",
+                    (long long)draws[DrawStats::DrawCalls], (long long)draws[DrawStats::ProgramSwitches],
+                    (long long)draws[DrawStats::TextureBinds]);
+
+        if (std::FILE* f = std::fopen(outPath.c_str(), "w"))
+        {
+            std::fprintf(f, "{\n");
+            std::fprintf(f, "  \"capture\": \"%s\",\n", capturePath.c_str());
+            std::fprintf(f, "  \"commands\": %d,\n", (int)capture.Commands().size());
+            std::fprintf(f, "  \"width\": %d,\n  \"height\": %d,\n", replayer.Width(), replayer.Height());
+            std::fprintf(f, "  \"iterations\": %d,\n  \"warmup\": %d,\n", iterations, warmup);
+            std::fprintf(f, "  \"summary\": {\n");
+            WriteSummary(f, "cpuSubmitMs", cpu, false);
+            WriteSummary(f, "gpuMs", gpu, false);
+            WriteSummary(f, "wallMs", wall, true);
+            std::fprintf(f, "  },\n");
+            std::fprintf(f, "  \"drawStats\": {\n");
+            for (int c = 0; c < DrawStats::kCounterCount; ++c)
+                std::fprintf(f, "    \"%s\": %lld%s\n", DrawStats::Name((DrawStats::Counter)c), (long long)draws[c],
+                             c + 1 < DrawStats::kCounterCount ? "," : "");
+            std::fprintf(f, "  }\n}\n");
+            std::fclose(f);
+            std::printf("[FrameReplay] Wrote %s\n", outPath.c_str());
+        }
+        else
+        {
+            std::fprintf(stderr, "[FrameReplay] Failed to write %s\n", outPath.c_str());
+            rc = 1;
+        }
+
+        if (!baselinePath.empty())
+        {
+            const struct { const char* name; double p50; double base; } current[] = {
+                { "cpuSubmitMs", cpu.p50, baseCpu }, { "gpuMs", gpu.p50, baseGpu } };
+            for (const auto& m : current)
+            {
+                const double base = m.base;
+                double delta = m.p50 / base - 1.0;
+                bool regressed = delta > threshold;
+                std::printf("[FrameReplay]   %-12s %.3f -> %.3f ms (%+.1f%%)%s\n", m.name, base, m.p50,
+                            delta * 100.0, regressed ? "  REGRESSION" : "");
+                if (regressed && rc == 0) rc = 2;
+            }
+        }
+    }
+    context.Destroy();
+    return rc;
+}
@@ -0,0 +1,152 @@
+// HdrDecodeBench：对比 stbi_loadf 路径和 RadianceHDR 并行 half 解码
+// 用法：HdrDecodeBench [file.hdr ...]
+// 不传文件时在当前目录生成 2k/4k/8k 的合成全景图（stbi_write_hdr 写出的 RLE 格式）
+// 纯 CPU，不需要 GL 上下文
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include <stb_image_write.h>
+
+#include "HalfFloat.h"
+#include "RadianceHDR.h"
+#include "ThreadPool.h"
+
+using Clock = std::chrono::high_resolution_clock;
+
+static double Ms(Clock::time_point a, Clock::time_point b)
+{
+    return std::chrono::duration<double, std::milli>(b - a).count();
+}
+
+static double Median(std::vector<double> v)
+{
+    std::sort(v.begin(), v.end());
+    return v[v.size() / 2];
+}
+
+// 合成一张有天空渐变 + 太阳高光的全景图，数值范围接近真实 HDRI
+static bool WriteSyntheticHDR(const std::string& path, int w, int h)
+{
+    std::vector<float> pixels((std::size_t)w * h * 3);
+    for (int y = 0; y < h; ++y)
+    {
+        float v = (float)y / (float)(h - 1);
+        for (int x = 0; x < w; ++x)
+        {
+            float u = (float)x / (float)(w - 1);
+            float du = u - 0.3f, dv = v - 0.25f;
+            float sun = 2000.0f * std::exp(-(du * du + dv * dv) * 4000.0f);
+            float* p = &pixels[((std::size_t)y * w + x) * 3];
+            p[0] = 0.2f + 0.8f * (1.0f - v) + sun;
+            p[1] = 0.3f + 0.9f * (1.0f - v) + sun * 0.9f;
+            p[2] = 0.6f + 1.2f * (1.0f - v) + sun * 0.7f + 0.05f * std::sin(u * 200.0f);
+        }
+    }
+    return stbi_write_hdr(path.c_str(), w, h, 3, pixels.data()) != 0;
+}
+
+int main(int argc, char** argv)
+{
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; ++i) files.push_back(argv[i]);
+
+    if (files.empty()) {
+        const int sizes[3] = { 2048, 4096, 8192 };
+        for (int s : sizes)
+        {
+            std::string path = "bench_" + std::to_string(s / 1024) + "k.hdr";
+            std::printf("Generating %s (%dx%d)...\n", path.c_str(), s, s / 2);
+            if (!WriteSyntheticHDR(path, s, s / 2)) {
+                std::fprintf(stderr, "Failed to write %s\n", path.c_str());
+                return 1;
+            }
+            files.push_back(path);
+        }
+    }
+
+    ThreadPool& pool = ThreadPool::Global();
+    const int iterations = 5;
+    std::printf("\nthreads: %u, F16C: %s, iterations: %d (median)\n\n",
+                pool.ThreadCount() + 1,
+#if defined(RENDERSANDBOX_HAS_F16C)
+                "yes",
+#else
+                "no",
+#endif
+                iterations);
+    std::printf("%-22s %11s %14s %14s %12s %9s %10s %10s\n",
+                "file", "size", "stb_loadf ms", "stb+half ms", "radiance ms", "speedup",
+                "stb MB", "ours MB");
+
+    for (const std::string& path : files)
+    {
+        std::vector<double> stbTimes, stbHalfTimes, oursTimes;
+        int w = 0, h = 0;
+        float maxRelError = 0.0f;
+
+        for (int it = 0; it < iterations; ++it)
+        {
+            // stb：解出 float RGB；GL_FLOAT 上传时驱动还要在 CPU 上转 half，这里把那一步也算进来
+            stbi_set_flip_vertically_on_load(1);
+            int comp = 0;
+            auto t0 = Clock::now();
+            float* data = stbi_loadf(path.c_str(), &w, &h, &comp, 3);
+            auto t1 = Clock::now();
+            if (!data) {
+                std::fprintf(stderr, "stb failed: %s\n", path.c_str());
+                return 1;
+            }
+            std::vector<std::uint16_t> half((std::size_t)w * h * 3);
+            FloatToHalfArray(data, half.data(), half.size());
+            auto t2 = Clock::now();
+            stbTimes.push_back(Ms(t0, t1));
+            stbHalfTimes.push_back(Ms(t0, t2));
+
+            RadianceHDR image;
+            auto t3 = Clock::now();
+            bool ok = image.Load(path, RadianceHDR::Output::Half, true, &pool);
+            auto t4 = Clock::now();
+            if (!ok) {
+                std::fprintf(stderr, "RadianceHDR failed: %s\n", path.c_str());
+                stbi_image_free(data);
+                return 1;
+            }
+            oursTimes.push_back(Ms(t3, t4));
+
+            // 只在第一轮校验：结果应该和 stb 的 float 完全对应到 half 精度
+            if (it == 0) {
+                for (std::size_t i = 0; i < half.size(); ++i)
+                {
+                    float ref = data[i];
+                    float ours = HalfToFloat(image.HalfData()[i]);
+                    float denom = std::max(std::fabs(ref), 1e-4f);
+                    maxRelError = std::max(maxRelError, std::fabs(ours - ref) / denom);
+                }
+            }
+            stbi_image_free(data);
+        }
+
+        // 峰值内存：stb = 文件内容 + float 缓冲 + 驱动的 half 暂存；ours = 文件内容 + half 缓冲
+        // 两边都算上文件内容，比的只是解码输出的差别
+        double pixels = (double)w * h;
+        double fileBytes = (double)std::filesystem::file_size(path);
+        double stbMB = (fileBytes + pixels * (12.0 + 6.0)) / (1024.0 * 1024.0);
+        double oursMB = (fileBytes + pixels * 6.0) / (1024.0 * 1024.0);
+        char size[32];
+        std::snprintf(size, sizeof(size), "%dx%d", w, h);
+
+        std::printf("%-22s %11s %14.2f %14.2f %12.2f %8.2fx %10.1f %10.1f\n",
+                    path.c_str(), size, Median(stbTimes), Median(stbHalfTimes), Median(oursTimes),
+                    Median(stbHalfTimes) / Median(oursTimes), stbMB, oursMB);
+        std::printf("%-22s max relative error vs stb float: %.2e\n", "", maxRelError);
+    }
+    return 0;
+}
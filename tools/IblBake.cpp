@@ -0,0 +1,264 @@
+// iblbake：离线 IBL 烘焙，纯 CPU，不需要 GL 上下文（构建机上没有 GPU 也能跑）
+// 用法：
+//   iblbake <input.hdr> [-o out.iblcache] [--shaders assets/shaders]
+//           [--env-size 512] [--irradiance-size 32] [--prefilter-size 128] [--format rgb16f|r11g11b10f]
+//       输出和 IBLBaker 运行时缓存同一格式、同一个 key：放到运行时的缓存路径上会直接命中
+//       （参数要和运行时的 IBLBakeSettings 一致，否则 key 不同）
+//   iblbake --compare <a.iblcache> <b.iblcache> [--tolerance 0.05]
+//       逐个贴图比较两份缓存（比如运行时 GPU 烘焙的 vs 离线 CPU 烘焙的），
+//       任何一项相对 RMS 误差超过容差、某张图只有一边有、或两边尺寸 / mip 数不同时返回 1
+//       ctest 的 iblbake_matches_gpu 就是这样比的（tools/IblBakeMatch.cmake）
+// 和运行时共用 IBLMath（投影、GGX 采样）和 IBLBakeSettings（分辨率、采样数）
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "HalfFloat.h"
+#include "IBLCache.h"
+#include "IBLMath.h"
+#include "RadianceHDR.h"
+#include "ThreadPool.h"
+
+using Clock = std::chrono::high_resolution_clock;
+
+static double Ms(Clock::time_point a, Clock::time_point b)
+{
+    return std::chrono::duration<double, std::milli>(b - a).count();
+}
+
+static const char* KindName(IBLCache::Kind kind)
+{
+    switch (kind)
+    {
+        case IBLCache::Kind::EnvCubemap: return "env";
+        case IBLCache::Kind::Irradiance: return "irradiance";
+        case IBLCache::Kind::Prefilter:  return "prefilter";
+        case IBLCache::Kind::BrdfLUT:    return "brdf_lut";
+    }
+    return "?";
+}
+
+// CubemapF（float）-> 缓存条目（half，mip 从大到小、每个 mip 6 个面）
+// 数据总是 half，internalFormat 只记录运行时上传成什么格式
+static IBLCache::Image PackCubemap(IBLCache::Kind kind, const CubemapF& cube, std::uint32_t internalFormat,
+                                   std::vector<std::uint16_t>& storage)
+{
+    IBLCache::Image img;
+    img.kind = kind;
+    img.cube = true;
+    img.internalFormat = internalFormat;
+    img.width = img.height = cube.size;
+    img.levels = cube.levels;
+    img.channels = 3;
+
+    storage.resize(img.TotalHalfCount());
+    std::uint16_t* dst = storage.data();
+    for (int level = 0; level < cube.levels; ++level)
+    {
+        for (int face = 0; face < 6; ++face)
+        {
+            std::size_t count = img.FaceHalfCount(level);
+            FloatToHalfArray(cube.Face(level, face), dst, count);
+            dst += count;
+        }
+    }
+    img.data = storage.data();
+    return img;
+}
+
+static int Bake(const std::string& hdrPath, std::string outPath, const std::string& shaderDir,
+                const IBLBakeSettings& settings)
+{
+    ThreadPool& pool = ThreadPool::Global();
+    auto t0 = Clock::now();
+
+    uint64_t key = 0;
+    if (!IBLCache::ComputeKey(hdrPath, settings, shaderDir, key)) return 1;
+    if (outPath.empty())
+        outPath = "cache/" + std::filesystem::path(hdrPath).stem().string() + ".iblcache";
+
+    // 1) 解码（和 TextureHDR 一样 flipY，行顺序与运行时上传的纹理一致）
+    RadianceHDR hdr;
+    if (!hdr.Load(hdrPath, RadianceHDR::Output::Half, true, &pool)) {
+        std::fprintf(stderr, "[iblbake] Failed to decode: %s\n", hdrPath.c_str());
+        return 1;
+    }
+    auto t1 = Clock::now();
+
+    // 2) 漫反射：SH9，另外求值出一张辐照度立方体
+    SH9 sh = RadianceToIrradianceSH9(ProjectEquirectToSH9(hdr.HalfData(), hdr.Width(), hdr.Height(), &pool));
+    CubemapF irradiance;
+    irradiance.Allocate(settings.irradianceSize, 1);
+    EvalSH9ToCubemap(sh, irradiance);
+    auto t2 = Clock::now();
+
+    // 3) 环境立方体 + mip 链
+    CubemapF env;
+    env.Allocate(settings.envSize, settings.EnvMips());
+    EquirectToCubemap(hdr.HalfData(), hdr.Width(), hdr.Height(), env, &pool);
+    GenerateCubemapMips(env, &pool);
+    auto t3 = Clock::now();
+
+    // 4) GGX 预滤波，每个 mip 一个 roughness
+    CubemapF prefilter;
+    prefilter.Allocate(settings.prefilterSize, settings.prefilterMips);
+    for (int mip = 0; mip < settings.prefilterMips; ++mip)
+    {
+        auto m0 = Clock::now();
+        float roughness = (float)mip / (float)std::max(settings.prefilterMips - 1, 1);
+        PrefilterCubemapLevel(env, prefilter, mip, roughness, settings.prefilterSamples[mip], &pool);
+        std::printf("[iblbake]   prefilter mip %d (%dx%d, roughness %.2f, %d samples): %.1f ms\n",
+                    mip, prefilter.LevelSize(mip), prefilter.LevelSize(mip), roughness,
+                    settings.prefilterSamples[mip], Ms(m0, Clock::now()));
+    }
+    auto t4 = Clock::now();
+
+    // 5) BRDF LUT
+    std::vector<float> lut = BakeBRDFLUTReference(settings.brdfLUTSize, settings.brdfLUTSamples, &pool);
+    auto t5 = Clock::now();
+
+    // 6) 写缓存
+    std::vector<std::uint16_t> envData, irrData, preData, lutData(lut.size());
+    FloatToHalfArray(lut.data(), lutData.data(), lut.size());
+
+    IBLCache::Image lutImage;
+    lutImage.kind = IBLCache::Kind::BrdfLUT;
+    lutImage.cube = false;
+    lutImage.internalFormat = IBLCache::kFormatRG16F;
+    lutImage.width = lutImage.height = settings.brdfLUTSize;
+    lutImage.levels = 1;
+    lutImage.channels = 2;
+    lutImage.data = lutData.data();
+
+    std::vector<IBLCache::Image> images = {
+        PackCubemap(IBLCache::Kind::EnvCubemap, env, settings.envFormat, envData),
+        PackCubemap(IBLCache::Kind::Irradiance, irradiance, settings.irradianceFormat, irrData),
+        PackCubemap(IBLCache::Kind::Prefilter, prefilter, settings.prefilterFormat, preData),
+        lutImage,
+    };
+    if (!IBLCache::Write(outPath, key, &sh, images)) return 1;
+    auto t6 = Clock::now();
+
+    std::printf("[iblbake] %s (%dx%d) -> %s, %u threads\n",
+                hdrPath.c_str(), hdr.Width(), hdr.Height(), outPath.c_str(), pool.ThreadCount() + 1);
+    std::printf("[iblbake]   decode %.1f ms, SH %.1f ms, env %.1f ms, prefilter %.1f ms, BRDF LUT %.1f ms, write %.1f ms\n",
+                Ms(t0, t1), Ms(t1, t2), Ms(t2, t3), Ms(t3, t4), Ms(t4, t5), Ms(t5, t6));
+    std::printf("[iblbake]   total %.1f ms\n", Ms(t0, t6));
+    return 0;
+}
+
+static int Compare(const std::string& pathA, const std::string& pathB, float tolerance)
+{
+    IBLCache a, b;
+    if (!a.Open(pathA)) { std::fprintf(stderr, "[iblbake] Cannot open: %s\n", pathA.c_str()); return 1; }
+    if (!b.Open(pathB)) { std::fprintf(stderr, "[iblbake] Cannot open: %s\n", pathB.c_str()); return 1; }
+    if (a.Key() != b.Key())
+        std::printf("[iblbake] Warning: keys differ (different HDR, settings or shaders)\n");
+
+    bool pass = true;
+    std::printf("%-12s %5s %12s %12s %12s\n", "image", "mip", "rel RMS", "max abs", "mean");
+    for (const IBLCache::Image& ia : a.Images())
+    {
+        // 一边缺图或布局不同都算不通过：没比上的东西不能报 PASS
+        const IBLCache::Image* ib = b.Find(ia.kind);
+        if (!ib) {
+            std::printf("%-12s missing in %s\n", KindName(ia.kind), pathB.c_str());
+            pass = false;
+            continue;
+        }
+        if (ib->cube != ia.cube || ib->width != ia.width || ib->height != ia.height ||
+            ib->channels != ia.channels || ib->levels != ia.levels) {
+            std::printf("%-12s layout differs (%dx%d x%d, %d mips vs %dx%d x%d, %d mips)\n", KindName(ia.kind),
+                        ia.width, ia.height, ia.channels, ia.levels, ib->width, ib->height, ib->channels, ib->levels);
+            pass = false;
+            continue;
+        }
+
+        std::size_t offset = 0;
+        for (int level = 0; level < ia.levels; ++level)
+        {
+            std::size_t count = ia.FaceHalfCount(level) * (std::size_t)ia.Faces();
+            std::vector<float> fa(count), fb(count);
+            HalfToFloatArray(ia.data + offset, fa.data(), count);
+            HalfToFloatArray(ib->data + offset, fb.data(), count);
+            offset += count;
+
+            // 相对误差按这一层的平均亮度归一（HDR 里单个像素的相对误差没有意义）
+            double sumSq = 0.0, sumRef = 0.0;
+            float maxAbs = 0.0f;
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                float d = fa[i] - fb[i];
+                sumSq += (double)d * d;
+                sumRef += std::fabs(fa[i]);
+                maxAbs = std::max(maxAbs, std::fabs(d));
+            }
+            double mean = sumRef / (double)count;
+            double relRms = std::sqrt(sumSq / (double)count) / std::max(mean, 1e-6);
+            bool ok = relRms <= tolerance;
+            pass = pass && ok;
+            std::printf("%-12s %5d %11.4f%s %12.5f %12.5f\n",
+                        KindName(ia.kind), level, relRms, ok ? " " : "!", maxAbs, mean);
+        }
+    }
+
+    for (const IBLCache::Image& ib : b.Images())
+    {
+        if (!a.Find(ib.kind)) {
+            std::printf("%-12s missing in %s\n", KindName(ib.kind), pathA.c_str());
+            pass = false;
+        }
+    }
+
+    std::printf("[iblbake] %s (tolerance %.4f)\n", pass ? "PASS" : "FAIL", tolerance);
+    return pass ? 0 : 1;
+}
+
+static void PrintUsage()
+{
+    std::printf("usage: iblbake <input.hdr> [-o out.iblcache] [--shaders dir]\n"
+                "               [--env-size n] [--irradiance-size n] [--prefilter-size n] [--format rgb16f|r11g11b10f]\n"
+                "       iblbake --compare <a.iblcache> <b.iblcache> [--tolerance 0.05]\n");
+}
+
+int main(int argc, char** argv)
+{
+    std::string input, output, compareA, compareB;
+    std::string shaderDir = "assets/shaders";
+    float tolerance = 0.05f;
+    IBLBakeSettings settings;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "-o" && i + 1 < argc) output = argv[++i];
+        else if (arg == "--shaders" && i + 1 < argc) shaderDir = argv[++i];
+        else if (arg == "--tolerance" && i + 1 < argc) tolerance = (float)std::atof(argv[++i]);
+        else if (arg == "--env-size" && i + 1 < argc) settings.envSize = std::atoi(argv[++i]);
+        else if (arg == "--irradiance-size" && i + 1 < argc) settings.irradianceSize = std::atoi(argv[++i]);
+        else if (arg == "--prefilter-size" && i + 1 < argc) settings.prefilterSize = std::atoi(argv[++i]);
+        else if (arg == "--format" && i + 1 < argc)
+        {
+            std::string format = argv[++i];
+            if (format == "rgb16f") settings.envFormat = IBLCache::kFormatRGB16F;
+            else if (format == "r11g11b10f") settings.envFormat = IBLCache::kFormatR11G11B10F;
+            else { PrintUsage(); return 1; }
+            settings.irradianceFormat = settings.prefilterFormat = settings.envFormat;
+        }
+        else if (arg == "--compare" && i + 2 < argc) { compareA = argv[++i]; compareB = argv[++i]; }
+        else if (arg == "-h" || arg == "--help") { PrintUsage(); return 0; }
+        else if (input.empty() && arg[0] != '-') input = arg;
+        else { PrintUsage(); return 1; }
+    }
+
+    if (!compareA.empty()) return Compare(compareA, compareB, tolerance);
+    if (input.empty()) { PrintUsage(); return 1; }
+    if (settings.envSize <= 0 || settings.irradianceSize <= 0 || settings.prefilterSize <= 0) { PrintUsage(); return 1; }
+    return Bake(input, output, shaderDir, settings);
+}
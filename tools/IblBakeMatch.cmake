@@ -0,0 +1,38 @@
+# ctest iblbake_matches_gpu：同一张 HDR、同一套默认 IBLBakeSettings，
+# RenderSandbox --headless 在 GPU 上烘一份缓存，iblbake 在 CPU 上烘一份，再用 iblbake --compare 按容差比对
+# 用法：cmake -DRENDERSANDBOX=... -DIBLBAKE=... -DASSET_DIR=... -DWORK_DIR=... -DTOLERANCE=... -P IblBakeMatch.cmake
+foreach(var RENDERSANDBOX IBLBAKE ASSET_DIR WORK_DIR TOLERANCE)
+    if (NOT DEFINED ${var})
+        message(FATAL_ERROR "IblBakeMatch: -D${var}=... is required")
+    endif()
+endforeach()
+
+set(hdr "assets/textures/suburban_garden_2k.hdr")
+set(gpuCache "cache/suburban_garden_2k.iblcache")
+set(cpuCache "cpu.iblcache")
+
+# 每次从空目录开始：没有缓存，RenderSandbox 启动时一定会在 GPU 上重新烘焙并写进 cache/
+file(REMOVE_RECURSE "${WORK_DIR}")
+file(MAKE_DIRECTORY "${WORK_DIR}")
+file(COPY "${ASSET_DIR}/" DESTINATION "${WORK_DIR}/assets")
+
+execute_process(COMMAND "${RENDERSANDBOX}" --headless --frames 1 --size 64x64
+                WORKING_DIRECTORY "${WORK_DIR}" RESULT_VARIABLE result)
+if (NOT result EQUAL 0)
+    message(FATAL_ERROR "RenderSandbox --headless failed (${result})")
+endif()
+if (NOT EXISTS "${WORK_DIR}/${gpuCache}")
+    message(FATAL_ERROR "RenderSandbox did not write ${gpuCache}")
+endif()
+
+execute_process(COMMAND "${IBLBAKE}" "${hdr}" -o "${cpuCache}" --shaders assets/shaders
+                WORKING_DIRECTORY "${WORK_DIR}" RESULT_VARIABLE result)
+if (NOT result EQUAL 0)
+    message(FATAL_ERROR "iblbake failed (${result})")
+endif()
+
+execute_process(COMMAND "${IBLBAKE}" --compare "${gpuCache}" "${cpuCache}" --tolerance "${TOLERANCE}"
+                WORKING_DIRECTORY "${WORK_DIR}" RESULT_VARIABLE result)
+if (NOT result EQUAL 0)
+    message(FATAL_ERROR "CPU and GPU IBL bakes differ by more than ${TOLERANCE}")
+endif()
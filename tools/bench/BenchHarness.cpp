@@ -0,0 +1,180 @@
+#include "BenchHarness.h"
+#include "HalfFloat.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+namespace Bench
+{
+    const void* volatile g_Sink = nullptr;
+
+    namespace
+    {
+        using Clock = std::chrono::steady_clock;
+
+        std::vector<Case>& Registry()
+        {
+            static std::vector<Case> s_Cases;
+            return s_Cases;
+        }
+
+        double TimeMs(const Case& c, std::int64_t iterations)
+        {
+            auto t0 = Clock::now();
+            c.run(iterations);
+            auto t1 = Clock::now();
+            return std::chrono::duration<double, std::milli>(t1 - t0).count();
+        }
+
+        const char* CompilerName()
+        {
+#if defined(__clang__)
+            return "clang " __clang_version__;
+#elif defined(__GNUC__)
+            return "gcc " __VERSION__;
+#elif defined(_MSC_VER)
+            return "msvc";
+#else
+            return "unknown";
+#endif
+        }
+    }
+
+    void Add(Case c)
+    {
+        Registry().push_back(std::move(c));
+    }
+
+    const std::vector<Case>& Cases()
+    {
+        return Registry();
+    }
+
+    std::vector<Result> RunAll(const Options& options)
+    {
+        std::vector<Result> results;
+        std::printf("%-44s %12s %12s %12s %10s\n", "case", "ns/item", "min", "max", "iters");
+
+        for (const Case& c : Registry())
+        {
+            if (!options.filter.empty() && c.name.find(options.filter) == std::string::npos) continue;
+
+            // 热身：第一次跑会有缓存未命中、页面分配、惰性初始化
+            c.run(1);
+
+            // 找到单次测量不少于 minTimeMs 的迭代次数
+            std::int64_t iterations = 1;
+            for (;;)
+            {
+                double ms = TimeMs(c, iterations);
+                if (ms >= options.minTimeMs || iterations >= (std::int64_t(1) << 40)) break;
+                double scale = ms > 0.0 ? options.minTimeMs * 1.2 / ms : 10.0;
+                iterations = std::max(iterations + 1, (std::int64_t)((double)iterations * std::min(scale, 10.0)));
+            }
+
+            std::vector<double> samples;
+            for (int r = 0; r < std::max(options.repeats, 1); ++r)
+            {
+                double ms = TimeMs(c, iterations);
+                samples.push_back(ms * 1.0e6 / ((double)iterations * (double)c.itemsPerIteration));
+            }
+            std::sort(samples.begin(), samples.end());
+
+            Result r;
+            r.name = c.name;
+            r.items = c.itemsPerIteration;
+            r.iterations = iterations;
+            r.repeats = (int)samples.size();
+            r.nsPerItem = samples[samples.size() / 2];
+            r.nsPerItemMin = samples.front();
+            r.nsPerItemMax = samples.back();
+            results.push_back(r);
+
+            std::printf("%-44s %12.3f %12.3f %12.3f %10lld\n", r.name.c_str(), r.nsPerItem,
+                        r.nsPerItemMin, r.nsPerItemMax, (long long)r.iterations);
+        }
+        return results;
+    }
+
+    bool WriteJson(const std::string& path, const std::vector<Result>& results, const Options& options)
+    {
+        std::FILE* f = std::fopen(path.c_str(), "w");
+        if (!f)
+        {
+            std::fprintf(stderr, "[Bench] Cannot write %s\n", path.c_str());
+            return false;
+        }
+        std::fprintf(f, "{\n  \"tool\": \"RenderSandboxBench\",\n  \"compiler\": \"%s\",\n", CompilerName());
+        std::fprintf(f, "  \"simd\": \"%s\",\n",
+#if defined(RENDERSANDBOX_HAS_F16C)
+                     "avx2+f16c"
+#else
+                     "none"
+#endif
+        );
+        std::fprintf(f, "  \"hardwareThreads\": %u,\n  \"minTimeMs\": %.1f,\n  \"repeats\": %d,\n",
+                     std::thread::hardware_concurrency(), options.minTimeMs, options.repeats);
+        std::fprintf(f, "  \"results\": [\n");
+        for (std::size_t i = 0; i < results.size(); ++i)
+        {
+            const Result& r = results[i];
+            std::fprintf(f, "    { \"name\": \"%s\", \"items\": %lld, \"iterations\": %lld, \"repeats\": %d, "
+                            "\"nsPerItem\": %.4f, \"nsPerItemMin\": %.4f, \"nsPerItemMax\": %.4f }%s\n",
+                         r.name.c_str(), (long long)r.items, (long long)r.iterations, r.repeats,
+                         r.nsPerItem, r.nsPerItemMin, r.nsPerItemMax, i + 1 < results.size() ? "," : "");
+        }
+        std::fprintf(f, "  ]\n}\n");
+        std::fclose(f);
+        std::printf("[Bench] Wrote %s (%d cases)\n", path.c_str(), (int)results.size());
+        return true;
+    }
+
+    bool LoadBaseline(const std::string& path, std::map<std::string, double>& nsPerItem)
+    {
+        std::FILE* f = std::fopen(path.c_str(), "r");
+        if (!f)
+        {
+            std::fprintf(stderr, "[Bench] Cannot read baseline %s\n", path.c_str());
+            return false;
+        }
+        char line[1024];
+        while (std::fgets(line, sizeof(line), f))
+        {
+            const char* name = std::strstr(line, "\"name\": \"");
+            const char* value = std::strstr(line, "\"nsPerItem\": ");
+            if (!name || !value) continue;
+            name += std::strlen("\"name\": \"");
+            const char* nameEnd = std::strchr(name, '"');
+            if (!nameEnd) continue;
+            nsPerItem[std::string(name, nameEnd)] = std::strtod(value + std::strlen("\"nsPerItem\": "), nullptr);
+        }
+        std::fclose(f);
+        return !nsPerItem.empty();
+    }
+
+    int Compare(const std::vector<Result>& results, const std::map<std::string, double>& baseline, double threshold)
+    {
+        int regressions = 0;
+        std::printf("\n%-44s %12s %12s %9s\n", "case", "baseline", "now", "change");
+        for (const Result& r : results)
+        {
+            auto it = baseline.find(r.name);
+            if (it == baseline.end() || it->second <= 0.0)
+            {
+                std::printf("%-44s %12s %12.3f %9s\n", r.name.c_str(), "-", r.nsPerItem, "new");
+                continue;
+            }
+            double change = r.nsPerItem / it->second - 1.0;
+            // 比 baseline 慢超过阈值，而且连这次最快的一轮都慢，才算回退（噪声大的用例不误报）
+            bool regressed = change > threshold && r.nsPerItemMin > it->second * (1.0 + threshold);
+            if (regressed) ++regressions;
+            std::printf("%-44s %12.3f %12.3f %+8.1f%%%s\n", r.name.c_str(), it->second, r.nsPerItem,
+                        change * 100.0, regressed ? "  REGRESSION" : "");
+        }
+        return regressions;
+    }
+}
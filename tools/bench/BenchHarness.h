@@ -0,0 +1,59 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+// RenderSandboxBench 的小型计时框架（不依赖 Google Benchmark）
+// - 每个用例先热身一次，再把迭代次数加到单次测量不少于 minTimeMs，测 repeats 次取中位数
+// - 结果按"每个 item 的纳秒数"报告，item 由用例自己定义（矩阵、顶点、像素、draw……）
+// - JSON 每个用例一行，baseline 就是之前某次运行的输出文件
+namespace Bench
+{
+    struct Case
+    {
+        std::string name;                   // "组/用例/参数"，--filter 按子串匹配
+        std::int64_t itemsPerIteration = 1;
+        std::function<void(std::int64_t iterations)> run;
+    };
+
+    struct Result
+    {
+        std::string name;
+        std::int64_t items = 0;             // 每次迭代
+        std::int64_t iterations = 0;        // 每次测量
+        int repeats = 0;
+        double nsPerItem = 0.0;             // 中位数
+        double nsPerItemMin = 0.0;
+        double nsPerItemMax = 0.0;
+    };
+
+    struct Options
+    {
+        double minTimeMs = 100.0;
+        int repeats = 5;
+        std::string filter;
+    };
+
+    void Add(Case c);
+    const std::vector<Case>& Cases();
+
+    std::vector<Result> RunAll(const Options& options);
+
+    bool WriteJson(const std::string& path, const std::vector<Result>& results, const Options& options);
+    // name -> nsPerItem；只认 WriteJson 写出来的格式
+    bool LoadBaseline(const std::string& path, std::map<std::string, double>& nsPerItem);
+    // 打印和 baseline 的差异，返回变慢超过 threshold（0.1 = 10%）的用例数
+    int Compare(const std::vector<Result>& results, const std::map<std::string, double>& baseline, double threshold);
+
+    // 让结果"被用到"，防止整个循环被优化掉
+    extern const void* volatile g_Sink;
+    template <class T>
+    inline void DoNotOptimize(const T& value)
+    {
+        g_Sink = &value;
+        std::atomic_signal_fence(std::memory_order_seq_cst);
+    }
+}
@@ -0,0 +1,138 @@
+#include "NullGL.h"
+
+#include <glad/glad.h>
+#include <cstring>
+
+namespace
+{
+    long long s_Calls = 0;
+    GLuint s_NextName = 1;
+
+    const GLubyte* APIENTRY NullGetString(GLenum name)
+    {
+        ++s_Calls;
+        static const char* kVersion = "3.3.0 NullGL";
+        static const char* kEmpty = "";
+        return (const GLubyte*)(name == GL_VERSION ? kVersion : kEmpty);
+    }
+    const GLubyte* APIENTRY NullGetStringi(GLenum, GLuint) { ++s_Calls; return (const GLubyte*)""; }
+    void APIENTRY NullGetIntegerv(GLenum, GLint* data) { ++s_Calls; if (data) *data = 0; }
+
+    GLuint APIENTRY NullCreateShader(GLenum) { ++s_Calls; return s_NextName++; }
+    GLuint APIENTRY NullCreateProgram() { ++s_Calls; return s_NextName++; }
+    void APIENTRY NullShaderSource(GLuint, GLsizei, const GLchar* const*, const GLint*) { ++s_Calls; }
+    void APIENTRY NullCompileShader(GLuint) { ++s_Calls; }
+    void APIENTRY NullGetShaderiv(GLuint, GLenum pname, GLint* params)
+    {
+        ++s_Calls;
+        *params = pname == GL_COMPILE_STATUS ? GL_TRUE : 0;
+    }
+    void APIENTRY NullGetProgramiv(GLuint, GLenum pname, GLint* params)
+    {
+        ++s_Calls;
+        *params = (pname == GL_LINK_STATUS || pname == GL_VALIDATE_STATUS) ? GL_TRUE : 0;
+    }
+    void APIENTRY NullGetInfoLog(GLuint, GLsizei, GLsizei* length, GLchar* log)
+    {
+        ++s_Calls;
+        if (length) *length = 0;
+        if (log) log[0] = 0;
+    }
+    void APIENTRY NullAttachShader(GLuint, GLuint) { ++s_Calls; }
+    void APIENTRY NullLinkProgram(GLuint) { ++s_Calls; }
+    void APIENTRY NullDeleteShader(GLuint) { ++s_Calls; }
+    void APIENTRY NullDeleteProgram(GLuint) { ++s_Calls; }
+    void APIENTRY NullUseProgram(GLuint) { ++s_Calls; }
+
+    // 驱动真的会按名字查表；这里只走一遍字符串，位置按长度给，永远不是 -1
+    GLint APIENTRY NullGetUniformLocation(GLuint, const GLchar* name)
+    {
+        ++s_Calls;
+        return (GLint)std::strlen(name);
+    }
+    void APIENTRY NullUniform1i(GLint, GLint) { ++s_Calls; }
+    void APIENTRY NullUniform1f(GLint, GLfloat) { ++s_Calls; }
+    void APIENTRY NullUniform2f(GLint, GLfloat, GLfloat) { ++s_Calls; }
+    void APIENTRY NullUniform3f(GLint, GLfloat, GLfloat, GLfloat) { ++s_Calls; }
+    void APIENTRY NullUniform4f(GLint, GLfloat, GLfloat, GLfloat, GLfloat) { ++s_Calls; }
+    void APIENTRY NullUniformfv(GLint, GLsizei, const GLfloat*) { ++s_Calls; }
+    void APIENTRY NullUniformMatrix4fv(GLint, GLsizei, GLboolean, const GLfloat*) { ++s_Calls; }
+
+    void APIENTRY NullActiveTexture(GLenum) { ++s_Calls; }
+    void APIENTRY NullBindTexture(GLenum, GLuint) { ++s_Calls; }
+    void APIENTRY NullBindVertexArray(GLuint) { ++s_Calls; }
+    void APIENTRY NullDrawArrays(GLenum, GLint, GLsizei) { ++s_Calls; }
+    void APIENTRY NullBindBuffer(GLenum, GLuint) { ++s_Calls; }
+    void APIENTRY NullBindBufferBase(GLenum, GLuint, GLuint) { ++s_Calls; }
+    void APIENTRY NullBufferSubData(GLenum, GLintptr, GLsizeiptr, const void*) { ++s_Calls; }
+    void APIENTRY NullGenBuffers(GLsizei n, GLuint* buffers)
+    {
+        ++s_Calls;
+        for (GLsizei i = 0; i < n; ++i) buffers[i] = s_NextName++;
+    }
+    void APIENTRY NullDeleteBuffers(GLsizei, const GLuint*) { ++s_Calls; }
+
+    struct Entry
+    {
+        const char* name;
+        void* proc;
+    };
+
+    const Entry kEntries[] = {
+        { "glGetString", (void*)&NullGetString },
+        { "glGetStringi", (void*)&NullGetStringi },
+        { "glGetIntegerv", (void*)&NullGetIntegerv },
+        { "glCreateShader", (void*)&NullCreateShader },
+        { "glCreateProgram", (void*)&NullCreateProgram },
+        { "glShaderSource", (void*)&NullShaderSource },
+        { "glCompileShader", (void*)&NullCompileShader },
+        { "glGetShaderiv", (void*)&NullGetShaderiv },
+        { "glGetProgramiv", (void*)&NullGetProgramiv },
+        { "glGetShaderInfoLog", (void*)&NullGetInfoLog },
+        { "glGetProgramInfoLog", (void*)&NullGetInfoLog },
+        { "glAttachShader", (void*)&NullAttachShader },
+        { "glDetachShader", (void*)&NullAttachShader },
+        { "glLinkProgram", (void*)&NullLinkProgram },
+        { "glDeleteShader", (void*)&NullDeleteShader },
+        { "glDeleteProgram", (void*)&NullDeleteProgram },
+        { "glUseProgram", (void*)&NullUseProgram },
+        { "glGetUniformLocation", (void*)&NullGetUniformLocation },
+        { "glUniform1i", (void*)&NullUniform1i },
+        { "glUniform1f", (void*)&NullUniform1f },
+        { "glUniform2f", (void*)&NullUniform2f },
+        { "glUniform3f", (void*)&NullUniform3f },
+        { "glUniform4f", (void*)&NullUniform4f },
+        { "glUniform3fv", (void*)&NullUniformfv },
+        { "glUniform4fv", (void*)&NullUniformfv },
+        { "glUniformMatrix4fv", (void*)&NullUniformMatrix4fv },
+        { "glActiveTexture", (void*)&NullActiveTexture },
+        { "glBindTexture", (void*)&NullBindTexture },
+        { "glBindVertexArray", (void*)&NullBindVertexArray },
+        { "glDrawArrays", (void*)&NullDrawArrays },
+        { "glBindBuffer", (void*)&NullBindBuffer },
+        { "glBindBufferBase", (void*)&NullBindBufferBase },
+        { "glBufferSubData", (void*)&NullBufferSubData },
+        { "glGenBuffers", (void*)&NullGenBuffers },
+        { "glDeleteBuffers", (void*)&NullDeleteBuffers },
+    };
+
+    void* NullGetProcAddress(const char* name)
+    {
+        for (const Entry& e : kEntries)
+            if (std::strcmp(e.name, name) == 0) return e.proc;
+        return nullptr;
+    }
+}
+
+namespace NullGL
+{
+    bool Install()
+    {
+        return gladLoadGLLoader((GLADloadproc)NullGetProcAddress) != 0;
+    }
+
+    long long CallCount()
+    {
+        return s_Calls;
+    }
+}
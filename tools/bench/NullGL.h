@@ -0,0 +1,12 @@
+#pragma once
+
+// NullGL：给 glad 装一套空的 GL 函数，没有 GPU、没有上下文也能跑 Shader / Material / Renderer 的 CPU 部分
+// - 编译、链接永远成功，glGetUniformLocation 永远找得到（返回按名字算的位置）
+// - 量到的是我们这边的开销（拼字符串、查 uniform、打包数据），不含驱动
+// - 表里没有的函数留空指针，基准里误调会直接崩，而不是悄悄量错
+namespace NullGL
+{
+    bool Install();
+    // 装上以后累计的 GL 调用次数
+    long long CallCount();
+}
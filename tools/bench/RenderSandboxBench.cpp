@@ -0,0 +1,463 @@
+// RenderSandboxBench：CPU 热点的微基准，结果写 JSON，可以和 baseline 对比
+// 用法：RenderSandboxBench [--filter S] [--min-time MS] [--repeats N] [--out FILE] [--baseline FILE] [--threshold F] [--list]
+// 不需要 GPU：Shader / Material / Renderer 走 NullGL（GL 函数都是空的），量的是 CPU 一侧的开销
+// 记录 baseline：在同一台机器上用 Release 跑一遍 --out tools/bench/baselines/<机器名>.json，提交进仓库
+//（刷新命令见 tools/bench/baselines/README.md）；
+// 之后改动热点时用 --baseline 对比，有回退时返回码是 2
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <assimp/scene.h>
+
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include <stb_image_write.h>
+#include <stb_image.h>
+
+#include "BenchHarness.h"
+#include "NullGL.h"
+
+#include "Material.h"
+#include "Model.h"
+#include "Object.h"
+#include "RadianceHDR.h"
+#include "SceneStore.h"
+#include "Shader.h"
+#include "ThreadPool.h"
+#include "Transform.h"
+#include "render/Renderer.h"
+
+#ifndef RENDERSANDBOX_ASSET_DIR
+#define RENDERSANDBOX_ASSET_DIR "assets"
+#endif
+
+namespace
+{
+    std::string Asset(const char* relative)
+    {
+        return std::string(RENDERSANDBOX_ASSET_DIR) + "/" + relative;
+    }
+
+    // 固定种子：每次运行的输入完全一样
+    std::vector<Transform> RandomTransforms(int count)
+    {
+        std::mt19937 rng(1234);
+        std::uniform_real_distribution<float> pos(-50.0f, 50.0f), angle(-180.0f, 180.0f), scale(0.2f, 3.0f);
+        std::vector<Transform> transforms(count);
+        for (Transform& t : transforms)
+        {
+            t.position = glm::vec3(pos(rng), pos(rng), pos(rng));
+            t.rotationEulerDeg = glm::vec3(angle(rng), angle(rng), angle(rng));
+            t.scale = glm::vec3(scale(rng), scale(rng), scale(rng));
+        }
+        return transforms;
+    }
+
+    // UV 球：(stacks + 1) * (slices + 1) 个顶点，带法线和 UV，和 Assimp 导入 OBJ 后的布局一样
+    std::shared_ptr<aiMesh> MakeSphereMesh(int stacks, int slices)
+    {
+        auto mesh = std::make_shared<aiMesh>();
+        const unsigned vertexCount = (unsigned)((stacks + 1) * (slices + 1));
+        mesh->mNumVertices = vertexCount;
+        mesh->mVertices = new aiVector3D[vertexCount];
+        mesh->mNormals = new aiVector3D[vertexCount];
+        mesh->mTextureCoords[0] = new aiVector3D[vertexCount];
+        mesh->mNumUVComponents[0] = 2;
+
+        unsigned v = 0;
+        for (int i = 0; i <= stacks; ++i)
+        {
+            float phi = 3.14159265f * (float)i / (float)stacks;
+            for (int j = 0; j <= slices; ++j, ++v)
+            {
+                float theta = 6.28318531f * (float)j / (float)slices;
+                aiVector3D n(std::sin(phi) * std::cos(theta), std::cos(phi), std::sin(phi) * std::sin(theta));
+                mesh->mNormals[v] = n;
+                mesh->mVertices[v] = aiVector3D(n.x * 2.0f + 1.0f, n.y * 2.0f, n.z * 2.0f - 0.5f);
+                mesh->mTextureCoords[0][v] = aiVector3D((float)j / (float)slices, (float)i / (float)stacks, 0.0f);
+            }
+        }
+
+        mesh->mNumFaces = (unsigned)(stacks * slices * 2);
+        mesh->mFaces = new aiFace[mesh->mNumFaces];
+        unsigned f = 0;
+        for (int i = 0; i < stacks; ++i)
+        {
+            for (int j = 0; j < slices; ++j)
+            {
+                unsigned a = (unsigned)(i * (slices + 1) + j), b = a + (unsigned)slices + 1;
+                const unsigned quad[2][3] = { { a, b, a + 1 }, { a + 1, b, b + 1 } };
+                for (const auto& tri : quad)
+                {
+                    aiFace& face = mesh->mFaces[f++];
+                    face.mNumIndices = 3;
+                    face.mIndices = new unsigned int[3]{ tri[0], tri[1], tri[2] };
+                }
+            }
+        }
+        return mesh;
+    }
+
+    // 和 HdrDecodeBench 一样的合成全景图：天空渐变 + 太阳
+    bool WriteSyntheticHDR(const std::string& path, int w, int h)
+    {
+        std::vector<float> pixels((std::size_t)w * h * 3);
+        for (int y = 0; y < h; ++y)
+        {
+            float v = (float)y / (float)(h - 1);
+            for (int x = 0; x < w; ++x)
+            {
+                float u = (float)x / (float)(w - 1);
+                float du = u - 0.3f, dv = v - 0.25f;
+                float sun = 2000.0f * std::exp(-(du * du + dv * dv) * 4000.0f);
+                float* p = &pixels[((std::size_t)y * w + x) * 3];
+                p[0] = 0.2f + 0.8f * (1.0f - v) + sun;
+                p[1] = 0.3f + 0.9f * (1.0f - v) + sun * 0.9f;
+                p[2] = 0.6f + 1.2f * (1.0f - v) + sun * 0.7f + 0.05f * std::sin(u * 200.0f);
+            }
+        }
+        return stbi_write_hdr(path.c_str(), w, h, 3, pixels.data()) != 0;
+    }
+
+    // ---------------- Transform ----------------
+
+    void AddTransformCases()
+    {
+        for (int count : { 1000, 100000 })
+        {
+            auto transforms = std::make_shared<std::vector<Transform>>(RandomTransforms(count));
+            auto matrices = std::make_shared<std::vector<glm::mat4>>(count);
+            Bench::Add({ "transform/to_matrix/" + std::to_string(count), count,
+                         [transforms, matrices](std::int64_t iterations) {
+                             for (std::int64_t it = 0; it < iterations; ++it)
+                             {
+                                 for (std::size_t i = 0; i < transforms->size(); ++i)
+                                     (*matrices)[i] = (*transforms)[i].ToMatrix();
+                                 Bench::DoNotOptimize(matrices->back());
+                             }
+                         } });
+        }
+    }
+
+    // ---------------- SceneStore ----------------
+
+    std::shared_ptr<SceneStore> MakeStore(const std::vector<Transform>& transforms, int childrenPerRoot)
+    {
+        auto store = std::make_shared<SceneStore>();
+        store->Reserve(transforms.size());
+        SceneHandle root;
+        for (std::size_t i = 0; i < transforms.size(); ++i)
+        {
+            bool isRoot = childrenPerRoot <= 0 || i % (std::size_t)(childrenPerRoot + 1) == 0;
+            SceneHandle h = store->Create(transforms[i], 0, 0, isRoot ? SceneHandle() : root);
+            if (isRoot) root = h;
+        }
+        store->Update();
+        return store;
+    }
+
+    // 和 transform/to_matrix 同样的 10 万个随机变换：全脏 / 1% 脏 / 带层级
+    // 没有脏实体时 Update 只看一眼脏区间就返回，几乎不花时间，不单独设用例（放进回退判断里只会是噪声）
+    void AddSceneStoreCases()
+    {
+        const int count = 100000;
+        const std::vector<Transform> transforms = RandomTransforms(count);
+        const std::string suffix = "/" + std::to_string(count);
+
+        auto flat = MakeStore(transforms, 0);
+        Bench::Add({ "scene/update_all" + suffix, count,
+                     [flat](std::int64_t iterations) {
+                         for (std::int64_t it = 0; it < iterations; ++it)
+                         {
+                             flat->MarkAllDirty();
+                             Bench::DoNotOptimize(flat->Update());
+                         }
+                     } });
+
+        // 每 100 个改一个位置，items 按改了的个数算
+        const int stride = 100;
+        auto handles = std::make_shared<std::vector<SceneHandle>>();
+        for (int i = 0; i < count; i += stride)
+            handles->push_back(flat->HandleAt(i));
+        Bench::Add({ "scene/update_1pct" + suffix, (std::int64_t)handles->size(),
+                     [flat, handles](std::int64_t iterations) {
+                         for (std::int64_t it = 0; it < iterations; ++it)
+                         {
+                             float y = (float)(it & 7);
+                             for (SceneHandle h : *handles)
+                                 flat->SetPosition(h, glm::vec3(1.0f, y, 2.0f));
+                             Bench::DoNotOptimize(flat->Update());
+                         }
+                     } });
+
+        // 1 万个根，每个挂 9 个子节点：局部矩阵之外还要乘一次父矩阵
+        auto tree = MakeStore(transforms, 9);
+        Bench::Add({ "scene/update_hierarchy" + suffix, count,
+                     [tree](std::int64_t iterations) {
+                         for (std::int64_t it = 0; it < iterations; ++it)
+                         {
+                             tree->MarkAllDirty();
+                             Bench::DoNotOptimize(tree->Update());
+                         }
+                     } });
+    }
+
+    // ---------------- Model ----------------
+
+    void AddModelCases()
+    {
+        // 约 1k / 66k / 263k 顶点
+        const int sizes[3][2] = { { 24, 40 }, { 128, 512 }, { 256, 1024 } };
+        for (const auto& size : sizes)
+        {
+            std::shared_ptr<aiMesh> mesh = MakeSphereMesh(size[0], size[1]);
+            const std::int64_t vertexCount = mesh->mNumVertices;
+            auto vertices = std::make_shared<std::vector<MeshVertex>>();
+            auto indices = std::make_shared<std::vector<unsigned int>>();
+
+            // ProcessMesh 除了 GL 上传以外的全部：拷贝顶点/索引 + 包围盒
+            Bench::Add({ "model/process_mesh/" + std::to_string(vertexCount), vertexCount,
+                         [mesh, vertices, indices](std::int64_t iterations) {
+                             for (std::int64_t it = 0; it < iterations; ++it)
+                             {
+                                 glm::vec3 bmin(0.0f), bmax(0.0f);
+                                 bool valid = false;
+                                 Model::ExtractMesh(mesh.get(), *vertices, *indices);
+                                 Model::ExpandBounds(*vertices, bmin, bmax, valid);
+                                 Bench::DoNotOptimize(bmax);
+                             }
+                         } });
+
+            Model::ExtractMesh(mesh.get(), *vertices, *indices);
+            Bench::Add({ "model/bounds/" + std::to_string(vertexCount), vertexCount,
+                         [vertices](std::int64_t iterations) {
+                             for (std::int64_t it = 0; it < iterations; ++it)
+                             {
+                                 glm::vec3 bmin(0.0f), bmax(0.0f);
+                                 bool valid = false;
+                                 Model::ExpandBounds(*vertices, bmin, bmax, valid);
+                                 Bench::DoNotOptimize(bmax);
+                             }
+                         } });
+        }
+    }
+
+    // ---------------- Shader / Renderer（NullGL） ----------------
+
+    struct RendererFixture
+    {
+        std::unique_ptr<Shader> shader;
+        Material material;
+        std::vector<Object> objects;
+        Renderer renderer;
+    };
+
+    std::shared_ptr<RendererFixture> MakeRendererFixture(int lightCount)
+    {
+        auto fx = std::make_shared<RendererFixture>();
+        fx->shader = std::make_unique<Shader>(Asset("shaders/basic.vert"), Asset("shaders/basic.frag"));
+        fx->material.shader = fx->shader.get();
+
+        std::vector<Transform> transforms = RandomTransforms(1000);
+        fx->objects.resize(transforms.size());
+        for (std::size_t i = 0; i < transforms.size(); ++i)
+        {
+            fx->objects[i].transform = transforms[i];
+            fx->objects[i].material = &fx->material;
+        }
+
+        std::vector<PointLight> lights(lightCount);
+        for (int i = 0; i < lightCount; ++i)
+        {
+            lights[i].position = glm::vec3((float)i, 2.0f, -(float)i);
+            lights[i].color = glm::vec3(1.0f, 0.9f, 0.8f);
+        }
+        fx->renderer.SetPointLights(lights);
+        fx->renderer.BeginFrame(glm::mat4(1.0f), glm::mat4(1.0f), glm::vec3(0.0f, 1.0f, 5.0f));
+        return fx;
+    }
+
+    void AddRendererCases()
+    {
+        // DrawObject 每个物体都要：材质 uniform + 3 个矩阵 + 灯光（每盏灯拼两个 "u_PointLights[i].xxx" 字符串）
+        for (int lights : { 0, 8 })
+        {
+            std::shared_ptr<RendererFixture> fx = MakeRendererFixture(lights);
+            Bench::Add({ "renderer/draw_object/lights_" + std::to_string(lights), (std::int64_t)fx->objects.size(),
+                         [fx](std::int64_t iterations) {
+                             for (std::int64_t it = 0; it < iterations; ++it)
+                                 for (const Object& obj : fx->objects)
+                                     fx->renderer.DrawObject(obj, 1, 36);
+                         } });
+        }
+
+        // 对照：同样 8 盏灯按 std140 打包进一个 UBO（每盏灯两个 vec4 + 数量），一次 glBufferSubData
+        // 和上面 lights_8 - lights_0 的差值比，就是把灯光改成 UBO 能省下的每物体开销
+        auto lights = std::make_shared<std::vector<PointLight>>(8);
+        auto packed = std::make_shared<std::vector<glm::vec4>>(1 + 2 * 8);
+        Bench::Add({ "renderer/light_ubo_pack_std140/lights_8", 1000,
+                     [lights, packed](std::int64_t iterations) {
+                         for (std::int64_t it = 0; it < iterations * 1000; ++it)
+                         {
+                             std::vector<glm::vec4>& block = *packed;
+                             block[0] = glm::vec4((float)lights->size(), 0.0f, 0.0f, 0.0f);
+                             for (std::size_t i = 0; i < lights->size(); ++i)
+                             {
+                                 block[1 + i * 2] = glm::vec4((*lights)[i].position, 0.0f);
+                                 block[2 + i * 2] = glm::vec4((*lights)[i].color, 0.0f);
+                             }
+                             glBindBuffer(GL_UNIFORM_BUFFER, 1);
+                             glBufferSubData(GL_UNIFORM_BUFFER, 0, (GLsizeiptr)(block.size() * sizeof(glm::vec4)),
+                                             block.data());
+                         }
+                     } });
+
+        // uniform 名字从 const char* 转 std::string：15 字节以内走 SSO，更长的每次都要分配
+        std::shared_ptr<RendererFixture> fx = MakeRendererFixture(0);
+        Bench::Add({ "shader/set_uniform/short_name", 1, [fx](std::int64_t iterations) {
+                         for (std::int64_t it = 0; it < iterations; ++it)
+                             fx->shader->setUniform1f("u_AO", 1.0f);
+                     } });
+        Bench::Add({ "shader/set_uniform/long_name", 1, [fx](std::int64_t iterations) {
+                         for (std::int64_t it = 0; it < iterations; ++it)
+                             fx->shader->setUniform1f("u_AmbientStrength", 0.08f);
+                     } });
+        Bench::Add({ "shader/set_uniform/mat4", 1, [fx](std::int64_t iterations) {
+                         glm::mat4 m(1.0f);
+                         for (std::int64_t it = 0; it < iterations; ++it)
+                             fx->shader->setUniformMat4("u_Model", m);
+                     } });
+        Bench::Add({ "shader/material_bind", 1, [fx](std::int64_t iterations) {
+                         for (std::int64_t it = 0; it < iterations; ++it)
+                             fx->material.Bind(glm::vec3(0.0f, 1.0f, 5.0f));
+                     } });
+    }
+
+    // ---------------- HDR 解码 ----------------
+
+    void AddHdrCases(const std::string& path, int w, int h)
+    {
+        const std::int64_t pixels = (std::int64_t)w * h;
+        const std::string suffix = std::to_string(w) + "x" + std::to_string(h);
+
+        Bench::Add({ "hdr/stbi_loadf/" + suffix, pixels, [path](std::int64_t iterations) {
+                         for (std::int64_t it = 0; it < iterations; ++it)
+                         {
+                             int x = 0, y = 0, comp = 0;
+                             float* data = stbi_loadf(path.c_str(), &x, &y, &comp, 3);
+                             Bench::DoNotOptimize(data);
+                             stbi_image_free(data);
+                         }
+                     } });
+        Bench::Add({ "hdr/radiance_half_1thread/" + suffix, pixels, [path](std::int64_t iterations) {
+                         for (std::int64_t it = 0; it < iterations; ++it)
+                         {
+                             RadianceHDR image;
+                             image.Load(path, RadianceHDR::Output::Half, true, nullptr);
+                             Bench::DoNotOptimize(image);
+                         }
+                     } });
+        Bench::Add({ "hdr/radiance_half_pool/" + suffix, pixels, [path](std::int64_t iterations) {
+                         for (std::int64_t it = 0; it < iterations; ++it)
+                         {
+                             RadianceHDR image;
+                             image.Load(path, RadianceHDR::Output::Half, true, &ThreadPool::Global());
+                             Bench::DoNotOptimize(image);
+                         }
+                     } });
+    }
+
+    void PrintUsage(const char* exe)
+    {
+        std::printf(
+            "Usage: %s [options]\n"
+            "  --filter S        only cases whose name contains S\n"
+            "  --min-time MS     minimum time per measurement (default 100)\n"
+            "  --repeats N       measurements per case, median reported (default 5)\n"
+            "  --out FILE        write results JSON (default bench_results.json)\n"
+            "  --baseline FILE   compare with an earlier results JSON, exit 2 on regression\n"
+            "  --threshold F     regression threshold as a fraction (default 0.10)\n"
+            "  --list            list case names and exit\n",
+            exe);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    Bench::Options options;
+    std::string outPath = "bench_results.json";
+    std::string baselinePath;
+    double threshold = 0.10;
+    bool listOnly = false;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const char* arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (std::strcmp(arg, "--list") == 0) { listOnly = true; continue; }
+        if (std::strcmp(arg, "--help") == 0 || !value) { PrintUsage(argv[0]); return std::strcmp(arg, "--help") == 0 ? 0 : 1; }
+        if (std::strcmp(arg, "--filter") == 0) options.filter = value;
+        else if (std::strcmp(arg, "--min-time") == 0) options.minTimeMs = std::atof(value);
+        else if (std::strcmp(arg, "--repeats") == 0) options.repeats = std::atoi(value);
+        else if (std::strcmp(arg, "--out") == 0) outPath = value;
+        else if (std::strcmp(arg, "--baseline") == 0) baselinePath = value;
+        else if (std::strcmp(arg, "--threshold") == 0) threshold = std::atof(value);
+        else { PrintUsage(argv[0]); return 1; }
+        ++i;
+    }
+
+    if (!NullGL::Install())
+    {
+        std::fprintf(stderr, "[Bench] NullGL install failed\n");
+        return 1;
+    }
+
+    // HDR 输入写到临时目录，每次运行内容一样
+    const int hdrW = 2048, hdrH = 1024;
+    const std::string hdrPath = (std::filesystem::temp_directory_path() / "rendersandbox_bench_2k.hdr").string();
+    if (!WriteSyntheticHDR(hdrPath, hdrW, hdrH))
+    {
+        std::fprintf(stderr, "[Bench] Failed to write %s\n", hdrPath.c_str());
+        return 1;
+    }
+
+    AddTransformCases();
+    AddSceneStoreCases();
+    AddModelCases();
+    AddRendererCases();
+    AddHdrCases(hdrPath, hdrW, hdrH);
+
+    if (listOnly)
+    {
+        for (const Bench::Case& c : Bench::Cases()) std::printf("%s\n", c.name.c_str());
+        std::remove(hdrPath.c_str());
+        return 0;
+    }
+
+    std::printf("threads: %u, min time %.0f ms, %d repeats (median)\n\n",
+                ThreadPool::Global().ThreadCount() + 1, options.minTimeMs, options.repeats);
+    std::vector<Bench::Result> results = Bench::RunAll(options);
+    std::remove(hdrPath.c_str());
+    if (!Bench::WriteJson(outPath, results, options)) return 1;
+
+    if (!baselinePath.empty())
+    {
+        std::map<std::string, double> baseline;
+        if (!Bench::LoadBaseline(baselinePath, baseline)) return 1;
+        int regressions = Bench::Compare(results, baseline, threshold);
+        if (regressions > 0)
+        {
+            std::printf("\n%d case(s) regressed by more than %.0f%%\n", regressions, threshold * 100.0);
+            return 2;
+        }
+    }
+    return 0;
+}